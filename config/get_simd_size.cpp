@@ -0,0 +1,29 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#include <cstdio>
+
+// Print the size in bytes of the widest SIMD registers enabled by the compiler
+// flags, used as the default value of MFEM_SIMD_SIZE.
+int main()
+{
+#if defined(__AVX512F__)
+   const int simd_size = 64;
+#elif defined(__AVX__)
+   const int simd_size = 32;
+#elif defined(__SSE2__) || (defined(__aarch64__) && defined(__ARM_NEON))
+   const int simd_size = 16;
+#else
+   const int simd_size = 8;
+#endif
+   std::printf("%d\n", simd_size);
+   return 0;
+}
@@ -29,8 +29,23 @@
 #define MFEM_ALWAYS_INLINE
 #endif
 
+// --- MFEM_ALIGN_AS
+#if (__cplusplus >= 201103L)
+#define MFEM_ALIGN_AS(bytes) alignas(bytes)
+#elif defined(__GNUC__) || defined(__clang__)
+#define MFEM_ALIGN_AS(bytes) __attribute__ ((aligned (bytes)))
+#else
+#define MFEM_ALIGN_AS(bytes)
+#endif
+
 #define MFEM_TEMPLATE_BLOCK_SIZE 4
-#define MFEM_SIMD_SIZE 32
+
+// --- MFEM_SIMD_SIZE: the size in bytes of the SIMD registers, see AutoSIMD.
+// It is set in config.hpp when the library is configured, because it changes
+// the layout of the templated classes instantiated in the library.
+#ifndef MFEM_SIMD_SIZE
+#error "MFEM_SIMD_SIZE is not defined in config.hpp, reconfigure MFEM"
+#endif
 #define MFEM_TEMPLATE_ENABLE_SERIALIZE
 
 // #define MFEM_TEMPLATE_ELTRANS_HAS_NODE_DOFS
@@ -47,7 +62,8 @@ namespace mfem
 {
 namespace internal
 {
-long long flop_count;
+// Defined in fem/tbilinearform_kernels.cpp, which also includes this header.
+extern long long flop_count;
 }
 }
 
@@ -13,6 +13,7 @@
 
 #include "fem.hpp"
 #include <cmath>
+#include <typeinfo>
 
 namespace mfem
 {
@@ -21,13 +22,24 @@ void BilinearForm::AllocMat()
 {
    if (static_cond) { return; }
 
-   if (precompute_sparsity == 0 || fes->GetVDim() > 1)
+   if (!precompute_sparsity)
    {
       mat = new SparseMatrix(height);
       return;
    }
 
-   const Table &elem_dof = fes->GetElementToDofTable();
+   const int ndofs = fes->GetNDofs();
+   const int vdim = fes->GetVDim();
+
+   // Copy of the element-to-dof table without the dof signs
+   Table elem_dof(fes->GetElementToDofTable());
+   {
+      int *J = elem_dof.GetJ();
+      for (int k = 0; k < elem_dof.Size_of_connections(); k++)
+      {
+         if (J[k] < 0) { J[k] = -1-J[k]; }
+      }
+   }
    Table dof_dof;
 
    if (fbfi.Size() > 0)
@@ -39,27 +51,87 @@ void BilinearForm::AllocMat()
          mfem::Mult(*face_elem, elem_dof, face_dof);
          delete face_elem;
       }
-      Transpose(face_dof, dof_face, height);
+      Transpose(face_dof, dof_face, ndofs);
       mfem::Mult(dof_face, face_dof, dof_dof);
    }
    else
    {
       // the sparsity pattern is defined from the map: element->dof
       Table dof_elem;
-      Transpose(elem_dof, dof_elem, height);
+      Transpose(elem_dof, dof_elem, ndofs);
       mfem::Mult(dof_elem, elem_dof, dof_dof);
    }
 
    dof_dof.SortRows();
 
-   int *I = dof_dof.GetI();
-   int *J = dof_dof.GetJ();
-   double *data = new double[I[height]];
+   if (vdim == 1)
+   {
+      int *I = dof_dof.GetI();
+      int *J = dof_dof.GetJ();
+      double *data = new double[I[height]];
+
+      mat = new SparseMatrix(I, J, data, height, height, true, true, true);
+      *mat = 0.0;
+
+      dof_dof.LoseData();
+      return;
+   }
+
+   // Vector space: all components of coupled scalar dofs are coupled. The
+   // columns in each row are generated in increasing order.
+   const int *dI = dof_dof.GetI(), *dJ = dof_dof.GetJ();
+   const bool byvdim = (fes->GetOrdering() == Ordering::byVDIM);
+   int *I = new int[height+1];
+   for (int i = 0; i < ndofs; i++)
+   {
+      for (int vd = 0; vd < vdim; vd++)
+      {
+         I[fes->DofToVDof(i, vd)] = vdim*(dI[i+1] - dI[i]);
+      }
+   }
+   int nnz = 0;
+   for (int r = 0; r < height; r++)
+   {
+      const int row_size = I[r];
+      I[r] = nnz;
+      nnz += row_size;
+   }
+   I[height] = nnz;
+   int *J = new int[nnz];
+#ifdef MFEM_USE_OPENMP
+   #pragma omp parallel for
+#endif
+   for (int i = 0; i < ndofs; i++)
+   {
+      for (int vd = 0; vd < vdim; vd++)
+      {
+         int *row = J + I[fes->DofToVDof(i, vd)];
+         if (byvdim)
+         {
+            for (int k = dI[i]; k < dI[i+1]; k++)
+            {
+               for (int vc = 0; vc < vdim; vc++)
+               {
+                  *(row++) = fes->DofToVDof(dJ[k], vc);
+               }
+            }
+         }
+         else
+         {
+            for (int vc = 0; vc < vdim; vc++)
+            {
+               for (int k = dI[i]; k < dI[i+1]; k++)
+               {
+                  *(row++) = fes->DofToVDof(dJ[k], vc);
+               }
+            }
+         }
+      }
+   }
+   double *data = new double[nnz];
 
    mat = new SparseMatrix(I, J, data, height, height, true, true, true);
    *mat = 0.0;
-
-   dof_dof.LoseData();
 }
 
 BilinearForm::BilinearForm (FiniteElementSpace * f)
@@ -72,8 +144,15 @@ BilinearForm::BilinearForm (FiniteElementSpace * f)
    element_matrices = NULL;
    static_cond = NULL;
    hybridization = NULL;
-   precompute_sparsity = 0;
+   precompute_sparsity = 1;
+   batched_faces = 1;
+   templated_kernels = 1;
+   colored_assembly = -1;
+   int_face_maps = bdr_face_maps = NULL;
+   face_maps_sequence = -1;
    diag_policy = DIAG_KEEP;
+   assembly = AssemblyLevel::FULL;
+   ext = NULL;
 }
 
 BilinearForm::BilinearForm (FiniteElementSpace * f, BilinearForm * bf, int ps)
@@ -87,7 +166,14 @@ BilinearForm::BilinearForm (FiniteElementSpace * f, BilinearForm * bf, int ps)
    static_cond = NULL;
    hybridization = NULL;
    precompute_sparsity = ps;
+   batched_faces = 1;
+   templated_kernels = 1;
+   colored_assembly = -1;
+   int_face_maps = bdr_face_maps = NULL;
+   face_maps_sequence = -1;
    diag_policy = DIAG_KEEP;
+   assembly = AssemblyLevel::FULL;
+   ext = NULL;
 
    // Copy the pointers to the integrators
    dbfi = bf->dbfi;
@@ -103,8 +189,32 @@ BilinearForm::BilinearForm (FiniteElementSpace * f, BilinearForm * bf, int ps)
    AllocMat();
 }
 
+void BilinearForm::SetAssemblyLevel(AssemblyLevel::Type assembly_level)
+{
+   if (ext)
+   {
+      MFEM_ABORT("the assembly level has already been set!");
+   }
+   assembly = assembly_level;
+   switch (assembly)
+   {
+      case AssemblyLevel::FULL:
+         break;
+      case AssemblyLevel::PARTIAL:
+         MFEM_VERIFY(!static_cond && !hybridization,
+                     "static condensation and hybridization are not supported"
+                     " with partial assembly");
+         ext = new PABilinearFormExtension(this);
+         break;
+      default:
+         MFEM_ABORT("unknown assembly level");
+   }
+}
+
 void BilinearForm::EnableStaticCondensation()
 {
+   MFEM_VERIFY(!ext, "static condensation is not supported with the current"
+               " assembly level");
    delete static_cond;
    static_cond = new StaticCondensation(fes);
    if (static_cond->ReducesTrueVSize())
@@ -124,6 +234,8 @@ void BilinearForm::EnableHybridization(FiniteElementSpace *constr_space,
                                        BilinearFormIntegrator *constr_integ,
                                        const Array<int> &ess_tdof_list)
 {
+   MFEM_VERIFY(!ext, "hybridization is not supported with the current"
+               " assembly level");
    delete hybridization;
    hybridization = new Hybridization(fes, constr_space);
    hybridization->SetConstraintIntegrator(constr_integ);
@@ -173,6 +285,7 @@ MatrixInverse * BilinearForm::Inverse() const
 
 void BilinearForm::Finalize (int skip_zeros)
 {
+   if (ext) { return; }
    if (!static_cond) { mat->Finalize(skip_zeros); }
    if (mat_e) { mat_e->Finalize(skip_zeros); }
    if (static_cond) { static_cond->Finalize(); }
@@ -287,6 +400,29 @@ void BilinearForm::AssembleBdrElementMatrix(
    }
 }
 
+bool BilinearForm::AssembleDomainKernels(int skip_zeros)
+{
+   TBilinearFormKernels::Assembler assembler(*fes, dbfi);
+   if (!assembler.Supported()) { return false; }
+
+   // Number of element matrices computed and stored at once
+   const int batch_size = 64;
+   const int NE = fes->GetNE();
+   const int dof = fes->GetFE(0)->GetDof();
+   DenseTensor elmats(dof, dof, std::min(batch_size, NE));
+   for (int first = 0; first < NE; first += batch_size)
+   {
+      const int num = std::min(batch_size, NE - first);
+      if (num != elmats.SizeK()) { elmats.SetSize(dof, dof, num); }
+      assembler.ComputeElementMatrices(first, elmats);
+      for (int j = 0; j < num; j++)
+      {
+         AssembleElementMatrix(first + j, elmats(j), vdofs, skip_zeros);
+      }
+   }
+   return true;
+}
+
 void BilinearForm::Assemble (int skip_zeros)
 {
    ElementTransformation *eltrans;
@@ -295,21 +431,48 @@ void BilinearForm::Assemble (int skip_zeros)
 
    int i;
 
+   if (ext)
+   {
+      ext->Assemble();
+      return;
+   }
+
    if (mat == NULL)
    {
       AllocMat();
    }
 
-#ifdef MFEM_USE_OPENMP
    int free_element_matrices = 0;
-   if (!element_matrices)
+#ifdef MFEM_USE_OPENMP
+   const bool use_colors = (colored_assembly != 0);
+#else
+   const bool use_colors = (colored_assembly > 0);
+#endif
+   const bool colored = (use_colors && dbfi.Size() && !element_matrices &&
+                         !static_cond && !hybridization && mat->Finalized());
+
+   // Use the registered templated kernels, if available, unless the domain
+   // integrators are assembled by colors
+   const bool kernels = (dbfi.Size() && !element_matrices && !colored &&
+                         templated_kernels && AssembleDomainKernels(skip_zeros));
+
+#ifdef MFEM_USE_OPENMP
+   if (!element_matrices && !colored && !kernels)
    {
       ComputeElementMatrices();
       free_element_matrices = 1;
    }
 #endif
 
-   if (dbfi.Size())
+   if (kernels)
+   {
+      // Already assembled
+   }
+   else if (colored)
+   {
+      AssembleDomainColored(skip_zeros);
+   }
+   else if (dbfi.Size())
    {
       for (i = 0; i < fes -> GetNE(); i++)
       {
@@ -400,7 +563,8 @@ void BilinearForm::Assemble (int skip_zeros)
       }
    }
 
-   if (fbfi.Size())
+   if (fbfi.Size() &&
+       !AssembleFacesBatched(fbfi, NULL, FaceElementMaps::INTERIOR, skip_zeros))
    {
       FaceElementTransformations *tr;
       Array<int> vdofs2;
@@ -425,7 +589,9 @@ void BilinearForm::Assemble (int skip_zeros)
       }
    }
 
-   if (bfbfi.Size())
+   if (bfbfi.Size() &&
+       !AssembleFacesBatched(bfbfi, &bfbfi_marker, FaceElementMaps::BOUNDARY,
+                             skip_zeros))
    {
       FaceElementTransformations *tr;
       const FiniteElement *fe1, *fe2;
@@ -477,12 +643,159 @@ void BilinearForm::Assemble (int skip_zeros)
       }
    }
 
-#ifdef MFEM_USE_OPENMP
    if (free_element_matrices)
    {
       FreeElementMatrices();
    }
+}
+
+void BilinearForm::FreeFaceMaps()
+{
+   delete int_face_maps;
+   delete bdr_face_maps;
+   int_face_maps = bdr_face_maps = NULL;
+   face_maps_sequence = -1;
+}
+
+bool BilinearForm::AssembleFacesBatched(
+   const Array<BilinearFormIntegrator*> &integs,
+   const Array<Array<int>*> *markers, FaceElementMaps::FaceType type,
+   int skip_zeros)
+{
+   if (!batched_faces || !FaceElementMaps::Supports(*fes)) { return false; }
+   for (int k = 0; k < integs.Size(); k++)
+   {
+      // Exact types only: derived classes may change the face matrices
+      const BilinearFormIntegrator &integ = *integs[k];
+      if ((typeid(integ) != typeid(DGTraceIntegrator) &&
+           typeid(integ) != typeid(DGDiffusionIntegrator)) ||
+          integ.GetIntRule())
+      {
+         return false;
+      }
+   }
+
+   // The maps, and the geometric factors cached in the mesh for their rules,
+   // are kept until the mesh changes
+   if (face_maps_sequence != fes->GetMesh()->GetSequence())
+   {
+      FreeFaceMaps();
+      face_maps_sequence = fes->GetMesh()->GetSequence();
+   }
+   FaceElementMaps *&maps_ptr = (type == FaceElementMaps::INTERIOR) ?
+                                int_face_maps : bdr_face_maps;
+   if (!maps_ptr)
+   {
+      maps_ptr = new FaceElementMaps(*fes, type);
+   }
+   const FaceElementMaps &maps = *maps_ptr;
+   const int nd = maps.GetNumSides()*maps.GetNumElementDofs();
+   DenseTensor face_mats(nd, nd, maps.GetNFaces());
+   face_mats = 0.0;
+   for (int k = 0; k < integs.Size(); k++)
+   {
+      integs[k]->AssemblePAFaces(maps, markers ? (*markers)[k] : NULL);
+      integs[k]->AssembleFaceMatricesPA(face_mats);
+   }
+   Array<int> dofs;
+   for (int f = 0; f < maps.GetNFaces(); f++)
+   {
+      maps.GetFaceDofs(f, dofs);
+      mat->AddSubMatrix(dofs, dofs, face_mats(f), skip_zeros);
+   }
+   return true;
+}
+
+// Adds the element matrices of AssembleByColors() to a SparseMatrix.
+struct SparseMatrixElementAdder
+{
+   const FiniteElementSpace &fes;
+   SparseMatrix &mat;
+   const int skip_zeros;
+
+   SparseMatrixElementAdder(const FiniteElementSpace &f, SparseMatrix &m,
+                            int sz) : fes(f), mat(m), skip_zeros(sz) { }
+
+   void operator()(int i, const DenseMatrix &elmat, Array<int> &vdofs) const
+   {
+      fes.GetElementVDofs(i, vdofs);
+      mat.AddSubMatrixThreadSafe(vdofs, vdofs, elmat, skip_zeros);
+   }
+};
+
+// Adds the element matrices of AssembleByColors() to a BlockSparseMatrix.
+struct BlockSparseElementAdder
+{
+   const FiniteElementSpace &fes;
+   BlockSparseMatrix &A;
+
+   BlockSparseElementAdder(const FiniteElementSpace &f, BlockSparseMatrix &m)
+      : fes(f), A(m) { }
+
+   void operator()(int i, const DenseMatrix &elmat, Array<int> &dofs) const
+   {
+      fes.GetElementDofs(i, dofs);
+      A.AddElementMatrix(dofs, elmat);
+   }
+};
+
+// Compute the element matrices of the domain integrators @a dbfi on all
+// elements of @a fes, in groups of elements that share no dofs (see
+// FiniteElementSpace::GetElementColoring()), and pass them to @a add with the
+// element number and an array for the dofs. With OpenMP, the elements of a
+// group are processed in parallel, so @a add must be thread-safe for elements
+// with disjoint dofs.
+template <typename Adder>
+static void AssembleByColors(FiniteElementSpace &fes,
+                             const Array<BilinearFormIntegrator*> &dbfi,
+                             const Adder &add)
+{
+   if (fes.GetNE() == 0) { return; }
+
+   Array<int> colors;
+   fes.GetElementColoring(colors);
+   Table color_elem;
+   Transpose(colors, color_elem);
+   const int num_colors = color_elem.Size();
+
+#ifdef MFEM_USE_OPENMP
+   #pragma omp parallel
 #endif
+   {
+      IsoparametricTransformation eltrans;
+      DenseMatrix elmat, tmp;
+      Array<int> dofs;
+      for (int c = 0; c < num_colors; c++)
+      {
+         const int num_el = color_elem.RowSize(c);
+         const int *el_list = color_elem.GetRow(c);
+         // Elements of the same color have no common dofs, so the rows of the
+         // matrix updated by different threads are disjoint.
+#ifdef MFEM_USE_OPENMP
+         #pragma omp for schedule(dynamic, 16)
+#endif
+         for (int k = 0; k < num_el; k++)
+         {
+            const int i = el_list[k];
+            const FiniteElement &fe = *fes.GetFE(i);
+            fes.GetElementTransformation(i, &eltrans);
+            dbfi[0]->AssembleElementMatrix(fe, eltrans, elmat);
+            for (int j = 1; j < dbfi.Size(); j++)
+            {
+               dbfi[j]->AssembleElementMatrix(fe, eltrans, tmp);
+               elmat += tmp;
+            }
+            add(i, elmat, dofs);
+         }
+      }
+   }
+}
+
+void BilinearForm::AssembleDomainColored(int skip_zeros)
+{
+   MFEM_VERIFY(mat && mat->Finalized(), "the matrix must be finalized");
+   AssembleByColors(*fes, dbfi, SparseMatrixElementAdder(*fes, *mat,
+                                                         skip_zeros));
 }
 
 void BilinearForm::ConformingAssemble()
@@ -586,6 +899,23 @@ void BilinearForm::FormLinearSystem(const Array<int> &ess_tdof_list,
    }
 }
 
+void BilinearForm::FormLinearSystem(const Array<int> &ess_tdof_list,
+                                    Vector &x, Vector &b,
+                                    Operator* &A, Vector &X, Vector &B,
+                                    int copy_interior)
+{
+   if (ext)
+   {
+      Operator::FormLinearSystem(ess_tdof_list, x, b, A, X, B, copy_interior);
+   }
+   else
+   {
+      SparseMatrix *A_mat = new SparseMatrix;
+      FormLinearSystem(ess_tdof_list, x, b, *A_mat, X, B, copy_interior);
+      A = A_mat;
+   }
+}
+
 void BilinearForm::FormSystemMatrix(const Array<int> &ess_tdof_list,
                                     SparseMatrix &A)
 {
@@ -623,6 +953,120 @@ void BilinearForm::FormSystemMatrix(const Array<int> &ess_tdof_list,
    }
 }
 
+void BilinearForm::AssembleDiagonal(Vector &diag) const
+{
+   MFEM_VERIFY(!static_cond && !hybridization,
+               "static condensation and hybridization are not supported");
+   const Operator *P = GetProlongation();
+   if (!ext)
+   {
+      MFEM_VERIFY(mat, "the form is not assembled");
+      if (!P || mat->Height() == P->Width())
+      {
+         // Conforming space, or the matrix is already on the true dofs
+         mat->GetDiag(diag);
+         return;
+      }
+   }
+
+   Vector local_diag(fes->GetVSize());
+   if (ext) { ext->AssembleDiagonal(local_diag); }
+   else { mat->GetDiag(local_diag); }
+   if (P)
+   {
+      diag.SetSize(P->Width());
+      P->MultTranspose(local_diag, diag);
+   }
+   else
+   {
+      diag = local_diag;
+   }
+}
+
+void BilinearForm::FormSystemDiagonal(const Array<int> &ess_tdof_list,
+                                      Vector &diag) const
+{
+   AssembleDiagonal(diag);
+   if (ext || diag_policy == DIAG_ONE)
+   {
+      diag.SetSubVector(ess_tdof_list, 1.0);
+   }
+   else if (diag_policy == DIAG_ZERO)
+   {
+      diag.SetSubVector(ess_tdof_list, 0.0);
+   }
+}
+
+void BilinearForm::AssembleBlockSparse(BlockSparseMatrix &A)
+{
+   MFEM_VERIFY(!ext && !static_cond && !hybridization,
+               "only full assembly without static condensation or "
+               "hybridization is supported");
+   MFEM_VERIFY(fbfi.Size() == 0 && bfbfi.Size() == 0,
+               "face integrators are not supported");
+   MFEM_VERIFY(fes->GetOrdering() == Ordering::byVDIM || fes->GetVDim() == 1,
+               "the FE space must use Ordering::byVDIM");
+   MFEM_VERIFY(fes->GetConformingProlongation() == NULL,
+               "nonconforming spaces are not supported");
+
+   // The blocks couple the nodes of the same element
+   const Table &elem_dof = fes->GetElementToDofTable();
+   Table dof_elem, dof_dof;
+   Transpose(elem_dof, dof_elem, fes->GetNDofs());
+   mfem::Mult(dof_elem, elem_dof, dof_dof);
+   A.Init(dof_dof, fes->GetNDofs(), fes->GetVDim());
+
+   Mesh *mesh = fes->GetMesh();
+   if (dbfi.Size())
+   {
+      AssembleByColors(*fes, dbfi, BlockSparseElementAdder(*fes, A));
+   }
+
+   if (bbfi.Size())
+   {
+      DenseMatrix elmat, tmp;
+      Array<int> be_dofs;
+      for (int i = 0; i < fes->GetNBE(); i++)
+      {
+         const int bdr_attr = mesh->GetBdrAttribute(i);
+         const FiniteElement &be = *fes->GetBE(i);
+         ElementTransformation *eltrans = fes->GetBdrElementTransformation(i);
+         bool first = true;
+         for (int k = 0; k < bbfi.Size(); k++)
+         {
+            if (bbfi_marker[k] &&
+                (*bbfi_marker[k])[bdr_attr-1] == 0) { continue; }
+
+            bbfi[k]->AssembleElementMatrix(be, *eltrans, first ? elmat : tmp);
+            if (!first) { elmat += tmp; }
+            first = false;
+         }
+         if (first) { continue; }
+         fes->GetBdrElementDofs(i, be_dofs);
+         A.AddElementMatrix(be_dofs, elmat);
+      }
+   }
+}
+
+void BilinearForm::FormLinearSystem(const Array<int> &ess_tdof_list,
+                                    Vector &x, Vector &b,
+                                    BlockSparseMatrix &A, Vector &X, Vector &B,
+                                    int copy_interior)
+{
+   AssembleBlockSparse(A);
+   A.EliminateRowsCols(ess_tdof_list, x, b, diag_policy);
+   X.NewDataAndSize(x.GetData(), x.Size());
+   B.NewDataAndSize(b.GetData(), b.Size());
+   if (!copy_interior) { X.SetSubVectorComplement(ess_tdof_list, 0.0); }
+}
+
+void BilinearForm::FormSystemMatrix(const Array<int> &ess_tdof_list,
+                                    BlockSparseMatrix &A)
+{
+   AssembleBlockSparse(A);
+   A.EliminateRowsCols(ess_tdof_list, diag_policy);
+}
+
 void BilinearForm::RecoverFEMSolution(const Vector &X,
                                       const Vector &b, Vector &x)
 {
@@ -678,6 +1122,13 @@ void BilinearForm::ComputeElementMatrices()
       return;
    }
 
+   if (templated_kernels)
+   {
+      element_matrices =
+         TBilinearFormKernels::ComputeElementMatrices(*fes, dbfi);
+      if (element_matrices) { return; }
+   }
+
    int num_elements = fes->GetNE();
    int num_dofs_per_el = fes->GetFE(0)->GetDof() * fes->GetVDim();
 
@@ -870,6 +1321,7 @@ void BilinearForm::Update(FiniteElementSpace *nfes)
    delete mat_e;
    mat_e = NULL;
    FreeElementMatrices();
+   FreeFaceMaps();
    delete static_cond;
    static_cond = NULL;
 
@@ -888,6 +1340,8 @@ void BilinearForm::Update(FiniteElementSpace *nfes)
    }
 
    height = width = fes->GetVSize();
+
+   if (ext) { ext->Update(); }
 }
 
 void BilinearForm::SetDiagonalPolicy(DiagonalPolicy policy)
@@ -900,8 +1354,10 @@ BilinearForm::~BilinearForm()
    delete mat_e;
    delete mat;
    delete element_matrices;
+   FreeFaceMaps();
    delete static_cond;
    delete hybridization;
+   delete ext;
 
    if (!extern_bfs)
    {
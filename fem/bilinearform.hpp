@@ -20,10 +20,27 @@
 #include "bilininteg.hpp"
 #include "staticcond.hpp"
 #include "hybridization.hpp"
+#include "bilinearform_ext.hpp"
 
 namespace mfem
 {
 
+/** @brief The assembly level used by BilinearForm, see
+    BilinearForm::SetAssemblyLevel(). */
+class AssemblyLevel
+{
+public:
+   /// %Assembly levels:
+   enum Type
+   {
+      /// Fully assembled form, i.e. a global sparse matrix (default).
+      FULL,
+      /** Partially assembled form: only quadrature-point data is stored and
+          the action is computed element-by-element (matrix-free). */
+      PARTIAL
+   };
+};
+
 /** Class for bilinear form - "Matrix" with associated FE space and
     BLFIntegrators. */
 class BilinearForm : public Matrix
@@ -46,6 +63,13 @@ protected:
        #fbfi, and #bfbfi are owned by another BilinearForm. */
    int extern_bfs;
 
+   /// The assembly level of the form (full, partial, etc.)
+   AssemblyLevel::Type assembly;
+
+   /** @brief Extension for supporting the assembly levels other than
+       AssemblyLevel::FULL. Owned. */
+   BilinearFormExtension *ext;
+
    /// Set of Domain Integrators to be applied.
    Array<BilinearFormIntegrator*> dbfi;
 
@@ -76,19 +100,56 @@ protected:
    DiagonalPolicy diag_policy;
 
    int precompute_sparsity;
+   int batched_faces;
+   int templated_kernels;
+   int colored_assembly;
+
+   /// Face maps of the batched face assembly, for the mesh sequence below.
+   FaceElementMaps *int_face_maps, *bdr_face_maps;
+   long face_maps_sequence;
+
    // Allocate appropriate SparseMatrix and assign it to mat
    void AllocMat();
 
    void ConformingAssemble();
 
+   /** Assemble the domain integrators into the finalized matrix #mat, whose
+       sparsity pattern must contain all element contributions, see
+       UseColoredAssembly(). */
+   void AssembleDomainColored(int skip_zeros);
+
+   /** Assemble the domain integrators with the kernels registered in
+       TBilinearFormKernels, computing the element matrices in batches of
+       elements. Return false, without assembling, if the space or one of the
+       integrators has no registered kernel. */
+   bool AssembleDomainKernels(int skip_zeros);
+
+   /** Assemble the face integrators @a integs, interior or boundary ones
+       depending on @a type, in batches over the faces, see FaceElementMaps.
+       Return false, without assembling, if the space or one of the
+       integrators is not supported. */
+   bool AssembleFacesBatched(const Array<BilinearFormIntegrator*> &integs,
+                             const Array<Array<int>*> *markers,
+                             FaceElementMaps::FaceType type, int skip_zeros);
+
+   /// Delete the face maps of AssembleFacesBatched().
+   void FreeFaceMaps();
+
    // may be used in the construction of derived classes
    BilinearForm() : Matrix (0)
    {
       fes = NULL; sequence = -1;
       mat = mat_e = NULL; extern_bfs = 0; element_matrices = NULL;
       static_cond = NULL; hybridization = NULL;
-      precompute_sparsity = 0;
+      precompute_sparsity = 1;
+      batched_faces = 1;
+      templated_kernels = 1;
+      colored_assembly = -1;
+      int_face_maps = bdr_face_maps = NULL;
+      face_maps_sequence = -1;
       diag_policy = DIAG_KEEP;
+      assembly = AssemblyLevel::FULL;
+      ext = NULL;
    }
 
 private:
@@ -113,11 +174,30 @@ public:
 
        The optional parameter @a ps is used to initialize the internal flag
        #precompute_sparsity, see UsePrecomputedSparsity() for details. */
-   BilinearForm(FiniteElementSpace *f, BilinearForm *bf, int ps = 0);
+   BilinearForm(FiniteElementSpace *f, BilinearForm *bf, int ps = 1);
 
    /// Get the size of the BilinearForm as a square matrix.
    int Size() const { return height; }
 
+   /// Set the desired assembly level.
+   /** Valid choices are:
+
+       - AssemblyLevel::FULL (default)
+       - AssemblyLevel::PARTIAL
+
+       If used, this method must be called before assembly. With partial
+       assembly, the global SparseMatrix is not constructed: the domain
+       integrators must implement the methods
+       BilinearFormIntegrator::AssemblePA() and AddMultPA(), and the face
+       integrators the method AssemblePAFaces(); boundary integrators, static
+       condensation and hybridization are not supported. The linear system
+       can be formed with the Operator version of FormLinearSystem(), and its
+       diagonal with FormSystemDiagonal(). */
+   void SetAssemblyLevel(AssemblyLevel::Type assembly_level);
+
+   /// Return the assembly level of the form.
+   AssemblyLevel::Type GetAssemblyLevel() const { return assembly; }
+
    /** Enable the use of static condensation. For details see the description
        for class StaticCondensation in fem/staticcond.hpp This method should be
        called before assembly. If the number of unknowns after static
@@ -139,9 +219,16 @@ public:
                             BilinearFormIntegrator *constr_integ,
                             const Array<int> &ess_tdof_list);
 
-   /** For scalar FE spaces, precompute the sparsity pattern of the matrix
-       (assuming dense element matrices) based on the types of integrators
-       present in the bilinear form. */
+   /** Precompute the sparsity pattern of the matrix (assuming dense element
+       matrices) based on the types of integrators present in the bilinear
+       form. This is the default: the pattern is computed in two (threaded,
+       with OpenMP) passes over the element-to-dof connectivity and the
+       element matrices are added directly to the finalized CSR matrix, which
+       avoids the memory and time overhead of the linked-list rows of a
+       non-finalized SparseMatrix. Call this method with @a ps = 0 before
+       assembly to use the linked-list rows instead, e.g. when entries outside
+       of the element and face couplings will be added to SpMat(). The
+       threaded assembly in Assemble() requires the precomputed pattern. */
    void UsePrecomputedSparsity(int ps = 1) { precompute_sparsity = ps; }
 
    /** @brief Use the given CSR sparsity pattern to allocate the internal
@@ -158,6 +245,38 @@ public:
    /// Use the sparsity of @a A to allocate the internal SparseMatrix.
    void UseSparsity(SparseMatrix &A);
 
+   /** @brief Assemble the face integrators DGTraceIntegrator and
+       DGDiffusionIntegrator in batches over the faces (default), or face by
+       face (@a bf = 0). */
+   /** The batched assembly uses precomputed face-to-element dof maps (see
+       FaceElementMaps), kept in the form until the mesh changes, and
+       quadrature-point data computed from the element Jacobians at the face
+       points (see Mesh::GetGeometricFactors()) instead of the element
+       matrices computed with FaceElementTransformations for each face. It
+       applies to scalar L2 spaces with tensor product elements on conforming
+       meshes whose space and reference dimensions agree, with the default
+       integration rules; other cases use the face by face assembly. */
+   void UseBatchedFaceAssembly(int bf = 1) { batched_faces = bf; }
+
+   /** @brief Compute the element matrices of the domain integrators with the
+       templated kernels registered in TBilinearFormKernels (default), or with
+       the generic integrators (@a tk = 0). */
+   /** The kernels apply to MassIntegrator and DiffusionIntegrator with
+       constant coefficients and the default integration rules, on the spaces
+       and meshes of the registered combinations; other cases use the generic
+       integrators. */
+   void UseTemplatedKernels(int tk = 1) { templated_kernels = tk; }
+
+   /** @brief Assemble the domain integrators in groups of elements that share
+       no dofs (@a ca = 1), or element by element (@a ca = 0). */
+   /** The groups are the colors of FiniteElementSpace::GetElementColoring().
+       With OpenMP, the elements of a group are assembled in parallel and the
+       element matrices are added to the matrix without conflicts. The default
+       (@a ca = -1) uses the colored assembly only with OpenMP. It requires the
+       precomputed sparsity pattern, see UsePrecomputedSparsity(), and no
+       static condensation or hybridization. */
+   void UseColoredAssembly(int ca = 1) { colored_assembly = ca; }
+
    /** Pre-allocate the internal SparseMatrix before assembly. If the flag
        'precompute sparsity' is set, the matrix is allocated in CSR format (i.e.
        finalized) and the entries are initialized with zeros. */
@@ -192,26 +311,39 @@ public:
    virtual const double &Elem(int i, int j) const;
 
    /// Matrix vector multiplication.
-   virtual void Mult(const Vector &x, Vector &y) const { mat->Mult(x, y); }
+   virtual void Mult(const Vector &x, Vector &y) const
+   {
+      if (ext) { ext->Mult(x, y); }
+      else { mat->Mult(x, y); }
+   }
 
    void FullMult(const Vector &x, Vector &y) const
    { mat->Mult(x, y); mat_e->AddMult(x, y); }
 
    virtual void AddMult(const Vector &x, Vector &y, const double a = 1.0) const
-   { mat -> AddMult (x, y, a); }
+   {
+      if (ext) { ext->AddMult(x, y, a); }
+      else { mat->AddMult(x, y, a); }
+   }
 
    void FullAddMult(const Vector &x, Vector &y) const
    { mat->AddMult(x, y); mat_e->AddMult(x, y); }
 
    virtual void AddMultTranspose(const Vector & x, Vector & y,
                                  const double a = 1.0) const
-   { mat->AddMultTranspose(x, y, a); }
+   {
+      if (ext) { ext->AddMultTranspose(x, y, a); }
+      else { mat->AddMultTranspose(x, y, a); }
+   }
 
    void FullAddMultTranspose(const Vector & x, Vector & y) const
    { mat->AddMultTranspose(x, y); mat_e->AddMultTranspose(x, y); }
 
    virtual void MultTranspose(const Vector & x, Vector & y) const
-   { y = 0.0; AddMultTranspose (x, y); }
+   {
+      if (ext) { ext->MultTranspose(x, y); }
+      else { y = 0.0; AddMultTranspose (x, y); }
+   }
 
    double InnerProduct(const Vector &x, const Vector &y) const
    { return mat->InnerProduct (x, y); }
@@ -281,7 +413,18 @@ public:
       if (mat_e != NULL) { *mat_e = a; }
    }
 
-   /// Assembles the form i.e. sums over all domain/bdr integrators.
+   /** @brief Assembles the form i.e. sums over all domain/bdr integrators.
+
+       When MFEM is built with OpenMP and the matrix has a precomputed sparsity
+       pattern, the domain integrators are assembled in parallel, see
+       UsePrecomputedSparsity() and UseColoredAssembly(). In this case, the
+       domain integrators and their coefficients must be thread-safe.
+
+       The element matrices of the domain integrators are computed in batches
+       of elements with the registered templated kernels, when available for
+       the space and all domain integrators, see UseTemplatedKernels(). With
+       OpenMP, the parallel assembly above is used instead, and similarly with
+       the colored assembly. */
    void Assemble(int skip_zeros = 1);
 
    /// Get the finite element space prolongation matrix
@@ -320,9 +463,66 @@ public:
                          SparseMatrix &A, Vector &X, Vector &B,
                          int copy_interior = 0);
 
+   /** @brief Form the linear system A X = B as in the SparseMatrix version of
+       FormLinearSystem(), returning the system Operator in @a A. */
+   /** This version can be used with any assembly level. When the form is
+       partially assembled, @a A is a matrix-free ConstrainedOperator; otherwise
+       @a A is a SparseMatrix referencing the internal matrix of the form.
+
+       @note The caller is responsible for destroying the output operator
+       @a A. */
+   void FormLinearSystem(const Array<int> &ess_tdof_list, Vector &x, Vector &b,
+                         Operator* &A, Vector &X, Vector &B,
+                         int copy_interior = 0);
+
    /// Form the linear system matrix A, see FormLinearSystem() for details.
    void FormSystemMatrix(const Array<int> &ess_tdof_list, SparseMatrix &A);
 
+   /// Assemble the diagonal of the bilinear form into @a diag.
+   /** The size of @a diag is the number of true dofs, see GetProlongation().
+       With partial assembly, the diagonal is computed by the integrators
+       without forming the matrix, see
+       BilinearFormIntegrator::AssembleDiagonalPA(); with full assembly, it is
+       extracted from the finalized matrix. On non-conforming spaces, the
+       diagonal d of the local matrix is reduced to P^t d, which approximates
+       the diagonal of P^t A P, unless the matrix has already been transformed
+       by FormSystemMatrix(). Static condensation and hybridization are not
+       supported. */
+   virtual void AssembleDiagonal(Vector &diag) const;
+
+   /** @brief Compute the diagonal of the system operator formed by
+       FormLinearSystem() or FormSystemMatrix() with the same
+       @a ess_tdof_list, e.g. for Jacobi or Chebyshev smoothers. */
+   /** The essential entries are set as in the system operator: to one with
+       partial assembly (see ConstrainedOperator), and according to the
+       diagonal policy of the form otherwise, see SetDiagonalPolicy(). */
+   virtual void FormSystemDiagonal(const Array<int> &ess_tdof_list,
+                                   Vector &diag) const;
+
+   /** @brief Assemble the domain and boundary integrators directly into the
+       block sparse matrix @a A, without forming a SparseMatrix. */
+   /** The FE space must be a vector space with Ordering::byVDIM, and the
+       blocks of @a A couple all components of two nodes. With OpenMP, the
+       domain integrators are assembled in parallel using the element coloring
+       of the space. Face integrators, static condensation, hybridization and
+       nonconforming spaces are not supported. */
+   void AssembleBlockSparse(BlockSparseMatrix &A);
+
+   /** @brief Form the linear system A X = B as in the SparseMatrix version of
+       FormLinearSystem(), with the system matrix assembled in a
+       BlockSparseMatrix, see AssembleBlockSparse(). */
+   /** This method does not use the SparseMatrix of the form; the essential
+       dofs are eliminated according to the diagonal policy of the form, see
+       SetDiagonalPolicy(). @a X and @a B use the data of @a x and @a b. */
+   void FormLinearSystem(const Array<int> &ess_tdof_list, Vector &x, Vector &b,
+                         BlockSparseMatrix &A, Vector &X, Vector &B,
+                         int copy_interior = 0);
+
+   /** @brief Form the linear system matrix A in a BlockSparseMatrix, see
+       FormLinearSystem() for details. */
+   void FormSystemMatrix(const Array<int> &ess_tdof_list,
+                         BlockSparseMatrix &A);
+
    /// Recover the solution of a linear system formed with FormLinearSystem().
    /** Call this method after solving a linear system constructed using the
        FormLinearSystem() method to recover the solution as a GridFunction-size
@@ -330,7 +530,9 @@ public:
    */
    virtual void RecoverFEMSolution(const Vector &X, const Vector &b, Vector &x);
 
-   /// Compute and store internally all element matrices.
+   /** @brief Compute and store internally all element matrices, using the
+       kernels registered in TBilinearFormKernels when available, see
+       UseTemplatedKernels(). */
    void ComputeElementMatrices();
 
    /// Free the memory used by the element matrices.
@@ -0,0 +1,168 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+// Implementation of the BilinearForm extensions
+
+#include "fem.hpp"
+
+namespace mfem
+{
+
+BilinearFormExtension::BilinearFormExtension(BilinearForm *form)
+   : Operator(form->Size()), a(form)
+{
+   // empty
+}
+
+void BilinearFormExtension::AddMult(const Vector &x, Vector &y,
+                                    const double a) const
+{
+   Vector z(y.Size());
+   Mult(x, z);
+   y.Add(a, z);
+}
+
+void BilinearFormExtension::AddMultTranspose(const Vector &x, Vector &y,
+                                             const double a) const
+{
+   Vector z(y.Size());
+   MultTranspose(x, z);
+   y.Add(a, z);
+}
+
+
+PABilinearFormExtension::PABilinearFormExtension(BilinearForm *form)
+   : BilinearFormExtension(form),
+     fes(form->FESpace()), elem_restrict(NULL),
+     int_face_maps(NULL), bdr_face_maps(NULL)
+{
+   SetupRestriction();
+}
+
+void PABilinearFormExtension::SetupRestriction()
+{
+   const Mesh *mesh = fes->GetMesh();
+   MFEM_VERIFY(mesh->GetNE() == 0 ||
+               mesh->GetNumGeometries(mesh->Dimension()) == 1,
+               "partial assembly requires a mesh with a single element type");
+
+   delete elem_restrict;
+   elem_restrict = new ElementRestriction(*fes);
+   delete int_face_maps;
+   delete bdr_face_maps;
+   int_face_maps = bdr_face_maps = NULL;
+   localX.SetSize(elem_restrict->Height());
+   localY.SetSize(elem_restrict->Height());
+   height = width = fes->GetVSize();
+}
+
+void PABilinearFormExtension::Assemble()
+{
+   MFEM_VERIFY(a->GetBBFI()->Size() == 0,
+               "partial assembly does not support boundary integrators");
+
+   Array<BilinearFormIntegrator*> &integrators = *a->GetDBFI();
+   for (int i = 0; i < integrators.Size(); i++)
+   {
+      integrators[i]->AssemblePA(*fes);
+   }
+
+   Array<BilinearFormIntegrator*> &int_face_integrators = *a->GetFBFI();
+   if (int_face_integrators.Size() && !int_face_maps)
+   {
+      int_face_maps = new FaceElementMaps(*fes, FaceElementMaps::INTERIOR);
+   }
+   for (int i = 0; i < int_face_integrators.Size(); i++)
+   {
+      int_face_integrators[i]->AssemblePAFaces(*int_face_maps);
+   }
+
+   Array<BilinearFormIntegrator*> &bdr_face_integrators = *a->GetBFBFI();
+   Array<Array<int>*> &bdr_face_markers = *a->GetBFBFI_Marker();
+   if (bdr_face_integrators.Size() && !bdr_face_maps)
+   {
+      bdr_face_maps = new FaceElementMaps(*fes, FaceElementMaps::BOUNDARY);
+   }
+   for (int i = 0; i < bdr_face_integrators.Size(); i++)
+   {
+      bdr_face_integrators[i]->AssemblePAFaces(*bdr_face_maps,
+                                                bdr_face_markers[i]);
+   }
+}
+
+// Apply the transposed action, or the action, of all integrators of @a a to
+// the E-vector @a x, adding the result to @a y.
+static void AddMultIntegrators(BilinearForm *a, const Vector &x, Vector &y,
+                               bool transp)
+{
+   Array<BilinearFormIntegrator*> *integrators[3] =
+   { a->GetDBFI(), a->GetFBFI(), a->GetBFBFI() };
+   for (int k = 0; k < 3; k++)
+   {
+      for (int i = 0; i < integrators[k]->Size(); i++)
+      {
+         if (transp)
+         {
+            (*integrators[k])[i]->AddMultTransposePA(x, y);
+         }
+         else
+         {
+            (*integrators[k])[i]->AddMultPA(x, y);
+         }
+      }
+   }
+}
+
+void PABilinearFormExtension::Update()
+{
+   fes = a->FESpace();
+   SetupRestriction();
+}
+
+void PABilinearFormExtension::Mult(const Vector &x, Vector &y) const
+{
+   elem_restrict->Mult(x, localX);
+   localY = 0.0;
+   AddMultIntegrators(a, localX, localY, false);
+   elem_restrict->MultTranspose(localY, y);
+}
+
+void PABilinearFormExtension::MultTranspose(const Vector &x, Vector &y) const
+{
+   elem_restrict->Mult(x, localX);
+   localY = 0.0;
+   AddMultIntegrators(a, localX, localY, true);
+   elem_restrict->MultTranspose(localY, y);
+}
+
+void PABilinearFormExtension::AssembleDiagonal(Vector &diag) const
+{
+   Array<BilinearFormIntegrator*> *integrators[3] =
+   { a->GetDBFI(), a->GetFBFI(), a->GetBFBFI() };
+   localY = 0.0;
+   for (int k = 0; k < 3; k++)
+   {
+      for (int i = 0; i < integrators[k]->Size(); i++)
+      {
+         (*integrators[k])[i]->AssembleDiagonalPA(localY);
+      }
+   }
+   elem_restrict->MultTransposeUnsigned(localY, diag);
+}
+
+PABilinearFormExtension::~PABilinearFormExtension()
+{
+   delete elem_restrict;
+   delete int_face_maps;
+   delete bdr_face_maps;
+}
+
+}
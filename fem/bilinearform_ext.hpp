@@ -0,0 +1,97 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#ifndef MFEM_BILINEARFORM_EXT
+#define MFEM_BILINEARFORM_EXT
+
+#include "../config/config.hpp"
+#include "../linalg/operator.hpp"
+#include "restriction.hpp"
+
+namespace mfem
+{
+
+class BilinearForm;
+
+/** @brief Class extending the BilinearForm class to support assembly levels
+    other than the full assembly of a global SparseMatrix. */
+/** The extension is an Operator on the L-vectors (GridFunction-size vectors)
+    of the FiniteElementSpace of the BilinearForm. */
+class BilinearFormExtension : public Operator
+{
+protected:
+   BilinearForm *a; ///< Not owned
+
+public:
+   BilinearFormExtension(BilinearForm *form);
+
+   /// Assemble at the level given for the BilinearFormExtension subclass
+   virtual void Assemble() = 0;
+
+   /// Update the extension after the FiniteElementSpace has changed.
+   virtual void Update() = 0;
+
+   /// Compute y += a x.
+   virtual void AddMult(const Vector &x, Vector &y, const double a = 1.0) const;
+
+   /// Compute y += a A^t x.
+   virtual void AddMultTranspose(const Vector &x, Vector &y,
+                                 const double a = 1.0) const;
+
+   /// Compute the diagonal of the operator on the L-vectors in @a diag.
+   virtual void AssembleDiagonal(Vector &diag) const = 0;
+
+   virtual ~BilinearFormExtension() { }
+};
+
+/** @brief Partial assembly extension for BilinearForm.
+
+    Only quadrature-point data (geometric factors combined with the
+    coefficients) is stored by the domain integrators, see
+    BilinearFormIntegrator::AssemblePA(). The action of the form is computed
+    element-by-element by the integrators, using sum-factorization for tensor
+    product elements, between the ElementRestriction gather and scatter.
+
+    Interior and boundary face integrators are supported on the spaces of
+    FaceElementMaps, see BilinearFormIntegrator::AssemblePAFaces(). Their
+    action is computed face-by-face on the same E-vectors. */
+class PABilinearFormExtension : public BilinearFormExtension
+{
+protected:
+   const FiniteElementSpace *fes; ///< Not owned
+   ElementRestriction *elem_restrict; ///< Owned
+   FaceElementMaps *int_face_maps, *bdr_face_maps; ///< Owned
+   mutable Vector localX, localY;
+
+   void SetupRestriction();
+
+public:
+   PABilinearFormExtension(BilinearForm *form);
+
+   /// Partial assembly of all domain integrators.
+   virtual void Assemble();
+
+   virtual void Update();
+
+   virtual void Mult(const Vector &x, Vector &y) const;
+
+   virtual void MultTranspose(const Vector &x, Vector &y) const;
+
+   /** @brief Sum the diagonals computed by the integrators, see
+       BilinearFormIntegrator::AssembleDiagonalPA(). */
+   virtual void AssembleDiagonal(Vector &diag) const;
+
+   virtual ~PABilinearFormExtension();
+};
+
+}
+
+#endif
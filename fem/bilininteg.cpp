@@ -20,6 +20,31 @@ using namespace std;
 namespace mfem
 {
 
+void BilinearFormIntegrator::AssemblePA(const FiniteElementSpace &fes)
+{
+   mfem_error ("BilinearFormIntegrator::AssemblePA(...)\n"
+               "   is not implemented for this class.");
+}
+
+void BilinearFormIntegrator::AddMultPA(const Vector &x, Vector &y) const
+{
+   mfem_error ("BilinearFormIntegrator::AddMultPA(...)\n"
+               "   is not implemented for this class.");
+}
+
+void BilinearFormIntegrator::AddMultTransposePA(const Vector &x,
+                                                Vector &y) const
+{
+   mfem_error ("BilinearFormIntegrator::AddMultTransposePA(...)\n"
+               "   is not implemented for this class.");
+}
+
+void BilinearFormIntegrator::AssembleDiagonalPA(Vector &diag) const
+{
+   mfem_error ("BilinearFormIntegrator::AssembleDiagonalPA(...)\n"
+               "   is not implemented for this class.");
+}
+
 void BilinearFormIntegrator::AssembleElementMatrix (
    const FiniteElement &el, ElementTransformation &Trans,
    DenseMatrix &elmat )
@@ -373,6 +398,8 @@ void DiffusionIntegrator::AssembleElementMatrix
 
 #ifdef MFEM_THREAD_SAFE
    DenseMatrix dshape(nd,dim), dshapedxt(nd,spaceDim), invdfdx(dim,spaceDim);
+   Vector Q_ir;
+   DenseTensor MQ_ir;
 #else
    dshape.SetSize(nd,dim);
    dshapedxt.SetSize(nd,spaceDim);
@@ -380,35 +407,18 @@ void DiffusionIntegrator::AssembleElementMatrix
 #endif
    elmat.SetSize(nd);
 
-   const IntegrationRule *ir = IntRule;
-   if (ir == NULL)
-   {
-      int order;
-      if (el.Space() == FunctionSpace::Pk)
-      {
-         order = 2*el.GetOrder() - 2;
-      }
-      else
-         // order = 2*el.GetOrder() - 2;  // <-- this seems to work fine too
-      {
-         order = 2*el.GetOrder() + dim - 1;
-      }
-
-      if (el.Space() == FunctionSpace::rQk)
-      {
-         ir = &RefinedIntRules.Get(el.GetGeomType(), order);
-      }
-      else
-      {
-         ir = &IntRules.Get(el.GetGeomType(), order);
-      }
-   }
+   const IntegrationRule *ir = IntRule ? IntRule : &GetRule(el);
+   const DofToQuad *maps = el.HasElementIndependentBasis() ?
+                           &el.GetDofToQuad(*ir, DofToQuad::FULL) : NULL;
+   if (MQ) { MQ->Eval(MQ_ir, Trans, *ir); }
+   else if (Q) { Q->Eval(Q_ir, Trans, *ir); }
 
    elmat = 0.0;
    for (int i = 0; i < ir->GetNPoints(); i++)
    {
       const IntegrationPoint &ip = ir->IntPoint(i);
-      el.CalcDShape(ip, dshape);
+      if (maps) { maps->GetDShape(i, dshape); }
+      else { el.CalcDShape(ip, dshape); }
 
       Trans.SetIntPoint(&ip);
       w = Trans.Weight();
@@ -420,13 +430,13 @@ void DiffusionIntegrator::AssembleElementMatrix
       {
          if (Q)
          {
-            w *= Q->Eval(Trans, ip);
+            w *= Q_ir(i);
          }
          AddMult_a_AAt(w, dshapedxt, elmat);
       }
       else
       {
-         MQ->Eval(invdfdx, Trans, ip);
+         invdfdx = MQ_ir(i);
          invdfdx *= w;
          Mult(dshapedxt, invdfdx, dshape);
          AddMultABt(dshape, dshapedxt, elmat);
@@ -434,6 +444,26 @@ void DiffusionIntegrator::AssembleElementMatrix
    }
 }
 
+const IntegrationRule &DiffusionIntegrator::GetRule(const FiniteElement &el)
+{
+   int order;
+   if (el.Space() == FunctionSpace::Pk)
+   {
+      order = 2*el.GetOrder() - 2;
+   }
+   else
+      // order = 2*el.GetOrder() - 2;  // <-- this seems to work fine too
+   {
+      order = 2*el.GetOrder() + el.GetDim() - 1;
+   }
+
+   if (el.Space() == FunctionSpace::rQk)
+   {
+      return RefinedIntRules.Get(el.GetGeomType(), order);
+   }
+   return IntRules.Get(el.GetGeomType(), order);
+}
+
 void DiffusionIntegrator::AssembleElementMatrix2(
    const FiniteElement &trial_fe, const FiniteElement &test_fe,
    ElementTransformation &Trans, DenseMatrix &elmat)
@@ -726,44 +756,47 @@ void MassIntegrator::AssembleElementMatrix
    double w;
 
 #ifdef MFEM_THREAD_SAFE
-   Vector shape;
+   Vector shape, Q_ir;
 #endif
    elmat.SetSize(nd);
    shape.SetSize(nd);
 
-   const IntegrationRule *ir = IntRule;
-   if (ir == NULL)
-   {
-      // int order = 2 * el.GetOrder();
-      int order = 2 * el.GetOrder() + Trans.OrderW();
-
-      if (el.Space() == FunctionSpace::rQk)
-      {
-         ir = &RefinedIntRules.Get(el.GetGeomType(), order);
-      }
-      else
-      {
-         ir = &IntRules.Get(el.GetGeomType(), order);
-      }
-   }
+   const IntegrationRule *ir = IntRule ? IntRule : &GetRule(el, Trans);
+   const DofToQuad *maps = el.HasElementIndependentBasis() ?
+                           &el.GetDofToQuad(*ir, DofToQuad::FULL) : NULL;
+   if (Q) { Q->Eval(Q_ir, Trans, *ir); }
 
    elmat = 0.0;
    for (int i = 0; i < ir->GetNPoints(); i++)
    {
       const IntegrationPoint &ip = ir->IntPoint(i);
-      el.CalcShape(ip, shape);
+      if (maps) { maps->GetShape(i, shape); }
+      else { el.CalcShape(ip, shape); }
 
       Trans.SetIntPoint (&ip);
       w = Trans.Weight() * ip.weight;
       if (Q)
       {
-         w *= Q -> Eval(Trans, ip);
+         w *= Q_ir(i);
       }
 
       AddMult_a_VVt(w, shape, elmat);
    }
 }
 
+const IntegrationRule &MassIntegrator::GetRule(const FiniteElement &el,
+                                               ElementTransformation &Trans)
+{
+   // int order = 2 * el.GetOrder();
+   int order = 2 * el.GetOrder() + Trans.OrderW();
+
+   if (el.Space() == FunctionSpace::rQk)
+   {
+      return RefinedIntRules.Get(el.GetGeomType(), order);
+   }
+   return IntRules.Get(el.GetGeomType(), order);
+}
+
 void MassIntegrator::AssembleElementMatrix2(
    const FiniteElement &trial_fe, const FiniteElement &test_fe,
    ElementTransformation &Trans, DenseMatrix &elmat)
@@ -878,14 +911,25 @@ void ConvectionIntegrator::AssembleElementMatrix(
       ir = &IntRules.Get(el.GetGeomType(), order);
    }
 
+   const DofToQuad *maps = el.HasElementIndependentBasis() ?
+                           &el.GetDofToQuad(*ir, DofToQuad::FULL) : NULL;
+
    Q.Eval(Q_ir, Trans, *ir);
 
    elmat = 0.0;
    for (int i = 0; i < ir->GetNPoints(); i++)
    {
       const IntegrationPoint &ip = ir->IntPoint(i);
-      el.CalcDShape(ip, dshape);
-      el.CalcShape(ip, shape);
+      if (maps)
+      {
+         maps->GetDShape(i, dshape);
+         maps->GetShape(i, shape);
+      }
+      else
+      {
+         el.CalcDShape(ip, dshape);
+         el.CalcShape(ip, shape);
+      }
 
       Trans.SetIntPoint(&ip);
       CalcAdjugate(Trans.Jacobian(), adjJ);
@@ -991,12 +1035,15 @@ void VectorMassIntegrator::AssembleElementMatrix
          ir = &IntRules.Get(el.GetGeomType(), order);
       }
    }
+   const DofToQuad *maps = el.HasElementIndependentBasis() ?
+                           &el.GetDofToQuad(*ir, DofToQuad::FULL) : NULL;
 
    elmat = 0.0;
    for (int s = 0; s < ir->GetNPoints(); s++)
    {
       const IntegrationPoint &ip = ir->IntPoint(s);
-      el.CalcShape(ip, shape);
+      if (maps) { maps->GetShape(s, shape); }
+      else { el.CalcShape(ip, shape); }
 
       Trans.SetIntPoint (&ip);
       norm = ip.weight * Trans.Weight();
@@ -1744,6 +1791,15 @@ void VectorFEMassIntegrator::AssembleElementMatrix(
       int order = Trans.OrderW() + 2 * el.GetOrder();
       ir = &IntRules.Get(el.GetGeomType(), order);
    }
+   // Map the cached reference values as in VectorFiniteElement::CalcVShape_RT
+   // and CalcVShape_ND
+   const int map_type = el.GetMapType();
+   const DofToQuad *maps =
+      (el.HasElementIndependentBasis() &&
+       el.GetRangeType() == FiniteElement::VECTOR &&
+       (map_type == FiniteElement::H_DIV || map_type == FiniteElement::H_CURL)) ?
+      &el.GetDofToQuad(*ir, DofToQuad::FULL) : NULL;
+   DenseMatrix ref_vshape;
 
    for (int i = 0; i < ir->GetNPoints(); i++)
    {
@@ -1751,7 +1807,21 @@ void VectorFEMassIntegrator::AssembleElementMatrix(
 
       Trans.SetIntPoint (&ip);
 
-      el.CalcVShape(Trans, trial_vshape);
+      if (!maps)
+      {
+         el.CalcVShape(Trans, trial_vshape);
+      }
+      else if (map_type == FiniteElement::H_DIV)
+      {
+         maps->GetVShape(i, ref_vshape);
+         MultABt(ref_vshape, Trans.Jacobian(), trial_vshape);
+         trial_vshape *= (1.0 / Trans.Weight());
+      }
+      else
+      {
+         maps->GetVShape(i, ref_vshape);
+         Mult(ref_vshape, Trans.InverseJacobian(), trial_vshape);
+      }
 
       w = ip.weight * Trans.Weight();
       if (MQ)
@@ -2071,20 +2141,9 @@ void VectorDiffusionIntegrator::AssembleElementMatrix(
    gshape.SetSize (dof, dim);
    pelmat.SetSize (dof);
 
-   const IntegrationRule *ir = IntRule;
-   if (ir == NULL)
-   {
-      // integrand is rational function if det(J) is not constant
-      int order = 2 * Trans.OrderGrad(&el); // order of the numerator
-      if (el.Space() == FunctionSpace::rQk)
-      {
-         ir = &RefinedIntRules.Get(el.GetGeomType(), order);
-      }
-      else
-      {
-         ir = &IntRules.Get(el.GetGeomType(), order);
-      }
-   }
+   const IntegrationRule *ir = IntRule ? IntRule : &GetRule(el, Trans);
+   const DofToQuad *maps = el.HasElementIndependentBasis() ?
+                           &el.GetDofToQuad(*ir, DofToQuad::FULL) : NULL;
 
    elmat = 0.0;
 
@@ -2092,7 +2151,8 @@ void VectorDiffusionIntegrator::AssembleElementMatrix(
    {
       const IntegrationPoint &ip = ir->IntPoint(i);
 
-      el.CalcDShape (ip, dshape);
+      if (maps) { maps->GetDShape(i, dshape); }
+      else { el.CalcDShape (ip, dshape); }
 
       Trans.SetIntPoint (&ip);
       norm = ip.weight * Trans.Weight();
@@ -2120,6 +2180,18 @@ void VectorDiffusionIntegrator::AssembleElementMatrix(
    }
 }
 
+const IntegrationRule &VectorDiffusionIntegrator::GetRule(
+   const FiniteElement &el, ElementTransformation &Trans)
+{
+   // integrand is rational function if det(J) is not constant
+   int order = 2 * Trans.OrderGrad(&el); // order of the numerator
+   if (el.Space() == FunctionSpace::rQk)
+   {
+      return RefinedIntRules.Get(el.GetGeomType(), order);
+   }
+   return IntRules.Get(el.GetGeomType(), order);
+}
+
 void VectorDiffusionIntegrator::AssembleElementVector(
    const FiniteElement &el, ElementTransformation &Tr,
    const Vector &elfun, Vector &elvect)
@@ -2198,6 +2270,8 @@ void ElasticityIntegrator::AssembleElementMatrix(
       int order = 2 * Trans.OrderGrad(&el); // correct order?
       ir = &IntRules.Get(el.GetGeomType(), order);
    }
+   const DofToQuad *maps = el.HasElementIndependentBasis() ?
+                           &el.GetDofToQuad(*ir, DofToQuad::FULL) : NULL;
 
    elmat = 0.0;
 
@@ -2205,7 +2279,8 @@ void ElasticityIntegrator::AssembleElementMatrix(
    {
       const IntegrationPoint &ip = ir->IntPoint(i);
 
-      el.CalcDShape(ip, dshape);
+      if (maps) { maps->GetDShape(i, dshape); }
+      else { el.CalcDShape(ip, dshape); }
 
       Trans.SetIntPoint(&ip);
       w = ip.weight * Trans.Weight();
@@ -18,6 +18,46 @@
 namespace mfem
 {
 
+class FiniteElementSpace;
+class FaceElementMaps;
+
+/** @brief Maximum number of 1D degrees of freedom and 1D quadrature points
+    supported by the tensor product (sum-factorization) partial assembly
+    kernels. */
+const int MAX_D1D = 16;
+const int MAX_Q1D = 16;
+
+/** @brief Values of the closed and open 1D bases of a Nedelec or Raviart-Thomas
+    tensor product element at the points of a 1D quadrature rule. */
+/** Used by the sum-factorization (partial assembly) kernels of the H(curl) and
+    H(div) integrators on quadrilateral and hexahedral meshes. The matrices are
+    stored column-major, with the 1D quadrature points as rows. */
+class VectorTensorDofToQuad
+{
+public:
+   int dim;      ///< Dimension of the reference element.
+   int map_type; ///< FiniteElement::H_CURL or FiniteElement::H_DIV.
+   int ndof;     ///< Total number of dofs of the element.
+   int nc, no;   ///< Number of closed and open 1D basis functions.
+   int nqpt;     ///< Number of 1D quadrature points.
+   /// Closed basis, its derivatives and open basis: nqpt x nc, nqpt x no.
+   Array<double> Bc, Gc, Bo;
+   /** @brief Map from the component-wise lexicographic ordering of the dofs to
+       the native one, see ND_HexahedronElement::GetDofMap(). Not owned. */
+   const Array<int> *dof_map;
+
+   VectorTensorDofToQuad() : dim(0), ndof(0), nqpt(0), dof_map(NULL) { }
+
+   /** @brief Compute the 1D data of the element @a el, which must be one of
+       ND_QuadrilateralElement, ND_HexahedronElement, RT_QuadrilateralElement,
+       or RT_HexahedronElement, for the tensor product rule @a ir. */
+   void Setup(const FiniteElement &el, const IntegrationRule &ir);
+
+   /** @brief Return true if @a el is a Nedelec or Raviart-Thomas element
+       supported by Setup(). */
+   static bool IsSupported(const FiniteElement &el);
+};
+
 /// Abstract base class BilinearFormIntegrator
 class BilinearFormIntegrator : public NonlinearFormIntegrator
 {
@@ -26,6 +66,60 @@ protected:
       NonlinearFormIntegrator(ir) { }
 
 public:
+   /// Method defining partial assembly.
+   /** The result of the partial assembly is stored internally so that it can
+       be used later in the methods AddMultPA() and AddMultTransposePA(). All
+       elements of the FiniteElementSpace @a fes must be of the same type. */
+   virtual void AssemblePA(const FiniteElementSpace &fes);
+
+   /// Method for partially assembled action.
+   /** Perform the action of integrator on the input @a x and add the result to
+       the output @a y. Both @a x and @a y are E-vectors, i.e. they represent
+       the element-wise discontinuous version of the FE space, see class
+       ElementRestriction.
+
+       This method can be called only after the method AssemblePA() has been
+       called. */
+   virtual void AddMultPA(const Vector &x, Vector &y) const;
+
+   /// Method for partially assembled transposed action.
+   /** Perform the transpose action of integrator on the input @a x and add the
+       result to the output @a y. Both @a x and @a y are E-vectors.
+
+       This method can be called only after the method AssemblePA() has been
+       called. */
+   virtual void AddMultTransposePA(const Vector &x, Vector &y) const;
+
+   /// Method for the diagonal of the partially assembled operator.
+   /** Add the diagonals of the element matrices to the E-vector @a diag.
+       Since the diagonals are not affected by the sign changes of the
+       ElementRestriction, they should be summed into an L-vector without
+       them, see ElementRestriction::MultTransposeUnsigned(). Face integrators
+       add the diagonals of their face matrices.
+
+       This method can be called only after the method AssemblePA(), or
+       AssemblePAFaces() for face integrators, has been called. */
+   virtual void AssembleDiagonalPA(Vector &diag) const;
+
+   /// Method defining partial assembly on the faces described by @a maps.
+   /** Used by the face integrators, see BilinearForm::AddInteriorFaceIntegrator
+       and BilinearForm::AddBdrFaceIntegrator. The quadrature-point data of all
+       faces is stored internally, together with a reference to @a maps, which
+       must be kept alive, for use in the methods AddMultPA(),
+       AddMultTransposePA(), and AssembleFaceMatricesPA(). For BOUNDARY faces,
+       the faces with attributes not marked in @a bdr_marker (if not NULL) are
+       skipped. */
+   virtual void AssemblePAFaces(const FaceElementMaps &maps,
+                                const Array<int> *bdr_marker = NULL);
+
+   /** @brief Add the face matrices computed from the data of AssemblePAFaces()
+       to @a face_mats. */
+   /** The size of @a face_mats is (ns*dof x ns*dof x nf), where ns is the
+       number of sides of the faces, dof is the number of dofs per element and
+       nf is the number of faces of the FaceElementMaps. The dofs are ordered
+       as in FaceElementMaps::GetFaceDofs(). */
+   virtual void AssembleFaceMatricesPA(DenseTensor &face_mats) const;
+
    /// Given a particular Finite Element computes the element matrix elmat.
    virtual void AssembleElementMatrix(const FiniteElement &el,
                                       ElementTransformation &Trans,
@@ -1631,19 +1725,29 @@ private:
 #ifndef MFEM_THREAD_SAFE
    DenseMatrix dshape, dshapedxt, invdfdx, mq;
    DenseMatrix te_dshape, te_dshapedxt;
+   Vector Q_ir;
+   DenseTensor MQ_ir;
 #endif
    Coefficient *Q;
    MatrixCoefficient *MQ;
 
+   // PA extension
+   Vector pa_data;
+   const DofToQuad *maps; ///< Not owned
+   int dim, ne, nq, dofs1D, quad1D;
+
+   friend class TBilinearFormKernels;
+
 public:
    /// Construct a diffusion integrator with coefficient Q = 1
-   DiffusionIntegrator() { Q = NULL; MQ = NULL; }
+   DiffusionIntegrator() { Q = NULL; MQ = NULL; maps = NULL; }
 
    /// Construct a diffusion integrator with a scalar coefficient q
-   DiffusionIntegrator (Coefficient &q) : Q(&q) { MQ = NULL; }
+   DiffusionIntegrator (Coefficient &q) : Q(&q) { MQ = NULL; maps = NULL; }
 
    /// Construct a diffusion integrator with a matrix coefficient q
-   DiffusionIntegrator (MatrixCoefficient &q) : MQ(&q) { Q = NULL; }
+   DiffusionIntegrator (MatrixCoefficient &q) : MQ(&q)
+   { Q = NULL; maps = NULL; }
 
    /** Given a particular Finite Element
        computes the element stiffness matrix elmat. */
@@ -1670,6 +1774,18 @@ public:
    virtual double ComputeFluxEnergy(const FiniteElement &fluxelem,
                                     ElementTransformation &Trans,
                                     Vector &flux, Vector *d_energy = NULL);
+
+   virtual void AssemblePA(const FiniteElementSpace &fes);
+
+   virtual void AddMultPA(const Vector &x, Vector &y) const;
+
+   virtual void AddMultTransposePA(const Vector &x, Vector &y) const
+   { AddMultPA(x, y); }
+
+   virtual void AssembleDiagonalPA(Vector &diag) const;
+
+   /// Return the default IntegrationRule used by AssembleElementMatrix().
+   static const IntegrationRule &GetRule(const FiniteElement &el);
 };
 
 /** Class for local mass matrix assembling a(u,v) := (Q u, v) */
@@ -1677,16 +1793,23 @@ class MassIntegrator: public BilinearFormIntegrator
 {
 protected:
 #ifndef MFEM_THREAD_SAFE
-   Vector shape, te_shape;
+   Vector shape, te_shape, Q_ir;
 #endif
    Coefficient *Q;
 
+   // PA extension
+   Vector pa_data;
+   const DofToQuad *maps; ///< Not owned
+   int dim, ne, nq, dofs1D, quad1D;
+
+   friend class TBilinearFormKernels;
+
 public:
    MassIntegrator(const IntegrationRule *ir = NULL)
-      : BilinearFormIntegrator(ir) { Q = NULL; }
+      : BilinearFormIntegrator(ir) { Q = NULL; maps = NULL; }
    /// Construct a mass integrator with coefficient q
    MassIntegrator(Coefficient &q, const IntegrationRule *ir = NULL)
-      : BilinearFormIntegrator(ir), Q(&q) { }
+      : BilinearFormIntegrator(ir), Q(&q) { maps = NULL; }
 
    /** Given a particular Finite Element
        computes the element mass matrix elmat. */
@@ -1697,6 +1820,19 @@ public:
                                        const FiniteElement &test_fe,
                                        ElementTransformation &Trans,
                                        DenseMatrix &elmat);
+
+   virtual void AssemblePA(const FiniteElementSpace &fes);
+
+   virtual void AddMultPA(const Vector &x, Vector &y) const;
+
+   virtual void AddMultTransposePA(const Vector &x, Vector &y) const
+   { AddMultPA(x, y); }
+
+   virtual void AssembleDiagonalPA(Vector &diag) const;
+
+   /// Return the default IntegrationRule used by AssembleElementMatrix().
+   static const IntegrationRule &GetRule(const FiniteElement &el,
+                                         ElementTransformation &Trans);
 };
 
 class BoundaryMassIntegrator : public MassIntegrator
@@ -1764,25 +1900,32 @@ private:
 
    int Q_order;
 
+   // PA extension
+   Vector pa_data;
+   const DofToQuad *maps; ///< Not owned
+   int dim, ne;
+
 public:
    /// Construct an integrator with coefficient 1.0
    VectorMassIntegrator()
-      : vdim(-1), Q(NULL), VQ(NULL), MQ(NULL), Q_order(0) { }
+      : vdim(-1), Q(NULL), VQ(NULL), MQ(NULL), Q_order(0) { maps = NULL; }
    /** Construct an integrator with scalar coefficient q.
        If possible, save memory by using a scalar integrator since
        the resulting matrix is block diagonal with the same diagonal
        block repeated. */
    VectorMassIntegrator(Coefficient &q, int qo = 0)
-      : vdim(-1), Q(&q) { VQ = NULL; MQ = NULL; Q_order = qo; }
+      : vdim(-1), Q(&q) { VQ = NULL; MQ = NULL; Q_order = qo; maps = NULL; }
    VectorMassIntegrator(Coefficient &q, const IntegrationRule *ir)
       : BilinearFormIntegrator(ir), vdim(-1), Q(&q)
-   { VQ = NULL; MQ = NULL; Q_order = 0; }
+   { VQ = NULL; MQ = NULL; Q_order = 0; maps = NULL; }
    /// Construct an integrator with diagonal coefficient q
    VectorMassIntegrator(VectorCoefficient &q, int qo = 0)
-      : vdim(q.GetVDim()), VQ(&q) { Q = NULL; MQ = NULL; Q_order = qo; }
+      : vdim(q.GetVDim()), VQ(&q)
+   { Q = NULL; MQ = NULL; Q_order = qo; maps = NULL; }
    /// Construct an integrator with matrix coefficient q
    VectorMassIntegrator(MatrixCoefficient &q, int qo = 0)
-      : vdim(q.GetVDim()), MQ(&q) { Q = NULL; VQ = NULL; Q_order = qo; }
+      : vdim(q.GetVDim()), MQ(&q)
+   { Q = NULL; VQ = NULL; Q_order = qo; maps = NULL; }
 
    int GetVDim() const { return vdim; }
    void SetVDim(int vdim) { this->vdim = vdim; }
@@ -1794,6 +1937,17 @@ public:
                                        const FiniteElement &test_fe,
                                        ElementTransformation &Trans,
                                        DenseMatrix &elmat);
+
+   /** @brief Partial assembly, supported with scalar coefficients and vector
+       spaces with the dimension of the integrator. */
+   virtual void AssemblePA(const FiniteElementSpace &fes);
+
+   virtual void AddMultPA(const Vector &x, Vector &y) const;
+
+   virtual void AddMultTransposePA(const Vector &x, Vector &y) const
+   { AddMultPA(x, y); }
+
+   virtual void AssembleDiagonalPA(Vector &diag) const;
 };
 
 
@@ -1904,11 +2058,16 @@ private:
    Coefficient *Q;
    MatrixCoefficient *MQ;
 
+   // PA extension
+   Vector pa_data;
+   VectorTensorDofToQuad pa_maps;
+   int ne;
+
 public:
-   CurlCurlIntegrator() { Q = NULL; MQ = NULL; }
+   CurlCurlIntegrator() { Q = NULL; MQ = NULL; ne = 0; }
    /// Construct a bilinear form integrator for Nedelec elements
-   CurlCurlIntegrator(Coefficient &q) : Q(&q) { MQ = NULL; }
-   CurlCurlIntegrator(MatrixCoefficient &m) : MQ(&m) { Q = NULL; }
+   CurlCurlIntegrator(Coefficient &q) : Q(&q) { MQ = NULL; ne = 0; }
+   CurlCurlIntegrator(MatrixCoefficient &m) : MQ(&m) { Q = NULL; ne = 0; }
 
    /* Given a particular Finite Element, compute the
       element curl-curl matrix elmat */
@@ -1924,6 +2083,17 @@ public:
    virtual double ComputeFluxEnergy(const FiniteElement &fluxelem,
                                     ElementTransformation &Trans,
                                     Vector &flux, Vector *d_energy = NULL);
+
+   /** @brief Partial assembly, supported for quadrilateral and hexahedral
+       meshes with a scalar (or no) coefficient, see VectorTensorDofToQuad. */
+   virtual void AssemblePA(const FiniteElementSpace &fes);
+
+   virtual void AddMultPA(const Vector &x, Vector &y) const;
+
+   virtual void AddMultTransposePA(const Vector &x, Vector &y) const
+   { AddMultPA(x, y); }
+
+   virtual void AssembleDiagonalPA(Vector &diag) const;
 };
 
 /** Integrator for (curl u, curl v) for FE spaces defined by 'dim' copies of a
@@ -1959,7 +2129,7 @@ private:
    VectorCoefficient *VQ;
    MatrixCoefficient *MQ;
    void Init(Coefficient *q, VectorCoefficient *vq, MatrixCoefficient *mq)
-   { Q = q; VQ = vq; MQ = mq; }
+   { Q = q; VQ = vq; MQ = mq; ne = 0; }
 
 #ifndef MFEM_THREAD_SAFE
    Vector shape;
@@ -1969,6 +2139,11 @@ private:
    DenseMatrix trial_vshape;
 #endif
 
+   // PA extension
+   Vector pa_data;
+   VectorTensorDofToQuad pa_maps;
+   int ne;
+
 public:
    VectorFEMassIntegrator() { Init(NULL, NULL, NULL); }
    VectorFEMassIntegrator(Coefficient *_q) { Init(_q, NULL, NULL); }
@@ -1985,6 +2160,17 @@ public:
                                        const FiniteElement &test_fe,
                                        ElementTransformation &Trans,
                                        DenseMatrix &elmat);
+
+   /** @brief Partial assembly, supported for quadrilateral and hexahedral
+       meshes with a scalar (or no) coefficient, see VectorTensorDofToQuad. */
+   virtual void AssemblePA(const FiniteElementSpace &fes);
+
+   virtual void AddMultPA(const Vector &x, Vector &y) const;
+
+   virtual void AddMultTransposePA(const Vector &x, Vector &y) const
+   { AddMultPA(x, y); }
+
+   virtual void AssembleDiagonalPA(Vector &diag) const;
 };
 
 /** Integrator for (Q div u, p) where u=(v1,...,vn) and all vi are in the same
@@ -2021,13 +2207,29 @@ private:
    Vector divshape;
 #endif
 
+   // PA extension
+   Vector pa_data;
+   VectorTensorDofToQuad pa_maps;
+   int ne;
+
 public:
-   DivDivIntegrator() { Q = NULL; }
-   DivDivIntegrator(Coefficient &q) : Q(&q) { }
+   DivDivIntegrator() { Q = NULL; ne = 0; }
+   DivDivIntegrator(Coefficient &q) : Q(&q) { ne = 0; }
 
    virtual void AssembleElementMatrix(const FiniteElement &el,
                                       ElementTransformation &Trans,
                                       DenseMatrix &elmat);
+
+   /** @brief Partial assembly, supported for quadrilateral and hexahedral
+       meshes with a scalar (or no) coefficient, see VectorTensorDofToQuad. */
+   virtual void AssemblePA(const FiniteElementSpace &fes);
+
+   virtual void AddMultPA(const Vector &x, Vector &y) const;
+
+   virtual void AddMultTransposePA(const Vector &x, Vector &y) const
+   { AddMultPA(x, y); }
+
+   virtual void AssembleDiagonalPA(Vector &diag) const;
 };
 
 /** Integrator for
@@ -2046,9 +2248,14 @@ private:
    DenseMatrix gshape;
    DenseMatrix pelmat;
 
+   // PA extension
+   Vector pa_data;
+   const DofToQuad *maps; ///< Not owned
+   int dim, ne, nq, dofs1D, quad1D;
+
 public:
-   VectorDiffusionIntegrator() { Q = NULL; }
-   VectorDiffusionIntegrator(Coefficient &q) { Q = &q; }
+   VectorDiffusionIntegrator() { Q = NULL; maps = NULL; }
+   VectorDiffusionIntegrator(Coefficient &q) { Q = &q; maps = NULL; }
 
    virtual void AssembleElementMatrix(const FiniteElement &el,
                                       ElementTransformation &Trans,
@@ -2056,6 +2263,19 @@ public:
    virtual void AssembleElementVector(const FiniteElement &el,
                                       ElementTransformation &Tr,
                                       const Vector &elfun, Vector &elvect);
+
+   virtual void AssemblePA(const FiniteElementSpace &fes);
+
+   virtual void AddMultPA(const Vector &x, Vector &y) const;
+
+   virtual void AddMultTransposePA(const Vector &x, Vector &y) const
+   { AddMultPA(x, y); }
+
+   virtual void AssembleDiagonalPA(Vector &diag) const;
+
+   /// Return the default IntegrationRule used by AssembleElementMatrix().
+   static const IntegrationRule &GetRule(const FiniteElement &el,
+                                         ElementTransformation &Trans);
 };
 
 /** Integrator for the linear elasticity form:
@@ -2132,20 +2352,40 @@ private:
 
    Vector shape1, shape2;
 
+   // Data of the batched face assembly, see AssemblePAFaces()
+   const FaceElementMaps *face_maps;
+   int pa_nq1d, pa_nn;
+   Array<double> pa_b0, pa_g0, pa_b, pa_g;
+   Vector pa_data;
+
+   void FaceMultPA(int f, const double *X1, const double *X2,
+                   double *Y1, double *Y2, bool transp) const;
+
 public:
    /// Construct integrator with rho = 1.
    DGTraceIntegrator(VectorCoefficient &_u, double a, double b)
-   { rho = NULL; u = &_u; alpha = a; beta = b; }
+   { rho = NULL; u = &_u; alpha = a; beta = b; face_maps = NULL; }
 
    DGTraceIntegrator(Coefficient &_rho, VectorCoefficient &_u,
                      double a, double b)
-   { rho = &_rho; u = &_u; alpha = a; beta = b; }
+   { rho = &_rho; u = &_u; alpha = a; beta = b; face_maps = NULL; }
 
    using BilinearFormIntegrator::AssembleFaceMatrix;
    virtual void AssembleFaceMatrix(const FiniteElement &el1,
                                    const FiniteElement &el2,
                                    FaceElementTransformations &Trans,
                                    DenseMatrix &elmat);
+
+   virtual void AssemblePAFaces(const FaceElementMaps &maps,
+                                const Array<int> *bdr_marker = NULL);
+
+   virtual void AddMultPA(const Vector &x, Vector &y) const;
+
+   virtual void AddMultTransposePA(const Vector &x, Vector &y) const;
+
+   virtual void AssembleFaceMatricesPA(DenseTensor &face_mats) const;
+
+   virtual void AssembleDiagonalPA(Vector &diag) const;
 };
 
 /** Integrator for the DG form:
@@ -2171,18 +2411,38 @@ protected:
    Vector shape1, shape2, dshape1dn, dshape2dn, nor, nh, ni;
    DenseMatrix jmat, dshape1, dshape2, mq, adjJ;
 
+   // Data of the batched face assembly, see AssemblePAFaces()
+   const FaceElementMaps *face_maps;
+   int pa_nq1d, pa_nn;
+   Array<double> pa_b0, pa_g0, pa_b, pa_g;
+   Vector pa_data;
+
+   void FaceMultPA(int f, const double *X1, const double *X2,
+                   double *Y1, double *Y2, bool transp) const;
+
 public:
    DGDiffusionIntegrator(const double s, const double k)
-      : Q(NULL), MQ(NULL), sigma(s), kappa(k) { }
+      : Q(NULL), MQ(NULL), sigma(s), kappa(k), face_maps(NULL) { }
    DGDiffusionIntegrator(Coefficient &q, const double s, const double k)
-      : Q(&q), MQ(NULL), sigma(s), kappa(k) { }
+      : Q(&q), MQ(NULL), sigma(s), kappa(k), face_maps(NULL) { }
    DGDiffusionIntegrator(MatrixCoefficient &q, const double s, const double k)
-      : Q(NULL), MQ(&q), sigma(s), kappa(k) { }
+      : Q(NULL), MQ(&q), sigma(s), kappa(k), face_maps(NULL) { }
    using BilinearFormIntegrator::AssembleFaceMatrix;
    virtual void AssembleFaceMatrix(const FiniteElement &el1,
                                    const FiniteElement &el2,
                                    FaceElementTransformations &Trans,
                                    DenseMatrix &elmat);
+
+   virtual void AssemblePAFaces(const FaceElementMaps &maps,
+                                const Array<int> *bdr_marker = NULL);
+
+   virtual void AddMultPA(const Vector &x, Vector &y) const;
+
+   virtual void AddMultTransposePA(const Vector &x, Vector &y) const;
+
+   virtual void AssembleFaceMatricesPA(DenseTensor &face_mats) const;
+
+   virtual void AssembleDiagonalPA(Vector &diag) const;
 };
 
 /** Integrator for the DG elasticity form, for the formulations see:
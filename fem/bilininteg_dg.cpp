@@ -0,0 +1,721 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+// Batched assembly of the DG face integrators DGTraceIntegrator and
+// DGDiffusionIntegrator, see FaceElementMaps
+
+#include "fem.hpp"
+#include <cmath>
+
+namespace mfem
+{
+
+// Number of normal layers of face-frame dofs with nonzero values (b0) or
+// derivatives (g0, if not NULL) on the face.
+static int NumFaceLayers(const Array<double> &b0, const Array<double> *g0)
+{
+   int nn = 0;
+   for (int i = 0; i < b0.Size(); i++)
+   {
+      if (b0[i] != 0.0 || (g0 && (*g0)[i] != 0.0)) { nn = i+1; }
+   }
+   return nn;
+}
+
+// Evaluate the face-frame dofs X (D^dim, normal index fastest) of one side of
+// a face at the Q^(dim-1) face quadrature points: the values u and, when du is
+// not NULL, the derivatives du along the dim face-frame axes, normal axis
+// first, with layout (points x dim). Only the first nn normal layers of X are
+// used.
+static void FaceEval(const int dim, const int D, const int Q, const int nn,
+                     const double *B0, const double *G0,
+                     const double *B, const double *G,
+                     const double *X, double *u, double *du)
+{
+   const int nt = (dim == 1) ? 1 : ((dim == 2) ? D : D*D);
+   double V[MAX_D1D*MAX_D1D], Vn[MAX_D1D*MAX_D1D];
+   for (int t = 0; t < nt; t++)
+   {
+      double v = 0.0, vn = 0.0;
+      for (int i = 0; i < nn; i++)
+      {
+         v += B0[i]*X[i+D*t];
+         vn += G0[i]*X[i+D*t];
+      }
+      V[t] = v;
+      Vn[t] = vn;
+   }
+   if (dim == 1)
+   {
+      u[0] = V[0];
+      if (du) { du[0] = Vn[0]; }
+   }
+   else if (dim == 2)
+   {
+      for (int q = 0; q < Q; q++)
+      {
+         double v = 0.0, vn = 0.0, vt = 0.0;
+         for (int j = 0; j < D; j++)
+         {
+            v += B[q+Q*j]*V[j];
+            vn += B[q+Q*j]*Vn[j];
+            vt += G[q+Q*j]*V[j];
+         }
+         u[q] = v;
+         if (du)
+         {
+            du[q] = vn;
+            du[q+Q] = vt;
+         }
+      }
+   }
+   else
+   {
+      const int NQ = Q*Q;
+      double A[MAX_Q1D*MAX_D1D], An[MAX_Q1D*MAX_D1D], Ag[MAX_Q1D*MAX_D1D];
+      for (int j2 = 0; j2 < D; j2++)
+      {
+         for (int q1 = 0; q1 < Q; q1++)
+         {
+            double a = 0.0, an = 0.0, ag = 0.0;
+            for (int j1 = 0; j1 < D; j1++)
+            {
+               a += B[q1+Q*j1]*V[j1+D*j2];
+               an += B[q1+Q*j1]*Vn[j1+D*j2];
+               ag += G[q1+Q*j1]*V[j1+D*j2];
+            }
+            A[q1+Q*j2] = a;
+            An[q1+Q*j2] = an;
+            Ag[q1+Q*j2] = ag;
+         }
+      }
+      for (int q2 = 0; q2 < Q; q2++)
+      {
+         for (int q1 = 0; q1 < Q; q1++)
+         {
+            double v = 0.0, vn = 0.0, vt1 = 0.0, vt2 = 0.0;
+            for (int j2 = 0; j2 < D; j2++)
+            {
+               const double b = B[q2+Q*j2];
+               v += b*A[q1+Q*j2];
+               vn += b*An[q1+Q*j2];
+               vt1 += b*Ag[q1+Q*j2];
+               vt2 += G[q2+Q*j2]*A[q1+Q*j2];
+            }
+            const int q = q1+Q*q2;
+            u[q] = v;
+            if (du)
+            {
+               du[q] = vn;
+               du[q+NQ] = vt1;
+               du[q+2*NQ] = vt2;
+            }
+         }
+      }
+   }
+}
+
+// Transpose of FaceEval: add to the first nn normal layers of the face-frame
+// dofs Y the integrals of the test functions against u and, when du is not
+// NULL, of their face-frame derivatives against du.
+static void FaceEvalT(const int dim, const int D, const int Q, const int nn,
+                      const double *B0, const double *G0,
+                      const double *B, const double *G,
+                      const double *u, const double *du, double *Y)
+{
+   const int nt = (dim == 1) ? 1 : ((dim == 2) ? D : D*D);
+   double V[MAX_D1D*MAX_D1D], Vn[MAX_D1D*MAX_D1D];
+   if (dim == 1)
+   {
+      V[0] = u[0];
+      Vn[0] = du ? du[0] : 0.0;
+   }
+   else if (dim == 2)
+   {
+      for (int j = 0; j < D; j++)
+      {
+         double v = 0.0, vn = 0.0;
+         for (int q = 0; q < Q; q++)
+         {
+            v += B[q+Q*j]*u[q];
+            if (du)
+            {
+               v += G[q+Q*j]*du[q+Q];
+               vn += B[q+Q*j]*du[q];
+            }
+         }
+         V[j] = v;
+         Vn[j] = vn;
+      }
+   }
+   else
+   {
+      const int NQ = Q*Q;
+      double A[MAX_Q1D*MAX_D1D], An[MAX_Q1D*MAX_D1D], Ag[MAX_Q1D*MAX_D1D];
+      for (int j2 = 0; j2 < D; j2++)
+      {
+         for (int q1 = 0; q1 < Q; q1++)
+         {
+            double a = 0.0, an = 0.0, ag = 0.0;
+            for (int q2 = 0; q2 < Q; q2++)
+            {
+               const int q = q1+Q*q2;
+               const double b = B[q2+Q*j2];
+               a += b*u[q];
+               if (du)
+               {
+                  a += G[q2+Q*j2]*du[q+2*NQ];
+                  an += b*du[q];
+                  ag += b*du[q+NQ];
+               }
+            }
+            A[q1+Q*j2] = a;
+            An[q1+Q*j2] = an;
+            Ag[q1+Q*j2] = ag;
+         }
+      }
+      for (int j2 = 0; j2 < D; j2++)
+      {
+         for (int j1 = 0; j1 < D; j1++)
+         {
+            double v = 0.0, vn = 0.0;
+            for (int q1 = 0; q1 < Q; q1++)
+            {
+               v += B[q1+Q*j1]*A[q1+Q*j2] + G[q1+Q*j1]*Ag[q1+Q*j2];
+               vn += B[q1+Q*j1]*An[q1+Q*j2];
+            }
+            V[j1+D*j2] = v;
+            Vn[j1+D*j2] = vn;
+         }
+      }
+   }
+   for (int t = 0; t < nt; t++)
+   {
+      for (int i = 0; i < nn; i++)
+      {
+         Y[i+D*t] += B0[i]*V[t] + G0[i]*Vn[t];
+      }
+   }
+}
+
+// Type of the methods computing the action of an integrator on the face-frame
+// dofs of the sides of one face, see DGTraceIntegrator::FaceMultPA().
+template <class integ_t> struct FaceMultMethod
+{
+   typedef void (integ_t::*Type)(int f, const double *X1, const double *X2,
+                                 double *Y1, double *Y2, bool transp) const;
+};
+
+// Add the action of the face integrator on the E-vector x to the E-vector y.
+template <class integ_t>
+static void AddMultFaces(const integ_t &integ,
+                         typename FaceMultMethod<integ_t>::Type face_mult,
+                         const FaceElementMaps &maps, const int nn,
+                         const Vector &x, Vector &y, bool transp)
+{
+   const int dof = maps.GetNumElementDofs(), D = maps.GetD1D();
+   const int ns = maps.GetNumSides();
+   Vector X(2*dof), Y(2*dof);
+   X = 0.0;
+   for (int f = 0; f < maps.GetNFaces(); f++)
+   {
+      for (int s = 0; s < ns; s++)
+      {
+         const int *map = maps.GetDofMap(f, s);
+         for (int k = 0; k < dof; k++)
+         {
+            if (k%D < nn) { X(s*dof+k) = x(map[k]); }
+         }
+      }
+      Y = 0.0;
+      (integ.*face_mult)(f, X.GetData(), ns == 2 ? X.GetData()+dof : NULL,
+                         Y.GetData(), ns == 2 ? Y.GetData()+dof : NULL,
+                         transp);
+      for (int s = 0; s < ns; s++)
+      {
+         const int *map = maps.GetDofMap(f, s);
+         for (int k = 0; k < dof; k++)
+         {
+            if (k%D < nn) { y(map[k]) += Y(s*dof+k); }
+         }
+      }
+   }
+}
+
+// Add the face matrices of the face integrator to face_mats, column by
+// column, by applying the action to the face-frame unit vectors.
+template <class integ_t>
+static void AddFaceMatrices(const integ_t &integ,
+                            typename FaceMultMethod<integ_t>::Type face_mult,
+                            const FaceElementMaps &maps, const int nn,
+                            DenseTensor &face_mats)
+{
+   const int dof = maps.GetNumElementDofs(), D = maps.GetD1D();
+   const int ns = maps.GetNumSides(), nd = ns*dof;
+   MFEM_VERIFY(face_mats.SizeI() == nd && face_mats.SizeJ() == nd &&
+               face_mats.SizeK() == maps.GetNFaces(),
+               "invalid size of the face matrices");
+   Vector X(2*dof), Y(2*dof);
+   X = 0.0;
+   for (int f = 0; f < maps.GetNFaces(); f++)
+   {
+      DenseMatrix &M = face_mats(f);
+      for (int j = 0; j < nd; j++)
+      {
+         // Skip the dofs that vanish on the face, together with their normal
+         // derivatives.
+         if ((j%dof)%D >= nn) { continue; }
+         X(j) = 1.0;
+         Y = 0.0;
+         (integ.*face_mult)(f, X.GetData(), ns == 2 ? X.GetData()+dof : NULL,
+                            Y.GetData(), ns == 2 ? Y.GetData()+dof : NULL,
+                            false);
+         X(j) = 0.0;
+         for (int i = 0; i < nd; i++)
+         {
+            M(i,j) += Y(i);
+         }
+      }
+   }
+}
+
+// Add the diagonals of the face matrices of the face integrator to the
+// E-vector diag, see AddFaceMatrices().
+template <class integ_t>
+static void AddFaceDiagonals(const integ_t &integ,
+                             typename FaceMultMethod<integ_t>::Type face_mult,
+                             const FaceElementMaps &maps, const int nn,
+                             Vector &diag)
+{
+   const int dof = maps.GetNumElementDofs(), D = maps.GetD1D();
+   const int ns = maps.GetNumSides(), nd = ns*dof;
+   Vector X(2*dof), Y(2*dof);
+   X = 0.0;
+   for (int f = 0; f < maps.GetNFaces(); f++)
+   {
+      for (int j = 0; j < nd; j++)
+      {
+         if ((j%dof)%D >= nn) { continue; }
+         X(j) = 1.0;
+         Y = 0.0;
+         (integ.*face_mult)(f, X.GetData(), ns == 2 ? X.GetData()+dof : NULL,
+                            Y.GetData(), ns == 2 ? Y.GetData()+dof : NULL,
+                            false);
+         X(j) = 0.0;
+         diag(maps.GetDofMap(f, j/dof)[j%dof]) += Y(j);
+      }
+   }
+}
+
+
+
+void BilinearFormIntegrator::AssemblePAFaces(const FaceElementMaps &maps,
+                                             const Array<int> *bdr_marker)
+{
+   mfem_error ("BilinearFormIntegrator::AssemblePAFaces(...)\n"
+               "   is not implemented for this class.");
+}
+
+void BilinearFormIntegrator::AssembleFaceMatricesPA(
+   DenseTensor &face_mats) const
+{
+   mfem_error ("BilinearFormIntegrator::AssembleFaceMatricesPA(...)\n"
+               "   is not implemented for this class.");
+}
+
+// Return true if face f of maps is a boundary face not marked in bdr_marker.
+static bool SkipFace(const FaceElementMaps &maps, int f,
+                     const Array<int> *bdr_marker)
+{
+   if (!bdr_marker || maps.GetFaceType() != FaceElementMaps::BOUNDARY)
+   {
+      return false;
+   }
+   const Mesh *mesh = maps.GetFESpace().GetMesh();
+   const int attr = mesh->GetBdrAttribute(maps.GetFace(f));
+   return (*bdr_marker)[attr-1] == 0;
+}
+
+// Return the 1D rule of the faces of maps for the face integration order.
+static const IntegrationRule &GetFaceRule1D(const FaceElementMaps &maps,
+                                            int order)
+{
+   return IntRules.Get((maps.GetDim() == 1) ? Geometry::POINT :
+                       Geometry::SEGMENT, order);
+}
+
+// The Jacobian Jq of element e at the point p of the geometric factors geom.
+static void GetJacobian(const GeometricFactors &geom, int p, int e,
+                        DenseMatrix &Jq)
+{
+   const int NQ = geom.IntRule->GetNPoints();
+   const int sdim = Jq.Height(), dim = Jq.Width();
+   for (int k = 0; k < dim; k++)
+   {
+      for (int c = 0; c < sdim; c++)
+      {
+         Jq(c,k) = geom.J(p+NQ*(c+sdim*(k+dim*e)));
+      }
+   }
+}
+
+// The scaled outward normal of the side s of face f of maps, with the adjugate
+// adjJ of the Jacobian of the element at the face point: by Nanson's formula,
+// adj(J)^t applied to the outward reference normal.
+static void GetFaceNormal(const FaceElementMaps &maps, int f, int s,
+                          const DenseMatrix &adjJ, Vector &nor)
+{
+   const int rf = maps.GetReferenceFace(f, s), k = rf/2;
+   const double sign = (rf%2) ? 1.0 : -1.0;
+   for (int c = 0; c < nor.Size(); c++)
+   {
+      nor(c) = sign*adjJ(k,c);
+   }
+}
+
+// Prepare the transformation T of element e at the point ip, for the
+// evaluation of coefficients, reusing T if it already describes element e.
+static void SetElementPoint(Mesh &mesh, int e, const IntegrationPoint &ip,
+                            IsoparametricTransformation &T)
+{
+   if (T.ElementNo != e) { mesh.GetElementTransformation(e, &T); }
+   T.SetIntPoint(&ip);
+}
+
+void DGTraceIntegrator::AssemblePAFaces(const FaceElementMaps &maps,
+                                        const Array<int> *bdr_marker)
+{
+   MFEM_VERIFY(IntRule == NULL, "custom integration rules are not supported");
+   face_maps = &maps;
+   const int nf = maps.GetNFaces();
+   if (nf == 0) { return; }
+
+   const int dim = maps.GetDim();
+   const FiniteElement &el = *maps.GetFESpace().GetFE(0);
+   Mesh &mesh = *maps.GetFESpace().GetMesh();
+   const bool interior = (maps.GetFaceType() == FaceElementMaps::INTERIOR);
+   // Same order as in AssembleFaceMatrix(), assuming order(u)==order(mesh),
+   // where all elements have the same transformation order
+   const int order = mesh.GetElementTransformation(0)->OrderW() +
+                     2*el.GetOrder();
+   const IntegrationRule &ir1d = GetFaceRule1D(maps, order);
+   maps.GetBasis(ir1d, pa_b0, pa_g0, pa_b, pa_g);
+   pa_nq1d = ir1d.GetNPoints();
+   pa_nn = NumFaceLayers(pa_b0, NULL);
+   const int Q1D = pa_nq1d;
+   const int nq = (dim == 1) ? 1 : ((dim == 2) ? Q1D : Q1D*Q1D);
+   MFEM_VERIFY(maps.GetD1D() <= MAX_D1D && pa_nq1d <= MAX_Q1D,
+               "order too high for the batched face kernels");
+
+   // The Jacobians of the elements at the points of all faces
+   const GeometricFactors &geom = *maps.GetGeometricFactors(ir1d);
+   const IntegrationRule &eir = *geom.IntRule;
+   IsoparametricTransformation T1, T2;
+   DenseMatrix Jq(dim), adjJ(dim);
+   Vector vu(dim), nor(dim);
+   pa_data.SetSize(2*nq*nf);
+   pa_data = 0.0;
+   for (int f = 0; f < nf; f++)
+   {
+      if (SkipFace(maps, f, bdr_marker)) { continue; }
+      const int e1 = maps.GetElement(f, 0), e2 = maps.GetElement(f, 1);
+      double *w = pa_data.GetData() + 2*nq*f;
+      for (int p = 0; p < nq; p++)
+      {
+         const int p1 = maps.GetElementFacePoint(f, 0, Q1D, p);
+         const IntegrationPoint &eip1 = eir.IntPoint(p1);
+         GetJacobian(geom, p1, e1, Jq);
+         CalcAdjugate(Jq, adjJ);
+         GetFaceNormal(maps, f, 0, adjJ, nor);
+
+         SetElementPoint(mesh, e1, eip1, T1);
+         u->Eval(vu, T1, eip1);
+
+         const double un = vu * nor;
+         double a = 0.5 * alpha * un;
+         double b = beta * fabs(un);
+         if (rho)
+         {
+            double rho_p;
+            if (un >= 0.0 && interior)
+            {
+               const IntegrationPoint &eip2 =
+                  eir.IntPoint(maps.GetElementFacePoint(f, 1, Q1D, p));
+               SetElementPoint(mesh, e2, eip2, T2);
+               rho_p = rho->Eval(T2, eip2);
+            }
+            else
+            {
+               rho_p = rho->Eval(T1, eip1);
+            }
+            a *= rho_p;
+            b *= rho_p;
+         }
+         // The weights of the element points are the face weights
+         w[p] = eip1.weight * (a+b);
+         w[p+nq] = interior ? eip1.weight * (b-a) : 0.0;
+      }
+   }
+}
+
+void DGTraceIntegrator::FaceMultPA(int f, const double *X1, const double *X2,
+                                   double *Y1, double *Y2, bool transp) const
+{
+   const int dim = face_maps->GetDim(), D = face_maps->GetD1D();
+   const int Q = pa_nq1d, nq = (dim == 1) ? 1 : ((dim == 2) ? Q : Q*Q);
+   const double *B0 = pa_b0.GetData(), *G0 = pa_g0.GetData();
+   const double *B = pa_b.GetData(), *G = pa_g.GetData();
+   const double *w = pa_data.GetData() + 2*nq*f;
+   double u1[MAX_Q1D*MAX_Q1D], u2[MAX_Q1D*MAX_Q1D];
+   FaceEval(dim, D, Q, pa_nn, B0, G0, B, G, X1, u1, NULL);
+   if (X2)
+   {
+      FaceEval(dim, D, Q, pa_nn, B0, G0, B, G, X2, u2, NULL);
+   }
+   else
+   {
+      for (int q = 0; q < nq; q++) { u2[q] = 0.0; }
+   }
+   // Face matrix: [ w1 s1 s1^t, -w2 s1 s2^t ; -w1 s2 s1^t, w2 s2 s2^t ]
+   for (int q = 0; q < nq; q++)
+   {
+      if (!transp)
+      {
+         const double F = w[q]*u1[q] - w[q+nq]*u2[q];
+         u1[q] = F;
+         u2[q] = -F;
+      }
+      else
+      {
+         const double J = u1[q] - u2[q];
+         u1[q] = w[q]*J;
+         u2[q] = -w[q+nq]*J;
+      }
+   }
+   FaceEvalT(dim, D, Q, pa_nn, B0, G0, B, G, u1, NULL, Y1);
+   if (Y2)
+   {
+      FaceEvalT(dim, D, Q, pa_nn, B0, G0, B, G, u2, NULL, Y2);
+   }
+}
+
+void DGTraceIntegrator::AddMultPA(const Vector &x, Vector &y) const
+{
+   MFEM_VERIFY(face_maps, "AssemblePAFaces() has not been called");
+   AddMultFaces(*this, &DGTraceIntegrator::FaceMultPA, *face_maps, pa_nn,
+                x, y, false);
+}
+
+void DGTraceIntegrator::AddMultTransposePA(const Vector &x, Vector &y) const
+{
+   MFEM_VERIFY(face_maps, "AssemblePAFaces() has not been called");
+   AddMultFaces(*this, &DGTraceIntegrator::FaceMultPA, *face_maps, pa_nn,
+                x, y, true);
+}
+
+void DGTraceIntegrator::AssembleFaceMatricesPA(DenseTensor &face_mats) const
+{
+   MFEM_VERIFY(face_maps, "AssemblePAFaces() has not been called");
+   AddFaceMatrices(*this, &DGTraceIntegrator::FaceMultPA, *face_maps, pa_nn,
+                   face_mats);
+}
+
+void DGTraceIntegrator::AssembleDiagonalPA(Vector &diag) const
+{
+   MFEM_VERIFY(face_maps, "AssemblePAFaces() has not been called");
+   AddFaceDiagonals(*this, &DGTraceIntegrator::FaceMultPA, *face_maps, pa_nn,
+                    diag);
+}
+
+
+void DGDiffusionIntegrator::AssemblePAFaces(const FaceElementMaps &maps,
+                                            const Array<int> *bdr_marker)
+{
+   MFEM_VERIFY(IntRule == NULL, "custom integration rules are not supported");
+   face_maps = &maps;
+   const int nf = maps.GetNFaces();
+   if (nf == 0) { return; }
+
+   const int dim = maps.GetDim();
+   const FiniteElement &el = *maps.GetFESpace().GetFE(0);
+   Mesh &mesh = *maps.GetFESpace().GetMesh();
+   const bool interior = (maps.GetFaceType() == FaceElementMaps::INTERIOR);
+   // Same order as in AssembleFaceMatrix()
+   const int order = 2*el.GetOrder();
+   const IntegrationRule &ir1d = GetFaceRule1D(maps, order);
+   maps.GetBasis(ir1d, pa_b0, pa_g0, pa_b, pa_g);
+   pa_nq1d = ir1d.GetNPoints();
+   pa_nn = NumFaceLayers(pa_b0, &pa_g0);
+   const int Q1D = pa_nq1d;
+   const int nq = (dim == 1) ? 1 : ((dim == 2) ? Q1D : Q1D*Q1D);
+   MFEM_VERIFY(maps.GetD1D() <= MAX_D1D && pa_nq1d <= MAX_Q1D,
+               "order too high for the batched face kernels");
+
+   // The Jacobians of the elements at the points of all faces
+   const GeometricFactors &geom = *maps.GetGeometricFactors(ir1d);
+   const IntegrationRule &eir = *geom.IntRule;
+   const int NQ = eir.GetNPoints();
+   IsoparametricTransformation T[2];
+   DenseMatrix Jq(dim);
+
+   // Per point: the face-frame vectors h1 and h2 such that the normal fluxes
+   // are h_s.grad(u_s), with the grad in the face frame, and kappa {h^{-1} Q}.
+   const int nd = 2*dim+1;
+   nor.SetSize(dim);
+   nh.SetSize(dim);
+   ni.SetSize(dim);
+   adjJ.SetSize(dim);
+   if (MQ)
+   {
+      mq.SetSize(dim);
+   }
+   pa_data.SetSize(nd*nq*nf);
+   pa_data = 0.0;
+   for (int f = 0; f < nf; f++)
+   {
+      if (SkipFace(maps, f, bdr_marker)) { continue; }
+      double *d = pa_data.GetData() + nd*nq*f;
+      for (int p = 0; p < nq; p++)
+      {
+         double wq = 0.0;
+         for (int s = 0; s < (interior ? 2 : 1); s++)
+         {
+            const int e = maps.GetElement(f, s);
+            const int ps = maps.GetElementFacePoint(f, s, Q1D, p);
+            const IntegrationPoint &eip = eir.IntPoint(ps);
+            GetJacobian(geom, ps, e, Jq);
+            CalcAdjugate(Jq, adjJ);
+            if (s == 0)
+            {
+               GetFaceNormal(maps, f, 0, adjJ, nor);
+            }
+            // The weights of the element points are the face weights
+            double w = eip.weight/geom.detJ(ps+NQ*e);
+            if (interior)
+            {
+               w /= 2;
+            }
+            if (!MQ)
+            {
+               if (Q)
+               {
+                  SetElementPoint(mesh, e, eip, T[s]);
+                  w *= Q->Eval(T[s], eip);
+               }
+               ni.Set(w, nor);
+            }
+            else
+            {
+               nh.Set(w, nor);
+               SetElementPoint(mesh, e, eip, T[s]);
+               MQ->Eval(mq, T[s], eip);
+               mq.MultTranspose(nh, ni);
+            }
+            adjJ.Mult(ni, nh);
+            wq += ni * nor;
+
+            double hf[3];
+            maps.ToFaceFrame(f, s, nh.GetData(), hf);
+            for (int a = 0; a < dim; a++)
+            {
+               d[p+nq*(a+dim*s)] = hf[a];
+            }
+         }
+         d[p+nq*2*dim] = kappa*wq;
+      }
+   }
+}
+
+void DGDiffusionIntegrator::FaceMultPA(int f, const double *X1,
+                                       const double *X2, double *Y1,
+                                       double *Y2, bool transp) const
+{
+   const int dim = face_maps->GetDim(), D = face_maps->GetD1D();
+   const int Q = pa_nq1d, nq = (dim == 1) ? 1 : ((dim == 2) ? Q : Q*Q);
+   const double *B0 = pa_b0.GetData(), *G0 = pa_g0.GetData();
+   const double *B = pa_b.GetData(), *G = pa_g.GetData();
+   const int nd = 2*dim+1;
+   const double *d = pa_data.GetData() + nd*nq*f;
+   const double *h[2] = { d, d + nq*dim };
+   const double *kw = d + nq*2*dim;
+   const int ns = X2 ? 2 : 1;
+   double u[2][MAX_Q1D*MAX_Q1D], du[2][3*MAX_Q1D*MAX_Q1D];
+   FaceEval(dim, D, Q, pa_nn, B0, G0, B, G, X1, u[0], du[0]);
+   if (X2)
+   {
+      FaceEval(dim, D, Q, pa_nn, B0, G0, B, G, X2, u[1], du[1]);
+   }
+   // With the jump [u] = u1 - u2 and the flux F = {(Q grad(u)).n}, the face
+   // matrix is -A + sigma A^t + kappa J, see AssembleFaceMatrix(), where A
+   // maps u to the flux tested with [v] and J maps [u] to [u] tested with [v].
+   const double cA = transp ? sigma : -1.0, cAt = transp ? -1.0 : sigma;
+   for (int q = 0; q < nq; q++)
+   {
+      double F = 0.0, J = u[0][q];
+      for (int s = 0; s < ns; s++)
+      {
+         for (int a = 0; a < dim; a++)
+         {
+            F += h[s][q+nq*a]*du[s][q+nq*a];
+         }
+      }
+      if (ns == 2)
+      {
+         J -= u[1][q];
+      }
+      const double r = cA*F + kw[q]*J;
+      for (int s = 0; s < ns; s++)
+      {
+         u[s][q] = (s == 0) ? r : -r;
+         for (int a = 0; a < dim; a++)
+         {
+            du[s][q+nq*a] = cAt*J*h[s][q+nq*a];
+         }
+      }
+   }
+   FaceEvalT(dim, D, Q, pa_nn, B0, G0, B, G, u[0], du[0], Y1);
+   if (Y2)
+   {
+      FaceEvalT(dim, D, Q, pa_nn, B0, G0, B, G, u[1], du[1], Y2);
+   }
+}
+
+void DGDiffusionIntegrator::AddMultPA(const Vector &x, Vector &y) const
+{
+   MFEM_VERIFY(face_maps, "AssemblePAFaces() has not been called");
+   AddMultFaces(*this, &DGDiffusionIntegrator::FaceMultPA, *face_maps,
+                pa_nn, x, y, false);
+}
+
+void DGDiffusionIntegrator::AddMultTransposePA(const Vector &x,
+                                               Vector &y) const
+{
+   MFEM_VERIFY(face_maps, "AssemblePAFaces() has not been called");
+   AddMultFaces(*this, &DGDiffusionIntegrator::FaceMultPA, *face_maps,
+                pa_nn, x, y, true);
+}
+
+void DGDiffusionIntegrator::AssembleFaceMatricesPA(
+   DenseTensor &face_mats) const
+{
+   MFEM_VERIFY(face_maps, "AssemblePAFaces() has not been called");
+   AddFaceMatrices(*this, &DGDiffusionIntegrator::FaceMultPA, *face_maps,
+                   pa_nn, face_mats);
+}
+
+void DGDiffusionIntegrator::AssembleDiagonalPA(Vector &diag) const
+{
+   MFEM_VERIFY(face_maps, "AssemblePAFaces() has not been called");
+   AddFaceDiagonals(*this, &DGDiffusionIntegrator::FaceMultPA, *face_maps,
+                    pa_nn, diag);
+}
+
+}
@@ -0,0 +1,776 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+// Partial assembly of DiffusionIntegrator and VectorDiffusionIntegrator
+
+#include "fem.hpp"
+
+namespace mfem
+{
+
+// Compute the symmetric quadrature-point data of the diffusion operator,
+//    D = w_q coeff adj(J) adj(J)^t / det(J),
+// stored as the upper triangular part of D (3 entries in 2D, 6 in 3D), for all
+// elements of the space.
+static void PADiffusionSetup(const FiniteElementSpace &fes,
+                             const IntegrationRule &ir, Coefficient *Q,
+                             Vector &op)
+{
+   Mesh *mesh = fes.GetMesh();
+   const int NE = fes.GetNE();
+   const int NQ = ir.GetNPoints();
+   const int dim = mesh->Dimension();
+   const int symmDims = (dim*(dim+1))/2;
+   MFEM_VERIFY(mesh->SpaceDimension() == dim,
+               "surface meshes are not supported");
+
+   const GeometricFactors *geom =
+      mesh->GetGeometricFactors(ir, GeometricFactors::JACOBIANS |
+                                GeometricFactors::DETERMINANTS);
+   ConstantCoefficient *cQ = dynamic_cast<ConstantCoefficient*>(Q);
+   DenseMatrix J(dim), adj(dim);
+   Vector Q_ir(NQ);
+   Q_ir = cQ ? cQ->constant : 1.0;
+   op.SetSize(symmDims*NQ*NE);
+   for (int e = 0; e < NE; e++)
+   {
+      // Only needed to evaluate a non-constant coefficient
+      if (Q && !cQ) { Q->Eval(Q_ir, *mesh->GetElementTransformation(e), ir); }
+      for (int q = 0; q < NQ; q++)
+      {
+         const IntegrationPoint &ip = ir.IntPoint(q);
+         const double *Jq = geom->J.GetData() + q + NQ*dim*dim*e;
+         for (int j = 0; j < dim; j++)
+         {
+            for (int i = 0; i < dim; i++)
+            {
+               J(i,j) = Jq[NQ*(i+dim*j)];
+            }
+         }
+         CalcAdjugate(J, adj);
+         const double w = Q_ir(q) * ip.weight / geom->detJ(q+NQ*e);
+         double *D = op.GetData() + symmDims*(q+NQ*e);
+         for (int i = 0, k = 0; i < dim; i++)
+         {
+            for (int j = i; j < dim; j++, k++)
+            {
+               double s = 0.0;
+               for (int l = 0; l < dim; l++)
+               {
+                  s += adj(i,l)*adj(j,l);
+               }
+               D[k] = w*s;
+            }
+         }
+      }
+   }
+}
+
+// PA Diffusion Apply kernel, non-tensor elements. The input and output have
+// layout (ND, VDIM, NE) and the components are treated independently.
+static void PADiffusionApply(const int dim, const int NE, const int VDIM,
+                             const Array<double> &g, const Array<double> &gt,
+                             const Vector &op, const Vector &x, Vector &y,
+                             const int ND, const int NQ)
+{
+   const int symmDims = (dim*(dim+1))/2;
+   const double *G = g.GetData();
+   const double *Gt = gt.GetData();
+   const double *D = op.GetData();
+   const double *X = x.GetData();
+   double *Y = y.GetData();
+   Vector grad(NQ*dim), dgrad(NQ*dim);
+   for (int e = 0; e < NE; e++)
+   {
+      for (int c = 0; c < VDIM; c++)
+      {
+         const double *Xe = X + ND*(c+VDIM*e);
+         double *Ye = Y + ND*(c+VDIM*e);
+         grad = 0.0;
+         for (int d = 0; d < ND; d++)
+         {
+            const double s = Xe[d];
+            for (int i = 0; i < NQ*dim; i++)
+            {
+               grad(i) += G[i+NQ*dim*d]*s;
+            }
+         }
+         for (int q = 0; q < NQ; q++)
+         {
+            const double *Dq = D + symmDims*(q+NQ*e);
+            for (int i = 0; i < dim; i++)
+            {
+               double s = 0.0;
+               for (int j = 0; j < dim; j++)
+               {
+                  // index of (i,j) in the packed upper triangular storage
+                  const int ii = i < j ? i : j, jj = i < j ? j : i;
+                  s += Dq[ii*dim - (ii*(ii-1))/2 + jj - ii]*grad(q+NQ*j);
+               }
+               dgrad(q+NQ*i) = s;
+            }
+         }
+         for (int d = 0; d < ND; d++)
+         {
+            double s = 0.0;
+            for (int i = 0; i < NQ*dim; i++)
+            {
+               s += Gt[d+ND*i]*dgrad(i);
+            }
+            Ye[d] += s;
+         }
+      }
+   }
+}
+
+// PA Diffusion Apply 2D kernel
+static void PADiffusionApply2D(const int NE, const int VDIM,
+                               const Array<double> &b, const Array<double> &g,
+                               const Array<double> &bt,
+                               const Array<double> &gt,
+                               const Vector &op, const Vector &x, Vector &y,
+                               const int D1D, const int Q1D)
+{
+   const double *B = b.GetData();
+   const double *G = g.GetData();
+   const double *Bt = bt.GetData();
+   const double *Gt = gt.GetData();
+   const double *D = op.GetData();
+   const double *X = x.GetData();
+   double *Y = y.GetData();
+#ifdef MFEM_USE_OPENMP
+   #pragma omp parallel for
+#endif
+   for (int ec = 0; ec < NE*VDIM; ec++)
+   {
+      const int e = ec/VDIM;
+      const double *Xe = X + D1D*D1D*ec;
+      double *Ye = Y + D1D*D1D*ec;
+      const double *De = D + 3*Q1D*Q1D*e;
+      double grad[MAX_Q1D][MAX_Q1D][2];
+      for (int qy = 0; qy < Q1D; ++qy)
+      {
+         for (int qx = 0; qx < Q1D; ++qx)
+         {
+            grad[qy][qx][0] = 0.0;
+            grad[qy][qx][1] = 0.0;
+         }
+      }
+      for (int dy = 0; dy < D1D; ++dy)
+      {
+         double gradX[MAX_Q1D][2];
+         for (int qx = 0; qx < Q1D; ++qx)
+         {
+            gradX[qx][0] = 0.0;
+            gradX[qx][1] = 0.0;
+         }
+         for (int dx = 0; dx < D1D; ++dx)
+         {
+            const double s = Xe[dx+D1D*dy];
+            for (int qx = 0; qx < Q1D; ++qx)
+            {
+               gradX[qx][0] += s*B[qx+Q1D*dx];
+               gradX[qx][1] += s*G[qx+Q1D*dx];
+            }
+         }
+         for (int qy = 0; qy < Q1D; ++qy)
+         {
+            const double wy  = B[qy+Q1D*dy];
+            const double wDy = G[qy+Q1D*dy];
+            for (int qx = 0; qx < Q1D; ++qx)
+            {
+               grad[qy][qx][0] += gradX[qx][1]*wy;
+               grad[qy][qx][1] += gradX[qx][0]*wDy;
+            }
+         }
+      }
+      // Calculate Dxy, xDy in plane
+      for (int qy = 0; qy < Q1D; ++qy)
+      {
+         for (int qx = 0; qx < Q1D; ++qx)
+         {
+            const double *Dq = De + 3*(qx+Q1D*qy);
+            const double O11 = Dq[0];
+            const double O12 = Dq[1];
+            const double O22 = Dq[2];
+            const double gradX = grad[qy][qx][0];
+            const double gradY = grad[qy][qx][1];
+            grad[qy][qx][0] = (O11 * gradX) + (O12 * gradY);
+            grad[qy][qx][1] = (O12 * gradX) + (O22 * gradY);
+         }
+      }
+      for (int qy = 0; qy < Q1D; ++qy)
+      {
+         double gradX[MAX_D1D][2];
+         for (int dx = 0; dx < D1D; ++dx)
+         {
+            gradX[dx][0] = 0.0;
+            gradX[dx][1] = 0.0;
+         }
+         for (int qx = 0; qx < Q1D; ++qx)
+         {
+            const double gX = grad[qy][qx][0];
+            const double gY = grad[qy][qx][1];
+            for (int dx = 0; dx < D1D; ++dx)
+            {
+               const double wx  = Bt[dx+D1D*qx];
+               const double wDx = Gt[dx+D1D*qx];
+               gradX[dx][0] += gX*wDx;
+               gradX[dx][1] += gY*wx;
+            }
+         }
+         for (int dy = 0; dy < D1D; ++dy)
+         {
+            const double wy  = Bt[dy+D1D*qy];
+            const double wDy = Gt[dy+D1D*qy];
+            for (int dx = 0; dx < D1D; ++dx)
+            {
+               Ye[dx+D1D*dy] += ((gradX[dx][0] * wy) + (gradX[dx][1] * wDy));
+            }
+         }
+      }
+   }
+}
+
+// PA Diffusion Apply 3D kernel
+static void PADiffusionApply3D(const int NE, const int VDIM,
+                               const Array<double> &b, const Array<double> &g,
+                               const Array<double> &bt,
+                               const Array<double> &gt,
+                               const Vector &op, const Vector &x, Vector &y,
+                               const int D1D, const int Q1D)
+{
+   const double *B = b.GetData();
+   const double *G = g.GetData();
+   const double *Bt = bt.GetData();
+   const double *Gt = gt.GetData();
+   const double *D = op.GetData();
+   const double *X = x.GetData();
+   double *Y = y.GetData();
+#ifdef MFEM_USE_OPENMP
+   #pragma omp parallel for
+#endif
+   for (int ec = 0; ec < NE*VDIM; ec++)
+   {
+      const int e = ec/VDIM;
+      const double *Xe = X + D1D*D1D*D1D*ec;
+      double *Ye = Y + D1D*D1D*D1D*ec;
+      const double *De = D + 6*Q1D*Q1D*Q1D*e;
+      double grad[MAX_Q1D][MAX_Q1D][MAX_Q1D][3];
+      for (int qz = 0; qz < Q1D; ++qz)
+      {
+         for (int qy = 0; qy < Q1D; ++qy)
+         {
+            for (int qx = 0; qx < Q1D; ++qx)
+            {
+               grad[qz][qy][qx][0] = 0.0;
+               grad[qz][qy][qx][1] = 0.0;
+               grad[qz][qy][qx][2] = 0.0;
+            }
+         }
+      }
+      for (int dz = 0; dz < D1D; ++dz)
+      {
+         double gradXY[MAX_Q1D][MAX_Q1D][3];
+         for (int qy = 0; qy < Q1D; ++qy)
+         {
+            for (int qx = 0; qx < Q1D; ++qx)
+            {
+               gradXY[qy][qx][0] = 0.0;
+               gradXY[qy][qx][1] = 0.0;
+               gradXY[qy][qx][2] = 0.0;
+            }
+         }
+         for (int dy = 0; dy < D1D; ++dy)
+         {
+            double gradX[MAX_Q1D][2];
+            for (int qx = 0; qx < Q1D; ++qx)
+            {
+               gradX[qx][0] = 0.0;
+               gradX[qx][1] = 0.0;
+            }
+            for (int dx = 0; dx < D1D; ++dx)
+            {
+               const double s = Xe[dx+D1D*(dy+D1D*dz)];
+               for (int qx = 0; qx < Q1D; ++qx)
+               {
+                  gradX[qx][0] += s*B[qx+Q1D*dx];
+                  gradX[qx][1] += s*G[qx+Q1D*dx];
+               }
+            }
+            for (int qy = 0; qy < Q1D; ++qy)
+            {
+               const double wy  = B[qy+Q1D*dy];
+               const double wDy = G[qy+Q1D*dy];
+               for (int qx = 0; qx < Q1D; ++qx)
+               {
+                  const double wx  = gradX[qx][0];
+                  const double wDx = gradX[qx][1];
+                  gradXY[qy][qx][0] += wDx*wy;
+                  gradXY[qy][qx][1] += wx*wDy;
+                  gradXY[qy][qx][2] += wx*wy;
+               }
+            }
+         }
+         for (int qz = 0; qz < Q1D; ++qz)
+         {
+            const double wz  = B[qz+Q1D*dz];
+            const double wDz = G[qz+Q1D*dz];
+            for (int qy = 0; qy < Q1D; ++qy)
+            {
+               for (int qx = 0; qx < Q1D; ++qx)
+               {
+                  grad[qz][qy][qx][0] += gradXY[qy][qx][0]*wz;
+                  grad[qz][qy][qx][1] += gradXY[qy][qx][1]*wz;
+                  grad[qz][qy][qx][2] += gradXY[qy][qx][2]*wDz;
+               }
+            }
+         }
+      }
+      // Calculate Dxyz, xDyz, xyDz in plane
+      for (int qz = 0; qz < Q1D; ++qz)
+      {
+         for (int qy = 0; qy < Q1D; ++qy)
+         {
+            for (int qx = 0; qx < Q1D; ++qx)
+            {
+               const double *Dq = De + 6*(qx+Q1D*(qy+Q1D*qz));
+               const double O11 = Dq[0];
+               const double O12 = Dq[1];
+               const double O13 = Dq[2];
+               const double O22 = Dq[3];
+               const double O23 = Dq[4];
+               const double O33 = Dq[5];
+               const double gradX = grad[qz][qy][qx][0];
+               const double gradY = grad[qz][qy][qx][1];
+               const double gradZ = grad[qz][qy][qx][2];
+               grad[qz][qy][qx][0] = (O11*gradX)+(O12*gradY)+(O13*gradZ);
+               grad[qz][qy][qx][1] = (O12*gradX)+(O22*gradY)+(O23*gradZ);
+               grad[qz][qy][qx][2] = (O13*gradX)+(O23*gradY)+(O33*gradZ);
+            }
+         }
+      }
+      for (int qz = 0; qz < Q1D; ++qz)
+      {
+         double gradXY[MAX_D1D][MAX_D1D][3];
+         for (int dy = 0; dy < D1D; ++dy)
+         {
+            for (int dx = 0; dx < D1D; ++dx)
+            {
+               gradXY[dy][dx][0] = 0.0;
+               gradXY[dy][dx][1] = 0.0;
+               gradXY[dy][dx][2] = 0.0;
+            }
+         }
+         for (int qy = 0; qy < Q1D; ++qy)
+         {
+            double gradX[MAX_D1D][3];
+            for (int dx = 0; dx < D1D; ++dx)
+            {
+               gradX[dx][0] = 0.0;
+               gradX[dx][1] = 0.0;
+               gradX[dx][2] = 0.0;
+            }
+            for (int qx = 0; qx < Q1D; ++qx)
+            {
+               const double gX = grad[qz][qy][qx][0];
+               const double gY = grad[qz][qy][qx][1];
+               const double gZ = grad[qz][qy][qx][2];
+               for (int dx = 0; dx < D1D; ++dx)
+               {
+                  const double wx  = Bt[dx+D1D*qx];
+                  const double wDx = Gt[dx+D1D*qx];
+                  gradX[dx][0] += gX*wDx;
+                  gradX[dx][1] += gY*wx;
+                  gradX[dx][2] += gZ*wx;
+               }
+            }
+            for (int dy = 0; dy < D1D; ++dy)
+            {
+               const double wy  = Bt[dy+D1D*qy];
+               const double wDy = Gt[dy+D1D*qy];
+               for (int dx = 0; dx < D1D; ++dx)
+               {
+                  gradXY[dy][dx][0] += gradX[dx][0]*wy;
+                  gradXY[dy][dx][1] += gradX[dx][1]*wDy;
+                  gradXY[dy][dx][2] += gradX[dx][2]*wy;
+               }
+            }
+         }
+         for (int dz = 0; dz < D1D; ++dz)
+         {
+            const double wz  = Bt[dz+D1D*qz];
+            const double wDz = Gt[dz+D1D*qz];
+            for (int dy = 0; dy < D1D; ++dy)
+            {
+               for (int dx = 0; dx < D1D; ++dx)
+               {
+                  Ye[dx+D1D*(dy+D1D*dz)] +=
+                     ((gradXY[dy][dx][0] * wz) +
+                      (gradXY[dy][dx][1] * wz) +
+                      (gradXY[dy][dx][2] * wDz));
+               }
+            }
+         }
+      }
+   }
+}
+
+static void PADiffusionApply(const int dim, const int NE, const int VDIM,
+                             const DofToQuad &maps, const Vector &op,
+                             const Vector &x, Vector &y)
+{
+   if (maps.mode == DofToQuad::FULL || dim == 1)
+   {
+      // In 1D, the tensor maps coincide with the full maps.
+      PADiffusionApply(dim, NE, VDIM, maps.G, maps.Gt, op, x, y,
+                       maps.ndof, maps.nqpt);
+   }
+   else if (dim == 2)
+   {
+      PADiffusionApply2D(NE, VDIM, maps.B, maps.G, maps.Bt, maps.Gt, op, x, y,
+                         maps.ndof, maps.nqpt);
+   }
+   else if (dim == 3)
+   {
+      PADiffusionApply3D(NE, VDIM, maps.B, maps.G, maps.Bt, maps.Gt, op, x, y,
+                         maps.ndof, maps.nqpt);
+   }
+   else
+   {
+      MFEM_ABORT("dimension " << dim << " is not supported");
+   }
+}
+
+// PA Diffusion Diagonal kernel, non-tensor elements: the diagonal of the
+// element matrices, sum_q G(q,d)^t D(q) G(q,d), added to all VDIM components.
+static void PADiffusionDiagonal(const int dim, const int NE, const int VDIM,
+                                const Array<double> &g, const Vector &op,
+                                Vector &y, const int ND, const int NQ)
+{
+   const int symmDims = (dim*(dim+1))/2;
+   const double *G = g.GetData();
+   const double *D = op.GetData();
+   double *Y = y.GetData();
+   for (int e = 0; e < NE; e++)
+   {
+      for (int d = 0; d < ND; d++)
+      {
+         const double *Gd = G + NQ*dim*d;
+         double s = 0.0;
+         for (int q = 0; q < NQ; q++)
+         {
+            const double *Dq = D + symmDims*(q+NQ*e);
+            for (int i = 0, k = 0; i < dim; i++)
+            {
+               for (int j = i; j < dim; j++, k++)
+               {
+                  const double f = (i == j) ? 1.0 : 2.0;
+                  s += f*Gd[q+NQ*i]*Dq[k]*Gd[q+NQ*j];
+               }
+            }
+         }
+         for (int c = 0; c < VDIM; c++)
+         {
+            Y[d+ND*(c+VDIM*e)] += s;
+         }
+      }
+   }
+}
+
+// Set W[n] to the entry-wise products of the 1D matrices B and G with n
+// factors G and 2-n factors B, n = 0,1,2, used by the tensor diagonal
+// kernels: the 1D factor of the entry (i,j) of D in direction d is W[n] with
+// n = (i == d) + (j == d).
+static void PADiffusionDiagonalProducts(const double *B, const double *G,
+                                        const int N, double *W)
+{
+   for (int k = 0; k < N; k++)
+   {
+      W[k] = B[k]*B[k];
+      W[k+N] = B[k]*G[k];
+      W[k+2*N] = G[k]*G[k];
+   }
+}
+
+// PA Diffusion Diagonal 2D kernel
+static void PADiffusionDiagonal2D(const int NE, const int VDIM,
+                                  const Array<double> &b,
+                                  const Array<double> &g,
+                                  const Vector &op, Vector &y,
+                                  const int D1D, const int Q1D)
+{
+   const int N = Q1D*D1D;
+   double W[3*MAX_Q1D*MAX_D1D];
+   PADiffusionDiagonalProducts(b.GetData(), g.GetData(), N, W);
+   const double *D = op.GetData();
+   double *Y = y.GetData();
+#ifdef MFEM_USE_OPENMP
+   #pragma omp parallel for
+#endif
+   for (int e = 0; e < NE; e++)
+   {
+      const double *De = D + 3*Q1D*Q1D*e;
+      double diag[MAX_D1D][MAX_D1D];
+      for (int dy = 0; dy < D1D; ++dy)
+      {
+         for (int dx = 0; dx < D1D; ++dx)
+         {
+            diag[dy][dx] = 0.0;
+         }
+      }
+      for (int i = 0, k = 0; i < 2; i++)
+      {
+         for (int j = i; j < 2; j++, k++)
+         {
+            const double f = (i == j) ? 1.0 : 2.0;
+            const double *Wx = W + N*((i == 0) + (j == 0));
+            const double *Wy = W + N*((i == 1) + (j == 1));
+            double temp[MAX_Q1D][MAX_D1D];
+            for (int qy = 0; qy < Q1D; ++qy)
+            {
+               for (int dx = 0; dx < D1D; ++dx)
+               {
+                  double s = 0.0;
+                  for (int qx = 0; qx < Q1D; ++qx)
+                  {
+                     s += Wx[qx+Q1D*dx]*De[k+3*(qx+Q1D*qy)];
+                  }
+                  temp[qy][dx] = f*s;
+               }
+            }
+            for (int dy = 0; dy < D1D; ++dy)
+            {
+               for (int dx = 0; dx < D1D; ++dx)
+               {
+                  double s = 0.0;
+                  for (int qy = 0; qy < Q1D; ++qy)
+                  {
+                     s += Wy[qy+Q1D*dy]*temp[qy][dx];
+                  }
+                  diag[dy][dx] += s;
+               }
+            }
+         }
+      }
+      for (int c = 0; c < VDIM; c++)
+      {
+         double *Ye = Y + D1D*D1D*(c+VDIM*e);
+         for (int dy = 0; dy < D1D; ++dy)
+         {
+            for (int dx = 0; dx < D1D; ++dx)
+            {
+               Ye[dx+D1D*dy] += diag[dy][dx];
+            }
+         }
+      }
+   }
+}
+
+// PA Diffusion Diagonal 3D kernel
+static void PADiffusionDiagonal3D(const int NE, const int VDIM,
+                                  const Array<double> &b,
+                                  const Array<double> &g,
+                                  const Vector &op, Vector &y,
+                                  const int D1D, const int Q1D)
+{
+   const int N = Q1D*D1D;
+   double W[3*MAX_Q1D*MAX_D1D];
+   PADiffusionDiagonalProducts(b.GetData(), g.GetData(), N, W);
+   const double *D = op.GetData();
+   double *Y = y.GetData();
+#ifdef MFEM_USE_OPENMP
+   #pragma omp parallel for
+#endif
+   for (int e = 0; e < NE; e++)
+   {
+      const double *De = D + 6*Q1D*Q1D*Q1D*e;
+      double diag[MAX_D1D][MAX_D1D][MAX_D1D];
+      for (int dz = 0; dz < D1D; ++dz)
+      {
+         for (int dy = 0; dy < D1D; ++dy)
+         {
+            for (int dx = 0; dx < D1D; ++dx)
+            {
+               diag[dz][dy][dx] = 0.0;
+            }
+         }
+      }
+      for (int i = 0, k = 0; i < 3; i++)
+      {
+         for (int j = i; j < 3; j++, k++)
+         {
+            const double f = (i == j) ? 1.0 : 2.0;
+            const double *Wx = W + N*((i == 0) + (j == 0));
+            const double *Wy = W + N*((i == 1) + (j == 1));
+            const double *Wz = W + N*((i == 2) + (j == 2));
+            double temp_x[MAX_Q1D][MAX_Q1D][MAX_D1D];
+            double temp_xy[MAX_Q1D][MAX_D1D][MAX_D1D];
+            for (int qz = 0; qz < Q1D; ++qz)
+            {
+               for (int qy = 0; qy < Q1D; ++qy)
+               {
+                  for (int dx = 0; dx < D1D; ++dx)
+                  {
+                     double s = 0.0;
+                     for (int qx = 0; qx < Q1D; ++qx)
+                     {
+                        s += Wx[qx+Q1D*dx]*De[k+6*(qx+Q1D*(qy+Q1D*qz))];
+                     }
+                     temp_x[qz][qy][dx] = f*s;
+                  }
+               }
+               for (int dy = 0; dy < D1D; ++dy)
+               {
+                  for (int dx = 0; dx < D1D; ++dx)
+                  {
+                     double s = 0.0;
+                     for (int qy = 0; qy < Q1D; ++qy)
+                     {
+                        s += Wy[qy+Q1D*dy]*temp_x[qz][qy][dx];
+                     }
+                     temp_xy[qz][dy][dx] = s;
+                  }
+               }
+            }
+            for (int dz = 0; dz < D1D; ++dz)
+            {
+               for (int dy = 0; dy < D1D; ++dy)
+               {
+                  for (int dx = 0; dx < D1D; ++dx)
+                  {
+                     double s = 0.0;
+                     for (int qz = 0; qz < Q1D; ++qz)
+                     {
+                        s += Wz[qz+Q1D*dz]*temp_xy[qz][dy][dx];
+                     }
+                     diag[dz][dy][dx] += s;
+                  }
+               }
+            }
+         }
+      }
+      for (int c = 0; c < VDIM; c++)
+      {
+         double *Ye = Y + D1D*D1D*D1D*(c+VDIM*e);
+         for (int dz = 0; dz < D1D; ++dz)
+         {
+            for (int dy = 0; dy < D1D; ++dy)
+            {
+               for (int dx = 0; dx < D1D; ++dx)
+               {
+                  Ye[dx+D1D*(dy+D1D*dz)] += diag[dz][dy][dx];
+               }
+            }
+         }
+      }
+   }
+}
+
+static void PADiffusionDiagonal(const int dim, const int NE, const int VDIM,
+                                const DofToQuad &maps, const Vector &op,
+                                Vector &y)
+{
+   if (maps.mode == DofToQuad::FULL || dim == 1)
+   {
+      PADiffusionDiagonal(dim, NE, VDIM, maps.G, op, y, maps.ndof, maps.nqpt);
+   }
+   else if (dim == 2)
+   {
+      PADiffusionDiagonal2D(NE, VDIM, maps.B, maps.G, op, y,
+                            maps.ndof, maps.nqpt);
+   }
+   else if (dim == 3)
+   {
+      PADiffusionDiagonal3D(NE, VDIM, maps.B, maps.G, op, y,
+                            maps.ndof, maps.nqpt);
+   }
+   else
+   {
+      MFEM_ABORT("dimension " << dim << " is not supported");
+   }
+}
+
+static const DofToQuad &PADiffusionMaps(const FiniteElement &el,
+                                        const IntegrationRule &ir)
+{
+   const bool tensor = dynamic_cast<const TensorBasisElement*>(&el) != NULL;
+   const DofToQuad &maps =
+      el.GetDofToQuad(ir, tensor ? DofToQuad::TENSOR : DofToQuad::FULL);
+   MFEM_VERIFY(!tensor || (maps.ndof <= MAX_D1D && maps.nqpt <= MAX_Q1D),
+               "order too high for the tensor partial assembly kernels");
+   return maps;
+}
+
+void DiffusionIntegrator::AssemblePA(const FiniteElementSpace &fes)
+{
+   MFEM_VERIFY(MQ == NULL, "matrix coefficients are not supported");
+   MFEM_VERIFY(fes.GetVDim() == 1, "vector spaces are not supported");
+   dim = fes.GetMesh()->Dimension();
+   ne = fes.GetNE();
+   if (ne == 0) { return; }
+
+   const FiniteElement &el = *fes.GetFE(0);
+   const IntegrationRule *ir = IntRule ? IntRule : &GetRule(el);
+   maps = &PADiffusionMaps(el, *ir);
+   nq = ir->GetNPoints();
+   dofs1D = maps->ndof;
+   quad1D = maps->nqpt;
+   PADiffusionSetup(fes, *ir, Q, pa_data);
+}
+
+void DiffusionIntegrator::AddMultPA(const Vector &x, Vector &y) const
+{
+   MFEM_ASSERT(maps || ne == 0, "AssemblePA() has not been called");
+   if (ne == 0) { return; }
+   PADiffusionApply(dim, ne, 1, *maps, pa_data, x, y);
+}
+
+void DiffusionIntegrator::AssembleDiagonalPA(Vector &diag) const
+{
+   MFEM_ASSERT(maps || ne == 0, "AssemblePA() has not been called");
+   if (ne == 0) { return; }
+   PADiffusionDiagonal(dim, ne, 1, *maps, pa_data, diag);
+}
+
+void VectorDiffusionIntegrator::AssemblePA(const FiniteElementSpace &fes)
+{
+   dim = fes.GetMesh()->Dimension();
+   ne = fes.GetNE();
+   MFEM_VERIFY(fes.GetVDim() == dim,
+               "the vector dimension of the space must be " << dim);
+   if (ne == 0) { return; }
+
+   const FiniteElement &el = *fes.GetFE(0);
+   ElementTransformation &T0 = *fes.GetMesh()->GetElementTransformation(0);
+   const IntegrationRule *ir = IntRule ? IntRule : &GetRule(el, T0);
+   maps = &PADiffusionMaps(el, *ir);
+   nq = ir->GetNPoints();
+   dofs1D = maps->ndof;
+   quad1D = maps->nqpt;
+   PADiffusionSetup(fes, *ir, Q, pa_data);
+}
+
+void VectorDiffusionIntegrator::AddMultPA(const Vector &x, Vector &y) const
+{
+   MFEM_ASSERT(maps || ne == 0, "AssemblePA() has not been called");
+   if (ne == 0) { return; }
+   PADiffusionApply(dim, ne, dim, *maps, pa_data, x, y);
+}
+
+void VectorDiffusionIntegrator::AssembleDiagonalPA(Vector &diag) const
+{
+   MFEM_ASSERT(maps || ne == 0, "AssemblePA() has not been called");
+   if (ne == 0) { return; }
+   PADiffusionDiagonal(dim, ne, dim, *maps, pa_data, diag);
+}
+
+}
@@ -0,0 +1,726 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+// Partial assembly of VectorFEMassIntegrator, CurlCurlIntegrator and
+// DivDivIntegrator for Nedelec and Raviart-Thomas tensor product elements
+
+#include "fem.hpp"
+
+namespace mfem
+{
+
+bool VectorTensorDofToQuad::IsSupported(const FiniteElement &el)
+{
+   return (dynamic_cast<const ND_QuadrilateralElement*>(&el) ||
+           dynamic_cast<const ND_HexahedronElement*>(&el) ||
+           dynamic_cast<const RT_QuadrilateralElement*>(&el) ||
+           dynamic_cast<const RT_HexahedronElement*>(&el));
+}
+
+void VectorTensorDofToQuad::Setup(const FiniteElement &el,
+                                  const IntegrationRule &ir)
+{
+   const ND_QuadrilateralElement *nd_quad =
+      dynamic_cast<const ND_QuadrilateralElement*>(&el);
+   const ND_HexahedronElement *nd_hex =
+      dynamic_cast<const ND_HexahedronElement*>(&el);
+   const RT_QuadrilateralElement *rt_quad =
+      dynamic_cast<const RT_QuadrilateralElement*>(&el);
+   const RT_HexahedronElement *rt_hex =
+      dynamic_cast<const RT_HexahedronElement*>(&el);
+
+   const Poly_1D::Basis *cbasis, *obasis;
+   if (nd_quad)
+   {
+      cbasis = &nd_quad->GetClosedBasis();
+      obasis = &nd_quad->GetOpenBasis();
+      dof_map = &nd_quad->GetDofMap();
+   }
+   else if (nd_hex)
+   {
+      cbasis = &nd_hex->GetClosedBasis();
+      obasis = &nd_hex->GetOpenBasis();
+      dof_map = &nd_hex->GetDofMap();
+   }
+   else if (rt_quad)
+   {
+      cbasis = &rt_quad->GetClosedBasis();
+      obasis = &rt_quad->GetOpenBasis();
+      dof_map = &rt_quad->GetDofMap();
+   }
+   else if (rt_hex)
+   {
+      cbasis = &rt_hex->GetClosedBasis();
+      obasis = &rt_hex->GetOpenBasis();
+      dof_map = &rt_hex->GetDofMap();
+   }
+   else
+   {
+      MFEM_ABORT("the element must be a Nedelec or Raviart-Thomas element on"
+                 " a quadrilateral or a hexahedron");
+      return;
+   }
+
+   dim = el.GetDim();
+   map_type = el.GetMapType();
+   ndof = el.GetDof();
+   // Both for ND_* (order p: closed order p, open order p-1) and RT_* (order
+   // p+1: closed order p+1, open order p) elements.
+   nc = el.GetOrder() + 1;
+   no = el.GetOrder();
+   nqpt = (int) floor(pow(ir.GetNPoints(), 1.0/dim) + 0.5);
+   MFEM_VERIFY((dim == 2 ? nqpt*nqpt : nqpt*nqpt*nqpt) == ir.GetNPoints(),
+               "the IntegrationRule is not a tensor product rule");
+   MFEM_VERIFY(nc <= MAX_D1D && nqpt <= MAX_Q1D,
+               "order too high for the tensor partial assembly kernels");
+
+   Bc.SetSize(nqpt*nc);
+   Gc.SetSize(nqpt*nc);
+   Bo.SetSize(nqpt*no);
+   Vector cval(nc), cgrad(nc), oval(no);
+   for (int i = 0; i < nqpt; i++)
+   {
+      // The first 'nqpt' points in 'ir' have the same x-coordinates as those
+      // of the 1D rule.
+      const double x = ir.IntPoint(i).x;
+      cbasis->Eval(x, cval, cgrad);
+      obasis->Eval(x, oval);
+      for (int j = 0; j < nc; j++)
+      {
+         Bc[i+nqpt*j] = cval(j);
+         Gc[i+nqpt*j] = cgrad(j);
+      }
+      for (int j = 0; j < no; j++)
+      {
+         Bo[i+nqpt*j] = oval(j);
+      }
+   }
+}
+
+// The reference operators mapping the dofs to the quadrature points
+enum { PA_VALUE, PA_CURL, PA_DIV };
+
+// One term of a reference operator: the dofs of the vector component 'comp'
+// contribute to the component 'qcomp' of the quadrature point vector through
+// the tensor product of the 1D matrices B[d] (Q1D x n[d]), scaled by 'sign'.
+struct PAVectorTensorTerm
+{
+   int comp, qcomp;
+   double sign;
+   int n[3];
+   const double *B[3];
+};
+
+// Return the number of components of the quadrature point vector of the
+// reference operator 'op'.
+static int PAVectorTensorQDim(const VectorTensorDofToQuad &maps, const int op)
+{
+   if (op == PA_VALUE) { return maps.dim; }
+   if (op == PA_CURL) { return (maps.dim == 3) ? 3 : 1; }
+   return 1;
+}
+
+// Fill 'terms' (at most 6) with the terms of the reference operator 'op' and
+// 'offsets' (size dim) with the offsets of the vector components in the
+// lexicographic ordering of the dofs. Return the number of terms.
+static int PAVectorTensorTerms(const VectorTensorDofToQuad &maps, const int op,
+                               PAVectorTensorTerm *terms, int *offsets)
+{
+   const int dim = maps.dim;
+   const bool hdiv = (maps.map_type == FiniteElement::H_DIV);
+   int nt = 0;
+   for (int c = 0, offset = 0; c < dim; c++)
+   {
+      // Component 'c' uses the closed basis in direction 'c' in H(div) and in
+      // the other directions in H(curl).
+      PAVectorTensorTerm base;
+      base.comp = c;
+      int size = 1;
+      for (int d = 0; d < dim; d++)
+      {
+         const bool closed = ((d == c) == hdiv);
+         base.n[d] = closed ? maps.nc : maps.no;
+         base.B[d] = closed ? maps.Bc.GetData() : maps.Bo.GetData();
+         size *= base.n[d];
+      }
+      offsets[c] = offset;
+      offset += size;
+
+      if (op == PA_VALUE)
+      {
+         terms[nt] = base;
+         terms[nt].qcomp = c;
+         terms[nt].sign = 1.0;
+         nt++;
+      }
+      else if (op == PA_DIV)
+      {
+         // div u = sum_c d_c u_c
+         terms[nt] = base;
+         terms[nt].qcomp = 0;
+         terms[nt].sign = 1.0;
+         terms[nt].B[c] = maps.Gc.GetData();
+         nt++;
+      }
+      else
+      {
+         // (curl u)_m = sum_{k,c} eps_{mkc} d_k u_c, or in 2D:
+         // curl u = d_0 u_1 - d_1 u_0
+         for (int k = 0; k < dim; k++)
+         {
+            if (k == c) { continue; }
+            terms[nt] = base;
+            terms[nt].B[k] = maps.Gc.GetData();
+            if (dim == 3)
+            {
+               terms[nt].qcomp = 3 - c - k;
+               terms[nt].sign = (c == (k + 1) % 3) ? 1.0 : -1.0;
+            }
+            else
+            {
+               terms[nt].qcomp = 0;
+               terms[nt].sign = (k == 0) ? 1.0 : -1.0;
+            }
+            nt++;
+         }
+      }
+   }
+   return nt;
+}
+
+// Add to the quadrature point values U the values of the tensor product field
+// with dofs X and 1D matrices B[d] (Q1D x n[d]), scaled by 'a'. Both X and U
+// use lexicographic ordering.
+static void TensorMult(const int dim, const int *n, const double *const *B,
+                       const int Q1D, const double *X, double *U,
+                       const double a)
+{
+   if (dim == 2)
+   {
+      const int nx = n[0], ny = n[1];
+      double t[MAX_Q1D*MAX_D1D];
+      for (int dy = 0; dy < ny; dy++)
+      {
+         double *ty = t + Q1D*dy;
+         for (int qx = 0; qx < Q1D; qx++) { ty[qx] = 0.0; }
+         for (int dx = 0; dx < nx; dx++)
+         {
+            const double s = X[dx+nx*dy];
+            const double *Bx = B[0] + Q1D*dx;
+            for (int qx = 0; qx < Q1D; qx++) { ty[qx] += Bx[qx]*s; }
+         }
+      }
+      for (int dy = 0; dy < ny; dy++)
+      {
+         const double *ty = t + Q1D*dy;
+         for (int qy = 0; qy < Q1D; qy++)
+         {
+            const double w = a*B[1][qy+Q1D*dy];
+            double *Uy = U + Q1D*qy;
+            for (int qx = 0; qx < Q1D; qx++) { Uy[qx] += w*ty[qx]; }
+         }
+      }
+      return;
+   }
+
+   const int nx = n[0], ny = n[1], nz = n[2];
+   double t1[MAX_Q1D*MAX_D1D*MAX_D1D], t2[MAX_Q1D*MAX_Q1D*MAX_D1D];
+   // t1(qx,dy,dz) = sum_dx Bx(qx,dx) X(dx,dy,dz)
+   for (int dyz = 0; dyz < ny*nz; dyz++)
+   {
+      double *t = t1 + Q1D*dyz;
+      for (int qx = 0; qx < Q1D; qx++) { t[qx] = 0.0; }
+      for (int dx = 0; dx < nx; dx++)
+      {
+         const double s = X[dx+nx*dyz];
+         const double *Bx = B[0] + Q1D*dx;
+         for (int qx = 0; qx < Q1D; qx++) { t[qx] += Bx[qx]*s; }
+      }
+   }
+   // t2(qx,qy,dz) = sum_dy By(qy,dy) t1(qx,dy,dz)
+   for (int dz = 0; dz < nz; dz++)
+   {
+      double *t = t2 + Q1D*Q1D*dz;
+      for (int i = 0; i < Q1D*Q1D; i++) { t[i] = 0.0; }
+      for (int dy = 0; dy < ny; dy++)
+      {
+         const double *s = t1 + Q1D*(dy+ny*dz);
+         for (int qy = 0; qy < Q1D; qy++)
+         {
+            const double w = B[1][qy+Q1D*dy];
+            for (int qx = 0; qx < Q1D; qx++) { t[qx+Q1D*qy] += w*s[qx]; }
+         }
+      }
+   }
+   // U(qx,qy,qz) += a sum_dz Bz(qz,dz) t2(qx,qy,dz)
+   for (int dz = 0; dz < nz; dz++)
+   {
+      const double *s = t2 + Q1D*Q1D*dz;
+      for (int qz = 0; qz < Q1D; qz++)
+      {
+         const double w = a*B[2][qz+Q1D*dz];
+         double *Uz = U + Q1D*Q1D*qz;
+         for (int i = 0; i < Q1D*Q1D; i++) { Uz[i] += w*s[i]; }
+      }
+   }
+}
+
+// Transpose of TensorMult(): add to the dofs Y the transposed action of the
+// tensor product of the 1D matrices B[d] on the quadrature point values U,
+// scaled by 'a'.
+static void TensorMultTranspose(const int dim, const int *n,
+                                const double *const *B, const int Q1D,
+                                const double *U, double *Y, const double a)
+{
+   if (dim == 2)
+   {
+      const int nx = n[0], ny = n[1];
+      double t[MAX_D1D*MAX_Q1D];
+      for (int qy = 0; qy < Q1D; qy++)
+      {
+         const double *Uy = U + Q1D*qy;
+         double *ty = t + nx*qy;
+         for (int dx = 0; dx < nx; dx++)
+         {
+            const double *Bx = B[0] + Q1D*dx;
+            double s = 0.0;
+            for (int qx = 0; qx < Q1D; qx++) { s += Bx[qx]*Uy[qx]; }
+            ty[dx] = s;
+         }
+      }
+      for (int dy = 0; dy < ny; dy++)
+      {
+         double *Yy = Y + nx*dy;
+         for (int qy = 0; qy < Q1D; qy++)
+         {
+            const double w = a*B[1][qy+Q1D*dy];
+            const double *ty = t + nx*qy;
+            for (int dx = 0; dx < nx; dx++) { Yy[dx] += w*ty[dx]; }
+         }
+      }
+      return;
+   }
+
+   const int nx = n[0], ny = n[1], nz = n[2];
+   double t1[MAX_D1D*MAX_Q1D*MAX_Q1D], t2[MAX_D1D*MAX_D1D*MAX_Q1D];
+   // t1(dx,qy,qz) = sum_qx Bx(qx,dx) U(qx,qy,qz)
+   for (int qyz = 0; qyz < Q1D*Q1D; qyz++)
+   {
+      const double *u = U + Q1D*qyz;
+      double *t = t1 + nx*qyz;
+      for (int dx = 0; dx < nx; dx++)
+      {
+         const double *Bx = B[0] + Q1D*dx;
+         double s = 0.0;
+         for (int qx = 0; qx < Q1D; qx++) { s += Bx[qx]*u[qx]; }
+         t[dx] = s;
+      }
+   }
+   // t2(dx,dy,qz) = sum_qy By(qy,dy) t1(dx,qy,qz)
+   for (int qz = 0; qz < Q1D; qz++)
+   {
+      double *t = t2 + nx*ny*qz;
+      for (int i = 0; i < nx*ny; i++) { t[i] = 0.0; }
+      for (int qy = 0; qy < Q1D; qy++)
+      {
+         const double *s = t1 + nx*(qy+Q1D*qz);
+         for (int dy = 0; dy < ny; dy++)
+         {
+            const double w = B[1][qy+Q1D*dy];
+            for (int dx = 0; dx < nx; dx++) { t[dx+nx*dy] += w*s[dx]; }
+         }
+      }
+   }
+   // Y(dx,dy,dz) += a sum_qz Bz(qz,dz) t2(dx,dy,qz)
+   for (int dz = 0; dz < nz; dz++)
+   {
+      double *Yz = Y + nx*ny*dz;
+      for (int qz = 0; qz < Q1D; qz++)
+      {
+         const double w = a*B[2][qz+Q1D*dz];
+         const double *s = t2 + nx*ny*qz;
+         for (int i = 0; i < nx*ny; i++) { Yz[i] += w*s[i]; }
+      }
+   }
+}
+
+// Index of the entry (i,j) in the upper triangular storage of a symmetric
+// matrix of size 'n'.
+static inline int SymmIndex(const int n, int i, int j)
+{
+   if (i > j) { Swap(i, j); }
+   return i*n - (i*(i-1))/2 + (j-i);
+}
+
+// Compute the symmetric quadrature-point data of the reference operator 'op',
+// stored as the upper triangular part (layout: symm, NQ, NE):
+//    PA_VALUE in H(curl):             D = w_q coeff det(J) J^{-1} J^{-t}
+//    PA_VALUE in H(div), PA_CURL 3D:  D = w_q coeff J^t J / det(J)
+//    PA_CURL in 2D, PA_DIV:           D = w_q coeff / det(J)
+static void PAVectorTensorSetup(const FiniteElementSpace &fes,
+                                const IntegrationRule &ir, Coefficient *Q,
+                                const VectorTensorDofToQuad &maps,
+                                const int op, Vector &pa_data)
+{
+   Mesh *mesh = fes.GetMesh();
+   const int NE = fes.GetNE();
+   const int NQ = ir.GetNPoints();
+   const int dim = mesh->Dimension();
+   MFEM_VERIFY(mesh->SpaceDimension() == dim,
+               "surface meshes are not supported");
+   const int qdim = PAVectorTensorQDim(maps, op);
+   const int symmDims = (qdim*(qdim+1))/2;
+   const bool covariant =
+      (op == PA_VALUE && maps.map_type == FiniteElement::H_CURL);
+
+   const GeometricFactors *geom =
+      mesh->GetGeometricFactors(ir, GeometricFactors::JACOBIANS |
+                                GeometricFactors::DETERMINANTS);
+   ConstantCoefficient *cQ = dynamic_cast<ConstantCoefficient*>(Q);
+   DenseMatrix J(dim), M(dim);
+   Vector Q_ir(NQ);
+   Q_ir = cQ ? cQ->constant : 1.0;
+   pa_data.SetSize(symmDims*NQ*NE);
+   for (int e = 0; e < NE; e++)
+   {
+      // Only needed to evaluate a non-constant coefficient
+      if (Q && !cQ) { Q->Eval(Q_ir, *mesh->GetElementTransformation(e), ir); }
+      for (int q = 0; q < NQ; q++)
+      {
+         const IntegrationPoint &ip = ir.IntPoint(q);
+         const double detJ = geom->detJ(q+NQ*e);
+         double w = Q_ir(q) * ip.weight;
+         double *D = pa_data.GetData() + symmDims*(q+NQ*e);
+         if (qdim == 1)
+         {
+            D[0] = w/detJ;
+            continue;
+         }
+         const double *Jq = geom->J.GetData() + q + NQ*dim*dim*e;
+         for (int j = 0; j < dim; j++)
+         {
+            for (int i = 0; i < dim; i++)
+            {
+               J(i,j) = Jq[NQ*(i+dim*j)];
+            }
+         }
+         if (covariant)
+         {
+            // adj(J) adj(J)^t / det(J) = det(J) J^{-1} J^{-t}
+            CalcAdjugate(J, M);
+            w /= detJ;
+            for (int i = 0, k = 0; i < dim; i++)
+            {
+               for (int j = i; j < dim; j++, k++)
+               {
+                  double s = 0.0;
+                  for (int l = 0; l < dim; l++)
+                  {
+                     s += M(i,l)*M(j,l);
+                  }
+                  D[k] = w*s;
+               }
+            }
+         }
+         else
+         {
+            w /= detJ;
+            for (int i = 0, k = 0; i < dim; i++)
+            {
+               for (int j = i; j < dim; j++, k++)
+               {
+                  double s = 0.0;
+                  for (int l = 0; l < dim; l++)
+                  {
+                     s += J(l,i)*J(l,j);
+                  }
+                  D[k] = w*s;
+               }
+            }
+         }
+      }
+   }
+}
+
+// PA Apply kernel for the reference operator 'op': y += B^t D B x, where B is
+// the sum of the terms returned by PAVectorTensorTerms(). The dofs are mapped
+// between the native and the lexicographic ordering, with sign changes, using
+// maps.dof_map. The input and output have layout (ND, NE).
+static void PAVectorTensorApply(const VectorTensorDofToQuad &maps,
+                                const int op, const int NE,
+                                const Vector &pa_data,
+                                const Vector &x, Vector &y)
+{
+   const int dim = maps.dim;
+   const int ND = maps.ndof;
+   const int Q1D = maps.nqpt;
+   const int NQ = (dim == 2) ? Q1D*Q1D : Q1D*Q1D*Q1D;
+   const int qdim = PAVectorTensorQDim(maps, op);
+   const int symmDims = (qdim*(qdim+1))/2;
+   PAVectorTensorTerm terms[6];
+   int offsets[3];
+   const int nt = PAVectorTensorTerms(maps, op, terms, offsets);
+   const int *dof_map = maps.dof_map->GetData();
+   const double *X = x.GetData();
+   double *Y = y.GetData();
+
+#ifdef MFEM_USE_OPENMP
+   #pragma omp parallel
+#endif
+   {
+      Vector xl(ND), yl(ND), u(qdim*NQ), v(qdim*NQ);
+#ifdef MFEM_USE_OPENMP
+      #pragma omp for
+#endif
+      for (int e = 0; e < NE; e++)
+      {
+         const double *Xe = X + ND*e;
+         double *Ye = Y + ND*e;
+         const double *De = pa_data.GetData() + symmDims*NQ*e;
+         for (int o = 0; o < ND; o++)
+         {
+            const int idx = dof_map[o];
+            xl(o) = (idx >= 0) ? Xe[idx] : -Xe[-1-idx];
+         }
+         u = 0.0;
+         for (int t = 0; t < nt; t++)
+         {
+            const PAVectorTensorTerm &term = terms[t];
+            TensorMult(dim, term.n, term.B, Q1D,
+                       xl.GetData() + offsets[term.comp],
+                       u.GetData() + NQ*term.qcomp, term.sign);
+         }
+         for (int q = 0; q < NQ; q++)
+         {
+            const double *D = De + symmDims*q;
+            for (int i = 0; i < qdim; i++)
+            {
+               double s = 0.0;
+               for (int j = 0; j < qdim; j++)
+               {
+                  s += D[SymmIndex(qdim, i, j)]*u(q+NQ*j);
+               }
+               v(q+NQ*i) = s;
+            }
+         }
+         yl = 0.0;
+         for (int t = 0; t < nt; t++)
+         {
+            const PAVectorTensorTerm &term = terms[t];
+            TensorMultTranspose(dim, term.n, term.B, Q1D,
+                                v.GetData() + NQ*term.qcomp,
+                                yl.GetData() + offsets[term.comp], term.sign);
+         }
+         for (int o = 0; o < ND; o++)
+         {
+            const int idx = dof_map[o];
+            if (idx >= 0) { Ye[idx] += yl(o); }
+            else { Ye[-1-idx] -= yl(o); }
+         }
+      }
+   }
+}
+
+// PA Diagonal kernel for the reference operator 'op': the diagonal of B^t D B
+// is the sum, over all pairs of terms (s,t) acting on the same component, of
+// the transposed tensor product of the entry-wise products of their 1D
+// matrices applied to D_{qcomp_s,qcomp_t}.
+static void PAVectorTensorDiagonal(const VectorTensorDofToQuad &maps,
+                                   const int op, const int NE,
+                                   const Vector &pa_data, Vector &diag)
+{
+   const int dim = maps.dim;
+   const int ND = maps.ndof;
+   const int Q1D = maps.nqpt;
+   const int NQ = (dim == 2) ? Q1D*Q1D : Q1D*Q1D*Q1D;
+   const int qdim = PAVectorTensorQDim(maps, op);
+   const int symmDims = (qdim*(qdim+1))/2;
+   PAVectorTensorTerm terms[6];
+   int offsets[3];
+   const int nt = PAVectorTensorTerms(maps, op, terms, offsets);
+
+   // The pairs of terms (s <= t), stored as terms with entry-wise products of
+   // the 1D matrices, the factor 2 for s < t and the index of the D entry. At
+   // most 2 terms act on the same component, so there are at most 9 pairs.
+   PAVectorTensorTerm pairs[9];
+   int pair_entry[9];
+   Array<double> products(9*dim*Q1D*maps.nc);
+   int np = 0;
+   for (int s = 0; s < nt; s++)
+   {
+      for (int t = s; t < nt; t++)
+      {
+         if (terms[s].comp != terms[t].comp) { continue; }
+         PAVectorTensorTerm &pair = pairs[np];
+         pair.comp = terms[s].comp;
+         pair.sign = terms[s].sign*terms[t].sign*((s == t) ? 1.0 : 2.0);
+         for (int d = 0; d < dim; d++)
+         {
+            double *P = products.GetData() + Q1D*maps.nc*(d+dim*np);
+            pair.n[d] = terms[s].n[d];
+            for (int i = 0; i < Q1D*pair.n[d]; i++)
+            {
+               P[i] = terms[s].B[d][i]*terms[t].B[d][i];
+            }
+            pair.B[d] = P;
+         }
+         pair_entry[np] = SymmIndex(qdim, terms[s].qcomp, terms[t].qcomp);
+         np++;
+      }
+   }
+
+   const int *dof_map = maps.dof_map->GetData();
+   double *Y = diag.GetData();
+#ifdef MFEM_USE_OPENMP
+   #pragma omp parallel
+#endif
+   {
+      Vector yl(ND), w(NQ);
+#ifdef MFEM_USE_OPENMP
+      #pragma omp for
+#endif
+      for (int e = 0; e < NE; e++)
+      {
+         double *Ye = Y + ND*e;
+         const double *De = pa_data.GetData() + symmDims*NQ*e;
+         yl = 0.0;
+         for (int p = 0; p < np; p++)
+         {
+            const PAVectorTensorTerm &pair = pairs[p];
+            for (int q = 0; q < NQ; q++)
+            {
+               w(q) = De[pair_entry[p]+symmDims*q];
+            }
+            TensorMultTranspose(dim, pair.n, pair.B, Q1D, w.GetData(),
+                                yl.GetData() + offsets[pair.comp], pair.sign);
+         }
+         for (int o = 0; o < ND; o++)
+         {
+            const int idx = dof_map[o];
+            Ye[(idx >= 0) ? idx : -1-idx] += yl(o);
+         }
+      }
+   }
+}
+
+// Common part of the AssemblePA methods below
+static void PAVectorTensorInit(const FiniteElementSpace &fes,
+                               const IntegrationRule *ir,
+                               VectorTensorDofToQuad &maps)
+{
+   MFEM_VERIFY(fes.GetVDim() == 1, "vector spaces are not supported");
+   const FiniteElement &el = *fes.GetFE(0);
+   MFEM_VERIFY(VectorTensorDofToQuad::IsSupported(el),
+               "partial assembly requires Nedelec or Raviart-Thomas elements"
+               " on quadrilateral or hexahedral meshes");
+   maps.Setup(el, *ir);
+}
+
+void VectorFEMassIntegrator::AssemblePA(const FiniteElementSpace &fes)
+{
+   MFEM_VERIFY(VQ == NULL && MQ == NULL,
+               "vector and matrix coefficients are not supported");
+   ne = fes.GetNE();
+   if (ne == 0) { return; }
+
+   const FiniteElement &el = *fes.GetFE(0);
+   const IntegrationRule *ir = IntRule;
+   if (ir == NULL)
+   {
+      // Same rule as in AssembleElementMatrix()
+      ElementTransformation &T0 = *fes.GetMesh()->GetElementTransformation(0);
+      int order = T0.OrderW() + 2 * el.GetOrder();
+      ir = &IntRules.Get(el.GetGeomType(), order);
+   }
+   PAVectorTensorInit(fes, ir, pa_maps);
+   PAVectorTensorSetup(fes, *ir, Q, pa_maps, PA_VALUE, pa_data);
+}
+
+void VectorFEMassIntegrator::AddMultPA(const Vector &x, Vector &y) const
+{
+   if (ne == 0) { return; }
+   MFEM_ASSERT(pa_maps.dof_map, "AssemblePA() has not been called");
+   PAVectorTensorApply(pa_maps, PA_VALUE, ne, pa_data, x, y);
+}
+
+void VectorFEMassIntegrator::AssembleDiagonalPA(Vector &diag) const
+{
+   if (ne == 0) { return; }
+   MFEM_ASSERT(pa_maps.dof_map, "AssemblePA() has not been called");
+   PAVectorTensorDiagonal(pa_maps, PA_VALUE, ne, pa_data, diag);
+}
+
+void CurlCurlIntegrator::AssemblePA(const FiniteElementSpace &fes)
+{
+   MFEM_VERIFY(MQ == NULL, "matrix coefficients are not supported");
+   ne = fes.GetNE();
+   if (ne == 0) { return; }
+
+   const FiniteElement &el = *fes.GetFE(0);
+   const IntegrationRule *ir = IntRule;
+   if (ir == NULL)
+   {
+      // Same rule as in AssembleElementMatrix() for Qk elements
+      ir = &IntRules.Get(el.GetGeomType(), 2*el.GetOrder());
+   }
+   PAVectorTensorInit(fes, ir, pa_maps);
+   MFEM_VERIFY(pa_maps.map_type == FiniteElement::H_CURL,
+               "CurlCurlIntegrator requires a Nedelec space");
+   PAVectorTensorSetup(fes, *ir, Q, pa_maps, PA_CURL, pa_data);
+}
+
+void CurlCurlIntegrator::AddMultPA(const Vector &x, Vector &y) const
+{
+   if (ne == 0) { return; }
+   MFEM_ASSERT(pa_maps.dof_map, "AssemblePA() has not been called");
+   PAVectorTensorApply(pa_maps, PA_CURL, ne, pa_data, x, y);
+}
+
+void CurlCurlIntegrator::AssembleDiagonalPA(Vector &diag) const
+{
+   if (ne == 0) { return; }
+   MFEM_ASSERT(pa_maps.dof_map, "AssemblePA() has not been called");
+   PAVectorTensorDiagonal(pa_maps, PA_CURL, ne, pa_data, diag);
+}
+
+void DivDivIntegrator::AssemblePA(const FiniteElementSpace &fes)
+{
+   ne = fes.GetNE();
+   if (ne == 0) { return; }
+
+   const FiniteElement &el = *fes.GetFE(0);
+   const IntegrationRule *ir = IntRule;
+   if (ir == NULL)
+   {
+      // Same rule as in AssembleElementMatrix()
+      ir = &IntRules.Get(el.GetGeomType(), 2*el.GetOrder() - 2);
+   }
+   PAVectorTensorInit(fes, ir, pa_maps);
+   MFEM_VERIFY(pa_maps.map_type == FiniteElement::H_DIV,
+               "DivDivIntegrator requires a Raviart-Thomas space");
+   PAVectorTensorSetup(fes, *ir, Q, pa_maps, PA_DIV, pa_data);
+}
+
+void DivDivIntegrator::AddMultPA(const Vector &x, Vector &y) const
+{
+   if (ne == 0) { return; }
+   MFEM_ASSERT(pa_maps.dof_map, "AssemblePA() has not been called");
+   PAVectorTensorApply(pa_maps, PA_DIV, ne, pa_data, x, y);
+}
+
+void DivDivIntegrator::AssembleDiagonalPA(Vector &diag) const
+{
+   if (ne == 0) { return; }
+   MFEM_ASSERT(pa_maps.dof_map, "AssemblePA() has not been called");
+   PAVectorTensorDiagonal(pa_maps, PA_DIV, ne, pa_data, diag);
+}
+
+}
@@ -0,0 +1,578 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+// Partial assembly of MassIntegrator and VectorMassIntegrator
+
+#include "fem.hpp"
+
+namespace mfem
+{
+
+// Compute the quadrature-point data of the mass operator, w_q coeff det(J),
+// for all elements of the space.
+static void PAMassSetup(const FiniteElementSpace &fes,
+                        const IntegrationRule &ir, Coefficient *Q,
+                        Vector &op)
+{
+   Mesh *mesh = fes.GetMesh();
+   const int NE = fes.GetNE();
+   const int NQ = ir.GetNPoints();
+   const GeometricFactors *geom =
+      mesh->GetGeometricFactors(ir, GeometricFactors::DETERMINANTS);
+   ConstantCoefficient *cQ = dynamic_cast<ConstantCoefficient*>(Q);
+   Vector Q_ir(NQ);
+   Q_ir = cQ ? cQ->constant : 1.0;
+   op.SetSize(NE*NQ);
+   for (int e = 0; e < NE; e++)
+   {
+      // Only needed to evaluate a non-constant coefficient
+      if (Q && !cQ) { Q->Eval(Q_ir, *mesh->GetElementTransformation(e), ir); }
+      for (int q = 0; q < NQ; q++)
+      {
+         const IntegrationPoint &ip = ir.IntPoint(q);
+         op(q+NQ*e) = ip.weight * geom->detJ(q+NQ*e) * Q_ir(q);
+      }
+   }
+}
+
+static const DofToQuad &PAMassMaps(const FiniteElement &el,
+                                   const IntegrationRule &ir)
+{
+   const bool tensor = dynamic_cast<const TensorBasisElement*>(&el) != NULL;
+   const DofToQuad &maps =
+      el.GetDofToQuad(ir, tensor ? DofToQuad::TENSOR : DofToQuad::FULL);
+   MFEM_VERIFY(!tensor || (maps.ndof <= MAX_D1D && maps.nqpt <= MAX_Q1D),
+               "order too high for the tensor partial assembly kernels");
+   return maps;
+}
+
+void MassIntegrator::AssemblePA(const FiniteElementSpace &fes)
+{
+   Mesh *mesh = fes.GetMesh();
+   ne = fes.GetNE();
+   dim = mesh->Dimension();
+   MFEM_VERIFY(fes.GetVDim() == 1, "vector spaces are not supported");
+   if (ne == 0) { return; }
+
+   const FiniteElement &el = *fes.GetFE(0);
+   ElementTransformation &T0 = *mesh->GetElementTransformation(0);
+   const IntegrationRule *ir = IntRule ? IntRule : &GetRule(el, T0);
+   maps = &PAMassMaps(el, *ir);
+   nq = ir->GetNPoints();
+   dofs1D = maps->ndof;
+   quad1D = maps->nqpt;
+   PAMassSetup(fes, *ir, Q, pa_data);
+}
+
+// PA Mass Apply kernel, non-tensor elements. The input and output have layout
+// (ND, VDIM, NE) and the components are treated independently.
+static void PAMassApply(const int NE, const int VDIM, const Array<double> &b,
+                        const Array<double> &bt, const Vector &op,
+                        const Vector &x, Vector &y,
+                        const int ND, const int NQ)
+{
+   const double *B = b.GetData();
+   const double *Bt = bt.GetData();
+   const double *D = op.GetData();
+   const double *X = x.GetData();
+   double *Y = y.GetData();
+   Vector vals(NQ);
+   for (int ec = 0; ec < NE*VDIM; ec++)
+   {
+      const int e = ec/VDIM;
+      const double *Xe = X + ND*ec;
+      double *Ye = Y + ND*ec;
+      for (int q = 0; q < NQ; q++)
+      {
+         double u = 0.0;
+         for (int d = 0; d < ND; d++)
+         {
+            u += B[q+NQ*d]*Xe[d];
+         }
+         vals(q) = u*D[q+NQ*e];
+      }
+      for (int d = 0; d < ND; d++)
+      {
+         double v = 0.0;
+         for (int q = 0; q < NQ; q++)
+         {
+            v += Bt[d+ND*q]*vals(q);
+         }
+         Ye[d] += v;
+      }
+   }
+}
+
+// PA Mass Apply 2D kernel
+static void PAMassApply2D(const int NE, const int VDIM,
+                          const Array<double> &b,
+                          const Array<double> &bt, const Vector &op,
+                          const Vector &x, Vector &y,
+                          const int D1D, const int Q1D)
+{
+   const double *B = b.GetData();
+   const double *Bt = bt.GetData();
+   const double *D = op.GetData();
+   const double *X = x.GetData();
+   double *Y = y.GetData();
+#ifdef MFEM_USE_OPENMP
+   #pragma omp parallel for
+#endif
+   for (int ec = 0; ec < NE*VDIM; ec++)
+   {
+      const int e = ec/VDIM;
+      const double *Xe = X + D1D*D1D*ec;
+      double *Ye = Y + D1D*D1D*ec;
+      const double *De = D + Q1D*Q1D*e;
+      double sol_xy[MAX_Q1D][MAX_Q1D];
+      for (int qy = 0; qy < Q1D; ++qy)
+      {
+         for (int qx = 0; qx < Q1D; ++qx)
+         {
+            sol_xy[qy][qx] = 0.0;
+         }
+      }
+      for (int dy = 0; dy < D1D; ++dy)
+      {
+         double sol_x[MAX_Q1D];
+         for (int qx = 0; qx < Q1D; ++qx)
+         {
+            sol_x[qx] = 0.0;
+         }
+         for (int dx = 0; dx < D1D; ++dx)
+         {
+            const double s = Xe[dx+D1D*dy];
+            for (int qx = 0; qx < Q1D; ++qx)
+            {
+               sol_x[qx] += B[qx+Q1D*dx]*s;
+            }
+         }
+         for (int qy = 0; qy < Q1D; ++qy)
+         {
+            const double d2q = B[qy+Q1D*dy];
+            for (int qx = 0; qx < Q1D; ++qx)
+            {
+               sol_xy[qy][qx] += d2q*sol_x[qx];
+            }
+         }
+      }
+      for (int qy = 0; qy < Q1D; ++qy)
+      {
+         for (int qx = 0; qx < Q1D; ++qx)
+         {
+            sol_xy[qy][qx] *= De[qx+Q1D*qy];
+         }
+      }
+      for (int qy = 0; qy < Q1D; ++qy)
+      {
+         double sol_x[MAX_D1D];
+         for (int dx = 0; dx < D1D; ++dx)
+         {
+            sol_x[dx] = 0.0;
+         }
+         for (int qx = 0; qx < Q1D; ++qx)
+         {
+            const double s = sol_xy[qy][qx];
+            for (int dx = 0; dx < D1D; ++dx)
+            {
+               sol_x[dx] += Bt[dx+D1D*qx]*s;
+            }
+         }
+         for (int dy = 0; dy < D1D; ++dy)
+         {
+            const double q2d = Bt[dy+D1D*qy];
+            for (int dx = 0; dx < D1D; ++dx)
+            {
+               Ye[dx+D1D*dy] += q2d*sol_x[dx];
+            }
+         }
+      }
+   }
+}
+
+// PA Mass Apply 3D kernel
+static void PAMassApply3D(const int NE, const int VDIM,
+                          const Array<double> &b,
+                          const Array<double> &bt, const Vector &op,
+                          const Vector &x, Vector &y,
+                          const int D1D, const int Q1D)
+{
+   const double *B = b.GetData();
+   const double *Bt = bt.GetData();
+   const double *D = op.GetData();
+   const double *X = x.GetData();
+   double *Y = y.GetData();
+#ifdef MFEM_USE_OPENMP
+   #pragma omp parallel for
+#endif
+   for (int ec = 0; ec < NE*VDIM; ec++)
+   {
+      const int e = ec/VDIM;
+      const double *Xe = X + D1D*D1D*D1D*ec;
+      double *Ye = Y + D1D*D1D*D1D*ec;
+      const double *De = D + Q1D*Q1D*Q1D*e;
+      double sol_xyz[MAX_Q1D][MAX_Q1D][MAX_Q1D];
+      for (int qz = 0; qz < Q1D; ++qz)
+      {
+         for (int qy = 0; qy < Q1D; ++qy)
+         {
+            for (int qx = 0; qx < Q1D; ++qx)
+            {
+               sol_xyz[qz][qy][qx] = 0.0;
+            }
+         }
+      }
+      for (int dz = 0; dz < D1D; ++dz)
+      {
+         double sol_xy[MAX_Q1D][MAX_Q1D];
+         for (int qy = 0; qy < Q1D; ++qy)
+         {
+            for (int qx = 0; qx < Q1D; ++qx)
+            {
+               sol_xy[qy][qx] = 0.0;
+            }
+         }
+         for (int dy = 0; dy < D1D; ++dy)
+         {
+            double sol_x[MAX_Q1D];
+            for (int qx = 0; qx < Q1D; ++qx)
+            {
+               sol_x[qx] = 0.0;
+            }
+            for (int dx = 0; dx < D1D; ++dx)
+            {
+               const double s = Xe[dx+D1D*(dy+D1D*dz)];
+               for (int qx = 0; qx < Q1D; ++qx)
+               {
+                  sol_x[qx] += B[qx+Q1D*dx]*s;
+               }
+            }
+            for (int qy = 0; qy < Q1D; ++qy)
+            {
+               const double wy = B[qy+Q1D*dy];
+               for (int qx = 0; qx < Q1D; ++qx)
+               {
+                  sol_xy[qy][qx] += wy*sol_x[qx];
+               }
+            }
+         }
+         for (int qz = 0; qz < Q1D; ++qz)
+         {
+            const double wz = B[qz+Q1D*dz];
+            for (int qy = 0; qy < Q1D; ++qy)
+            {
+               for (int qx = 0; qx < Q1D; ++qx)
+               {
+                  sol_xyz[qz][qy][qx] += wz*sol_xy[qy][qx];
+               }
+            }
+         }
+      }
+      for (int qz = 0; qz < Q1D; ++qz)
+      {
+         for (int qy = 0; qy < Q1D; ++qy)
+         {
+            for (int qx = 0; qx < Q1D; ++qx)
+            {
+               sol_xyz[qz][qy][qx] *= De[qx+Q1D*(qy+Q1D*qz)];
+            }
+         }
+      }
+      for (int qz = 0; qz < Q1D; ++qz)
+      {
+         double sol_xy[MAX_D1D][MAX_D1D];
+         for (int dy = 0; dy < D1D; ++dy)
+         {
+            for (int dx = 0; dx < D1D; ++dx)
+            {
+               sol_xy[dy][dx] = 0.0;
+            }
+         }
+         for (int qy = 0; qy < Q1D; ++qy)
+         {
+            double sol_x[MAX_D1D];
+            for (int dx = 0; dx < D1D; ++dx)
+            {
+               sol_x[dx] = 0.0;
+            }
+            for (int qx = 0; qx < Q1D; ++qx)
+            {
+               const double s = sol_xyz[qz][qy][qx];
+               for (int dx = 0; dx < D1D; ++dx)
+               {
+                  sol_x[dx] += Bt[dx+D1D*qx]*s;
+               }
+            }
+            for (int dy = 0; dy < D1D; ++dy)
+            {
+               const double wy = Bt[dy+D1D*qy];
+               for (int dx = 0; dx < D1D; ++dx)
+               {
+                  sol_xy[dy][dx] += wy*sol_x[dx];
+               }
+            }
+         }
+         for (int dz = 0; dz < D1D; ++dz)
+         {
+            const double wz = Bt[dz+D1D*qz];
+            for (int dy = 0; dy < D1D; ++dy)
+            {
+               for (int dx = 0; dx < D1D; ++dx)
+               {
+                  Ye[dx+D1D*(dy+D1D*dz)] += wz*sol_xy[dy][dx];
+               }
+            }
+         }
+      }
+   }
+}
+
+static void PAMassApply(const int dim, const int NE, const int VDIM,
+                        const DofToQuad &maps, const Vector &op,
+                        const Vector &x, Vector &y)
+{
+   if (maps.mode == DofToQuad::FULL || dim == 1)
+   {
+      // In 1D, the tensor maps coincide with the full maps.
+      PAMassApply(NE, VDIM, maps.B, maps.Bt, op, x, y, maps.ndof, maps.nqpt);
+   }
+   else if (dim == 2)
+   {
+      PAMassApply2D(NE, VDIM, maps.B, maps.Bt, op, x, y,
+                    maps.ndof, maps.nqpt);
+   }
+   else if (dim == 3)
+   {
+      PAMassApply3D(NE, VDIM, maps.B, maps.Bt, op, x, y,
+                    maps.ndof, maps.nqpt);
+   }
+   else
+   {
+      MFEM_ABORT("dimension " << dim << " is not supported");
+   }
+}
+
+// PA Mass Diagonal kernel, non-tensor elements: the diagonal of the element
+// matrices, sum_q B(q,d)^2 D(q), added to all VDIM components.
+static void PAMassDiagonal(const int NE, const int VDIM,
+                           const Array<double> &b, const Vector &op,
+                           Vector &y, const int ND, const int NQ)
+{
+   const double *B = b.GetData();
+   const double *D = op.GetData();
+   double *Y = y.GetData();
+   for (int e = 0; e < NE; e++)
+   {
+      for (int d = 0; d < ND; d++)
+      {
+         double s = 0.0;
+         for (int q = 0; q < NQ; q++)
+         {
+            s += B[q+NQ*d]*B[q+NQ*d]*D[q+NQ*e];
+         }
+         for (int c = 0; c < VDIM; c++)
+         {
+            Y[d+ND*(c+VDIM*e)] += s;
+         }
+      }
+   }
+}
+
+// PA Mass Diagonal 2D kernel
+static void PAMassDiagonal2D(const int NE, const int VDIM,
+                             const Array<double> &b, const Vector &op,
+                             Vector &y, const int D1D, const int Q1D)
+{
+   const double *B = b.GetData();
+   const double *D = op.GetData();
+   double *Y = y.GetData();
+   double B2[MAX_Q1D*MAX_D1D];
+   for (int i = 0; i < Q1D*D1D; i++) { B2[i] = B[i]*B[i]; }
+#ifdef MFEM_USE_OPENMP
+   #pragma omp parallel for
+#endif
+   for (int e = 0; e < NE; e++)
+   {
+      const double *De = D + Q1D*Q1D*e;
+      double temp[MAX_Q1D][MAX_D1D];
+      for (int qy = 0; qy < Q1D; ++qy)
+      {
+         for (int dx = 0; dx < D1D; ++dx)
+         {
+            double s = 0.0;
+            for (int qx = 0; qx < Q1D; ++qx)
+            {
+               s += B2[qx+Q1D*dx]*De[qx+Q1D*qy];
+            }
+            temp[qy][dx] = s;
+         }
+      }
+      for (int dy = 0; dy < D1D; ++dy)
+      {
+         for (int dx = 0; dx < D1D; ++dx)
+         {
+            double s = 0.0;
+            for (int qy = 0; qy < Q1D; ++qy)
+            {
+               s += B2[qy+Q1D*dy]*temp[qy][dx];
+            }
+            for (int c = 0; c < VDIM; c++)
+            {
+               Y[dx+D1D*(dy+D1D*(c+VDIM*e))] += s;
+            }
+         }
+      }
+   }
+}
+
+// PA Mass Diagonal 3D kernel
+static void PAMassDiagonal3D(const int NE, const int VDIM,
+                             const Array<double> &b, const Vector &op,
+                             Vector &y, const int D1D, const int Q1D)
+{
+   const double *B = b.GetData();
+   const double *D = op.GetData();
+   double *Y = y.GetData();
+   double B2[MAX_Q1D*MAX_D1D];
+   for (int i = 0; i < Q1D*D1D; i++) { B2[i] = B[i]*B[i]; }
+#ifdef MFEM_USE_OPENMP
+   #pragma omp parallel for
+#endif
+   for (int e = 0; e < NE; e++)
+   {
+      const double *De = D + Q1D*Q1D*Q1D*e;
+      double temp_x[MAX_Q1D][MAX_Q1D][MAX_D1D];
+      double temp_xy[MAX_Q1D][MAX_D1D][MAX_D1D];
+      for (int qz = 0; qz < Q1D; ++qz)
+      {
+         for (int qy = 0; qy < Q1D; ++qy)
+         {
+            for (int dx = 0; dx < D1D; ++dx)
+            {
+               double s = 0.0;
+               for (int qx = 0; qx < Q1D; ++qx)
+               {
+                  s += B2[qx+Q1D*dx]*De[qx+Q1D*(qy+Q1D*qz)];
+               }
+               temp_x[qz][qy][dx] = s;
+            }
+         }
+         for (int dy = 0; dy < D1D; ++dy)
+         {
+            for (int dx = 0; dx < D1D; ++dx)
+            {
+               double s = 0.0;
+               for (int qy = 0; qy < Q1D; ++qy)
+               {
+                  s += B2[qy+Q1D*dy]*temp_x[qz][qy][dx];
+               }
+               temp_xy[qz][dy][dx] = s;
+            }
+         }
+      }
+      for (int dz = 0; dz < D1D; ++dz)
+      {
+         for (int dy = 0; dy < D1D; ++dy)
+         {
+            for (int dx = 0; dx < D1D; ++dx)
+            {
+               double s = 0.0;
+               for (int qz = 0; qz < Q1D; ++qz)
+               {
+                  s += B2[qz+Q1D*dz]*temp_xy[qz][dy][dx];
+               }
+               for (int c = 0; c < VDIM; c++)
+               {
+                  Y[dx+D1D*(dy+D1D*(dz+D1D*(c+VDIM*e)))] += s;
+               }
+            }
+         }
+      }
+   }
+}
+
+static void PAMassDiagonal(const int dim, const int NE, const int VDIM,
+                           const DofToQuad &maps, const Vector &op, Vector &y)
+{
+   if (maps.mode == DofToQuad::FULL || dim == 1)
+   {
+      PAMassDiagonal(NE, VDIM, maps.B, op, y, maps.ndof, maps.nqpt);
+   }
+   else if (dim == 2)
+   {
+      PAMassDiagonal2D(NE, VDIM, maps.B, op, y, maps.ndof, maps.nqpt);
+   }
+   else if (dim == 3)
+   {
+      PAMassDiagonal3D(NE, VDIM, maps.B, op, y, maps.ndof, maps.nqpt);
+   }
+   else
+   {
+      MFEM_ABORT("dimension " << dim << " is not supported");
+   }
+}
+
+void MassIntegrator::AddMultPA(const Vector &x, Vector &y) const
+{
+   MFEM_ASSERT(maps || ne == 0, "AssemblePA() has not been called");
+   if (ne == 0) { return; }
+   PAMassApply(dim, ne, 1, *maps, pa_data, x, y);
+}
+
+void MassIntegrator::AssembleDiagonalPA(Vector &diag) const
+{
+   MFEM_ASSERT(maps || ne == 0, "AssemblePA() has not been called");
+   if (ne == 0) { return; }
+   PAMassDiagonal(dim, ne, 1, *maps, pa_data, diag);
+}
+
+void VectorMassIntegrator::AssemblePA(const FiniteElementSpace &fes)
+{
+   MFEM_VERIFY(VQ == NULL && MQ == NULL,
+               "only scalar coefficients are supported");
+   Mesh *mesh = fes.GetMesh();
+   ne = fes.GetNE();
+   dim = mesh->Dimension();
+   vdim = (vdim == -1) ? mesh->SpaceDimension() : vdim;
+   MFEM_VERIFY(fes.GetVDim() == vdim,
+               "the vector dimension of the space must be " << vdim);
+   if (ne == 0) { return; }
+
+   const FiniteElement &el = *fes.GetFE(0);
+   const IntegrationRule *ir = IntRule;
+   if (ir == NULL)
+   {
+      // Same rule as in AssembleElementMatrix()
+      ElementTransformation &T0 = *mesh->GetElementTransformation(0);
+      int order = 2 * el.GetOrder() + T0.OrderW() + Q_order;
+      ir = (el.Space() == FunctionSpace::rQk) ?
+           &RefinedIntRules.Get(el.GetGeomType(), order) :
+           &IntRules.Get(el.GetGeomType(), order);
+   }
+   maps = &PAMassMaps(el, *ir);
+   PAMassSetup(fes, *ir, Q, pa_data);
+}
+
+void VectorMassIntegrator::AddMultPA(const Vector &x, Vector &y) const
+{
+   MFEM_ASSERT(maps || ne == 0, "AssemblePA() has not been called");
+   if (ne == 0) { return; }
+   PAMassApply(dim, ne, vdim, *maps, pa_data, x, y);
+}
+
+void VectorMassIntegrator::AssembleDiagonalPA(Vector &diag) const
+{
+   MFEM_ASSERT(maps || ne == 0, "AssemblePA() has not been called");
+   if (ne == 0) { return; }
+   PAMassDiagonal(dim, ne, vdim, *maps, pa_data, diag);
+}
+
+}
@@ -21,6 +21,18 @@ namespace mfem
 
 using namespace std;
 
+void Coefficient::Eval(Vector &V, ElementTransformation &T,
+                       const IntegrationRule &ir)
+{
+   V.SetSize(ir.GetNPoints());
+   for (int i = 0; i < ir.GetNPoints(); i++)
+   {
+      const IntegrationPoint &ip = ir.IntPoint(i);
+      T.SetIntPoint(&ip);
+      V(i) = Eval(T, ip);
+   }
+}
+
 double PWConstCoefficient::Eval(ElementTransformation & T,
                                 const IntegrationPoint & ip)
 {
@@ -277,6 +289,18 @@ void VectorRestrictedCoefficient::Eval(
    }
 }
 
+void MatrixCoefficient::Eval(DenseTensor &M, ElementTransformation &T,
+                             const IntegrationRule &ir)
+{
+   M.SetSize(height, width, ir.GetNPoints());
+   for (int i = 0; i < ir.GetNPoints(); i++)
+   {
+      const IntegrationPoint &ip = ir.IntPoint(i);
+      T.SetIntPoint(&ip);
+      Eval(M(i), T, ip);
+   }
+}
+
 void MatrixFunctionCoefficient::Eval(DenseMatrix &K, ElementTransformation &T,
                                      const IntegrationPoint &ip)
 {
@@ -564,6 +588,187 @@ void OuterProductCoefficient::Eval(DenseMatrix &M, ElementTransformation &T,
    }
 }
 
+QuadratureFunctionCoefficient::QuadratureFunctionCoefficient(
+   QuadratureFunction &qf_) : qf(qf_)
+{
+   MFEM_VERIFY(qf.GetVDim() == 1, "the QuadratureFunction must be scalar");
+}
+
+const IntegrationRule &QuadratureFunctionCoefficient::GetIntRule(int idx) const
+{
+   return qf.GetSpace()->GetElementIntRule(idx);
+}
+
+double QuadratureFunctionCoefficient::Eval(ElementTransformation &T,
+                                           const IntegrationPoint &ip)
+{
+   const IntegrationRule &ir = GetIntRule(T.ElementNo);
+   const int nq = ir.GetNPoints();
+   const IntegrationPoint *points = ir.GetData();
+   int i;
+   if (points <= &ip && &ip < points + nq)
+   {
+      // The point belongs to the rule of the QuadratureSpace
+      i = (int)(&ip - points);
+   }
+   else
+   {
+      // Compare only the coordinates of the reference element
+      const int dim = T.GetDimension();
+      for (i = 0; i < nq; i++)
+      {
+         const IntegrationPoint &ipi = points[i];
+         if (ipi.x == ip.x && (dim < 2 || ipi.y == ip.y) &&
+             (dim < 3 || ipi.z == ip.z)) { break; }
+      }
+      MFEM_VERIFY(i < nq, "the point is not in the QuadratureSpace");
+   }
+   Vector values; // a reference to the data of qf
+   qf.GetElementValues(T.ElementNo, values);
+   return values(i);
+}
+
+void QuadratureFunctionCoefficient::Eval(Vector &V, ElementTransformation &T,
+                                         const IntegrationRule &ir)
+{
+   MFEM_VERIFY(ir.GetNPoints() == GetIntRule(T.ElementNo).GetNPoints(),
+               "the IntegrationRule does not match the QuadratureSpace");
+   const QuadratureFunction &cqf = qf;
+   cqf.GetElementValues(T.ElementNo, V);
+}
+
+struct CoefficientCache::Entry
+{
+   // The rules are identified by their geometry, points and weights
+   Geometry::Type geom;
+   IntegrationRule ir; // copy of the rule
+   Vector values;
+   Array<int> ready; // per element flag: 1 if the values have been computed
+};
+
+CoefficientCache::CoefficientCache(Mesh &mesh_, int vsize_)
+   : mesh(&mesh_), sequence(mesh_.GetSequence()), vsize(vsize_) { }
+
+void CoefficientCache::Clear()
+{
+   published.Clear();
+   for (int i = 0; i < entries.Size(); i++) { delete entries[i]; }
+   entries.SetSize(0);
+#ifdef MFEM_USE_OPENMP
+   #pragma omp flush
+   #pragma omp atomic write
+#endif
+   sequence = mesh->GetSequence();
+}
+
+CoefficientCache::Entry *CoefficientCache::FindEntry(
+   Geometry::Type geom, const IntegrationRule &ir) const
+{
+   const int dim = mesh->Dimension();
+   Entry *entry;
+   for (int i = 0; (entry = published.Get(i)) != NULL; i++)
+   {
+      if (entry->geom == geom && entry->ir.SameAs(ir, dim)) { return entry; }
+   }
+   return NULL;
+}
+
+double *CoefficientCache::GetValues(ElementTransformation &T,
+                                    const IntegrationRule &ir, int *&ready)
+{
+   const int NE = mesh->GetNE();
+   if (T.mesh != mesh || T.GetDimension() != mesh->Dimension() ||
+       T.ElementNo < 0 || T.ElementNo >= NE)
+   {
+      return NULL;
+   }
+
+   long seq;
+#ifdef MFEM_USE_OPENMP
+   #pragma omp atomic read
+#endif
+   seq = sequence;
+#ifdef MFEM_USE_OPENMP
+   #pragma omp flush
+#endif
+   if (seq != mesh->GetSequence())
+   {
+      // The mesh has changed since the values were cached. This happens on
+      // the first call of an assembly, not while other threads use the cache.
+#ifdef MFEM_USE_OPENMP
+      #pragma omp critical (CoefficientCache)
+#endif
+      {
+         if (sequence != mesh->GetSequence()) { Clear(); }
+      }
+   }
+
+   const int e = T.ElementNo, nq = ir.GetNPoints();
+   const Geometry::Type geom = mesh->GetElementBaseGeometry(e);
+   // Search without locking first
+   Entry *entry = FindEntry(geom, ir);
+   if (entry == NULL)
+   {
+#ifdef MFEM_USE_OPENMP
+      #pragma omp critical (CoefficientCache)
+#endif
+      {
+         entry = FindEntry(geom, ir);
+         if (entry == NULL)
+         {
+            entry = new Entry;
+            entry->geom = geom;
+            entry->ir = ir;
+            entry->values.SetSize(vsize*nq*NE);
+            entry->ready.SetSize(NE);
+            entry->ready = 0;
+            entries.Append(entry);
+            published.Publish(entries);
+         }
+      }
+   }
+   ready = &entry->ready[e];
+   return entry->values.GetData() + vsize*nq*e;
+}
+
+void CachedCoefficient::Eval(Vector &V, ElementTransformation &T,
+                             const IntegrationRule &ir)
+{
+   int *ready;
+   double *values = cache.GetValues(T, ir, ready);
+   if (values == NULL) { Q.Eval(V, T, ir); return; }
+
+   const int nq = ir.GetNPoints();
+   if (!*ready)
+   {
+      Q.Eval(V, T, ir);
+      for (int i = 0; i < nq; i++) { values[i] = V(i); }
+      *ready = 1;
+      return;
+   }
+   V.SetSize(nq);
+   for (int i = 0; i < nq; i++) { V(i) = values[i]; }
+}
+
+void CachedMatrixCoefficient::Eval(DenseTensor &M, ElementTransformation &T,
+                                   const IntegrationRule &ir)
+{
+   int *ready;
+   double *values = cache.GetValues(T, ir, ready);
+   if (values == NULL) { MQ.Eval(M, T, ir); return; }
+
+   const int size = height*width*ir.GetNPoints();
+   if (!*ready)
+   {
+      MQ.Eval(M, T, ir);
+      for (int i = 0; i < size; i++) { values[i] = M.Data()[i]; }
+      *ready = 1;
+      return;
+   }
+   M.SetSize(height, width, ir.GetNPoints());
+   for (int i = 0; i < size; i++) { M.Data()[i] = values[i]; }
+}
+
 double LpNormLoop(double p, Coefficient &coeff, Mesh &mesh,
                   const IntegrationRule *irs[])
 {
@@ -21,6 +21,7 @@ namespace mfem
 {
 
 class Mesh;
+class QuadratureFunction;
 
 #ifdef MFEM_USE_MPI
 class ParMesh;
@@ -59,6 +60,21 @@ public:
       return Eval(T, ip);
    }
 
+   /** @brief Evaluate the coefficient in the element described by @a T at all
+       points of @a ir, storing the result in @a V. */
+   /** The size of @a V is set to ir.GetNPoints() by this method.
+
+       The general implementation provided by the base class (using the Eval
+       method for one IntegrationPoint at a time) can be overloaded for more
+       efficient implementation, see e.g. QuadratureFunctionCoefficient and
+       CachedCoefficient.
+
+       @note The IntegrationPoint associated with @a T is not used, and this
+       method will generally modify this IntegrationPoint associated with @a T.
+   */
+   virtual void Eval(Vector &V, ElementTransformation &T,
+                     const IntegrationRule &ir);
+
    virtual ~Coefficient() { }
 };
 
@@ -76,6 +92,10 @@ public:
    virtual double Eval(ElementTransformation &T,
                        const IntegrationPoint &ip)
    { return (constant); }
+
+   virtual void Eval(Vector &V, ElementTransformation &T,
+                     const IntegrationRule &ir)
+   { V.SetSize(ir.GetNPoints()); V = constant; }
 };
 
 /// class for piecewise constant coefficient
@@ -562,6 +582,21 @@ public:
    virtual void Eval(DenseMatrix &K, ElementTransformation &T,
                      const IntegrationPoint &ip) = 0;
 
+   /** @brief Evaluate the matrix coefficient in the element described by @a T
+       at all points of @a ir, storing the result in @a M. */
+   /** The dimensions of @a M are set to GetHeight() by GetWidth() by
+       ir.GetNPoints() by this method, and M(i) is the value at ir.IntPoint(i).
+
+       The general implementation provided by the base class (using the Eval
+       method for one IntegrationPoint at a time) can be overloaded for more
+       efficient implementation, see e.g. CachedMatrixCoefficient.
+
+       @note The IntegrationPoint associated with @a T is not used, and this
+       method will generally modify this IntegrationPoint associated with @a T.
+   */
+   virtual void Eval(DenseTensor &M, ElementTransformation &T,
+                     const IntegrationRule &ir);
+
    virtual ~MatrixCoefficient() { }
 };
 
@@ -933,6 +968,135 @@ public:
                      const IntegrationPoint &ip);
 };
 
+/// Coefficient defined by the values of a scalar QuadratureFunction.
+/** The coefficient can only be evaluated at the points of the QuadratureSpace
+    of the QuadratureFunction, so the integrators using it must use the same
+    IntegrationRule%s, e.g. by calling SetIntRule() with GetIntRule(). The
+    evaluation on all points of an element with the bulk Eval() method, which
+    the domain integrators use, copies the values of the element from the
+    QuadratureFunction. */
+class QuadratureFunctionCoefficient : public Coefficient
+{
+private:
+   QuadratureFunction &qf;
+
+public:
+   QuadratureFunctionCoefficient(QuadratureFunction &qf_);
+
+   QuadratureFunction &GetQuadFunction() const { return qf; }
+
+   /// Return the IntegrationRule of the QuadratureSpace on element @a idx.
+   const IntegrationRule &GetIntRule(int idx = 0) const;
+
+   /** @brief Evaluate at the point @a ip, which must be one of the points of
+       the IntegrationRule of the element. */
+   virtual double Eval(ElementTransformation &T,
+                       const IntegrationPoint &ip);
+
+   virtual void Eval(Vector &V, ElementTransformation &T,
+                     const IntegrationRule &ir);
+};
+
+/** @brief Storage for the values of a coefficient at the points of the
+    IntegrationRule%s used on the elements of a Mesh, see CachedCoefficient and
+    CachedMatrixCoefficient. */
+class CoefficientCache
+{
+private:
+   struct Entry;
+
+   Mesh *mesh;
+   long sequence;
+   int vsize;
+   Array<Entry *> entries;
+   /// Copy of #entries that is searched without locking.
+   PublishedArray<Entry> published;
+
+   /// Return the entry of the rule @a ir on elements of type @a geom, or NULL.
+   Entry *FindEntry(Geometry::Type geom, const IntegrationRule &ir) const;
+
+public:
+   /// Cache @a vsize values per point on the elements of @a mesh.
+   CoefficientCache(Mesh &mesh_, int vsize_);
+
+   /// Remove all cached values. Must not be called concurrently with
+   /// GetValues().
+   void Clear();
+
+   /** @brief Return the storage for the values at the points of @a ir on the
+       element described by @a T, or NULL if @a T is not an element
+       transformation of the mesh. */
+   /** The storage has size vsize*ir.GetNPoints(). The rules are identified by
+       their geometry, points and weights, see IntegrationRule::SameAs(). If
+       *@a ready is zero on return, the values have not been computed yet: the
+       caller must set them, and then set *@a ready to one. The cache is
+       cleared automatically when Mesh::GetSequence() changes. This method can
+       be called by several threads, as long as they work on different
+       elements; only the creation of the storage for a new rule is
+       serialized. */
+   double *GetValues(ElementTransformation &T, const IntegrationRule &ir,
+                     int *&ready);
+
+   ~CoefficientCache() { Clear(); }
+};
+
+/** @brief Coefficient that caches the values of a time- and state-independent
+    Coefficient at the quadrature points of the mesh elements. */
+/** The values are computed the first time the bulk Eval() method is called on
+    an element with a given IntegrationRule and are then copied from contiguous
+    storage, e.g. when the forms of a time-dependent problem are assembled
+    repeatedly. Call Reset() when the wrapped coefficient or the mesh nodes
+    change; a refinement of the mesh resets the cache automatically. The
+    evaluation at a single IntegrationPoint, and on boundary elements or faces,
+    is forwarded to the wrapped coefficient. */
+class CachedCoefficient : public Coefficient
+{
+private:
+   Coefficient &Q;
+   CoefficientCache cache;
+
+public:
+   /// Cache the values of @a q on the elements of @a mesh.
+   CachedCoefficient(Coefficient &q, Mesh &mesh)
+      : Q(q), cache(mesh, 1) { }
+
+   /// Remove the cached values; they will be recomputed on the next Eval().
+   void Reset() { cache.Clear(); }
+
+   virtual double Eval(ElementTransformation &T,
+                       const IntegrationPoint &ip)
+   { return Q.Eval(T, ip); }
+
+   virtual void Eval(Vector &V, ElementTransformation &T,
+                     const IntegrationRule &ir);
+};
+
+/** @brief MatrixCoefficient that caches the values of a time- and
+    state-independent MatrixCoefficient at the quadrature points of the mesh
+    elements, see CachedCoefficient. */
+class CachedMatrixCoefficient : public MatrixCoefficient
+{
+private:
+   MatrixCoefficient &MQ;
+   CoefficientCache cache;
+
+public:
+   /// Cache the values of @a mq on the elements of @a mesh.
+   CachedMatrixCoefficient(MatrixCoefficient &mq, Mesh &mesh)
+      : MatrixCoefficient(mq.GetHeight(), mq.GetWidth()), MQ(mq),
+        cache(mesh, mq.GetHeight()*mq.GetWidth()) { }
+
+   /// Remove the cached values; they will be recomputed on the next Eval().
+   void Reset() { cache.Clear(); }
+
+   virtual void Eval(DenseMatrix &K, ElementTransformation &T,
+                     const IntegrationPoint &ip)
+   { MQ.Eval(K, T, ip); }
+
+   virtual void Eval(DenseTensor &M, ElementTransformation &T,
+                     const IntegrationRule &ir);
+};
+
 /** Compute the Lp norm of a function f.
     \f$ \| f \|_{Lp} = ( \int_\Omega | f |^p d\Omega)^{1/p} \f$ */
 double ComputeLpNorm(double p, Coefficient &coeff, Mesh &mesh,
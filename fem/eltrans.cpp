@@ -20,7 +20,8 @@ ElementTransformation::ElementTransformation()
    : IntPoint(static_cast<IntegrationPoint *>(NULL)),
      EvalState(0),
      Attribute(-1),
-     ElementNo(-1)
+     ElementNo(-1),
+     mesh(NULL)
 { }
 
 double ElementTransformation::EvalWeight()
@@ -325,6 +326,14 @@ int InverseElementTransformation::Transform(const Vector &pt,
 {
    MFEM_VERIFY(T != NULL, "invalid ElementTransformation");
 
+   // The points outside of the box of the element are outside of it
+   if (bbox_tree && T->mesh == bbox_tree->GetMesh() &&
+       T->GetDimension() == T->mesh->Dimension() && bbox_tree->IsUpToDate() &&
+       !bbox_tree->ElementBoxContains(T->ElementNo, pt.GetData()))
+   {
+      return Outside;
+   }
+
    // Select initial guess ...
    switch (init_guess_type)
    {
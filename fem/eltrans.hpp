@@ -20,6 +20,9 @@
 namespace mfem
 {
 
+class Mesh;
+class BoundingBoxTree;
+
 class ElementTransformation
 {
 protected:
@@ -47,6 +50,8 @@ protected:
 
 public:
    int Attribute, ElementNo;
+   /// The Mesh that set the transformation, or NULL.
+   const Mesh *mesh;
 
    ElementTransformation();
 
@@ -165,6 +170,7 @@ protected:
    double phys_rtol; // physical space tolerance (relative)
    double ip_tol; // tolerance for checking if a point is inside the ref. elem.
    int print_level;
+   const BoundingBoxTree *bbox_tree; // for the early rejection. Not owned.
 
    void NewtonPrint(int mode, double val);
    void NewtonPrintPoint(const char *prefix, const Vector &pt,
@@ -207,7 +213,8 @@ public:
         ref_tol(1e-15),
         phys_rtol(1e-15),
         ip_tol(1e-8),
-        print_level(-1)
+        print_level(-1),
+        bbox_tree(NULL)
    { }
 
    virtual ~InverseElementTransformation() { }
@@ -257,6 +264,16 @@ public:
        and 3 - print every iteration including point coordinates. */
    void SetPrintLevel(int pr_level) { print_level = pr_level; }
 
+   /** @brief Use the element boxes of @a tree to reject the points outside of
+       the elements of its mesh without solving for their reference
+       coordinates, or disable the check (@a tree = NULL, the default). */
+   /** Transform() returns #Outside for a point outside of the box of the
+       element, see BoundingBoxTree::ElementBoxContains(). The check applies to
+       the element transformations of the mesh of the tree, while the tree is
+       up to date with the mesh, see Mesh::GetBoundingBoxTree(). The tree is
+       not owned. */
+   void SetBoundingBoxTree(const BoundingBoxTree *tree) { bbox_tree = tree; }
+
    /** @brief Find the IntegrationPoint mapped closest to @a pt. */
    /** This function uses the given IntegrationRule, @a ir, maps its points to
        physical space and finds the one that is closest to the point @a pt.
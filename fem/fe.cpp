@@ -182,6 +182,163 @@ void FiniteElement::ProjectDiv(
               "this element!");
 }
 
+void DofToQuad::GetShape(int q, Vector &shape) const
+{
+   MFEM_ASSERT(mode == FULL && B.Size() == nqpt*ndof, "invalid DofToQuad");
+   shape.SetSize(ndof);
+   const double *bt = Bt.GetData() + ndof*q;
+   for (int j = 0; j < ndof; j++)
+   {
+      shape(j) = bt[j];
+   }
+}
+
+void DofToQuad::GetDShape(int q, DenseMatrix &dshape) const
+{
+   const int dim = FE->GetDim();
+   MFEM_ASSERT(mode == FULL && G.Size() == nqpt*dim*ndof, "invalid DofToQuad");
+   dshape.SetSize(ndof, dim);
+   for (int d = 0; d < dim; d++)
+   {
+      const double *gt = Gt.GetData() + ndof*(q + nqpt*d);
+      double *ds = dshape.GetColumn(d);
+      for (int j = 0; j < ndof; j++)
+      {
+         ds[j] = gt[j];
+      }
+   }
+}
+
+void DofToQuad::GetVShape(int q, DenseMatrix &vshape) const
+{
+   const int dim = FE->GetDim();
+   MFEM_ASSERT(mode == FULL && B.Size() == nqpt*dim*ndof, "invalid DofToQuad");
+   vshape.SetSize(ndof, dim);
+   for (int d = 0; d < dim; d++)
+   {
+      const double *bt = Bt.GetData() + ndof*(q + nqpt*d);
+      double *vs = vshape.GetColumn(d);
+      for (int j = 0; j < ndof; j++)
+      {
+         vs[j] = bt[j];
+      }
+   }
+}
+
+// Search the DofToQuad objects of an element of dimension dim for the given
+// mode and a rule with the same points and weights as ir. The rules are
+// compared by value: a rule at the address of a deleted one may be different.
+static DofToQuad *FindDofToQuad(const PublishedArray<DofToQuad> &d2q_pub,
+                                const IntegrationRule &ir,
+                                DofToQuad::Mode mode, int dim)
+{
+   DofToQuad *d2q;
+   for (int i = 0; (d2q = d2q_pub.Get(i)) != NULL; i++)
+   {
+      if (d2q->mode == mode && d2q->IntRule->SameAs(ir, dim)) { return d2q; }
+   }
+   return NULL;
+}
+
+const DofToQuad &FiniteElement::GetDofToQuad(const IntegrationRule &ir,
+                                             DofToQuad::Mode mode) const
+{
+   MFEM_VERIFY(mode == DofToQuad::FULL, "invalid mode requested");
+
+   // The integrators call this method from several threads: search without
+   // locking first.
+   DofToQuad *d2q = FindDofToQuad(dof2quad_published, ir, mode, Dim);
+   if (d2q) { return *d2q; }
+
+#ifdef MFEM_USE_OPENMP
+   #pragma omp critical (DofToQuad)
+#endif
+   {
+      d2q = FindDofToQuad(dof2quad_published, ir, mode, Dim);
+      if (!d2q)
+      {
+         d2q = new DofToQuad;
+         d2q->int_rule = ir;
+         ComputeDofToQuad(d2q->int_rule, *d2q);
+         dof2quad_array.Append(d2q);
+         dof2quad_published.Publish(dof2quad_array);
+      }
+   }
+   return *d2q;
+}
+
+void FiniteElement::ComputeDofToQuad(const IntegrationRule &ir,
+                                     DofToQuad &d2q) const
+{
+   const int nqpt = ir.GetNPoints();
+   // Number of values per basis function and point
+   const int vdim = (RangeType == SCALAR) ? 1 : Dim;
+   d2q.FE = this;
+   d2q.IntRule = &ir;
+   d2q.mode = DofToQuad::FULL;
+   d2q.ndof = Dof;
+   d2q.nqpt = nqpt;
+   d2q.B.SetSize(nqpt*vdim*Dof);
+   d2q.Bt.SetSize(Dof*nqpt*vdim);
+   if (RangeType == SCALAR)
+   {
+      Vector shape(Dof);
+      for (int i = 0; i < nqpt; i++)
+      {
+         const IntegrationPoint &ip = ir.IntPoint(i);
+         CalcShape(ip, shape);
+         for (int j = 0; j < Dof; j++)
+         {
+            d2q.B[i+nqpt*j] = d2q.Bt[j+Dof*i] = shape(j);
+         }
+      }
+   }
+   else
+   {
+      DenseMatrix vshape(Dof, Dim);
+      for (int i = 0; i < nqpt; i++)
+      {
+         const IntegrationPoint &ip = ir.IntPoint(i);
+         CalcVShape(ip, vshape);
+         for (int d = 0; d < Dim; d++)
+         {
+            for (int j = 0; j < Dof; j++)
+            {
+               d2q.B[i+nqpt*(d+Dim*j)] = d2q.Bt[j+Dof*(i+nqpt*d)] =
+                                            vshape(j,d);
+            }
+         }
+      }
+   }
+   if (RangeType == SCALAR && DerivType == GRAD)
+   {
+      d2q.G.SetSize(nqpt*Dim*Dof);
+      d2q.Gt.SetSize(Dof*nqpt*Dim);
+      DenseMatrix dshape(Dof, Dim);
+      for (int i = 0; i < nqpt; i++)
+      {
+         const IntegrationPoint &ip = ir.IntPoint(i);
+         CalcDShape(ip, dshape);
+         for (int d = 0; d < Dim; d++)
+         {
+            for (int j = 0; j < Dof; j++)
+            {
+               d2q.G[i+nqpt*(d+Dim*j)] = d2q.Gt[j+Dof*(i+nqpt*d)] =
+                                            dshape(j,d);
+            }
+         }
+      }
+   }
+}
+
+FiniteElement::~FiniteElement()
+{
+   for (int i = 0; i < dof2quad_array.Size(); i++)
+   {
+      delete dof2quad_array[i];
+   }
+}
+
 void FiniteElement::CalcPhysShape(ElementTransformation &Trans,
                                   Vector &shape) const
 {
@@ -6787,43 +6944,79 @@ const double *Poly_1D::GetPoints(const int p, const int btype)
 
    if (qtype == Quadrature1D::Invalid) { return NULL; }
 
-   if (points_container.find(btype) == points_container.end())
-   {
-      points_container[btype] = new Array<double*>;
-   }
-   Array<double*> &pts = *points_container[btype];
-   if (pts.Size() <= p)
-   {
-      pts.SetSize(p + 1, NULL);
-   }
-   if (pts[p] == NULL)
+   // Fast path: the points exist. Published points are never modified.
+   const double *points = points_published[btype].Get(p);
+   if (points) { return points; }
+
+#ifdef MFEM_USE_OPENMP
+   #pragma omp critical (Poly_1D)
+#endif
    {
-      pts[p] = new double[p + 1];
-      quad_func.GivePolyPoints(p+1, pts[p], qtype);
+      if (points_container.find(btype) == points_container.end())
+      {
+         points_container[btype] = new Array<double*>;
+      }
+      Array<double*> &pts = *points_container[btype];
+      if (pts.Size() <= p)
+      {
+         pts.SetSize(p + 1, NULL);
+      }
+      if (pts[p] == NULL)
+      {
+         pts[p] = new double[p + 1];
+         quad_func.GivePolyPoints(p+1, pts[p], qtype);
+      }
+      points_published[btype].Publish(pts);
    }
-   return pts[p];
+   return points_published[btype].Get(p);
 }
 
 Poly_1D::Basis &Poly_1D::GetBasis(const int p, const int btype)
 {
    BasisType::Check(btype);
 
-   if ( bases_container.find(btype) == bases_container.end() )
-   {
-      // we haven't been asked for basis or points of this type yet
-      bases_container[btype] = new Array<Basis*>;
-   }
-   Array<Basis*> &bases = *bases_container[btype];
-   if (bases.Size() <= p)
+   // Fast path: the basis exists. Published bases are never modified.
+   Basis *basis = bases_published[btype].Get(p);
+   if (basis) { return *basis; }
+
+   // The points are constructed outside of the critical section below, which
+   // is not reentrant.
+   EvalType etype = (btype == BasisType::Positive) ? Positive : Barycentric;
+   const double *points = GetPoints(p, btype);
+#ifdef MFEM_USE_OPENMP
+   #pragma omp critical (Poly_1D)
+#endif
    {
-      bases.SetSize(p + 1, NULL);
+      if ( bases_container.find(btype) == bases_container.end() )
+      {
+         // we haven't been asked for basis or points of this type yet
+         bases_container[btype] = new Array<Basis*>;
+      }
+      Array<Basis*> &bases = *bases_container[btype];
+      if (bases.Size() <= p)
+      {
+         bases.SetSize(p + 1, NULL);
+      }
+      if (bases[p] == NULL)
+      {
+         bases[p] = new Basis(p, points, etype);
+      }
+      bases_published[btype].Publish(bases);
    }
-   if (bases[p] == NULL)
+   return *bases_published[btype].Get(p);
+}
+
+void Poly_1D::Precompute(const int p_max, const int btype)
+{
+   const int qtype = BasisType::GetQuadrature1D(btype);
+   // Closed points require at least two points
+   const int p_min =
+      (qtype != Quadrature1D::Invalid &&
+       Quadrature1D::CheckClosed(qtype) != Quadrature1D::Invalid) ? 1 : 0;
+   for (int p = p_min; p <= p_max; p++)
    {
-      EvalType etype = (btype == BasisType::Positive) ? Positive : Barycentric;
-      bases[p] = new Basis(p, GetPoints(p, btype), etype);
+      GetBasis(p, btype);
    }
-   return *bases[p];
 }
 
 Poly_1D::~Poly_1D()
@@ -7055,6 +7248,66 @@ TensorBasisElement::TensorBasisElement(const int dims, const int p,
 }
 
 
+const DofToQuad &TensorBasisElement::GetTensorDofToQuad(
+   const FiniteElement &fe, const IntegrationRule &ir,
+   DofToQuad::Mode mode, Array<DofToQuad*> &d2q_array,
+   PublishedArray<DofToQuad> &d2q_pub) const
+{
+   MFEM_VERIFY(mode == DofToQuad::TENSOR, "invalid mode requested");
+
+   DofToQuad *d2q = FindDofToQuad(d2q_pub, ir, mode, fe.GetDim());
+   if (d2q) { return *d2q; }
+
+#ifdef MFEM_USE_OPENMP
+   #pragma omp critical (DofToQuad)
+#endif
+   {
+      d2q = FindDofToQuad(d2q_pub, ir, mode, fe.GetDim());
+      if (!d2q)
+      {
+         d2q = new DofToQuad;
+         d2q->int_rule = ir;
+         ComputeTensorDofToQuad(fe, d2q->int_rule, *d2q);
+         d2q_array.Append(d2q);
+         d2q_pub.Publish(d2q_array);
+      }
+   }
+   return *d2q;
+}
+
+void TensorBasisElement::ComputeTensorDofToQuad(const FiniteElement &fe,
+                                                const IntegrationRule &ir,
+                                                DofToQuad &d2q) const
+{
+   const int dim = fe.GetDim();
+   const int ndof = fe.GetOrder() + 1;
+   const int nqpt = (int) floor(pow(ir.GetNPoints(), 1.0/dim) + 0.5);
+   MFEM_VERIFY(Pow(nqpt, dim) == ir.GetNPoints(),
+               "the IntegrationRule is not a tensor product rule");
+
+   d2q.FE = &fe;
+   d2q.IntRule = &ir;
+   d2q.mode = DofToQuad::TENSOR;
+   d2q.ndof = ndof;
+   d2q.nqpt = nqpt;
+   d2q.B.SetSize(nqpt*ndof);
+   d2q.Bt.SetSize(ndof*nqpt);
+   d2q.G.SetSize(nqpt*ndof);
+   d2q.Gt.SetSize(ndof*nqpt);
+   Vector val(ndof), grad(ndof);
+   for (int i = 0; i < nqpt; i++)
+   {
+      // The first 'nqpt' points in 'ir' have the same x-coordinates as those
+      // of the 1D rule.
+      basis1d.Eval(ir.IntPoint(i).x, val, grad);
+      for (int j = 0; j < ndof; j++)
+      {
+         d2q.B[i+nqpt*j] = d2q.Bt[j+ndof*i] = val(j);
+         d2q.G[i+nqpt*j] = d2q.Gt[j+ndof*i] = grad(j);
+      }
+   }
+}
+
 NodalTensorFiniteElement::NodalTensorFiniteElement(const int dims,
                                                    const int p,
                                                    const int btype,
@@ -135,6 +135,98 @@ class Coefficient;
 class VectorCoefficient;
 class MatrixCoefficient;
 class KnotVector;
+class FiniteElement;
+
+/** @brief Structure representing the matrices needed to evaluate (in reference
+    space) the values and gradients of a FiniteElement at the quadrature points
+    of a given IntegrationRule. */
+/** Objects of this type are typically created and owned by the respective
+    FiniteElement object, see FiniteElement::GetDofToQuad(). */
+class DofToQuad
+{
+public:
+   /// The FiniteElement that created and owns this object.
+   const FiniteElement *FE;
+
+   /** @brief IntegrationRule that defines the quadrature points at which the
+       basis functions of the #FE are evaluated. */
+   /** Not owned. In the objects returned by FiniteElement::GetDofToQuad(), it
+       points to #int_rule. */
+   const IntegrationRule *IntRule;
+
+   /** @brief Copy of the rule given to FiniteElement::GetDofToQuad(), which
+       may be deleted before the FiniteElement. Empty in other objects. */
+   IntegrationRule int_rule;
+
+   /// Type of data stored in the arrays #B, #Bt, #G, and #Gt.
+   enum Mode
+   {
+      /// Full multidimensional representation which does not use tensor
+      /// product structure. The ordering of the degrees of freedom is as
+      /// defined by #FE.
+      FULL,
+
+      /// Tensor product representation using 1D matrices/tensors with
+      /// dimensions using 1D number of quadrature points and degrees of
+      /// freedom. The degrees of freedom are ordered lexicographically.
+      TENSOR
+   };
+
+   /// Describes the contents of the #B, #Bt, #G, and #Gt arrays, see #Mode.
+   Mode mode;
+
+   /** @brief Number of degrees of freedom = number of basis functions. When
+       #mode is TENSOR, this is the 1D number. */
+   int ndof;
+
+   /** @brief Number of quadrature points. When #mode is TENSOR, this is the 1D
+       number. */
+   int nqpt;
+
+   /// Basis functions evaluated at quadrature points.
+   /** The storage layout is column-major with dimensions:
+       - #nqpt x #ndof, for scalar elements, or
+       - #nqpt x dim x #ndof, for vector elements (FULL mode only).
+
+       In the case of a TENSOR mode, this array represents the 1D data. */
+   Array<double> B;
+
+   /// Transpose of #B.
+   /** The storage layout is column-major with dimensions:
+       - #ndof x #nqpt, for scalar elements, or
+       - #ndof x #nqpt x dim, for vector elements. */
+   Array<double> Bt;
+
+   /** @brief Gradients of the basis functions evaluated at quadrature points.
+       Only defined for scalar elements with GRAD derivative type. */
+   /** The storage layout is column-major with dimensions:
+       - #nqpt x dim x #ndof, when #mode is FULL, or
+       - #nqpt x #ndof, when #mode is TENSOR (1D derivatives). */
+   Array<double> G;
+
+   /// Transpose of #G.
+   /** The storage layout is column-major with dimensions:
+       - #ndof x #nqpt x dim, when #mode is FULL, or
+       - #ndof x #nqpt, when #mode is TENSOR. */
+   Array<double> Gt;
+
+   /** @brief Copy the values of the basis functions at the quadrature point
+       @a q into @a shape, as FiniteElement::CalcShape() would. */
+   /** Only for scalar elements and FULL #mode. */
+   void GetShape(int q, Vector &shape) const;
+
+   /** @brief Copy the reference gradients of the basis functions at the
+       quadrature point @a q into @a dshape, as FiniteElement::CalcDShape()
+       would. */
+   /** Only for scalar elements with GRAD derivative type and FULL #mode. */
+   void GetDShape(int q, DenseMatrix &dshape) const;
+
+   /** @brief Copy the reference values of the vector basis functions at the
+       quadrature point @a q into @a vshape, as FiniteElement::CalcVShape(const
+       IntegrationPoint &, DenseMatrix &) would. */
+   /** Only for vector elements and FULL #mode. */
+   void GetVShape(int q, DenseMatrix &vshape) const;
+};
 
 /// Abstract class for Finite Elements
 class FiniteElement
@@ -152,6 +244,12 @@ protected:
 #ifndef MFEM_THREAD_SAFE
    mutable DenseMatrix vshape; // Dof x Dim
 #endif
+   /// Container for all DofToQuad objects created by the FiniteElement.
+   /** Multiple DofToQuad objects may be needed when different quadrature rules
+       or different DofToQuad::Mode are used. */
+   mutable Array<DofToQuad*> dof2quad_array;
+   /// Copy of #dof2quad_array that is searched without locking.
+   mutable PublishedArray<DofToQuad> dof2quad_published;
 
 public:
    /// Enumeration for RangeType and DerivRangeType
@@ -417,7 +515,29 @@ public:
                            ElementTransformation &Trans,
                            DenseMatrix &div) const;
 
-   virtual ~FiniteElement () { }
+   /** @brief Return a DofToQuad structure corresponding to the given
+       IntegrationRule using the given DofToQuad::Mode. */
+   /** See the documentation for DofToQuad for more details. The returned
+       object is owned by the FiniteElement and is reused in subsequent calls
+       with the same DofToQuad::Mode and a rule with the same points and
+       weights as @a ir, see IntegrationRule::SameAs(); @a ir itself is not
+       referenced after the call. */
+   virtual const DofToQuad &GetDofToQuad(const IntegrationRule &ir,
+                                         DofToQuad::Mode mode) const;
+
+   /** @brief Fill @a d2q with the DofToQuad::FULL data of this element on
+       @a ir, without storing it in the FiniteElement. */
+   /** The DofToQuad::IntRule of @a d2q is set to point to @a ir. */
+   void ComputeDofToQuad(const IntegrationRule &ir, DofToQuad &d2q) const;
+
+   /** @brief Return true if the reference basis functions are the same on all
+       elements using this FiniteElement. */
+   /** In this case the integrators evaluate the basis functions at the
+       quadrature points once, through GetDofToQuad(), instead of calling
+       CalcShape() and CalcDShape() on every element. */
+   virtual bool HasElementIndependentBasis() const { return true; }
+
+   virtual ~FiniteElement();
 
    static bool IsClosedType(int b_type)
    {
@@ -1590,6 +1710,11 @@ private:
    PointsMap points_container;
    BasisMap  bases_container;
 
+   /** @brief Copies of the containers above, indexed by BasisType, that are
+       read without locking in GetPoints() and GetBasis(). */
+   PublishedArray<double> points_published[BasisType::NumBasisTypes];
+   PublishedArray<Basis>  bases_published[BasisType::NumBasisTypes];
+
    static Array2D<int> binom;
 
    static void CalcMono(const int p, const double x, double *u);
@@ -1637,8 +1762,16 @@ public:
 
        @return A reference to an object of type Poly_1D::Basis that represents
                the requested basis type. */
+   /** GetPoints() and GetBasis() return the existing points and bases without
+       locking, so they can be called concurrently from many threads; only the
+       construction of new ones is serialized. */
    Basis &GetBasis(const int p, const int btype);
 
+   /** @brief Construct the points and the bases of the given BasisType for all
+       degrees up to @a p_max, so that later calls to GetPoints() and
+       GetBasis() do not need to construct them. */
+   void Precompute(const int p_max, const int btype);
+
    // Evaluate the values of a hierarchical 1D basis at point x
    // hierarchical = k-th basis function is degree k polynomial
    static void CalcBasis(const int p, const double x, double *u)
@@ -1698,6 +1831,11 @@ protected:
    Array<int> dof_map;
    Poly_1D::Basis &basis1d;
 
+   /// Fill @a d2q with the 1D TENSOR data of @a fe on @a ir.
+   void ComputeTensorDofToQuad(const FiniteElement &fe,
+                               const IntegrationRule &ir,
+                               DofToQuad &d2q) const;
+
 public:
    enum DofMapType
    {
@@ -1718,6 +1856,18 @@ public:
        Array will be empty. */
    const Array<int> &GetDofMap() const { return dof_map; }
 
+   /** @brief Return the 1D DofToQuad structure of the tensor product element
+       @a fe, using the 1D basis of this TensorBasisElement. */
+   /** The IntegrationRule @a ir must be a tensor product rule, with the first
+       coordinate running fastest, as the rules in IntRules. The new object is
+       stored in, or found in, the container @a d2q, whose published copy is
+       @a d2q_pub. */
+   const DofToQuad &GetTensorDofToQuad(const FiniteElement &fe,
+                                       const IntegrationRule &ir,
+                                       DofToQuad::Mode mode,
+                                       Array<DofToQuad*> &d2q,
+                                       PublishedArray<DofToQuad> &d2q_pub) const;
+
    static Geometry::Type GetTensorProductGeometry(int dim)
    {
       switch (dim)
@@ -1750,6 +1900,15 @@ class NodalTensorFiniteElement : public NodalFiniteElement,
 public:
    NodalTensorFiniteElement(const int dims, const int p, const int btype,
                             const DofMapType dmtype);
+
+   virtual const DofToQuad &GetDofToQuad(const IntegrationRule &ir,
+                                         DofToQuad::Mode mode) const
+   {
+      return (mode == DofToQuad::FULL) ?
+             FiniteElement::GetDofToQuad(ir, mode) :
+             GetTensorDofToQuad(*this, ir, mode, dof2quad_array,
+                                dof2quad_published);
+   }
 };
 
 class PositiveTensorFiniteElement : public PositiveFiniteElement,
@@ -1758,6 +1917,15 @@ class PositiveTensorFiniteElement : public PositiveFiniteElement,
 public:
    PositiveTensorFiniteElement(const int dims, const int p,
                                const DofMapType dmtype);
+
+   virtual const DofToQuad &GetDofToQuad(const IntegrationRule &ir,
+                                         DofToQuad::Mode mode) const
+   {
+      return (mode == DofToQuad::FULL) ?
+             FiniteElement::GetDofToQuad(ir, mode) :
+             GetTensorDofToQuad(*this, ir, mode, dof2quad_array,
+                                dof2quad_published);
+   }
 };
 
 class H1_SegmentElement : public NodalTensorFiniteElement
@@ -2262,6 +2430,12 @@ public:
    RT_QuadrilateralElement(const int p,
                            const int cb_type = BasisType::GaussLobatto,
                            const int ob_type = BasisType::GaussLegendre);
+   /// See ND_HexahedronElement::GetClosedBasis().
+   const Poly_1D::Basis &GetClosedBasis() const { return cbasis1d; }
+   /// See ND_HexahedronElement::GetOpenBasis().
+   const Poly_1D::Basis &GetOpenBasis() const { return obasis1d; }
+   /// See ND_HexahedronElement::GetDofMap().
+   const Array<int> &GetDofMap() const { return dof_map; }
    virtual void CalcVShape(const IntegrationPoint &ip,
                            DenseMatrix &shape) const;
    virtual void CalcVShape(ElementTransformation &Trans,
@@ -2318,6 +2492,13 @@ public:
                         const int cb_type = BasisType::GaussLobatto,
                         const int ob_type = BasisType::GaussLegendre);
 
+   /// See ND_HexahedronElement::GetClosedBasis().
+   const Poly_1D::Basis &GetClosedBasis() const { return cbasis1d; }
+   /// See ND_HexahedronElement::GetOpenBasis().
+   const Poly_1D::Basis &GetOpenBasis() const { return obasis1d; }
+   /// See ND_HexahedronElement::GetDofMap().
+   const Array<int> &GetDofMap() const { return dof_map; }
+
    virtual void CalcVShape(const IntegrationPoint &ip,
                            DenseMatrix &shape) const;
    virtual void CalcVShape(ElementTransformation &Trans,
@@ -2472,6 +2653,15 @@ public:
                         const int cb_type = BasisType::GaussLobatto,
                         const int ob_type = BasisType::GaussLegendre);
 
+   /// Return the closed 1D basis used in the tensor product construction.
+   const Poly_1D::Basis &GetClosedBasis() const { return cbasis1d; }
+   /// Return the open 1D basis used in the tensor product construction.
+   const Poly_1D::Basis &GetOpenBasis() const { return obasis1d; }
+   /** @brief Return the map from the component-wise lexicographic ordering of
+       the dofs to their native ordering; negative entries, -1-i, mark dofs
+       with a sign change. */
+   const Array<int> &GetDofMap() const { return dof_map; }
+
    virtual void CalcVShape(const IntegrationPoint &ip,
                            DenseMatrix &shape) const;
 
@@ -2537,6 +2727,12 @@ public:
    ND_QuadrilateralElement(const int p,
                            const int cb_type = BasisType::GaussLobatto,
                            const int ob_type = BasisType::GaussLegendre);
+   /// See ND_HexahedronElement::GetClosedBasis().
+   const Poly_1D::Basis &GetClosedBasis() const { return cbasis1d; }
+   /// See ND_HexahedronElement::GetOpenBasis().
+   const Poly_1D::Basis &GetOpenBasis() const { return obasis1d; }
+   /// See ND_HexahedronElement::GetDofMap().
+   const Array<int> &GetDofMap() const { return dof_map; }
    virtual void CalcVShape(const IntegrationPoint &ip,
                            DenseMatrix &shape) const;
    virtual void CalcVShape(ElementTransformation &Trans,
@@ -2750,6 +2946,9 @@ public:
    Vector              &Weights    ()         const { return weights; }
    /// Update the NURBSFiniteElement according to the currently set knot vectors
    virtual void         SetOrder   ()         const { }
+
+   /// The basis functions depend on the knot vectors and weights.
+   virtual bool HasElementIndependentBasis() const { return false; }
 };
 
 class NURBS1DFiniteElement : public NURBSFiniteElement
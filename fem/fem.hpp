@@ -25,7 +25,10 @@
 #include "gridfunc.hpp"
 #include "linearform.hpp"
 #include "nonlinearform.hpp"
+#include "restriction.hpp"
+#include "bilinearform_ext.hpp"
 #include "bilinearform.hpp"
+#include "tbilinearform_kernels.hpp"
 #include "hybridization.hpp"
 #include "datacollection.hpp"
 #include "estimators.hpp"
@@ -40,6 +43,10 @@
 #include "pnonlinearform.hpp"
 #endif
 
+#include "fespacehierarchy.hpp"
+#include "geometricmultigrid.hpp"
+#include "lor.hpp"
+
 #ifdef MFEM_USE_SIDRE
 #include "sidredatacollection.hpp"
 #endif
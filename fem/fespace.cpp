@@ -283,6 +283,45 @@ void FiniteElementSpace::BuildDofToArrays()
    }
 }
 
+void FiniteElementSpace::GetElementColoring(Array<int> &colors) const
+{
+   const int ne = mesh->GetNE();
+   const Table &el_dof = GetElementToDofTable();
+   Table el_dof_abs(el_dof), dof_el;
+   {
+      int *J = el_dof_abs.GetJ();
+      for (int k = 0; k < el_dof_abs.Size_of_connections(); k++)
+      {
+         if (J[k] < 0) { J[k] = -1-J[k]; }
+      }
+   }
+   Transpose(el_dof_abs, dof_el, ndofs);
+
+   // col_marker[c] == el means that color c is used by a neighbor of el
+   Array<int> col_marker;
+   colors.SetSize(ne);
+   colors = -1;
+   for (int el = 0; el < ne; el++)
+   {
+      const int *dofs = el_dof_abs.GetRow(el);
+      const int n = el_dof_abs.RowSize(el);
+      for (int j = 0; j < n; j++)
+      {
+         const int *nbrs = dof_el.GetRow(dofs[j]);
+         const int nn = dof_el.RowSize(dofs[j]);
+         for (int k = 0; k < nn; k++)
+         {
+            const int col = colors[nbrs[k]];
+            if (col >= 0) { col_marker[col] = el; }
+         }
+      }
+      int col = 0;
+      while (col < col_marker.Size() && col_marker[col] == el) { col++; }
+      if (col == col_marker.Size()) { col_marker.Append(-1); }
+      colors[el] = col;
+   }
+}
+
 static void mark_dofs(const Array<int> &dofs, Array<int> &mark_array)
 {
    for (int i = 0; i < dofs.Size(); i++)
@@ -975,6 +1014,188 @@ void FiniteElementSpace::RefinementOperator
    }
 }
 
+void FiniteElementSpace::GetLocalPRefinementMatrix(
+   const FiniteElementSpace &coarse_fes, Geometry::Type geom,
+   DenseMatrix &localP) const
+{
+   const FiniteElement *fine_fe = fec->FiniteElementForGeometry(geom);
+   const FiniteElement *coarse_fe =
+      coarse_fes.fec->FiniteElementForGeometry(geom);
+
+   IsoparametricTransformation isotr;
+   isotr.SetIdentityTransformation(geom);
+
+   localP.SetSize(fine_fe->GetDof(), coarse_fe->GetDof());
+   fine_fe->GetTransferMatrix(*coarse_fe, isotr, localP);
+}
+
+SparseMatrix *FiniteElementSpace::PRefinementMatrix(
+   const FiniteElementSpace &coarse_fes) const
+{
+   MFEM_VERIFY(coarse_fes.GetMesh() == mesh && coarse_fes.GetVDim() == vdim,
+               "the spaces must be defined on the same mesh with the same "
+               "vdim");
+
+   Mesh::GeometryList elem_geoms(*mesh);
+   DenseMatrix localP[Geometry::NumGeom];
+   for (int i = 0; i < elem_geoms.Size(); i++)
+   {
+      GetLocalPRefinementMatrix(coarse_fes, elem_geoms[i],
+                                localP[elem_geoms[i]]);
+   }
+
+   SparseMatrix *P = new SparseMatrix(GetVSize(), coarse_fes.GetVSize());
+
+   Array<int> mark(P->Height());
+   mark = 0;
+
+   Array<int> dofs, coarse_dofs, coarse_vdofs;
+   Vector row;
+   const int coarse_ndofs = coarse_fes.GetNDofs();
+   for (int k = 0; k < mesh->GetNE(); k++)
+   {
+      const DenseMatrix &lP = localP[mesh->GetElementBaseGeometry(k)];
+
+      GetElementDofs(k, dofs);
+      coarse_fes.GetElementDofs(k, coarse_dofs);
+
+      for (int vd = 0; vd < vdim; vd++)
+      {
+         coarse_dofs.Copy(coarse_vdofs);
+         coarse_fes.DofsToVDofs(vd, coarse_vdofs, coarse_ndofs);
+
+         for (int i = 0; i < dofs.Size(); i++)
+         {
+            int r = DofToVDof(dofs[i], vd);
+            int m = (r >= 0) ? r : (-1 - r);
+
+            if (!mark[m])
+            {
+               lP.GetRow(i, row);
+               P->SetRow(r, coarse_vdofs, row);
+               mark[m] = 1;
+            }
+         }
+      }
+   }
+
+   MFEM_ASSERT(mark.Sum() == P->Height(), "Not all rows of P set.");
+   P->Finalize();
+   return P;
+}
+
+FiniteElementSpace::PRefinementOperator::PRefinementOperator(
+   const FiniteElementSpace *fespace, const FiniteElementSpace *coarse_fes)
+   : Operator(fespace->GetVSize(), coarse_fes->GetVSize()),
+     fespace(fespace), coarse_fes(coarse_fes)
+{
+   MFEM_VERIFY(coarse_fes->GetMesh() == fespace->GetMesh() &&
+               coarse_fes->GetVDim() == fespace->GetVDim(),
+               "the spaces must be defined on the same mesh with the same "
+               "vdim");
+
+   Mesh::GeometryList elem_geoms(*fespace->GetMesh());
+   for (int i = 0; i < elem_geoms.Size(); i++)
+   {
+      fespace->GetLocalPRefinementMatrix(*coarse_fes, elem_geoms[i],
+                                         localP[elem_geoms[i]]);
+   }
+}
+
+void FiniteElementSpace::PRefinementOperator
+::Mult(const Vector &x, Vector &y) const
+{
+   Mesh *mesh = fespace->GetMesh();
+   Array<int> dofs, coarse_dofs, coarse_vdofs;
+
+   Array<char> processed(fespace->GetVSize());
+   processed = 0;
+
+   const int vdim = fespace->GetVDim();
+   const int coarse_ndofs = coarse_fes->GetNDofs();
+
+   for (int k = 0; k < mesh->GetNE(); k++)
+   {
+      const DenseMatrix &lP = localP[mesh->GetElementBaseGeometry(k)];
+
+      fespace->GetElementDofs(k, dofs);
+      coarse_fes->GetElementDofs(k, coarse_dofs);
+
+      for (int vd = 0; vd < vdim; vd++)
+      {
+         coarse_dofs.Copy(coarse_vdofs);
+         coarse_fes->DofsToVDofs(vd, coarse_vdofs, coarse_ndofs);
+
+         for (int i = 0; i < dofs.Size(); i++)
+         {
+            double rsign, csign;
+            int r = fespace->DofToVDof(dofs[i], vd);
+            r = DecodeDof(r, rsign);
+
+            if (!processed[r])
+            {
+               double value = 0.0;
+               for (int j = 0; j < coarse_vdofs.Size(); j++)
+               {
+                  int c = DecodeDof(coarse_vdofs[j], csign);
+                  value += x[c] * lP(i, j) * csign;
+               }
+               y[r] = value * rsign;
+               processed[r] = 1;
+            }
+         }
+      }
+   }
+}
+
+void FiniteElementSpace::PRefinementOperator
+::MultTranspose(const Vector &x, Vector &y) const
+{
+   Mesh *mesh = fespace->GetMesh();
+   Array<int> dofs, coarse_dofs, coarse_vdofs;
+
+   // Each fine dof contributes once, through the first element containing it,
+   // as in Mult()
+   Array<char> processed(fespace->GetVSize());
+   processed = 0;
+
+   const int vdim = fespace->GetVDim();
+   const int coarse_ndofs = coarse_fes->GetNDofs();
+
+   y = 0.0;
+   for (int k = 0; k < mesh->GetNE(); k++)
+   {
+      const DenseMatrix &lP = localP[mesh->GetElementBaseGeometry(k)];
+
+      fespace->GetElementDofs(k, dofs);
+      coarse_fes->GetElementDofs(k, coarse_dofs);
+
+      for (int vd = 0; vd < vdim; vd++)
+      {
+         coarse_dofs.Copy(coarse_vdofs);
+         coarse_fes->DofsToVDofs(vd, coarse_vdofs, coarse_ndofs);
+
+         for (int i = 0; i < dofs.Size(); i++)
+         {
+            double rsign, csign;
+            int r = fespace->DofToVDof(dofs[i], vd);
+            r = DecodeDof(r, rsign);
+
+            if (!processed[r])
+            {
+               const double xr = x[r] * rsign;
+               for (int j = 0; j < coarse_vdofs.Size(); j++)
+               {
+                  int c = DecodeDof(coarse_vdofs[j], csign);
+                  y[c] += xr * lP(i, j) * csign;
+               }
+               processed[r] = 1;
+            }
+         }
+      }
+   }
+}
+
 void FiniteElementSpace::GetLocalDerefinementMatrices(Geometry::Type geom,
                                                       DenseTensor &localR) const
 {
@@ -1679,6 +1900,20 @@ void FiniteElementSpace::GetTransferOperator(
 {
    // Assumptions: see the declaration of the method.
 
+   if (coarse_fes.GetMesh() == mesh)
+   {
+      // p-refinement on the same mesh
+      if (T.Type() == Operator::MFEM_SPARSEMAT)
+      {
+         T.Reset(PRefinementMatrix(coarse_fes));
+      }
+      else
+      {
+         T.Reset(new PRefinementOperator(this, &coarse_fes));
+      }
+      return;
+   }
+
    if (T.Type() == Operator::MFEM_SPARSEMAT)
    {
       Mesh::GeometryList elem_geoms(*mesh);
@@ -150,6 +150,30 @@ protected:
       virtual ~RefinementOperator();
    };
 
+   /** @brief GridFunction interpolation operator from a space with a lower
+       order on the same mesh (p-refinement). */
+   class PRefinementOperator : public Operator
+   {
+      const FiniteElementSpace *fespace, *coarse_fes;
+      DenseMatrix localP[Geometry::NumGeom];
+
+   public:
+      PRefinementOperator(const FiniteElementSpace *fespace,
+                          const FiniteElementSpace *coarse_fes);
+      virtual void Mult(const Vector &x, Vector &y) const;
+      virtual void MultTranspose(const Vector &x, Vector &y) const;
+   };
+
+   /// Calculate the local interpolation matrix from the element of
+   /// @a coarse_fes to the element of this space, both on the same mesh.
+   void GetLocalPRefinementMatrix(const FiniteElementSpace &coarse_fes,
+                                  Geometry::Type geom,
+                                  DenseMatrix &localP) const;
+
+   /// Calculate the explicit interpolation matrix from @a coarse_fes, defined
+   /// on the same mesh as this space.
+   SparseMatrix *PRefinementMatrix(const FiniteElementSpace &coarse_fes) const;
+
    // This method makes the same assumptions as the method:
    //    void GetLocalRefinementMatrices(
    //       const FiniteElementSpace &coarse_fes, Geometry::Type geom,
@@ -390,6 +414,14 @@ public:
    const Table &GetElementToDofTable() const { return *elem_dof; }
    const Table &GetBdrElementToDofTable() const { return *bdrElem_dof; }
 
+   /** @brief Compute a coloring of the elements such that elements with the
+       same color do not share any dofs.
+
+       The colors are numbered from 0 and are assigned greedily, visiting the
+       elements in their mesh order. Note that the face-based coloring
+       Mesh::GetElementColoring() does not have this property. */
+   void GetElementColoring(Array<int> &colors) const;
+
    int GetElementForDof(int i) const { return dof_elem_array[i]; }
    int GetLocalDofForDof(int i) const { return dof_ldof_array[i]; }
 
@@ -464,6 +496,9 @@ public:
    /** It is assumed that the mesh of this FE space is a refinement of the mesh
        of @a coarse_fes and the CoarseFineTransformations returned by the method
        Mesh::GetRefinementTransforms() of the refined mesh are set accordingly.
+       Alternatively, both spaces can be defined on the same mesh, e.g. with
+       different orders (p-refinement); then the transfer is computed with the
+       method FiniteElement::GetTransferMatrix() of the elements of this space.
        The Operator::Type of @a T can be set to request an Operator of the set
        type. Currently, only Operator::MFEM_SPARSEMAT and Operator::ANY_TYPE
        (matrix-free) are supported. When Operator::ANY_TYPE is requested, the
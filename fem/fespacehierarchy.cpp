@@ -0,0 +1,120 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+// Implementation of class FiniteElementSpaceHierarchy
+
+#include "fem.hpp"
+
+namespace mfem
+{
+
+FiniteElementSpaceHierarchy::FiniteElementSpaceHierarchy(
+   Mesh *mesh, FiniteElementSpace *fespace, bool own_mesh, bool own_fespace)
+{
+   MFEM_VERIFY(mesh != NULL && fespace != NULL &&
+               fespace->GetMesh() == mesh, "invalid arguments");
+   meshes.Append(mesh);
+   fespaces.Append(fespace);
+   own_meshes.Append(own_mesh);
+   own_fespaces.Append(own_fespace);
+}
+
+void FiniteElementSpaceHierarchy::AddUniformlyRefinedLevel()
+{
+   const FiniteElementSpace &fes = *fespaces.Last();
+   Mesh *mesh = new Mesh(*meshes.Last(), true);
+   mesh->UniformRefinement();
+   FiniteElementSpace *fine_fes =
+      new FiniteElementSpace(mesh, fes.FEColl(), fes.GetVDim(),
+                             fes.GetOrdering());
+   AddLevel(mesh, fine_fes, true, true);
+}
+
+void FiniteElementSpaceHierarchy::AddOrderRefinedLevel(
+   FiniteElementCollection *fec, bool own_fec)
+{
+   const FiniteElementSpace &fes = *fespaces.Last();
+   FiniteElementSpace *fine_fes =
+      new FiniteElementSpace(meshes.Last(), fec, fes.GetVDim(),
+                             fes.GetOrdering());
+   if (own_fec) { fecs.Append(fec); }
+   AddLevel(meshes.Last(), fine_fes, false, true);
+}
+
+void FiniteElementSpaceHierarchy::AddLevel(Mesh *mesh,
+                                           FiniteElementSpace *fespace,
+                                           bool own_mesh, bool own_fespace)
+{
+   MFEM_VERIFY(mesh != NULL && fespace != NULL &&
+               fespace->GetMesh() == mesh, "invalid arguments");
+
+   Operator::Type tid = Operator::MFEM_SPARSEMAT;
+#ifdef MFEM_USE_MPI
+   if (dynamic_cast<ParFiniteElementSpace*>(fespace))
+   {
+      tid = Operator::Hypre_ParCSR;
+   }
+#endif
+   // Use a matrix-free transfer between spaces on the same mesh
+   if (mesh == meshes.Last()) { tid = Operator::ANY_TYPE; }
+   OperatorHandle *P = new OperatorHandle(tid);
+   fespace->GetTrueTransferOperator(*fespaces.Last(), *P);
+   prolongations.Append(P);
+
+   meshes.Append(mesh);
+   fespaces.Append(fespace);
+   own_meshes.Append(own_mesh);
+   own_fespaces.Append(own_fespace);
+}
+
+FiniteElementSpaceHierarchy::~FiniteElementSpaceHierarchy()
+{
+   for (int l = 0; l < prolongations.Size(); l++)
+   {
+      delete prolongations[l];
+   }
+   for (int l = 0; l < fespaces.Size(); l++)
+   {
+      if (own_fespaces[l]) { delete fespaces[l]; }
+      if (own_meshes[l]) { delete meshes[l]; }
+   }
+   for (int i = 0; i < fecs.Size(); i++)
+   {
+      delete fecs[i];
+   }
+}
+
+#ifdef MFEM_USE_MPI
+void ParFiniteElementSpaceHierarchy::AddUniformlyRefinedLevel()
+{
+   const ParFiniteElementSpace &pfes = GetFinestFESpace();
+   ParMesh *pmesh = new ParMesh(GetMeshAtLevel(GetFinestLevelIndex()), true);
+   pmesh->UniformRefinement();
+   ParFiniteElementSpace *fine_pfes =
+      new ParFiniteElementSpace(pmesh, pfes.FEColl(), pfes.GetVDim(),
+                                pfes.GetOrdering());
+   AddLevel(pmesh, fine_pfes, true, true);
+}
+
+void ParFiniteElementSpaceHierarchy::AddOrderRefinedLevel(
+   FiniteElementCollection *fec, bool own_fec)
+{
+   const ParFiniteElementSpace &pfes = GetFinestFESpace();
+   ParMesh *pmesh = &GetMeshAtLevel(GetFinestLevelIndex());
+   ParFiniteElementSpace *fine_pfes =
+      new ParFiniteElementSpace(pmesh, fec, pfes.GetVDim(),
+                                pfes.GetOrdering());
+   if (own_fec) { fecs.Append(fec); }
+   AddLevel(pmesh, fine_pfes, false, true);
+}
+#endif
+
+}
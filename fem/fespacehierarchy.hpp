@@ -0,0 +1,133 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#ifndef MFEM_FESPACEHIERARCHY
+#define MFEM_FESPACEHIERARCHY
+
+#include "../config/config.hpp"
+#include "fespace.hpp"
+#ifdef MFEM_USE_MPI
+#include "pfespace.hpp"
+#endif
+
+namespace mfem
+{
+
+/** @brief A sequence of finite element spaces on successively refined meshes
+    or with increasing orders, together with the true-dof prolongations between
+    them.
+
+    The first (coarsest) level is given in the constructor. Finer levels are
+    added with AddUniformlyRefinedLevel(), which refines a copy of the finest
+    mesh with Mesh::UniformRefinement(), with AddOrderRefinedLevel(), which
+    uses a higher order collection on the finest mesh, or with AddLevel().
+
+    The prolongation from level l to level l+1 is the true-dof transfer
+    operator computed by FiniteElementSpace::GetTrueTransferOperator(). Between
+    refined meshes it is assembled, as a SparseMatrix in serial and as a
+    HypreParMatrix for parallel spaces. Between spaces on the same mesh it is
+    matrix-free, see FiniteElementSpace::GetTransferOperator(). */
+class FiniteElementSpaceHierarchy
+{
+protected:
+   Array<Mesh*> meshes;
+   Array<FiniteElementSpace*> fespaces;
+   /// Prolongations from level l to level l+1. Owned.
+   Array<OperatorHandle*> prolongations;
+   Array<bool> own_meshes, own_fespaces;
+   /// Collections of the order-refined levels. Owned.
+   Array<FiniteElementCollection*> fecs;
+
+public:
+   /** @brief Construct a hierarchy with the coarsest level given by @a mesh
+       and @a fespace. The ownership flags specify whether they are deleted by
+       the hierarchy. */
+   FiniteElementSpaceHierarchy(Mesh *mesh, FiniteElementSpace *fespace,
+                               bool own_mesh, bool own_fespace);
+
+   /// Return the number of levels.
+   int GetNumLevels() const { return fespaces.Size(); }
+
+   /// Return the index of the finest level.
+   int GetFinestLevelIndex() const { return fespaces.Size() - 1; }
+
+   /** @brief Add a new finest level with a uniformly refined copy of the
+       finest mesh and a space with the same collection, vdim, and ordering as
+       the finest space. The new mesh and space are owned by the hierarchy. */
+   virtual void AddUniformlyRefinedLevel();
+
+   /** @brief Add a new finest level with a space on the finest mesh using the
+       collection @a fec, with the same vdim and ordering as the finest space.
+       */
+   /** The space is owned by the hierarchy, and so is @a fec when @a own_fec
+       is true. Typically, @a fec is an H1_FECollection or L2_FECollection of a
+       higher order than that of the finest space, resulting in a polynomial
+       (p-) multigrid hierarchy. */
+   virtual void AddOrderRefinedLevel(FiniteElementCollection *fec,
+                                     bool own_fec = true);
+
+   /** @brief Add a new finest level given by @a mesh and @a fespace. */
+   /** The @a mesh must either be the mesh of the finest level, or a copy of it
+       that has just been refined, see Mesh::GetRefinementTransforms(). */
+   void AddLevel(Mesh *mesh, FiniteElementSpace *fespace, bool own_mesh,
+                 bool own_fespace);
+
+   /// Return the mesh on the given level (0 is the coarsest).
+   Mesh &GetMeshAtLevel(int level) const { return *meshes[level]; }
+
+   /// Return the finite element space on the given level (0 is the coarsest).
+   FiniteElementSpace &GetFESpaceAtLevel(int level) const
+   { return *fespaces[level]; }
+
+   /// Return the finite element space on the finest level.
+   FiniteElementSpace &GetFinestFESpace() const { return *fespaces.Last(); }
+
+   /** @brief Return the true-dof prolongation from @a level to @a level + 1
+       as an OperatorHandle of type Operator::MFEM_SPARSEMAT or
+       Operator::Hypre_ParCSR. */
+   OperatorHandle &GetProlongationAtLevel(int level) const
+   { return *prolongations[level]; }
+
+   virtual ~FiniteElementSpaceHierarchy();
+};
+
+#ifdef MFEM_USE_MPI
+/// Parallel version of FiniteElementSpaceHierarchy.
+class ParFiniteElementSpaceHierarchy : public FiniteElementSpaceHierarchy
+{
+public:
+   ParFiniteElementSpaceHierarchy(ParMesh *pmesh,
+                                  ParFiniteElementSpace *pfespace,
+                                  bool own_mesh, bool own_fespace)
+      : FiniteElementSpaceHierarchy(pmesh, pfespace, own_mesh, own_fespace)
+   { }
+
+   /** @brief Add a new finest level with a uniformly refined copy of the
+       finest ParMesh, see FiniteElementSpaceHierarchy. */
+   virtual void AddUniformlyRefinedLevel();
+
+   virtual void AddOrderRefinedLevel(FiniteElementCollection *fec,
+                                     bool own_fec = true);
+
+   ParMesh &GetMeshAtLevel(int level) const
+   { return static_cast<ParMesh&>(*meshes[level]); }
+
+   ParFiniteElementSpace &GetFESpaceAtLevel(int level) const
+   { return static_cast<ParFiniteElementSpace&>(*fespaces[level]); }
+
+   ParFiniteElementSpace &GetFinestFESpace() const
+   { return static_cast<ParFiniteElementSpace&>(*fespaces.Last()); }
+};
+#endif
+
+}
+
+#endif
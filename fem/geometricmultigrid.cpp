@@ -0,0 +1,215 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+// Implementation of class GeometricMultigrid
+
+#include "fem.hpp"
+
+namespace mfem
+{
+
+GeometricMultigrid::GeometricMultigrid(
+   const FiniteElementSpaceHierarchy &fes_hierarchy, const Array<int> &ess_bdr)
+   : fespaces(fes_hierarchy), smoother_type(JACOBI), smoother_sweeps(1)
+{
+   for (int l = 0; l < fespaces.GetNumLevels(); l++)
+   {
+      Array<int> *ess = new Array<int>;
+      if (fespaces.GetMeshAtLevel(l).bdr_attributes.Size())
+      {
+         fespaces.GetFESpaceAtLevel(l).GetEssentialTrueDofs(ess_bdr, *ess);
+      }
+      ess_tdofs.Append(ess);
+   }
+}
+
+void GeometricMultigrid::FormSystemOperator(BilinearForm &form,
+                                            const Array<int> &ess_tdof_list,
+                                            OperatorHandle &A)
+{
+   if (form.GetAssemblyLevel() != AssemblyLevel::FULL)
+   {
+      const Operator *P = form.GetProlongation();
+      Operator *rap = &form;
+      if (P) { rap = new RAPOperator(*P, form, *P); }
+      A.Reset(new ConstrainedOperator(rap, ess_tdof_list, rap != &form));
+      return;
+   }
+#ifdef MFEM_USE_MPI
+   ParBilinearForm *pform = dynamic_cast<ParBilinearForm*>(&form);
+   if (pform)
+   {
+      A.SetType(Operator::Hypre_ParCSR);
+      pform->FormSystemMatrix(ess_tdof_list, A);
+      return;
+   }
+#endif
+   SparseMatrix *mat = new SparseMatrix;
+   form.FormSystemMatrix(ess_tdof_list, *mat);
+   A.Reset(mat);
+}
+
+void GeometricMultigrid::FormOperators(BilinearForm &fine_form)
+{
+   MFEM_VERIFY(GetNumLevels() == 0, "the operators are already formed");
+   MFEM_VERIFY(fine_form.FESpace() == &fespaces.GetFinestFESpace(),
+               "the form must be defined on the finest space");
+   MFEM_VERIFY(fine_form.GetAssemblyLevel() == AssemblyLevel::FULL,
+               "Galerkin coarsening requires a fully assembled form");
+
+   const int num_levels = fespaces.GetNumLevels();
+   for (int l = 0; l + 1 < num_levels; l++)
+   {
+      MFEM_VERIFY(fespaces.GetProlongationAtLevel(l).Type() !=
+                  Operator::ANY_TYPE, "Galerkin coarsening requires "
+                  "assembled prolongations, use rediscretization instead");
+   }
+
+   forms.SetSize(num_levels);
+   forms = NULL;
+   forms.Last() = &fine_form;
+
+   Array<OperatorHandle*> ops(num_levels);
+   ops.Last() = new OperatorHandle;
+   FormSystemOperator(fine_form, *ess_tdofs.Last(), *ops.Last());
+   for (int l = num_levels - 2; l >= 0; l--)
+   {
+      // The fine dofs on the essential boundary only depend on the coarse
+      // dofs on the essential boundary, so after the elimination of the
+      // latter the interior block is the Galerkin product of the interior
+      // blocks.
+      ops[l] = new OperatorHandle;
+      ops[l]->MakePtAP(*ops[l+1], fespaces.GetProlongationAtLevel(l));
+      OperatorHandle A_e;
+      A_e.EliminateRowsCols(*ops[l], *ess_tdofs[l]);
+   }
+   AddLevels(ops);
+}
+
+void GeometricMultigrid::FormOperators(const Array<BilinearForm*> &level_forms)
+{
+   MFEM_VERIFY(GetNumLevels() == 0, "the operators are already formed");
+   MFEM_VERIFY(level_forms.Size() == fespaces.GetNumLevels(),
+               "one form is needed on each level");
+
+   level_forms.Copy(forms);
+   Array<OperatorHandle*> ops(forms.Size());
+   for (int l = 0; l < forms.Size(); l++)
+   {
+      MFEM_VERIFY(forms[l]->FESpace() == &fespaces.GetFESpaceAtLevel(l),
+                  "the form on level " << l << " has an invalid space");
+      ops[l] = new OperatorHandle;
+      FormSystemOperator(*forms[l], *ess_tdofs[l], *ops[l]);
+   }
+   AddLevels(ops);
+}
+
+void GeometricMultigrid::AddLevels(Array<OperatorHandle*> &ops)
+{
+   for (int l = 0; l < ops.Size(); l++)
+   {
+      Solver *smoother = (l == 0) ? MakeCoarseSolver(*ops[l]) :
+                         MakeSmoother(l, *ops[l]);
+      const Operator *P =
+         (l == 0) ? NULL : fespaces.GetProlongationAtLevel(l-1).Ptr();
+      const bool own_op = ops[l]->OwnsOperator();
+      ops[l]->SetOperatorOwner(false);
+      AddLevel(ops[l]->Ptr(), smoother, P, own_op, true, false);
+      delete ops[l];
+   }
+}
+
+Solver *GeometricMultigrid::MakeSmoother(int level, OperatorHandle &A)
+{
+   if (smoother_type == CHEBYSHEV)
+   {
+      Vector diag;
+      switch (A.Type())
+      {
+         case Operator::MFEM_SPARSEMAT:
+            A.As<SparseMatrix>()->GetDiag(diag);
+            break;
+#ifdef MFEM_USE_MPI
+         case Operator::Hypre_ParCSR:
+            A.As<HypreParMatrix>()->GetDiag(diag);
+            return new OperatorChebyshevSmoother(
+                      A.As<HypreParMatrix>()->GetComm(), *A.Ptr(), diag,
+                      smoother_sweeps);
+#endif
+         default:
+            MFEM_VERIFY(forms[level] != NULL, "missing form on level "
+                        << level);
+            forms[level]->FormSystemDiagonal(*ess_tdofs[level], diag);
+#ifdef MFEM_USE_MPI
+            ParFiniteElementSpace *pfes =
+               dynamic_cast<ParFiniteElementSpace*>(forms[level]->FESpace());
+            if (pfes)
+            {
+               return new OperatorChebyshevSmoother(
+                         pfes->GetComm(), *A.Ptr(), diag, smoother_sweeps);
+            }
+#endif
+            break;
+      }
+      return new OperatorChebyshevSmoother(*A.Ptr(), diag, smoother_sweeps);
+   }
+
+   switch (A.Type())
+   {
+      case Operator::MFEM_SPARSEMAT:
+      {
+         const SparseMatrix &mat = *A.As<SparseMatrix>();
+         if (smoother_type == GAUSS_SEIDEL)
+         {
+            return new GSSmoother(mat, 0, smoother_sweeps);
+         }
+         return new DSmoother(mat, 1, 1.0, smoother_sweeps);
+      }
+#ifdef MFEM_USE_MPI
+      case Operator::Hypre_ParCSR:
+         return new HypreSmoother(*A.As<HypreParMatrix>(),
+                                  smoother_type == GAUSS_SEIDEL ?
+                                  HypreSmoother::l1GS : HypreSmoother::l1Jacobi,
+                                  smoother_sweeps);
+#endif
+      default:
+         MFEM_ABORT("matrix-free level operators require the CHEBYSHEV "
+                    "smoother");
+   }
+   return NULL;
+}
+
+Solver *GeometricMultigrid::MakeCoarseSolver(OperatorHandle &A)
+{
+   switch (A.Type())
+   {
+      case Operator::MFEM_SPARSEMAT:
+         return new AMGSolver(*A.As<SparseMatrix>());
+#ifdef MFEM_USE_MPI
+      case Operator::Hypre_ParCSR:
+      {
+         HypreBoomerAMG *amg = new HypreBoomerAMG(*A.As<HypreParMatrix>());
+         amg->SetPrintLevel(0);
+         return amg;
+      }
+#endif
+      default:
+         MFEM_ABORT("the coarsest level must be fully assembled");
+   }
+   return NULL;
+}
+
+GeometricMultigrid::~GeometricMultigrid()
+{
+   for (int l = 0; l < ess_tdofs.Size(); l++) { delete ess_tdofs[l]; }
+}
+
+}
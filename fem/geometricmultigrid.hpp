@@ -0,0 +1,135 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#ifndef MFEM_GEOMETRICMULTIGRID
+#define MFEM_GEOMETRICMULTIGRID
+
+#include "../config/config.hpp"
+#include "../linalg/multigrid.hpp"
+#include "fespacehierarchy.hpp"
+#include "bilinearform.hpp"
+
+namespace mfem
+{
+
+/** @brief Geometric (h- and p-) multigrid solver for bilinear forms defined on
+    the finest level of a FiniteElementSpaceHierarchy.
+
+    The level operators are the true-dof system operators with eliminated
+    essential boundary conditions, and the prolongations are those of the
+    hierarchy. The coarse operators are formed either by Galerkin projection of
+    the fine operator, see FormOperators(BilinearForm &), or by
+    rediscretization with a bilinear form on each level, see
+    FormOperators(const Array<BilinearForm*> &). Both BilinearForm and
+    ParBilinearForm are supported.
+
+    With rediscretization, the forms can use partial assembly, see
+    BilinearForm::SetAssemblyLevel(); their level operators are then
+    matrix-free and require the CHEBYSHEV smoother, which uses the diagonal
+    computed by BilinearForm::FormSystemDiagonal(). A typical polynomial
+    multigrid uses a hierarchy built with
+    FiniteElementSpaceHierarchy::AddOrderRefinedLevel(), partially assembled
+    forms on the high-order levels, and a fully assembled lowest order form on
+    the coarsest level.
+
+    The smoothers are l1-Jacobi, symmetric Gauss-Seidel, or Chebyshev
+    accelerated Jacobi, see SetSmoother(), and the coarsest level is solved
+    with one cycle of AMGSolver in serial and HypreBoomerAMG in parallel, so it
+    must be fully assembled. The smoothers and the coarse solver can be
+    customized in a derived class by overriding MakeSmoother() and
+    MakeCoarseSolver().
+
+    The linear system on the finest level should be formed with the essential
+    true dofs returned by GetEssentialTrueDofs(), e.g.
+    @code
+       a.Assemble();
+       GeometricMultigrid mg(hierarchy, ess_bdr);
+       mg.FormOperators(a);
+       a.FormLinearSystem(mg.GetEssentialTrueDofs(), x, b, A, X, B);
+       PCG(*A, mg, B, X);
+    @endcode */
+class GeometricMultigrid : public MultigridSolver
+{
+public:
+   /// Smoother types.
+   enum SmootherType
+   {
+      JACOBI,       ///< l1-Jacobi, DSmoother or HypreSmoother::l1Jacobi.
+      GAUSS_SEIDEL, ///< Symmetric GSSmoother or HypreSmoother::l1GS.
+      CHEBYSHEV     ///< OperatorChebyshevSmoother.
+   };
+
+protected:
+   const FiniteElementSpaceHierarchy &fespaces;
+   /// Essential true dofs on each level.
+   Array<Array<int>*> ess_tdofs;
+   /// The forms used on each level, NULL for Galerkin coarse levels. Not
+   /// owned.
+   Array<BilinearForm*> forms;
+
+   SmootherType smoother_type;
+   int smoother_sweeps;
+
+   /** @brief Form the true-dof system operator of @a form in @a A: a matrix
+       for fully assembled forms, and a ConstrainedOperator otherwise. */
+   void FormSystemOperator(BilinearForm &form,
+                           const Array<int> &ess_tdof_list,
+                           OperatorHandle &A);
+
+   /// Add the given level operators to the MultigridSolver.
+   void AddLevels(Array<OperatorHandle*> &ops);
+
+   /// Construct the smoother for the level operator @a A.
+   virtual Solver *MakeSmoother(int level, OperatorHandle &A);
+
+   /// Construct the solver for the coarsest level operator @a A.
+   virtual Solver *MakeCoarseSolver(OperatorHandle &A);
+
+public:
+   /** @brief Construct a geometric multigrid solver for the given hierarchy,
+       with essential boundary conditions on the boundary attributes marked in
+       @a ess_bdr. */
+   GeometricMultigrid(const FiniteElementSpaceHierarchy &fes_hierarchy,
+                      const Array<int> &ess_bdr);
+
+   /** @brief Set the smoother type and the number of sweeps of each smoother
+       application (the polynomial order for CHEBYSHEV), default: one
+       l1-Jacobi sweep. Must be called before FormOperators(). */
+   void SetSmoother(SmootherType type, int sweeps = 1)
+   { smoother_type = type; smoother_sweeps = sweeps; }
+
+   /** @brief Form the level operators with Galerkin projection, A_l =
+       P_l^T A_{l+1} P_l, of the system matrix of @a fine_form. */
+   /** The @a fine_form must be defined on the finest space of the hierarchy
+       and fully assembled, and the prolongations of the hierarchy must be
+       assembled, i.e. the levels must be obtained by mesh refinement. The
+       system matrix of the form is referenced, not copied. */
+   void FormOperators(BilinearForm &fine_form);
+
+   /** @brief Form the level operators by rediscretization with the given
+       assembled bilinear @a level_forms, one for each level, coarsest first. */
+   /** The system matrices of the fully assembled forms are referenced, not
+       copied. */
+   void FormOperators(const Array<BilinearForm*> &level_forms);
+
+   /// Return the essential true dofs on the given level.
+   const Array<int> &GetEssentialTrueDofs(int level) const
+   { return *ess_tdofs[level]; }
+
+   /// Return the essential true dofs on the finest level.
+   const Array<int> &GetEssentialTrueDofs() const { return *ess_tdofs.Last(); }
+
+   virtual ~GeometricMultigrid();
+};
+
+}
+
+#endif
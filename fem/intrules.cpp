@@ -78,6 +78,22 @@ IntegrationRule::IntegrationRule(IntegrationRule &irx, IntegrationRule &iry,
    }
 }
 
+bool IntegrationRule::SameAs(const IntegrationRule &ir, int dim) const
+{
+   if (this == &ir) { return true; }
+   if (Size() != ir.Size()) { return false; }
+   for (int i = 0; i < Size(); i++)
+   {
+      const IntegrationPoint &ipa = (*this)[i], &ipb = ir[i];
+      if (ipa.x != ipb.x || ipa.weight != ipb.weight ||
+          (dim > 1 && ipa.y != ipb.y) || (dim > 2 && ipa.z != ipb.z))
+      {
+         return false;
+      }
+   }
+   return true;
+}
+
 void IntegrationRule::GrundmannMollerSimplexRule(int s, int n)
 {
    // for pow on older compilers
@@ -861,78 +877,98 @@ IntegrationRules::IntegrationRules(int Ref, int _type):
    CubeIntRules = NULL;
 }
 
-const IntegrationRule &IntegrationRules::Get(int GeomType, int Order)
+Array<IntegrationRule *> &IntegrationRules::GetIntRuleArray(int GeomType)
 {
-   Array<IntegrationRule *> *ir_array;
-
    switch (GeomType)
    {
-      case Geometry::POINT:       ir_array = &PointIntRules; Order = 0; break;
-      case Geometry::SEGMENT:     ir_array = &SegmentIntRules; break;
-      case Geometry::TRIANGLE:    ir_array = &TriangleIntRules; break;
-      case Geometry::SQUARE:      ir_array = &SquareIntRules; break;
-      case Geometry::TETRAHEDRON: ir_array = &TetrahedronIntRules; break;
-      case Geometry::CUBE:        ir_array = &CubeIntRules; break;
-      case Geometry::PRISM:       ir_array = &PrismIntRules; break;
+      case Geometry::POINT:       return PointIntRules;
+      case Geometry::SEGMENT:     return SegmentIntRules;
+      case Geometry::TRIANGLE:    return TriangleIntRules;
+      case Geometry::SQUARE:      return SquareIntRules;
+      case Geometry::TETRAHEDRON: return TetrahedronIntRules;
+      case Geometry::CUBE:        return CubeIntRules;
+      case Geometry::PRISM:       return PrismIntRules;
       default:
-         mfem_error("IntegrationRules::Get(...) : Unknown geometry type!");
-         ir_array = NULL;
+         MFEM_ABORT("Unknown geometry type: " << GeomType);
    }
+   return PointIntRules;
+}
 
-   if (Order < 0)
+void IntegrationRules::PublishIntRules()
+{
+   // Generating a rule may also generate rules of other geometries, e.g. the
+   // segment rules for the square and cube rules.
+   for (int g = 0; g < NumGeom; g++)
    {
-      Order = 0;
+      PublishedIntRules[g].Publish(GetIntRuleArray(g));
    }
+}
 
-   if (!HaveIntRule(*ir_array, Order))
+const IntegrationRule &IntegrationRules::Get(int GeomType, int Order)
+{
+   MFEM_ASSERT(NumGeom == Geometry::NumGeom, "invalid NumGeom");
+   MFEM_VERIFY(0 <= GeomType && GeomType < NumGeom,
+               "Unknown geometry type: " << GeomType);
+
+   if (GeomType == Geometry::POINT || Order < 0)
    {
+      Order = 0;
+   }
+
+   // Fast path: the rule exists. Published rules are never modified.
+   const IntegrationRule *ir = PublishedIntRules[GeomType].Get(Order);
+   if (ir) { return *ir; }
+
 #ifdef MFEM_USE_OPENMP
-      #pragma omp critical
+   #pragma omp critical (IntegrationRules)
 #endif
+   {
+      Array<IntegrationRule *> &ir_array = GetIntRuleArray(GeomType);
+      if (!HaveIntRule(ir_array, Order))
       {
-         if (!HaveIntRule(*ir_array, Order))
+         IntegrationRule *new_ir = GenerateIntegrationRule(GeomType, Order);
+         int RealOrder = Order;
+         while (RealOrder+1 < ir_array.Size() &&
+         /*  */ ir_array[RealOrder+1] == new_ir)
          {
-            IntegrationRule *ir = GenerateIntegrationRule(GeomType, Order);
-            int RealOrder = Order;
-            while (RealOrder+1 < ir_array->Size() &&
-            /*  */ (*ir_array)[RealOrder+1] == ir)
-            {
-               RealOrder++;
-            }
-            ir->SetOrder(RealOrder);
+            RealOrder++;
          }
+         new_ir->SetOrder(RealOrder);
       }
+      PublishIntRules();
    }
 
-   return *(*ir_array)[Order];
+   return *PublishedIntRules[GeomType].Get(Order);
 }
 
 void IntegrationRules::Set(int GeomType, int Order, IntegrationRule &IntRule)
 {
-   Array<IntegrationRule *> *ir_array;
+   MFEM_VERIFY(0 <= GeomType && GeomType < NumGeom,
+               "Unknown geometry type: " << GeomType);
 
-   switch (GeomType)
+#ifdef MFEM_USE_OPENMP
+   #pragma omp critical (IntegrationRules)
+#endif
    {
-      case Geometry::POINT:       ir_array = &PointIntRules; break;
-      case Geometry::SEGMENT:     ir_array = &SegmentIntRules; break;
-      case Geometry::TRIANGLE:    ir_array = &TriangleIntRules; break;
-      case Geometry::SQUARE:      ir_array = &SquareIntRules; break;
-      case Geometry::TETRAHEDRON: ir_array = &TetrahedronIntRules; break;
-      case Geometry::CUBE:        ir_array = &CubeIntRules; break;
-      case Geometry::PRISM:       ir_array = &PrismIntRules; break;
-      default:
-         mfem_error("IntegrationRules::Set(...) : Unknown geometry type!");
-         ir_array = NULL;
+      Array<IntegrationRule *> &ir_array = GetIntRuleArray(GeomType);
+      if (HaveIntRule(ir_array, Order))
+      {
+         MFEM_ABORT("Overwriting set rules is not supported!");
+      }
+
+      AllocIntRule(ir_array, Order);
+
+      ir_array[Order] = &IntRule;
+      PublishIntRules();
    }
+}
 
-   if (HaveIntRule(*ir_array, Order))
+void IntegrationRules::Precompute(int GeomType, int max_order)
+{
+   for (int order = 0; order <= max_order; order++)
    {
-      MFEM_ABORT("Overwriting set rules is not supported!");
+      Get(GeomType, order);
    }
-
-   AllocIntRule(*ir_array, Order);
-
-   (*ir_array)[Order] = &IntRule;
 }
 
 void IntegrationRules::DeleteIntRuleArray(Array<IntegrationRule *> &ir_array)
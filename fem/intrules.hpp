@@ -239,6 +239,12 @@ public:
    /// Returns a const reference to the i-th integration point
    const IntegrationPoint &IntPoint(int i) const { return (*this)[i]; }
 
+   /** @brief Return true if @a ir has the same points and weights as this
+       rule, comparing the first @a dim coordinates of the points. */
+   /** The unused coordinates of the points of lower dimensional rules are not
+       initialized. The orders of the rules are not compared. */
+   bool SameAs(const IntegrationRule &ir, int dim) const;
+
    /// Destroys an IntegrationRule object
    ~IntegrationRule() { }
 };
@@ -309,6 +315,19 @@ private:
    Array<IntegrationRule *> PrismIntRules;
    Array<IntegrationRule *> CubeIntRules;
 
+   /// Number of rule arrays above, equal to Geometry::NumGeom.
+   static const int NumGeom = 7;
+
+   /** @brief Copies of the rule arrays above, indexed by Geometry::Type, that
+       are read without locking in Get(). */
+   PublishedArray<IntegrationRule> PublishedIntRules[NumGeom];
+
+   /// Return the rule array of the given geometry.
+   Array<IntegrationRule *> &GetIntRuleArray(int GeomType);
+
+   /// Publish the current rules of all geometries.
+   void PublishIntRules();
+
    void AllocIntRule(Array<IntegrationRule *> &ir_array, int Order)
    {
       if (ir_array.Size() <= Order)
@@ -343,10 +362,17 @@ public:
                              int type = Quadrature1D::GaussLegendre);
 
    /// Returns an integration rule for given GeomType and Order.
+   /** The rules that already exist are returned without locking, so Get() can
+       be called concurrently from many threads; only the generation of a new
+       rule is serialized. */
    const IntegrationRule &Get(int GeomType, int Order);
 
    void Set(int GeomType, int Order, IntegrationRule &IntRule);
 
+   /** @brief Generate the rules of all orders up to @a max_order for the given
+       geometry, so that later calls to Get() do not need to generate them. */
+   void Precompute(int GeomType, int max_order);
+
    void SetOwnRules(int o) { own_rules = o; }
 
    /// Destroys an IntegrationRules object
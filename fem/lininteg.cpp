@@ -40,15 +40,19 @@ void DomainLFIntegrator::AssembleRHSElementVect(const FiniteElement &el,
       //                    oa * el.GetOrder() + ob + Tr.OrderW());
       ir = &IntRules.Get(el.GetGeomType(), oa * el.GetOrder() + ob);
    }
+   const DofToQuad *maps = el.HasElementIndependentBasis() ?
+                           &el.GetDofToQuad(*ir, DofToQuad::FULL) : NULL;
+   Q.Eval(Q_ir, Tr, *ir);
 
    for (int i = 0; i < ir->GetNPoints(); i++)
    {
       const IntegrationPoint &ip = ir->IntPoint(i);
 
       Tr.SetIntPoint (&ip);
-      double val = Tr.Weight() * Q.Eval(Tr, ip);
+      double val = Tr.Weight() * Q_ir(i);
 
-      el.CalcShape(ip, shape);
+      if (maps) { maps->GetShape(i, shape); }
+      else { el.CalcShape(ip, shape); }
 
       add(elvect, ip.weight * val, shape, elvect);
    }
@@ -184,6 +188,8 @@ void VectorDomainLFIntegrator::AssembleRHSElementVect(
       int intorder = el.GetOrder() + 1;
       ir = &IntRules.Get(el.GetGeomType(), intorder);
    }
+   const DofToQuad *maps = el.HasElementIndependentBasis() ?
+                           &el.GetDofToQuad(*ir, DofToQuad::FULL) : NULL;
 
    for (int i = 0; i < ir->GetNPoints(); i++)
    {
@@ -192,7 +198,8 @@ void VectorDomainLFIntegrator::AssembleRHSElementVect(
       Tr.SetIntPoint (&ip);
       val = Tr.Weight();
 
-      el.CalcShape(ip, shape);
+      if (maps) { maps->GetShape(i, shape); }
+      else { el.CalcShape(ip, shape); }
       Q.Eval (Qvec, Tr, ip);
 
       for (int k = 0; k < vdim; k++)
@@ -92,7 +92,7 @@ public:
 /// Class for domain integration L(v) := (f, v)
 class DomainLFIntegrator : public DeltaLFIntegrator
 {
-   Vector shape;
+   Vector shape, Q_ir;
    Coefficient &Q;
    int oa, ob;
 public:
@@ -0,0 +1,194 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+// Implementation of class LORSolver
+
+#include "fem.hpp"
+
+namespace mfem
+{
+
+LORSolver::LORSolver(BilinearForm &a_ho, const Array<int> &ess_tdof_list)
+   : Solver(a_ho.FESpace()->GetTrueVSize()), solver(NULL), own_solver(false)
+{
+   FiniteElementSpace &ho_fes = *a_ho.FESpace();
+   Mesh *mesh = ho_fes.GetMesh();
+   const H1_FECollection *ho_fec =
+      dynamic_cast<const H1_FECollection*>(ho_fes.FEColl());
+   MFEM_VERIFY(ho_fec != NULL, "the high-order space must be an H1 space");
+   const int btype = ho_fec->GetBasisType();
+   MFEM_VERIFY(btype == BasisType::GaussLobatto ||
+               btype == BasisType::ClosedUniform,
+               "the H1 basis must be GaussLobatto or ClosedUniform");
+   MFEM_VERIFY(mesh->GetNE() > 0, "empty mesh");
+   const int order = ho_fes.GetFE(0)->GetOrder();
+   MFEM_VERIFY(order > 1, "the order of the space must be > 1");
+
+   const int dim = mesh->Dimension();
+   const int vdim = ho_fes.GetVDim();
+   lor_fec = new H1_FECollection(1, dim);
+#ifdef MFEM_USE_MPI
+   ParBilinearForm *pa_ho = dynamic_cast<ParBilinearForm*>(&a_ho);
+   if (pa_ho)
+   {
+      ParMesh *pmesh = dynamic_cast<ParMesh*>(mesh);
+      ParMesh *lor_pmesh = new ParMesh(pmesh, order, btype);
+      ParFiniteElementSpace *lor_pfes =
+         new ParFiniteElementSpace(lor_pmesh, lor_fec, vdim,
+                                   ho_fes.GetOrdering());
+      lor_mesh = lor_pmesh;
+      lor_fes = lor_pfes;
+      lor_form = new ParBilinearForm(lor_pfes, pa_ho);
+   }
+   else
+#endif
+   {
+      MFEM_VERIFY(ho_fes.GetConformingProlongation() == NULL,
+                  "nonconforming spaces are not supported");
+      lor_mesh = new Mesh(mesh, order, btype);
+      lor_fes = new FiniteElementSpace(lor_mesh, lor_fec, vdim,
+                                       ho_fes.GetOrdering());
+      lor_form = new BilinearForm(lor_fes, &a_ho);
+   }
+
+   Array<int> ldof_perm;
+   ComputeDofPermutation(ho_fes, ldof_perm);
+
+   perm.SetSize(height);
+#ifdef MFEM_USE_MPI
+   if (pa_ho)
+   {
+      ParFiniteElementSpace *ho_pfes = pa_ho->ParFESpace();
+      ParFiniteElementSpace *lor_pfes =
+         static_cast<ParFiniteElementSpace*>(lor_fes);
+      for (int i = 0; i < ldof_perm.Size(); i++)
+      {
+         const int tdof = ho_pfes->GetLocalTDofNumber(i);
+         if (tdof < 0) { continue; }
+         perm[tdof] = lor_pfes->GetLocalTDofNumber(ldof_perm[i]);
+         MFEM_VERIFY(perm[tdof] >= 0, "inconsistent true dofs");
+      }
+   }
+   else
+#endif
+   {
+      perm = ldof_perm;
+   }
+
+   Array<int> lor_ess_tdofs(ess_tdof_list.Size());
+   for (int i = 0; i < ess_tdof_list.Size(); i++)
+   {
+      lor_ess_tdofs[i] = perm[ess_tdof_list[i]];
+   }
+
+   lor_form->Assemble();
+#ifdef MFEM_USE_MPI
+   if (pa_ho)
+   {
+      A.SetType(Operator::Hypre_ParCSR);
+      static_cast<ParBilinearForm*>(lor_form)->FormSystemMatrix(lor_ess_tdofs,
+                                                               A);
+      HypreBoomerAMG *amg = new HypreBoomerAMG(*A.As<HypreParMatrix>());
+      amg->SetPrintLevel(0);
+      SetSolver(amg);
+   }
+   else
+#endif
+   {
+      SparseMatrix *mat = new SparseMatrix;
+      lor_form->FormSystemMatrix(lor_ess_tdofs, *mat);
+      A.Reset(mat);
+      SetSolver(new AMGSolver);
+   }
+}
+
+void LORSolver::ComputeDofPermutation(const FiniteElementSpace &ho_fes,
+                                      Array<int> &ldof_perm) const
+{
+   // The vertices of each LOR element are nodes of its parent high-order
+   // element. The local node index of each vertex depends only on the
+   // embedding matrix and is computed once per matrix.
+   const CoarseFineTransformations &cf = lor_mesh->GetRefinementTransforms();
+   const Geometry::Type geom = lor_mesh->GetElementBaseGeometry(0);
+   const DenseTensor &pmats = cf.point_matrices.find(geom)->second;
+   const int nv = Geometry::NumVerts[geom];
+   const int dim = lor_mesh->Dimension();
+   const int vdim = ho_fes.GetVDim();
+
+   Array<int> node_map(nv*pmats.SizeK());
+   node_map = -1;
+   Array<int> ho_dofs, lor_dofs;
+   ldof_perm.SetSize(ho_fes.GetVSize());
+   ldof_perm = -1;
+   for (int e = 0; e < lor_mesh->GetNE(); e++)
+   {
+      const Embedding &emb = cf.embeddings[e];
+      ho_fes.GetElementDofs(emb.parent, ho_dofs);
+      lor_fes->GetElementDofs(e, lor_dofs);
+      MFEM_ASSERT(lor_dofs.Size() == nv, "");
+      for (int k = 0; k < nv; k++)
+      {
+         int &node = node_map[k + nv*emb.matrix];
+         if (node < 0)
+         {
+            const DenseMatrix &pm = pmats(emb.matrix);
+            const IntegrationRule &nodes =
+               ho_fes.GetFE(emb.parent)->GetNodes();
+            for (int n = 0; n < nodes.GetNPoints(); n++)
+            {
+               double x[3];
+               nodes.IntPoint(n).Get(x, dim);
+               double dist = 0.0;
+               for (int d = 0; d < dim; d++)
+               {
+                  dist = std::max(dist, fabs(x[d] - pm(d,k)));
+               }
+               if (dist < 1e-12) { node = n; break; }
+            }
+            MFEM_VERIFY(node >= 0, "LOR vertex is not a high-order node");
+         }
+         for (int c = 0; c < vdim; c++)
+         {
+            ldof_perm[ho_fes.DofToVDof(ho_dofs[node], c)] =
+               lor_fes->DofToVDof(lor_dofs[k], c);
+         }
+      }
+   }
+}
+
+void LORSolver::SetSolver(Solver *s, bool own)
+{
+   if (own_solver) { delete solver; }
+   solver = s;
+   own_solver = own;
+   solver->SetOperator(*A.Ptr());
+   solver->iterative_mode = false;
+}
+
+void LORSolver::Mult(const Vector &b, Vector &x) const
+{
+   B.SetSize(height);
+   X.SetSize(height);
+   for (int i = 0; i < height; i++) { B(perm[i]) = b(i); }
+   solver->Mult(B, X);
+   for (int i = 0; i < height; i++) { x(i) = X(perm[i]); }
+}
+
+LORSolver::~LORSolver()
+{
+   if (own_solver) { delete solver; }
+   delete lor_form;
+   delete lor_fes;
+   delete lor_fec;
+   delete lor_mesh;
+}
+
+}
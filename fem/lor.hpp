@@ -0,0 +1,114 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#ifndef MFEM_LOR
+#define MFEM_LOR
+
+#include "../config/config.hpp"
+#include "bilinearform.hpp"
+
+namespace mfem
+{
+
+/** @brief Low-order-refined (LOR) preconditioner for high-order H1 bilinear
+    forms.
+
+    For a form of order p on a mesh of quadrilaterals or hexahedra, the LOR
+    discretization uses the lowest order space on the mesh obtained by
+    refining each element p times, see Mesh::Mesh(Mesh*, int, int), with the
+    refined vertices placed at the nodes of the high-order space. The two
+    spaces have the same number of dofs, related by a permutation, and the LOR
+    operator, assembled with the integrators of the high-order form, is
+    spectrally equivalent to the high-order operator, independently of p. The
+    cost of its assembly is that of a lowest order form with the same number
+    of dofs.
+
+    Mult() permutes the input to the LOR dofs, applies a solver for the
+    assembled LOR system and permutes the result back, so LORSolver can
+    precondition the (e.g. partially assembled) high-order system operator.
+    The default solver is one cycle of AMGSolver in serial and of
+    HypreBoomerAMG in parallel; other solvers can be set with SetSolver().
+    Both BilinearForm and ParBilinearForm are supported.
+
+    The high-order space must use an H1_FECollection with GaussLobatto or
+    ClosedUniform basis, e.g.
+    @code
+       a.SetAssemblyLevel(AssemblyLevel::PARTIAL);
+       a.Assemble();
+       a.FormLinearSystem(ess_tdof_list, x, b, A, X, B);
+       LORSolver lor(a, ess_tdof_list);
+       PCG(*A, lor, B, X);
+    @endcode */
+class LORSolver : public Solver
+{
+protected:
+   /// The LOR mesh, space and form. Owned.
+   Mesh *lor_mesh;
+   FiniteElementCollection *lor_fec;
+   FiniteElementSpace *lor_fes;
+   BilinearForm *lor_form;
+
+   /// The LOR system matrix with eliminated essential dofs.
+   OperatorHandle A;
+
+   /// The LOR true dof for each high-order true dof.
+   Array<int> perm;
+
+   Solver *solver;
+   bool own_solver;
+
+   mutable Vector X, B;
+
+   /** @brief Compute the LOR local (vector) dof for each local (vector) dof of
+       @a ho_fes. */
+   void ComputeDofPermutation(const FiniteElementSpace &ho_fes,
+                              Array<int> &ldof_perm) const;
+
+public:
+   /** @brief Construct the LOR discretization of the assembled high-order form
+       @a a_ho, whose system operator has the essential true dofs
+       @a ess_tdof_list. */
+   /** The integrators of @a a_ho are used by the LOR form, so @a a_ho must
+       not be destroyed before this object. */
+   LORSolver(BilinearForm &a_ho, const Array<int> &ess_tdof_list);
+
+   /** @brief Set the solver for the assembled LOR system, replacing the
+       default one; SetOperator() of @a s is called with the LOR matrix. */
+   void SetSolver(Solver *s, bool own = true);
+
+   /// The operator is fixed at construction.
+   virtual void SetOperator(const Operator &op)
+   {
+      MFEM_VERIFY(op.Height() == height && op.Width() == width,
+                  "the operator size does not match the LOR system");
+   }
+
+   /// Apply the LOR solver to the high-order vector @a b.
+   virtual void Mult(const Vector &b, Vector &x) const;
+
+   /// Return the assembled LOR system operator.
+   OperatorHandle &GetAssembledSystem() { return A; }
+
+   /// Return the LOR true dof for each high-order true dof.
+   const Array<int> &GetDofPermutation() const { return perm; }
+
+   /// Return the LOR mesh.
+   Mesh &GetMesh() { return *lor_mesh; }
+
+   /// Return the LOR finite element space.
+   FiniteElementSpace &GetFESpace() { return *lor_fes; }
+
+   virtual ~LORSolver();
+};
+
+}
+
+#endif
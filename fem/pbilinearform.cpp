@@ -366,6 +366,25 @@ void ParBilinearForm::FormSystemMatrix(const Array<int> &ess_tdof_list,
    }
 }
 
+void ParBilinearForm::AssembleDiagonal(Vector &diag) const
+{
+   if (p_mat.Ptr())
+   {
+      MFEM_VERIFY(p_mat.Type() == Operator::Hypre_ParCSR,
+                  "only HypreParMatrix is supported");
+      p_mat.As<HypreParMatrix>()->GetDiag(diag);
+      return;
+   }
+   BilinearForm::AssembleDiagonal(diag);
+}
+
+void ParBilinearForm::FormSystemDiagonal(const Array<int> &ess_tdof_list,
+                                         Vector &diag) const
+{
+   AssembleDiagonal(diag);
+   diag.SetSubVector(ess_tdof_list, 1.0);
+}
+
 void ParBilinearForm::RecoverFEMSolution(
    const Vector &X, const Vector &b, Vector &x)
 {
@@ -223,6 +223,22 @@ public:
       A.MakeRef(*A_ptr);
    }
 
+   /** @brief Assemble the diagonal of the bilinear form on the true dofs,
+       see BilinearForm::AssembleDiagonal(). */
+   /** After FormSystemMatrix(), the diagonal of the parallel matrix is
+       returned, with ones at the eliminated essential dofs; otherwise the
+       local diagonals are summed with P^t, which is exact on conforming
+       meshes. */
+   virtual void AssembleDiagonal(Vector &diag) const;
+
+   /** @brief Compute the diagonal of the system operator formed by
+       FormLinearSystem() or FormSystemMatrix() with the same
+       @a ess_tdof_list. */
+   /** The essential entries are set to one, as in the elimination of the
+       HypreParMatrix and in the ConstrainedOperator of partial assembly. */
+   virtual void FormSystemDiagonal(const Array<int> &ess_tdof_list,
+                                   Vector &diag) const;
+
    /** Call this method after solving a linear system constructed using the
        FormLinearSystem method to recover the solution as a ParGridFunction-size
        vector in x. Use the same arguments as in the FormLinearSystem call. */
@@ -0,0 +1,397 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+// Implementation of classes ElementRestriction and FaceElementMaps
+
+#include "restriction.hpp"
+#include <cmath>
+
+namespace mfem
+{
+
+ElementRestriction::ElementRestriction(const FiniteElementSpace &f)
+   : fes(f),
+     ne(f.GetNE()),
+     vdim(f.GetVDim()),
+     byvdim(f.GetOrdering() == Ordering::byVDIM),
+     ndofs(f.GetNDofs()),
+     dof(ne > 0 ? f.GetFE(0)->GetDof() : 0),
+     nedofs(ne*dof)
+{
+   height = vdim*nedofs;
+   width = f.GetVSize();
+
+   const FiniteElement *fe = ne > 0 ? f.GetFE(0) : NULL;
+   const TensorBasisElement *el =
+      dynamic_cast<const TensorBasisElement*>(fe);
+   const Array<int> *dof_map = (el && el->GetDofMap().Size() > 0) ?
+                               &el->GetDofMap() : NULL;
+
+   gather_map.SetSize(nedofs);
+   offsets.SetSize(ndofs+1);
+   offsets = 0;
+
+   Array<int> elem_dofs;
+   for (int e = 0; e < ne; e++)
+   {
+      f.GetElementDofs(e, elem_dofs);
+      MFEM_VERIFY(elem_dofs.Size() == dof,
+                  "all elements must have the same number of dofs");
+      for (int i = 0; i < dof; i++)
+      {
+         const int did = elem_dofs[dof_map ? (*dof_map)[i] : i];
+         gather_map[e*dof+i] = did;
+         offsets[(did >= 0 ? did : -1-did)+1]++;
+      }
+   }
+   for (int i = 1; i <= ndofs; i++)
+   {
+      offsets[i] += offsets[i-1];
+   }
+
+   indices.SetSize(nedofs);
+   for (int k = 0; k < nedofs; k++)
+   {
+      const int did = gather_map[k];
+      const int gid = (did >= 0) ? did : -1-did;
+      indices[offsets[gid]++] = (did >= 0) ? k : -1-k;
+   }
+   // Shift the offsets back
+   for (int i = ndofs; i > 0; i--)
+   {
+      offsets[i] = offsets[i-1];
+   }
+   offsets[0] = 0;
+}
+
+void ElementRestriction::Mult(const Vector &x, Vector &y) const
+{
+   y.SetSize(height);
+   const double *X = x.GetData();
+   double *Y = y.GetData();
+#ifdef MFEM_USE_OPENMP
+   #pragma omp parallel for
+#endif
+   for (int e = 0; e < ne; e++)
+   {
+      for (int c = 0; c < vdim; c++)
+      {
+         for (int i = 0; i < dof; i++)
+         {
+            const int did = gather_map[e*dof+i];
+            const int gid = (did >= 0) ? did : -1-did;
+            const int vid = byvdim ? c+vdim*gid : gid+ndofs*c;
+            const double value = X[vid];
+            Y[i+dof*(c+vdim*e)] = (did >= 0) ? value : -value;
+         }
+      }
+   }
+}
+
+void ElementRestriction::MultTranspose(const Vector &x, Vector &y) const
+{
+   y.SetSize(width);
+   const double *X = x.GetData();
+   double *Y = y.GetData();
+#ifdef MFEM_USE_OPENMP
+   #pragma omp parallel for
+#endif
+   for (int i = 0; i < ndofs; i++)
+   {
+      for (int c = 0; c < vdim; c++)
+      {
+         double dofValue = 0.0;
+         for (int j = offsets[i]; j < offsets[i+1]; j++)
+         {
+            const int idx = indices[j];
+            const int k = (idx >= 0) ? idx : -1-idx;
+            const double value = X[k%dof + dof*(c + vdim*(k/dof))];
+            dofValue += (idx >= 0) ? value : -value;
+         }
+         Y[byvdim ? c+vdim*i : i+ndofs*c] = dofValue;
+      }
+   }
+}
+
+void ElementRestriction::MultTransposeUnsigned(const Vector &x,
+                                              Vector &y) const
+{
+   y.SetSize(width);
+   const double *X = x.GetData();
+   double *Y = y.GetData();
+#ifdef MFEM_USE_OPENMP
+   #pragma omp parallel for
+#endif
+   for (int i = 0; i < ndofs; i++)
+   {
+      for (int c = 0; c < vdim; c++)
+      {
+         double dofValue = 0.0;
+         for (int j = offsets[i]; j < offsets[i+1]; j++)
+         {
+            const int idx = indices[j];
+            const int k = (idx >= 0) ? idx : -1-idx;
+            dofValue += X[k%dof + dof*(c + vdim*(k/dof))];
+         }
+         Y[byvdim ? c+vdim*i : i+ndofs*c] = dofValue;
+      }
+   }
+}
+
+
+bool FaceElementMaps::Supports(const FiniteElementSpace &f)
+{
+   const Mesh *mesh = f.GetMesh();
+   const int dim = mesh->Dimension();
+   if (f.GetVDim() != 1 || !dynamic_cast<const L2_FECollection*>(f.FEColl()) ||
+       mesh->Nonconforming() || mesh->NURBSext || dim > 3 ||
+       mesh->SpaceDimension() != dim)
+   {
+      return false;
+   }
+   if (f.GetNE() == 0) { return true; }
+   return (mesh->GetNumGeometries(dim) == 1 &&
+           dynamic_cast<const TensorBasisElement*>(f.GetFE(0)) != NULL);
+}
+
+FaceElementMaps::FaceElementMaps(const FiniteElementSpace &f, FaceType t)
+   : fes(f),
+     type(t),
+     dim(f.GetMesh()->Dimension()),
+     d1d(f.GetNE() > 0 ? f.GetFE(0)->GetOrder()+1 : 0),
+     dof(f.GetNE() > 0 ? f.GetFE(0)->GetDof() : 0),
+     nf(0)
+{
+   MFEM_VERIFY(Supports(f), "the space is not supported by FaceElementMaps");
+   Mesh *mesh = f.GetMesh();
+
+   if (type == INTERIOR)
+   {
+      for (int face = 0; face < mesh->GetNumFaces(); face++)
+      {
+         int e1, e2;
+         mesh->GetFaceElements(face, &e1, &e2);
+         if (e2 < 0) { continue; }
+         faces.Append(face);
+         elems.Append(e1);
+         elems.Append(e2);
+      }
+   }
+   else
+   {
+      for (int be = 0; be < mesh->GetNBE(); be++)
+      {
+         const int face = mesh->GetBdrElementEdgeIndex(be);
+         int e1, e2, inf1, inf2;
+         mesh->GetFaceElements(face, &e1, &e2);
+         mesh->GetFaceInfos(face, &inf1, &inf2);
+         // Skip interior and shared faces, cf. Mesh::GetBdrFaceTransformations
+         if (e2 >= 0 || inf2 >= 0) { continue; }
+         faces.Append(be);
+         elems.Append(e1);
+         elems.Append(-1);
+      }
+   }
+   nf = faces.Size();
+
+   frames.SetSize(2*nf*dim);
+   frames = -1;
+   dof_map.SetSize(2*nf*dof);
+   dof_map = -1;
+   const int ns = GetNumSides();
+   for (int f = 0; f < nf; f++)
+   {
+      const int face = (type == INTERIOR) ? faces[f] :
+                       mesh->GetBdrElementEdgeIndex(faces[f]);
+      // Only the maps from the face to the element reference coordinates
+      FaceElementTransformations *T =
+         mesh->GetFaceElementTransformations(face, 4|8);
+      for (int s = 0; s < ns; s++)
+      {
+         IntegrationPointTransformation &loc = (s == 0) ? T->Loc1 : T->Loc2;
+         int *frame = frames.GetData() + (2*f+s)*dim;
+
+         // The image of the face origin and of the face coordinate axes
+         IntegrationPoint fip, eip0, eip;
+         fip.Init();
+         loc.Transform(fip, eip0);
+         const double x0[3] = { eip0.x, eip0.y, eip0.z };
+         bool tangent[3] = { false, false, false };
+         for (int j = 0; j < dim-1; j++)
+         {
+            fip.Init();
+            (j == 0 ? fip.x : fip.y) = 1.0;
+            loc.Transform(fip, eip);
+            const double dx[3] = { eip.x-x0[0], eip.y-x0[1], eip.z-x0[2] };
+            int k = 0;
+            for (int l = 1; l < dim; l++)
+            {
+               if (std::abs(dx[l]) > std::abs(dx[k])) { k = l; }
+            }
+            frame[1+j] = 2*k + (dx[k] < 0.0);
+            tangent[k] = true;
+         }
+         for (int k = 0; k < dim; k++)
+         {
+            if (!tangent[k]) { frame[0] = 2*k + (x0[k] > 0.5); }
+         }
+
+         // The lexicographic element dofs in face-frame order
+         const int e = elems[2*f+s];
+         int *map = dof_map.GetData() + (2*f+s)*dof;
+         for (int k = 0; k < dof; k++)
+         {
+            int fi = k, lex = 0;
+            const int stride[3] = { 1, d1d, d1d*d1d };
+            for (int a = 0; a < dim; a++)
+            {
+               const int i = fi % d1d;
+               fi /= d1d;
+               const int axis = frame[a]/2, flip = frame[a]%2;
+               lex += stride[axis]*(flip ? d1d-1-i : i);
+            }
+            map[k] = e*dof + lex;
+         }
+      }
+   }
+}
+
+void FaceElementMaps::ToFaceFrame(int f, int s, const double *v,
+                                  double *vf) const
+{
+   const int *frame = frames.GetData() + (2*f+s)*dim;
+   for (int a = 0; a < dim; a++)
+   {
+      const double c = v[frame[a]/2];
+      vf[a] = (frame[a]%2) ? -c : c;
+   }
+}
+
+void FaceElementMaps::GetFaceDofs(int f, Array<int> &dofs) const
+{
+   const TensorBasisElement *tfe =
+      dynamic_cast<const TensorBasisElement*>(fes.GetFE(0));
+   const Array<int> &native = tfe->GetDofMap();
+   const int ns = GetNumSides();
+   Array<int> elem_dofs;
+   dofs.SetSize(ns*dof);
+   for (int s = 0; s < ns; s++)
+   {
+      const int e = elems[2*f+s];
+      fes.GetElementDofs(e, elem_dofs);
+      const int *map = GetDofMap(f, s);
+      for (int k = 0; k < dof; k++)
+      {
+         const int lex = map[k] - e*dof;
+         dofs[s*dof+k] = elem_dofs[native.Size() ? native[lex] : lex];
+      }
+   }
+}
+
+void FaceElementMaps::GetElementFaceRule(const IntegrationRule &ir1d,
+                                         IntegrationRule &ir) const
+{
+   const int Q = ir1d.GetNPoints();
+   const int nq = (dim == 1) ? 1 : ((dim == 2) ? Q : Q*Q);
+   for (int i = 0; i < Q; i++)
+   {
+      MFEM_ASSERT(dim == 1 || std::abs(ir1d.IntPoint(i).x +
+                                       ir1d.IntPoint(Q-1-i).x - 1.0) < 1e-14,
+                  "the 1D points must be symmetric about 1/2");
+   }
+   ir.SetSize(2*dim*nq);
+   for (int k = 0; k < dim; k++)
+   {
+      // The tangential axes in increasing order
+      const int t1 = (k == 0) ? 1 : 0, t2 = (k == 2) ? 1 : 2;
+      for (int c = 0; c < 2; c++)
+      {
+         for (int q = 0; q < nq; q++)
+         {
+            double x[3] = { 0.0, 0.0, 0.0 }, w = 1.0;
+            x[k] = c;
+            if (dim > 1)
+            {
+               const IntegrationPoint &ip1 = ir1d.IntPoint(q%Q);
+               x[t1] = ip1.x;
+               w = ip1.weight;
+            }
+            if (dim > 2)
+            {
+               const IntegrationPoint &ip2 = ir1d.IntPoint(q/Q);
+               x[t2] = ip2.x;
+               w *= ip2.weight;
+            }
+            IntegrationPoint &ip = ir.IntPoint((2*k+c)*nq+q);
+            ip.Set(x[0], x[1], x[2], w);
+         }
+      }
+   }
+}
+
+int FaceElementMaps::GetElementFacePoint(int f, int s, int Q, int q) const
+{
+   const int *frame = frames.GetData() + (2*f+s)*dim;
+   const int nq = (dim == 1) ? 1 : ((dim == 2) ? Q : Q*Q);
+   const int k = frame[0]/2;
+   int p = 0;
+   for (int a = 1; a < dim; a++)
+   {
+      int i = q % Q;
+      q /= Q;
+      if (frame[a]%2) { i = Q-1-i; }
+      // Position of the element axis among the tangential axes
+      const int axis = frame[a]/2;
+      p += ((axis - (axis > k)) ? Q : 1)*i;
+   }
+   return frame[0]*nq + p;
+}
+
+const GeometricFactors *FaceElementMaps::GetGeometricFactors(
+   const IntegrationRule &ir1d) const
+{
+   IntegrationRule ir;
+   GetElementFaceRule(ir1d, ir);
+   return fes.GetMesh()->GetGeometricFactors(
+             ir, GeometricFactors::JACOBIANS | GeometricFactors::DETERMINANTS);
+}
+
+void FaceElementMaps::GetBasis(const IntegrationRule &ir1d,
+                               Array<double> &b0, Array<double> &g0,
+                               Array<double> &b, Array<double> &g) const
+{
+   const TensorBasisElement *tfe =
+      dynamic_cast<const TensorBasisElement*>(fes.GetFE(0));
+   const Poly_1D::Basis &basis1d = tfe->GetBasis1D();
+   const int nq = ir1d.GetNPoints();
+   Vector u(d1d), d(d1d);
+   b0.SetSize(d1d);
+   g0.SetSize(d1d);
+   basis1d.Eval(0.0, u, d);
+   for (int i = 0; i < d1d; i++)
+   {
+      b0[i] = u(i);
+      g0[i] = d(i);
+   }
+   b.SetSize(nq*d1d);
+   g.SetSize(nq*d1d);
+   for (int q = 0; q < nq; q++)
+   {
+      basis1d.Eval(ir1d.IntPoint(q).x, u, d);
+      for (int i = 0; i < d1d; i++)
+      {
+         b[q+nq*i] = u(i);
+         g[q+nq*i] = d(i);
+      }
+   }
+}
+
+}
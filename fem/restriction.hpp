@@ -0,0 +1,191 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#ifndef MFEM_RESTRICTION
+#define MFEM_RESTRICTION
+
+#include "../config/config.hpp"
+#include "../linalg/operator.hpp"
+#include "fespace.hpp"
+
+namespace mfem
+{
+
+/** @brief Operator that converts FiniteElementSpace L-vectors to E-vectors.
+
+    An L-vector is a regular (GridFunction-size) vector of the space, while an
+    E-vector is its element-wise discontinuous representation: the local
+    degrees of freedom of every element are stored contiguously, with layout
+    (dof, vdim, element), i.e. the local dof index runs fastest.
+
+    For tensor product elements (TensorBasisElement), the local dofs in the
+    E-vector are ordered lexicographically, so that they can be used directly
+    with sum-factorization kernels. For all other elements the native local
+    dof ordering of the FiniteElement is used.
+
+    The method Mult() performs the L-to-E gather and MultTranspose() performs
+    the E-to-L scatter-add. All elements of the space are required to have the
+    same number of dofs. */
+class ElementRestriction : public Operator
+{
+protected:
+   const FiniteElementSpace &fes;
+   const int ne;    ///< Number of elements.
+   const int vdim;  ///< Vector dimension of the space.
+   const bool byvdim;
+   const int ndofs; ///< Number of scalar dofs in the space.
+   const int dof;   ///< Number of scalar dofs per element.
+   const int nedofs;
+   /** Offsets, in #indices, of the list of E-vector entries that correspond to
+       each scalar dof of the space (CSR-like, size ndofs+1). */
+   Array<int> offsets;
+   /** E-vector entries (e*dof+i) for each scalar dof of the space; negative
+       values, -1-k, mark entries with a sign change. */
+   Array<int> indices;
+   /// Scalar dof of the space for each E-vector entry (e*dof+i), with sign.
+   Array<int> gather_map;
+
+public:
+   ElementRestriction(const FiniteElementSpace &f);
+
+   /// Gather: @a y (E-vector) = restriction of @a x (L-vector).
+   virtual void Mult(const Vector &x, Vector &y) const;
+
+   /// Scatter-add: @a y (L-vector) = sum of the element contributions in @a x.
+   virtual void MultTranspose(const Vector &x, Vector &y) const;
+
+   /** @brief Scatter-add as in MultTranspose(), ignoring the sign changes,
+       e.g. to sum the diagonals of the element matrices. */
+   void MultTransposeUnsigned(const Vector &x, Vector &y) const;
+
+   /// Return the number of dofs per element (per vector component).
+   int GetNumElementDofs() const { return dof; }
+
+   /** @brief Return the scalar dof (with sign encoded as -1-dof) of the
+       space corresponding to the local dof @a i of element @a e, where @a i
+       uses the E-vector (possibly lexicographic) ordering. */
+   int GetGatherMap(int e, int i) const { return gather_map[e*dof+i]; }
+};
+
+/** @brief Maps from the interior or the boundary faces of a DG space with
+    tensor product elements to the E-vectors of ElementRestriction.
+
+    Each side of a face is described in the "face frame" of the element on
+    that side: the first reference coordinate is the distance from the face,
+    increasing into the element, and the other coordinates are the reference
+    coordinates of the face, i.e. the coordinates of the points of a face
+    IntegrationRule. The local dofs of both elements of a face are listed in
+    the same face-frame lexicographic order, normal index fastest, so the
+    orientation of the neighbor (the permutation of its dofs relative to the
+    first element) is absorbed in the maps. This requires 1D bases with nodes
+    symmetric about 1/2, which is the case for all BasisType%s.
+
+    The maps are used by the batched assembly of the DG face integrators, see
+    BilinearFormIntegrator::AssemblePAFaces(). The space must be a scalar L2
+    space on a conforming mesh with a single tensor product element type,
+    whose space dimension is the mesh dimension. */
+class FaceElementMaps
+{
+public:
+   enum FaceType { INTERIOR, BOUNDARY };
+
+protected:
+   const FiniteElementSpace &fes;
+   const FaceType type;
+   const int dim;
+   const int d1d; ///< Number of 1D dofs per direction.
+   const int dof; ///< Number of dofs per element, d1d^dim.
+   int nf;
+   /// Mesh face (INTERIOR) or boundary element (BOUNDARY) of each face.
+   Array<int> faces;
+   /// The two elements of each face; the second one is -1 on the boundary.
+   Array<int> elems;
+   /** For each face, side, and face-frame axis a (0 is the normal axis), the
+       element reference axis k as 2*k+flip, where flip is 1 if the face-frame
+       coordinate is 1 minus the element coordinate. */
+   Array<int> frames;
+   /// E-vector index (e*dof+i) of each face-frame dof of each face side.
+   Array<int> dof_map;
+
+public:
+   FaceElementMaps(const FiniteElementSpace &f, FaceType t);
+
+   /// Return true if the FaceElementMaps can be constructed for @a f.
+   static bool Supports(const FiniteElementSpace &f);
+
+   const FiniteElementSpace &GetFESpace() const { return fes; }
+   FaceType GetFaceType() const { return type; }
+   int GetNFaces() const { return nf; }
+   int GetDim() const { return dim; }
+   int GetD1D() const { return d1d; }
+   int GetNumElementDofs() const { return dof; }
+   /// Number of sides of each face: 2 for INTERIOR and 1 for BOUNDARY faces.
+   int GetNumSides() const { return (type == INTERIOR) ? 2 : 1; }
+
+   /// Mesh face (INTERIOR) or boundary element (BOUNDARY) of face @a f.
+   int GetFace(int f) const { return faces[f]; }
+   int GetElement(int f, int s) const { return elems[2*f+s]; }
+
+   /** @brief Return the E-vector indices of the d1d^dim face-frame dofs of the
+       side @a s of face @a f. */
+   const int *GetDofMap(int f, int s) const
+   { return dof_map.GetData() + (2*f+s)*dof; }
+
+   /** @brief Return the face-frame components, @a vf, of the vector @a v
+       given in the reference coordinates of the element on side @a s of
+       face @a f. */
+   void ToFaceFrame(int f, int s, const double *v, double *vf) const;
+
+   /** @brief Return the global dofs of the face-frame dofs of all sides of
+       face @a f, i.e. the row and column indices of the face matrices. */
+   void GetFaceDofs(int f, Array<int> &dofs) const;
+
+   /** @brief Return the face 2*k+c of the reference element on the side @a s
+       of face @a f, where k is the normal axis and c (0 or 1) is the
+       coordinate of the face along it. */
+   /** The outward reference normal of the element is (2c-1) e_k. */
+   int GetReferenceFace(int f, int s) const { return frames[(2*f+s)*dim]; }
+
+   /** @brief Return in @a ir the points, in the reference element, of the
+       tensor product face rule with the 1D rule @a ir1d on all faces of the
+       reference element. */
+   /** The points of the reference face 2*k+c (see GetReferenceFace()) are
+       numbered from (2*k+c)*nq, where nq is the number of points per face,
+       lexicographically in the other axes in increasing order. The weights
+       are the ones of the face rule. The 1D points must be symmetric about
+       1/2, as in all IntRules for Geometry::SEGMENT. */
+   void GetElementFaceRule(const IntegrationRule &ir1d,
+                           IntegrationRule &ir) const;
+
+   /** @brief Return the index, in the rule of GetElementFaceRule() with
+       @a Q 1D points, of the face point @a q of the side @a s of face @a f,
+       where @a q is the index of the point in the face rule. */
+   int GetElementFacePoint(int f, int s, int Q, int q) const;
+
+   /** @brief Return the geometric factors of all elements at the points of
+       GetElementFaceRule() for @a ir1d, with the Jacobians and their
+       determinants, see Mesh::GetGeometricFactors(). */
+   /** The factors of all faces are computed at once from the mesh nodes, and
+       they are owned and updated by the mesh. */
+   const GeometricFactors *GetGeometricFactors(
+      const IntegrationRule &ir1d) const;
+
+   /** @brief Compute the values, @a b0, and derivatives, @a g0, of the 1D
+       basis on the face, and the values, @a b, and derivatives, @a g, at the
+       points of @a ir1d, with layout (points x dofs). */
+   void GetBasis(const IntegrationRule &ir1d, Array<double> &b0,
+                 Array<double> &g0, Array<double> &b,
+                 Array<double> &g) const;
+};
+
+}
+
+#endif
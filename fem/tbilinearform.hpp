@@ -14,6 +14,7 @@
 
 #include "../config/tconfig.hpp"
 #include "../linalg/ttensor.hpp"
+#include "../linalg/simd.hpp"
 #include "bilinearform.hpp"
 #include "tevaluator.hpp"
 #include "teltrans.hpp"
@@ -27,16 +28,24 @@ namespace mfem
 
 // complex_t - sol dof data type
 // real_t - mesh nodes, sol basis, mesh basis data type
+// impl_traits_t - SIMD traits, see AutoSIMDTraits: the partially assembled
+//                 action and the element matrices are computed for batches of
+//                 impl_traits_t::simd_size elements, one element per SIMD lane
 template <typename meshType, typename solFESpace,
           typename IR, typename IntegratorType,
           typename solVecLayout_t = ScalarLayout,
-          typename complex_t = double, typename real_t = double>
+          typename complex_t = double, typename real_t = double,
+          typename impl_traits_t = AutoSIMDTraits<complex_t,real_t> >
 class TBilinearForm : public Operator
 {
 protected:
    typedef complex_t complex_type;
    typedef real_t    real_type;
 
+   typedef typename impl_traits_t::vcomplex_t vcomplex_t;
+   static const int SS = impl_traits_t::simd_size;  // elements per batch
+   static const int AS = impl_traits_t::align_size; // batch data alignment
+
    typedef typename meshType::FE_type            meshFE_type;
    typedef ShapeEvaluator<meshFE_type,IR,real_t> meshShapeEval;
    typedef typename solFESpace::FE_type          solFE_type;
@@ -55,6 +64,12 @@ protected:
    typedef typename kernel_t::template p_asm_data<qpts>::type p_assembled_t;
    typedef typename kernel_t::template f_asm_data<qpts>::type f_assembled_t;
 
+   // The kernel and the data types for batches of elements
+   typedef typename integ_t::template kernel<sdim,dim,vcomplex_t>::type
+   vkernel_t;
+   typedef typename vkernel_t::template p_asm_data<qpts>::type vp_assembled_t;
+   typedef typename vkernel_t::template f_asm_data<qpts>::type vf_assembled_t;
+
    typedef TElementTransformation<meshType,IR,real_t> Trans_t;
    template <int NE> struct T_result
    {
@@ -72,6 +87,19 @@ protected:
       typedef typename Spec::ElementMatrix ElementMatrix;
    };
 
+   // Field evaluator for batches of elements, using local dof data, see
+   // GatherBatch() and ScatterBatch()
+   typedef FieldEvaluator<solFESpace,solVecLayout_t,IR,
+           vcomplex_t,real_t> vsolFieldEval;
+   template <int NB> struct VS_spec
+   {
+      typedef typename vsolFieldEval::template Spec<vkernel_t,NB> Spec;
+      typedef typename Spec::DataType DataType;
+      typedef typename Spec::ElementMatrix ElementMatrix;
+   };
+
+   typedef TTensor3<dofs,vdim,1,complex_t> dof_data_t;
+
    // Data members
 
    meshType      mesh;
@@ -86,10 +114,82 @@ protected:
 
    coeff_t coeff;
 
-   p_assembled_t *assembled_data;
+   // Partially assembled data for batches of SS elements, the data of element
+   // 'el' is in lane el%SS of assembled_data[el/SS].
+   vp_assembled_t *assembled_data;
 
    const FiniteElementSpace &in_fes;
 
+   int GetNumBatches() const { return (mesh.GetNE()+SS-1)/SS; }
+
+   // Copy the data of one element, a, to lane l of the batch data va.
+   template <typename data_t, typename vdata_t>
+   static inline MFEM_ALWAYS_INLINE
+   void SetLane(int l, const data_t &a, vdata_t &va)
+   {
+      MFEM_STATIC_ASSERT(data_t::size == vdata_t::size, "incompatible data");
+      for (int i = 0; i < data_t::size; i++)
+      {
+         SIMDLane(va.data[i], l) = a.data[i];
+      }
+   }
+
+   void AllocAssembledData()
+   {
+      const int NB = GetNumBatches();
+      assembled_data = AlignedAlloc<vp_assembled_t>(NB, AS);
+      p_assembled_t zero;
+      zero.Set(0.0);
+      for (int b = 0; b < NB; b++)
+      {
+         for (int l = 0; l < SS; l++)
+         {
+            SetLane(l, zero, assembled_data[b]);
+         }
+      }
+   }
+
+   // Extract the dofs of the elements el, ..., el+SS-1 from x to the lanes of
+   // vx, with layout (dofs x vdim); the lanes past the last element are zero.
+   void GatherBatch(int el, const complex_t *x, vcomplex_t *vx) const
+   {
+      const int NE = mesh.GetNE();
+      dof_data_t x_dof;
+      for (int l = 0; l < SS; l++)
+      {
+         if (el+l < NE)
+         {
+            solFES.SetElement(el+l);
+            solFES.VectorExtract(solVecLayout, x, x_dof.layout, x_dof);
+         }
+         else
+         {
+            x_dof.Set(0.0);
+         }
+         for (int i = 0; i < dof_data_t::size; i++)
+         {
+            SIMDLane(vx[i], l) = x_dof[i];
+         }
+      }
+   }
+
+   // Add the lanes of vy, with layout (dofs x vdim), to y for the elements el,
+   // ..., el+SS-1.
+   void ScatterBatch(int el, const vcomplex_t *vy, complex_t *y) const
+   {
+      const int NE = mesh.GetNE();
+      dof_data_t y_dof;
+      for (int l = 0; l < SS && el+l < NE; l++)
+      {
+         for (int i = 0; i < dof_data_t::size; i++)
+         {
+            y_dof[i] = SIMDLane(vy[i], l);
+         }
+         solFES.SetElement(el+l);
+         solFES.VectorAssemble(y_dof.layout, y_dof, solVecLayout, y);
+      }
+   }
+
 public:
    TBilinearForm(const IntegratorType &integ, const FiniteElementSpace &sol_fes)
       : Operator(sol_fes.GetNDofs()*vdim),
@@ -105,9 +205,26 @@ public:
         in_fes(sol_fes)
    { }
 
+   /** @brief Use the given mesh @a nodes, instead of the nodes of the mesh of
+       @a sol_fes, see TMesh. */
+   TBilinearForm(const IntegratorType &integ, const FiniteElementSpace &sol_fes,
+                 const GridFunction &nodes)
+      : Operator(sol_fes.GetNDofs()*vdim),
+        mesh(*sol_fes.GetMesh(), nodes),
+        meshEval(mesh.fe),
+        sol_fe(*sol_fes.FEColl()),
+        solEval(sol_fe),
+        solFES(sol_fe, sol_fes),
+        solVecLayout(sol_fes),
+        int_rule(),
+        coeff(integ.coeff),
+        assembled_data(NULL),
+        in_fes(sol_fes)
+   { }
+
    virtual ~TBilinearForm()
    {
-      delete [] assembled_data;
+      AlignedFree(assembled_data);
    }
 
    /// Get the input finite element space prolongation matrix
@@ -187,7 +304,7 @@ public:
       const int NE = mesh.GetNE();
       if (!assembled_data)
       {
-         assembled_data = new p_assembled_t[NE];
+         AllocAssembledData();
       }
       for (int el = 0; el < NE; el++) // BE == 1
       {
@@ -197,46 +314,58 @@ public:
          typename coeff_eval_t::result_t res;
          wQ.Eval(F, res);
 
-         for (int k = 0; k < BE; k++)
-         {
-            kernel_t::Assemble(k, F, wQ, res, assembled_data[el+k]);
-         }
+         p_assembled_t A;
+         kernel_t::Assemble(0, F, wQ, res, A);
+         SetLane(el%SS, A, assembled_data[el/SS]);
       }
    }
 
-   template <int num_elem>
+   // Partially assembled action for the batches b, ..., b+num_batches-1.
+   template <int num_batches>
    inline MFEM_ALWAYS_INLINE
-   void ElementAddMultAssembled(int el, solFieldEval &solFEval) const
+   void BatchAddMultAssembled(int b, vsolFieldEval &solFEval,
+                              const complex_t *x, complex_t *y) const
    {
-      typename S_spec<num_elem>::DataType R;
-      solFEval.Eval(el, R);
+      const int size = dof_data_t::size;
+      TTensor3<dofs,vdim,num_batches,vcomplex_t> xy_dof;
+      for (int k = 0; k < num_batches; k++)
+      {
+         GatherBatch((b+k)*SS, x, xy_dof.data + k*size);
+      }
 
-      for (int k = 0; k < num_elem; k++)
+      typename VS_spec<num_batches>::DataType R;
+      solFEval.EvalSerialized(xy_dof.data, R);
+
+      for (int k = 0; k < num_batches; k++)
       {
-         kernel_t::MultAssembled(k, assembled_data[el+k], R);
+         vkernel_t::MultAssembled(k, assembled_data[b+k], R);
       }
 
-      solFEval.template Assemble<true>(R);
+      solFEval.template AssembleSerialized<false>(R, xy_dof.data);
+      for (int k = 0; k < num_batches; k++)
+      {
+         ScatterBatch((b+k)*SS, xy_dof.data + k*size, y);
+      }
    }
 
    // complex_t = double
-   template <int num_elem>
+   // num_batches - the number of batches of SS elements processed at once
+   template <int num_batches>
    void MultAssembled(const Vector &x, Vector &y) const
    {
       y = 0.0;
 
-      solFieldEval solFEval(solFES, solEval, solVecLayout,
-                            x.GetData(), y.GetData());
+      vsolFieldEval solFEval(solFES, solEval, solVecLayout, NULL, NULL);
 
-      const int NE = mesh.GetNE();
-      const int bNE = NE-NE%num_elem;
-      for (int el = 0; el < bNE; el += num_elem)
+      const int NB = GetNumBatches();
+      const int bNB = NB-NB%num_batches;
+      for (int b = 0; b < bNB; b += num_batches)
       {
-         ElementAddMultAssembled<num_elem>(el, solFEval);
+         BatchAddMultAssembled<num_batches>(b, solFEval, x, y);
       }
-      for (int el = bNE; el < NE; el++)
+      for (int b = bNB; b < NB; b++)
       {
-         ElementAddMultAssembled<1>(el, solFEval);
+         BatchAddMultAssembled<1>(b, solFEval, x, y);
       }
    }
 
@@ -294,7 +423,7 @@ public:
       const int NE = mesh.GetNE();
       if (!assembled_data)
       {
-         assembled_data = new p_assembled_t[NE];
+         AllocAssembledData();
       }
       for (int el = 0; el < NE; el++)
       {
@@ -304,7 +433,9 @@ public:
          typename coeff_eval_t::result_t res;
          wQ.Eval(F, res);
 
-         kernel_t::Assemble(0, F, wQ, res, assembled_data[el]);
+         p_assembled_t A;
+         kernel_t::Assemble(0, F, wQ, res, A);
+         SetLane(el%SS, A, assembled_data[el/SS]);
       }
    }
 
@@ -330,22 +461,40 @@ public:
    // complex_t = double
    void MultAssembledSerialized(const Vector &sx, Vector &sy) const
    {
-      solFieldEval solFEval(solFES, solEval, solVecLayout, NULL, NULL);
+      vsolFieldEval solFEval(solFES, solEval, solVecLayout, NULL, NULL);
 
       const int NE = mesh.GetNE();
+      const int size = dof_data_t::size;
       const complex_t *loc_sx = sx.GetData();
       complex_t *loc_sy = sy.GetData();
-      for (int el = 0; el < NE; el++)
+      for (int el = 0; el < NE; el += SS)
       {
-         typename S_spec<1>::DataType R;
-         solFEval.EvalSerialized(loc_sx, R);
+         const int nl = std::min(SS, NE-el);
+         TTensor3<dofs,vdim,1,vcomplex_t> xy_dof;
+         for (int l = 0; l < SS; l++)
+         {
+            for (int i = 0; i < size; i++)
+            {
+               SIMDLane(xy_dof[i], l) = (l < nl) ? loc_sx[i+size*l] : 0.0;
+            }
+         }
 
-         kernel_t::MultAssembled(0, assembled_data[el], R);
+         typename VS_spec<1>::DataType R;
+         solFEval.EvalSerialized(xy_dof.data, R);
 
-         solFEval.template AssembleSerialized<false>(R, loc_sy);
+         vkernel_t::MultAssembled(0, assembled_data[el/SS], R);
 
-         loc_sx += vdim*dofs;
-         loc_sy += vdim*dofs;
+         solFEval.template AssembleSerialized<false>(R, xy_dof.data);
+         for (int l = 0; l < nl; l++)
+         {
+            for (int i = 0; i < size; i++)
+            {
+               loc_sy[i+size*l] = SIMDLane(xy_dof[i], l);
+            }
+         }
+
+         loc_sx += nl*size;
+         loc_sy += nl*size;
       }
    }
 #endif // MFEM_TEMPLATE_ENABLE_SERIALIZE
@@ -393,8 +542,17 @@ public:
    }
 
    // Assemble element matrices and store them as a DenseTensor object.
+   // The element matrices are computed for batches of SS elements.
    // complex_t = double
    void AssembleMatrix(DenseTensor &M) const
+   {
+      AssembleMatrix(M, 0, mesh.GetNE());
+   }
+
+   // Assemble the element matrices of the elements first, ..., first+num-1 and
+   // store them in the DenseTensor M of size (dof x dof x num).
+   // complex_t = double
+   void AssembleMatrix(DenseTensor &M, int first, int num) const
    {
       const int BE = 1; // batch-size of elements
       typedef typename kernel_t::template
@@ -404,29 +562,46 @@ public:
       solShapeEval solEval(this->solEval);
       coeff_eval_t wQ(int_rule, coeff);
 
-      const int NE = mesh.GetNE();
-      for (int el = 0; el < NE; el++)
+      const int end = first + num;
+      for (int el = first; el < end; el += SS)
       {
-         f_assembled_t asm_qpt_data;
+         const int nl = std::min(SS, end-el);
+         vf_assembled_t asm_qpt_data;
+         for (int l = 0; l < SS; l++)
          {
-            typename T_result<BE>::Type F;
-            T.Eval(el, F);
+            f_assembled_t el_asm_qpt_data;
+            if (l < nl)
+            {
+               typename T_result<BE>::Type F;
+               T.Eval(el+l, F);
 
-            typename coeff_eval_t::result_t res;
-            wQ.Eval(F, res);
+               typename coeff_eval_t::result_t res;
+               wQ.Eval(F, res);
 
-            kernel_t::Assemble(0, F, wQ, res, asm_qpt_data);
+               kernel_t::Assemble(0, F, wQ, res, el_asm_qpt_data);
+            }
+            else
+            {
+               el_asm_qpt_data.Set(0.0);
+            }
+            SetLane(l, el_asm_qpt_data, asm_qpt_data);
          }
 
          // For now, when vdim > 1, assume block-diagonal matrix with the same
          // diagonal block for all components.
-         // M is assumed to be (dof x dof x NE).
-         TMatrix<dofs,dofs> M_loc;
-         S_spec<BE>::ElementMatrix::Compute(
+         // M is assumed to be (dof x dof x num).
+         TMatrix<dofs,dofs,vcomplex_t> M_loc;
+         VS_spec<BE>::ElementMatrix::Compute(
             asm_qpt_data.layout, asm_qpt_data, M_loc.layout, M_loc, solEval);
 
-         complex_t *M_data = M.GetData(el);
-         M_loc.template AssignTo<AssignOp::Set>(M_data);
+         for (int l = 0; l < nl; l++)
+         {
+            complex_t *M_data = M.GetData(el-first+l);
+            for (int i = 0; i < dofs*dofs; i++)
+            {
+               M_data[i] = SIMDLane(M_loc.data[i], l);
+            }
+         }
       }
    }
 
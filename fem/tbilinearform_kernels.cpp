@@ -0,0 +1,223 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+// Implementation of class TBilinearFormKernels
+
+#include "fem.hpp"
+#include "tbilininteg.hpp"
+
+#include <typeinfo>
+
+// The (geometry, mesh order, solution order) combinations registered by the
+// library, for both MassIntegrator and DiffusionIntegrator. Each entry is a
+// separate instantiation of the templated kernels, so extending this table
+// increases the compilation time of this file.
+#define MFEM_TBILINEARFORM_KERNELS(X) \
+   X(Geometry::SQUARE, 1, 1)          \
+   X(Geometry::SQUARE, 1, 2)          \
+   X(Geometry::SQUARE, 1, 3)          \
+   X(Geometry::SQUARE, 2, 1)          \
+   X(Geometry::SQUARE, 2, 2)          \
+   X(Geometry::SQUARE, 2, 3)          \
+   X(Geometry::CUBE,   1, 1)          \
+   X(Geometry::CUBE,   1, 2)          \
+   X(Geometry::CUBE,   1, 3)          \
+   X(Geometry::CUBE,   2, 1)          \
+   X(Geometry::CUBE,   2, 2)          \
+   X(Geometry::CUBE,   2, 3)
+
+namespace mfem
+{
+
+namespace internal
+{
+long long flop_count;
+}
+
+static Array<TBilinearFormKernels::Kernel> &RegisteredKernels()
+{
+   static Array<TBilinearFormKernels::Kernel> kernels;
+   return kernels;
+}
+
+static bool RegisterDefaultKernels()
+{
+#define MFEM_REGISTER_TBILINEARFORM_KERNELS(geom, mesh_p, sol_p) \
+   RegisterTBilinearFormKernels<geom, mesh_p, sol_p>();
+   MFEM_TBILINEARFORM_KERNELS(MFEM_REGISTER_TBILINEARFORM_KERNELS)
+#undef MFEM_REGISTER_TBILINEARFORM_KERNELS
+   return true;
+}
+
+// Register the default table on first use. The initialization of the local
+// static variable is done once, also when called from several threads.
+static void InitKernels()
+{
+   static const bool initialized = RegisterDefaultKernels();
+   MFEM_CONTRACT_VAR(initialized);
+}
+
+static bool SameParameters(const TBilinearFormKernels::Kernel &a,
+                           const TBilinearFormKernels::Kernel &b)
+{
+   return (a.geom == b.geom && a.mesh_order == b.mesh_order &&
+           a.sol_order == b.sol_order && a.ir_npoints == b.ir_npoints &&
+           a.integ == b.integ);
+}
+
+void TBilinearFormKernels::Add(const Kernel &kernel)
+{
+   Array<Kernel> &kernels = RegisteredKernels();
+   for (int i = 0; i < kernels.Size(); i++)
+   {
+      if (SameParameters(kernels[i], kernel))
+      {
+         kernels[i] = kernel;
+         return;
+      }
+   }
+   kernels.Append(kernel);
+}
+
+const TBilinearFormKernels::Kernel *TBilinearFormKernels::Find(
+   Geometry::Type geom, int mesh_order, int sol_order, int ir_npoints,
+   IntegratorType integ)
+{
+   InitKernels();
+   Kernel key;
+   key.geom = geom;
+   key.mesh_order = mesh_order;
+   key.sol_order = sol_order;
+   key.ir_npoints = ir_npoints;
+   key.integ = integ;
+   const Array<Kernel> &kernels = RegisteredKernels();
+   for (int i = 0; i < kernels.Size(); i++)
+   {
+      if (SameParameters(kernels[i], key)) { return &kernels[i]; }
+   }
+   return NULL;
+}
+
+int TBilinearFormKernels::NumKernels()
+{
+   InitKernels();
+   return RegisteredKernels().Size();
+}
+
+// Return the value of a constant (or NULL) coefficient in 'value', or false if
+// the coefficient is not constant.
+static bool GetConstantCoefficient(Coefficient *Q, double &value)
+{
+   if (Q == NULL) { value = 1.0; return true; }
+   ConstantCoefficient *cQ = dynamic_cast<ConstantCoefficient*>(Q);
+   if (cQ == NULL) { return false; }
+   value = cQ->constant;
+   return true;
+}
+
+TBilinearFormKernels::Assembler::Assembler(
+   const FiniteElementSpace &fes, const Array<BilinearFormIntegrator*> &integs)
+   : fes(fes), nodes(NULL), nodes_fec(NULL), nodes_fes(NULL),
+     linear_nodes(NULL)
+{
+   Mesh *mesh = fes.GetMesh();
+   if (integs.Size() == 0 || mesh->GetNE() == 0 || fes.GetVDim() != 1 ||
+       !dynamic_cast<const H1_FECollection*>(fes.FEColl()))
+   {
+      return;
+   }
+   const FiniteElement &el = *fes.GetFE(0);
+   const Geometry::Type geom = el.GetGeomType();
+   nodes = mesh->GetNodes();
+   const int mesh_order =
+      nodes ? nodes->FESpace()->GetFE(0)->GetOrder() : 1;
+
+   kernels.SetSize(integs.Size());
+   coeffs.SetSize(integs.Size());
+   for (int k = 0; k < integs.Size(); k++)
+   {
+      MassIntegrator *mass = dynamic_cast<MassIntegrator*>(integs[k]);
+      DiffusionIntegrator *diff = dynamic_cast<DiffusionIntegrator*>(integs[k]);
+      int ir_npoints;
+      IntegratorType type;
+      // Exact types only: derived classes may change the element matrices
+      if (mass && typeid(*mass) == typeid(MassIntegrator) &&
+          !mass->IntRule && GetConstantCoefficient(mass->Q, coeffs[k]))
+      {
+         ElementTransformation &T0 = *mesh->GetElementTransformation(0);
+         ir_npoints = MassIntegrator::GetRule(el, T0).GetNPoints();
+         type = MASS;
+      }
+      else if (diff && typeid(*diff) == typeid(DiffusionIntegrator) &&
+               !diff->IntRule && !diff->MQ &&
+               GetConstantCoefficient(diff->Q, coeffs[k]))
+      {
+         ir_npoints = DiffusionIntegrator::GetRule(el).GetNPoints();
+         type = DIFFUSION;
+      }
+      else
+      {
+         kernels.SetSize(0);
+         return;
+      }
+      kernels[k] = Find(geom, mesh_order, el.GetOrder(), ir_npoints, type);
+      if (kernels[k] == NULL || !kernels[k]->matches(fes))
+      {
+         kernels.SetSize(0);
+         return;
+      }
+   }
+
+   if (nodes == NULL)
+   {
+      // Linear nodes with the layout expected by the kernels
+      nodes_fec = new H1_FECollection(1, mesh->Dimension());
+      nodes_fes = new FiniteElementSpace(mesh, nodes_fec,
+                                         mesh->SpaceDimension(),
+                                         Ordering::byNODES);
+      linear_nodes = new GridFunction(nodes_fes);
+      mesh->GetNodes(*linear_nodes);
+      nodes = linear_nodes;
+   }
+}
+
+TBilinearFormKernels::Assembler::~Assembler()
+{
+   delete linear_nodes;
+   delete nodes_fes;
+   delete nodes_fec;
+}
+
+void TBilinearFormKernels::Assembler::ComputeElementMatrices(
+   int first, DenseTensor &elmats) const
+{
+   MFEM_ASSERT(Supported(), "no registered kernels");
+   MFEM_ASSERT(first >= 0 && first + elmats.SizeK() <= fes.GetNE(),
+               "invalid element range");
+   elmats = 0.0;
+   for (int k = 0; k < kernels.Size(); k++)
+   {
+      kernels[k]->element_matrices(fes, *nodes, coeffs[k], first, elmats);
+   }
+}
+
+DenseTensor *TBilinearFormKernels::ComputeElementMatrices(
+   const FiniteElementSpace &fes, const Array<BilinearFormIntegrator*> &integs)
+{
+   Assembler assembler(fes, integs);
+   if (!assembler.Supported()) { return NULL; }
+   const int dof = fes.GetFE(0)->GetDof();
+   DenseTensor *elmats = new DenseTensor(dof, dof, fes.GetNE());
+   assembler.ComputeElementMatrices(0, *elmats);
+   return elmats;
+}
+
+}
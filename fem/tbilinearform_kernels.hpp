@@ -0,0 +1,129 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#ifndef MFEM_TEMPLATE_BILINEAR_FORM_KERNELS
+#define MFEM_TEMPLATE_BILINEAR_FORM_KERNELS
+
+#include "../config/config.hpp"
+#include "../general/array.hpp"
+#include "../linalg/densemat.hpp"
+#include "../mesh/mesh.hpp"
+
+namespace mfem
+{
+
+class FiniteElementCollection;
+class FiniteElementSpace;
+class GridFunction;
+class BilinearFormIntegrator;
+
+/** @brief Registry of instantiations of the templated TBilinearForm kernels,
+    used by BilinearForm to compute element matrices without recompiling the
+    application for each run configuration. */
+/** Each registered kernel computes the element matrices of MassIntegrator or
+    DiffusionIntegrator, with a constant (or no) coefficient and the default
+    integration rule, for a fixed geometry, mesh order and solution order.
+    BilinearForm::Assemble() and BilinearForm::ComputeElementMatrices() use the
+    kernels through the class Assembler, unless disabled for the form with
+    BilinearForm::UseTemplatedKernels(0); if there is no registered kernel for
+    the space or for one of the domain integrators, the generic path is used
+    instead.
+
+    The library registers the combinations listed in the table at the top of
+    tbilinearform_kernels.cpp. Applications can register more combinations
+    with RegisterTBilinearFormKernels(), see tbilininteg.hpp. */
+class TBilinearFormKernels
+{
+public:
+   /// The integrators with templated kernels.
+   enum IntegratorType { MASS, DIFFUSION };
+
+   /** @brief Add to @a elmats (size dof x dof x n) the element matrices of
+       the integrator for the elements @a first, ..., @a first+n-1 of @a fes,
+       in the native dof ordering of the elements, using the mesh @a nodes and
+       the constant coefficient @a coeff. */
+   typedef void (*ElementMatricesFunction)(const FiniteElementSpace &fes,
+                                           const GridFunction &nodes,
+                                           double coeff, int first,
+                                           DenseTensor &elmats);
+
+   /// Return true if the mesh and the space @a fes match the kernel.
+   typedef bool (*MatchesFunction)(const FiniteElementSpace &fes);
+
+   /// A registered kernel
+   struct Kernel
+   {
+      Geometry::Type geom;
+      int mesh_order;  ///< Order of the mesh nodes (1 for meshes without nodes)
+      int sol_order;   ///< Order of the H1 solution space
+      int ir_npoints;  ///< Number of points of the integration rule
+      IntegratorType integ;
+      MatchesFunction matches;
+      ElementMatricesFunction element_matrices;
+   };
+
+   /** @brief Add a kernel to the registry, replacing a registered one with
+       the same geometry, orders, integration rule and integrator type. */
+   static void Add(const Kernel &kernel);
+
+   /** @brief Return the registered kernel for the given parameters, or NULL if
+       there is none. */
+   static const Kernel *Find(Geometry::Type geom, int mesh_order,
+                             int sol_order, int ir_npoints,
+                             IntegratorType integ);
+
+   /// Return the number of registered kernels.
+   static int NumKernels();
+
+   /** @brief The registered kernels for the domain integrators of a form,
+       used to compute the element matrices in batches of elements. */
+   class Assembler
+   {
+   protected:
+      const FiniteElementSpace &fes;
+      Array<const Kernel*> kernels;
+      Array<double> coeffs;
+      const GridFunction *nodes;
+      // Linear nodes for meshes without nodes
+      FiniteElementCollection *nodes_fec;
+      FiniteElementSpace *nodes_fes;
+      GridFunction *linear_nodes;
+
+   public:
+      /** @brief Find the kernels for the integrators @a integs on @a fes, see
+          Supported(). */
+      Assembler(const FiniteElementSpace &fes,
+                const Array<BilinearFormIntegrator*> &integs);
+
+      ~Assembler();
+
+      /** @brief Return true if the space and all integrators have a
+          registered kernel. */
+      bool Supported() const { return kernels.Size() > 0; }
+
+      /** @brief Set @a elmats (size dof x dof x n) to the element matrices of
+          the sum of the integrators for the elements @a first, ...,
+          @a first+n-1. */
+      void ComputeElementMatrices(int first, DenseTensor &elmats) const;
+   };
+
+   /** @brief Return the element matrices of the sum of the integrators
+       @a integs on @a fes, computed with the registered kernels, or NULL if
+       the space or one of the integrators has no registered kernel. */
+   /** The returned DenseTensor is owned by the caller. */
+   static DenseTensor *ComputeElementMatrices(
+      const FiniteElementSpace &fes,
+      const Array<BilinearFormIntegrator*> &integs);
+};
+
+}
+
+#endif
@@ -13,8 +13,12 @@
 #define MFEM_TEMPLATE_BILININTEG
 
 #include "../config/tconfig.hpp"
+#include "../mesh/tmesh.hpp"
+#include "tintrules.hpp"
+#include "tfespace.hpp"
 #include "tcoefficient.hpp"
 #include "tbilinearform.hpp"
+#include "tbilinearform_kernels.hpp"
 
 namespace mfem
 {
@@ -554,6 +558,104 @@ struct TDiffusionKernel<3,3,complex_t>
    }
 };
 
+/** @brief TBilinearForm kernel for the runtime dispatch of
+    TBilinearFormKernels: H1 space of order @a sol_p on a mesh with elements of
+    geometry @a geom and nodes of order @a mesh_p (or without nodes, if
+    @a mesh_p is 1), integration rule of order @a ir_order, and a constant
+    coefficient. */
+template <Geometry::Type geom, int mesh_p, int sol_p, int ir_order,
+          template<int,int,typename> class kernel_t>
+class TBilinearFormKernel
+{
+public:
+   static const int dim = Geometry::Constants<geom>::Dimension;
+
+   typedef H1_FiniteElement<geom,mesh_p>                mesh_fe_t;
+   typedef H1_FiniteElementSpace<mesh_fe_t>             mesh_fes_t;
+   typedef TMesh<mesh_fes_t>                            mesh_t;
+   typedef H1_FiniteElement<geom,sol_p>                 sol_fe_t;
+   typedef H1_FiniteElementSpace<sol_fe_t>              sol_fes_t;
+   typedef TIntegrationRule<geom,ir_order>              int_rule_t;
+   typedef TConstantCoefficient<>                       coeff_t;
+   typedef TIntegrator<coeff_t,kernel_t>                integ_t;
+   typedef TBilinearForm<mesh_t,sol_fes_t,int_rule_t,integ_t> form_t;
+
+   static bool Matches(const FiniteElementSpace &fes)
+   {
+      const Mesh &mesh = *fes.GetMesh();
+      if (fes.GetVDim() != 1 || !mesh_t::MatchesGeometry(mesh) ||
+          !sol_fes_t::Matches(fes))
+      {
+         return false;
+      }
+      return mesh.GetNodes() ? mesh_t::MatchesNodes(mesh) : (mesh_p == 1);
+   }
+
+   static void ElementMatrices(const FiniteElementSpace &fes,
+                               const GridFunction &nodes, double coeff,
+                               int first, DenseTensor &elmats)
+   {
+      const int NE = elmats.SizeK();
+      const int dofs = sol_fe_t::dofs;
+      DenseTensor M(dofs, dofs, NE);
+      form_t form(integ_t(coeff_t(coeff)), fes, nodes);
+      form.AssembleMatrix(M, first, NE);
+
+      // Switch from the lexicographic ordering of the kernels
+      const TensorBasisElement *tfe =
+         dynamic_cast<const TensorBasisElement*>(fes.GetFE(0));
+      const int *dof_map = (tfe && tfe->GetDofMap().Size()) ?
+                           tfe->GetDofMap().GetData() : NULL;
+      for (int e = 0; e < NE; e++)
+      {
+         const double *Me = M.GetData(e);
+         double *Ee = elmats.GetData(e);
+         for (int j = 0; j < dofs; j++)
+         {
+            const int dj = dof_map ? dof_map[j] : j;
+            for (int i = 0; i < dofs; i++)
+            {
+               const int di = dof_map ? dof_map[i] : i;
+               Ee[di+dofs*dj] += Me[i+dofs*j];
+            }
+         }
+      }
+   }
+
+   static TBilinearFormKernels::Kernel Get(
+      TBilinearFormKernels::IntegratorType integ)
+   {
+      TBilinearFormKernels::Kernel k;
+      k.geom = geom;
+      k.mesh_order = mesh_p;
+      k.sol_order = sol_p;
+      k.ir_npoints = int_rule_t::qpts;
+      k.integ = integ;
+      k.matches = Matches;
+      k.element_matrices = ElementMatrices;
+      return k;
+   }
+};
+
+/** @brief Register in TBilinearFormKernels the templated MassIntegrator and
+    DiffusionIntegrator kernels for the given geometry, mesh order and solution
+    order, using the default integration rules of the integrators. */
+template <Geometry::Type geom, int mesh_p, int sol_p>
+inline void RegisterTBilinearFormKernels()
+{
+   const int dim = Geometry::Constants<geom>::Dimension;
+   const bool tensor = (geom == Geometry::SQUARE || geom == Geometry::CUBE);
+   // Same as MassIntegrator::GetRule() and DiffusionIntegrator::GetRule()
+   const int mass_order = 2*sol_p + (tensor ? dim*mesh_p - 1 : dim*(mesh_p-1));
+   const int diff_order = tensor ? 2*sol_p + dim - 1 : 2*sol_p - 2;
+   TBilinearFormKernels::Add(
+      TBilinearFormKernel<geom,mesh_p,sol_p,mass_order,TMassKernel>::Get(
+         TBilinearFormKernels::MASS));
+   TBilinearFormKernels::Add(
+      TBilinearFormKernel<geom,mesh_p,sol_p,diff_order,TDiffusionKernel>::Get(
+         TBilinearFormKernels::DIFFUSION));
+}
+
 } // namespace mfem
 
 #endif // MFEM_TEMPLATE_BILININTEG
@@ -185,7 +185,8 @@ public:
                          D_data_t           &D_data) const
    {
       const int NC = qpt_layout_t::dim_4;
-      TTensor4<NIP,DIM,DOF,NC> F;
+      typedef typename qpt_data_t::data_type entry_t;
+      TTensor4<NIP,DIM,DOF,NC,entry_t> F;
       for (int k = 0; k < NC; k++)
       {
          // Next loop performs a batch of matrix-matrix products of size
@@ -354,7 +355,8 @@ public:
    {
       const int NC = dof_layout_t::dim_2;
       // DOF x DOF x NC --> NIP x DOF x NC --> NIP x NIP x NC
-      TTensor3<NIP,DOF,NC> A;
+      typedef typename qpt_data_t::data_type entry_t;
+      TTensor3<NIP,DOF,NC,entry_t> A;
 
       // (1) A_{i,j,k} = \sum_s B_1d_{i,s} dof_data_{s,j,k}
       Mult_2_1<false>(B_1d.layout, Dx ? G_1d : B_1d,
@@ -386,7 +388,8 @@ public:
    {
       const int NC = dof_layout_t::dim_2;
       // NIP x NIP X NC --> NIP x DOF x NC --> DOF x DOF x NC
-      TTensor3<NIP,DOF,NC> A;
+      typedef typename qpt_data_t::data_type entry_t;
+      TTensor3<NIP,DOF,NC,entry_t> A;
 
       // (1) A_{i,j,k} = \sum_s B_1d_{s,j} qpt_data_{i,s,k}
       Mult_1_2<false>(B_1d.layout, Dy ? G_1d : B_1d,
@@ -457,7 +460,8 @@ public:
       // Using TensorAssemble: <I,NIP,J> --> <DOF,I,DOF,J>
 
 #if 0
-      TTensor4<DOF,NIP,DOF,NC> A;
+      typedef typename qpt_data_t::data_type entry_t;
+      TTensor4<DOF,NIP,DOF,NC,entry_t> A;
       // qpt_data<NIP1,NIP2,NC> --> A<DOF2,NIP1,DOF2,NC>
       TensorAssemble<false>(
          B_1d.layout, B_1d,
@@ -469,7 +473,8 @@ public:
          TTensor3<DOF,NIP,DOF*NC>::layout, A,
          M_layout.merge_23().template split_12<DOF,DOF,DOF,DOF*NC>(), M_data);
 #elif 1
-      TTensor4<DOF,NIP,DOF,NC> A;
+      typedef typename qpt_data_t::data_type entry_t;
+      TTensor4<DOF,NIP,DOF,NC,entry_t> A;
       // qpt_data<NIP1,NIP2,NC> --> A<DOF2,NIP1,DOF2,NC>
       TensorAssemble<false>(
          Bt_1d.layout, Bt_1d, B_1d.layout, B_1d,
@@ -481,9 +486,10 @@ public:
          A.layout.merge_34(), A,
          M_layout.merge_23().template split_12<DOF,DOF,DOF,DOF*NC>(), M_data);
 #else
-      TTensor3<NIP,NIP,DOF> F3;
-      TTensor4<NIP,NIP,DOF,DOF> F4;
-      TTensor3<NIP,DOF,DOF*DOF> H3;
+      typedef typename qpt_data_t::data_type entry_t;
+      TTensor3<NIP,NIP,DOF,entry_t> F3;
+      TTensor4<NIP,NIP,DOF,DOF,entry_t> F4;
+      TTensor3<NIP,DOF,DOF*DOF,entry_t> H3;
       for (int k = 0; k < NC; k++)
       {
          // <1,NIP1,NIP2> --> <1,NIP1,NIP2,DOF1>
@@ -517,7 +523,8 @@ public:
                  D_data_t           &D_data) const
    {
       const int NC = qpt_layout_t::dim_2;
-      TTensor4<DOF,NIP,DOF,NC> A;
+      typedef typename qpt_data_t::data_type entry_t;
+      TTensor4<DOF,NIP,DOF,NC,entry_t> A;
 
       // Using TensorAssemble: <I,NIP,J> --> <DOF,I,DOF,J>
 
@@ -553,9 +560,10 @@ public:
       Assemble<1,1,true >(qpt_layout.ind23(1,1), qpt_data, D_layout, D_data);
 #else
       const int NC = qpt_layout_t::dim_4;
-      TTensor3<NIP,NIP,DOF> F3;
-      TTensor4<NIP,NIP,DOF,DOF> F4;
-      TTensor3<NIP,DOF,DOF*DOF> H3;
+      typedef typename qpt_data_t::data_type entry_t;
+      TTensor3<NIP,NIP,DOF,entry_t> F3;
+      TTensor4<NIP,NIP,DOF,DOF,entry_t> F4;
+      TTensor3<NIP,DOF,DOF*DOF,entry_t> H3;
 
       for (int k = 0; k < NC; k++)
       {
@@ -629,8 +637,9 @@ public:
              const qpt_layout_t &qpt_layout, qpt_data_t &qpt_data) const
    {
       const int NC = dof_layout_t::dim_2;
-      TVector<NIP*DOF*DOF*NC> QDD;
-      TVector<NIP*NIP*DOF*NC> QQD;
+      typedef typename qpt_data_t::data_type entry_t;
+      TVector<NIP*DOF*DOF*NC,entry_t> QDD;
+      TVector<NIP*NIP*DOF*NC,entry_t> QQD;
 
       // QDD_{i,jj,k} = \sum_s B_1d_{i,s} dof_data_{s,jj,k}
       Mult_2_1<false>(B_1d.layout, Dx ? G_1d : B_1d,
@@ -665,8 +674,9 @@ public:
               const dof_layout_t &dof_layout, dof_data_t &dof_data) const
    {
       const int NC = dof_layout_t::dim_2;
-      TVector<NIP*DOF*DOF*NC> QDD;
-      TVector<NIP*NIP*DOF*NC> QQD;
+      typedef typename qpt_data_t::data_type entry_t;
+      TVector<NIP*DOF*DOF*NC,entry_t> QDD;
+      TVector<NIP*NIP*DOF*NC,entry_t> QQD;
 
       // QQD_{ii,j,k} = \sum_s B_1d_{s,j} qpt_data_{ii,s,k}
       Mult_1_2<false>(B_1d.layout, Dz ? G_1d : B_1d,
@@ -743,8 +753,9 @@ public:
                  const M_layout_t &M_layout, M_data_t &M_data) const
    {
       const int NC = qpt_layout_t::dim_2;
-      TTensor4<DOF,NIP*NIP,DOF,NC> A1;
-      TTensor4<DOF,DOF*NIP,DOF,DOF*NC> A2;
+      typedef typename qpt_data_t::data_type entry_t;
+      TTensor4<DOF,NIP*NIP,DOF,NC,entry_t> A1;
+      TTensor4<DOF,DOF*NIP,DOF,DOF*NC,entry_t> A2;
 
       // Using TensorAssemble: <I,NIP,J> --> <DOF,I,DOF,J>
 
@@ -795,8 +806,9 @@ public:
                  D_data_t           &D_data) const
    {
       const int NC = qpt_layout_t::dim_2;
-      TTensor4<DOF,NIP*NIP,DOF,NC> A1;
-      TTensor4<DOF,DOF*NIP,DOF,DOF*NC> A2;
+      typedef typename qpt_data_t::data_type entry_t;
+      TTensor4<DOF,NIP*NIP,DOF,NC,entry_t> A1;
+      TTensor4<DOF,DOF*NIP,DOF,DOF*NC,entry_t> A2;
 
       // Using TensorAssemble: <I,NIP,J> --> <DOF,I,DOF,J>
 
@@ -832,8 +844,9 @@ public:
                  D_data_t           &D_data) const
    {
       const int NC = qpt_layout_t::dim_2;
-      TTensor4<DOF,NIP*NIP,DOF,NC> A1;
-      TTensor4<DOF,DOF*NIP,DOF,DOF*NC> A2;
+      typedef typename qpt_data_t::data_type entry_t;
+      TTensor4<DOF,NIP*NIP,DOF,NC,entry_t> A1;
+      TTensor4<DOF,DOF*NIP,DOF,DOF*NC,entry_t> A2;
 
       // Using TensorAssemble: <I,NIP,J> --> <DOF,I,DOF,J>
 
@@ -1109,7 +1122,8 @@ public:
       Assemble<Add>(F);
    }
 
-#ifdef MFEM_TEMPLATE_ENABLE_SERIALIZE
+   // Eval/Assemble using local dof data, loc_dofs, with layout
+   // (dofs x vdim x NE), instead of the global data.
    template <typename DataType>
    inline MFEM_ALWAYS_INLINE
    void EvalSerialized(const complex_t *loc_dofs, DataType &F)
@@ -1124,7 +1138,6 @@ public:
       Action<DataType::OutData,true>::
       template AssembleSerialized<Add>(*this, F, loc_dofs);
    }
-#endif
 
    // Enumeration for the data type used by the Eval() and Assemble() methods.
    // The types can obtained by summing constants from this enumeration and used
@@ -1235,7 +1248,6 @@ public:
             val_dofs.layout, val_dofs, l, T.data_out);
       }
 
-#ifdef MFEM_TEMPLATE_ENABLE_SERIALIZE
       template <typename AData_t>
       static inline MFEM_ALWAYS_INLINE
       void EvalSerialized(T_type &T, const complex_t *loc_dofs, AData_t &D)
@@ -1252,7 +1264,6 @@ public:
             D.val_qpts.layout.merge_23(), D.val_qpts,
             AData_t::val_dofs_t::layout.merge_23(), loc_dofs);
       }
-#endif
    };
 
    template <bool dummy> struct Action<2,dummy> // 2 = Gradients
@@ -1288,7 +1299,6 @@ public:
             val_dofs.layout, val_dofs, l, T.data_out);
       }
 
-#ifdef MFEM_TEMPLATE_ENABLE_SERIALIZE
       template <typename AData_t>
       static inline MFEM_ALWAYS_INLINE
       void EvalSerialized(T_type &T, const complex_t *loc_dofs, AData_t &D)
@@ -1305,7 +1315,6 @@ public:
             D.grad_qpts.layout.merge_34(), D.grad_qpts,
             AData_t::val_dofs_t::layout.merge_23(), loc_dofs);
       }
-#endif
    };
 
    template <bool dummy> struct Action<3,dummy> // 3 = Values+Gradients
@@ -1346,7 +1355,6 @@ public:
             val_dofs.layout, val_dofs, l, T.data_out);
       }
 
-#ifdef MFEM_TEMPLATE_ENABLE_SERIALIZE
       template <typename AData_t>
       static inline MFEM_ALWAYS_INLINE
       void EvalSerialized(T_type &T, const complex_t *loc_dofs, AData_t &D)
@@ -1368,7 +1376,6 @@ public:
             D.grad_qpts.layout.merge_34(), D.grad_qpts,
             AData_t::val_dofs_t::layout.merge_23(), loc_dofs);
       }
-#endif
    };
 
    // This struct implements element matrix computation for some combinations
@@ -549,6 +549,138 @@ protected:
 };
 
 
+/** @brief A read-only copy of an array of pointers that can be read by many
+    threads without locking while new entries are published by one thread.
+
+    The writer updates its own Array, e.g. under an OpenMP critical section,
+    and calls Publish(), which updates the copy seen by the readers. The copy
+    is reallocated with doubled capacity when the Array outgrows it; the
+    previous buffers are kept until the object is destroyed, so a reader never
+    accesses freed memory, and the total storage stays linear in the size of
+    the Array. The Array may grow and its NULL entries may be set, but its
+    other entries must not change. The pointed-to objects must be fully
+    constructed before they are published, and must not be modified or
+    deleted while the PublishedArray is in use; they are not owned by the
+    PublishedArray.
+
+    With OpenMP, the size, the buffer pointer and the entries are written and
+    read with atomic operations, and the writer and the readers flush around
+    them, so that a reader that sees a new entry also sees the object it
+    points to, also on weakly ordered processors. */
+template <class T>
+class PublishedArray
+{
+private:
+   /// The current buffer, read without locking, see Get() and Publish().
+   T **data;
+   /// The number of published entries in #data.
+   int size;
+   /// The number of entries allocated in #data.
+   int capacity;
+   /// The previous buffers, which may still be used by readers.
+   Array<T**> old_data;
+
+   // Copying is not supported.
+   PublishedArray(const PublishedArray &);
+   PublishedArray &operator=(const PublishedArray &);
+
+public:
+   PublishedArray() : data(NULL), size(0), capacity(0) { }
+
+   /** @brief Return the published entry @a i, or NULL if @a i is out of range.
+       Can be called concurrently with Publish(). */
+   T *Get(int i) const
+   {
+      int sz;
+#ifdef MFEM_USE_OPENMP
+      #pragma omp atomic read
+#endif
+      sz = size;
+      // Read the buffer and its entries only after the size (acquire): a
+      // buffer at least as new as the size is seen
+#ifdef MFEM_USE_OPENMP
+      #pragma omp flush
+#endif
+      if (i >= sz) { return NULL; }
+      T **d, *entry;
+#ifdef MFEM_USE_OPENMP
+      #pragma omp atomic read
+#endif
+      d = data;
+#ifdef MFEM_USE_OPENMP
+      #pragma omp atomic read
+#endif
+      entry = d[i];
+#ifdef MFEM_USE_OPENMP
+      #pragma omp flush
+#endif
+      return entry;
+   }
+
+   /** @brief Make the entries of @a a visible to the readers. Concurrent calls
+       must be serialized by the caller. */
+   void Publish(const Array<T*> &a)
+   {
+      const int n = a.Size();
+      MFEM_ASSERT(n >= size, "the published array cannot shrink");
+      // Complete all writes before the new entries become visible (release)
+#ifdef MFEM_USE_OPENMP
+      #pragma omp flush
+#endif
+      if (n > capacity)
+      {
+         // The readers may still use the current buffer: keep it
+         const int new_capacity = (n > 2*capacity) ? n : 2*capacity;
+         T **new_data = new T*[new_capacity];
+         for (int i = 0; i < new_capacity; i++)
+         {
+            new_data[i] = (i < n) ? a[i] : NULL;
+         }
+         if (data) { old_data.Append(data); }
+#ifdef MFEM_USE_OPENMP
+         #pragma omp flush
+         #pragma omp atomic write
+#endif
+         data = new_data;
+         capacity = new_capacity;
+      }
+      else
+      {
+         for (int i = 0; i < n; i++)
+         {
+            if (data[i] == a[i]) { continue; }
+            MFEM_ASSERT(data[i] == NULL || i >= size,
+                        "published entries cannot change: " << i);
+#ifdef MFEM_USE_OPENMP
+            #pragma omp atomic write
+#endif
+            data[i] = a[i];
+         }
+      }
+#ifdef MFEM_USE_OPENMP
+      #pragma omp flush
+      #pragma omp atomic write
+#endif
+      size = n;
+#ifdef MFEM_USE_OPENMP
+      #pragma omp flush
+#endif
+   }
+
+   /// Remove all entries. Must not be called concurrently with Get().
+   void Clear()
+   {
+      for (int i = 0; i < old_data.Size(); i++) { delete [] old_data[i]; }
+      old_data.SetSize(0);
+      delete [] data;
+      data = NULL;
+      size = capacity = 0;
+   }
+
+   ~PublishedArray() { Clear(); }
+};
+
+
 /// inlines ///
 
 template <class T>
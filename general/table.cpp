@@ -197,6 +197,9 @@ void Table::GetRow(int i, Array<int> &row) const
 
 void Table::SortRows()
 {
+#ifdef MFEM_USE_OPENMP
+   #pragma omp parallel for
+#endif
    for (int r = 0; r < size; r++)
    {
       std::sort(J + I[r], J + I[r+1]);
@@ -477,7 +480,6 @@ void Transpose(const Array<int> &A, Table &At, int _ncols_A)
 
 void Mult (const Table &A, const Table &B, Table &C)
 {
-   int  i, j, k, l, m;
    const int *i_A     = A.GetI();
    const int *j_A     = A.GetJ();
    const int *i_B     = B.GetI();
@@ -490,59 +492,74 @@ void Mult (const Table &A, const Table &B, Table &C)
    MFEM_VERIFY( ncols_A <= nrows_B, "Table size mismatch: ncols_A = " << ncols_A
                 << ", nrows_B = " << nrows_B);
 
-   Array<int> B_marker (ncols_B);
-
-   for (i = 0; i < ncols_B; i++)
-   {
-      B_marker[i] = -1;
-   }
-
-   int counter = 0;
-   for (i = 0; i < nrows_A; i++)
+   // The first pass counts the entries in each row of C and the second one
+   // fills them. The rows are independent, so with OpenMP they are processed
+   // in parallel, each thread using its own marker array.
+   int *i_C = new int[nrows_A+1];
+   i_C[0] = 0;
+#ifdef MFEM_USE_OPENMP
+   #pragma omp parallel
+#endif
    {
-      for (j = i_A[i]; j < i_A[i+1]; j++)
+      Array<int> B_marker(ncols_B);
+      B_marker = -1;
+#ifdef MFEM_USE_OPENMP
+      #pragma omp for
+#endif
+      for (int i = 0; i < nrows_A; i++)
       {
-         k = j_A[j];
-         for (l = i_B[k]; l < i_B[k+1]; l++)
+         int counter = 0;
+         for (int j = i_A[i]; j < i_A[i+1]; j++)
          {
-            m = j_B[l];
-            if (B_marker[m] != i)
+            const int k = j_A[j];
+            for (int l = i_B[k]; l < i_B[k+1]; l++)
             {
-               B_marker[m] = i;
-               counter++;
+               const int m = j_B[l];
+               if (B_marker[m] != i)
+               {
+                  B_marker[m] = i;
+                  counter++;
+               }
             }
          }
+         i_C[i+1] = counter;
       }
    }
-
-   C.SetDims (nrows_A, counter);
-
-   for (i = 0; i < ncols_B; i++)
+   for (int i = 0; i < nrows_A; i++)
    {
-      B_marker[i] = -1;
+      i_C[i+1] += i_C[i];
    }
 
-   int *i_C = C.GetI();
-   int *j_C = C.GetJ();
-   counter = 0;
-   for (i = 0; i < nrows_A; i++)
+   int *j_C = new int[i_C[nrows_A]];
+#ifdef MFEM_USE_OPENMP
+   #pragma omp parallel
+#endif
    {
-      i_C[i] = counter;
-      for (j = i_A[i]; j < i_A[i+1]; j++)
+      Array<int> B_marker(ncols_B);
+      B_marker = -1;
+#ifdef MFEM_USE_OPENMP
+      #pragma omp for
+#endif
+      for (int i = 0; i < nrows_A; i++)
       {
-         k = j_A[j];
-         for (l = i_B[k]; l < i_B[k+1]; l++)
+         int counter = i_C[i];
+         for (int j = i_A[i]; j < i_A[i+1]; j++)
          {
-            m = j_B[l];
-            if (B_marker[m] != i)
+            const int k = j_A[j];
+            for (int l = i_B[k]; l < i_B[k+1]; l++)
             {
-               B_marker[m] = i;
-               j_C[counter] = m;
-               counter++;
+               const int m = j_B[l];
+               if (B_marker[m] != i)
+               {
+                  B_marker[m] = i;
+                  j_C[counter] = m;
+                  counter++;
+               }
             }
          }
       }
    }
+   C.SetIJ(i_C, j_C, nrows_A);
 }
 
 
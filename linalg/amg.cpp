@@ -0,0 +1,396 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+// Implementation of class AMGSolver
+
+#include "linalg.hpp"
+#include <cmath>
+
+namespace mfem
+{
+
+AMGSolver::AMGSolver()
+{
+   theta = 0.08;
+   max_levels = 25;
+   coarse_size = 100;
+   smooth_sweeps = 1;
+   print_level = 0;
+   smoother_type = GAUSS_SEIDEL;
+   cycle_type = V_CYCLE;
+   single_precision = false;
+   coarse_direct = false;
+}
+
+AMGSolver::AMGSolver(const SparseMatrix &a)
+{
+   theta = 0.08;
+   max_levels = 25;
+   coarse_size = 100;
+   smooth_sweeps = 1;
+   print_level = 0;
+   smoother_type = GAUSS_SEIDEL;
+   cycle_type = V_CYCLE;
+   single_precision = false;
+   coarse_direct = false;
+
+   SetOperator(a);
+}
+
+void AMGSolver::ClearSmoothers()
+{
+   for (int l = 0; l < A_sp.Size(); l++) { delete A_sp[l]; }
+   for (int l = 0; l < smoothers.Size(); l++)
+   {
+      delete smoothers[l];
+      delete post_smoothers[l];
+   }
+   A_sp.SetSize(0);
+   smoothers.SetSize(0);
+   post_smoothers.SetSize(0);
+}
+
+void AMGSolver::Clear()
+{
+   ClearSmoothers();
+   for (int l = 1; l < A.Size(); l++) { delete A[l]; }
+   for (int l = 0; l < P.Size(); l++) { delete P[l]; }
+   for (int l = 0; l < x_lev.Size(); l++)
+   {
+      delete x_lev[l];
+      delete b_lev[l];
+      delete r_lev[l];
+   }
+   A.SetSize(0);
+   P.SetSize(0);
+   x_lev.SetSize(0);
+   b_lev.SetSize(0);
+   r_lev.SetSize(0);
+}
+
+void AMGSolver::SetSinglePrecision(bool sp)
+{
+   if (sp == single_precision) { return; }
+   single_precision = sp;
+   if (A.Size() > 0)
+   {
+      // Rebuild the smoothers of the existing hierarchy
+      ClearSmoothers();
+      SetupSmoothers();
+   }
+}
+
+void AMGSolver::SetOperator(const Operator &op)
+{
+   const SparseMatrix *a = dynamic_cast<const SparseMatrix*>(&op);
+   MFEM_VERIFY(a != NULL, "the operator must be a SparseMatrix");
+   MFEM_VERIFY(a->Finalized(), "the SparseMatrix must be finalized");
+   MFEM_VERIFY(a->Height() == a->Width(), "the SparseMatrix must be square");
+
+   height = width = a->Height();
+   Clear();
+   A.Append(a);
+   Setup();
+}
+
+int AMGSolver::Aggregate(const SparseMatrix &Al, Array<int> &aggregates) const
+{
+   const int n = Al.Height();
+   const int *I = Al.GetI(), *J = Al.GetJ();
+   const double *V = Al.GetData();
+   Vector diag;
+   Al.GetDiag(diag);
+
+   // Mark the strong connections: entry k of row i is strong if it is an
+   // off-diagonal entry with |a_ij| >= theta sqrt(|a_ii a_jj|).
+   Array<bool> strong(I[n]);
+   for (int i = 0; i < n; i++)
+   {
+      for (int k = I[i]; k < I[i+1]; k++)
+      {
+         const int j = J[k];
+         strong[k] = (j != i && V[k] != 0.0 &&
+                      fabs(V[k]) >= theta*sqrt(fabs(diag(i)*diag(j))));
+      }
+   }
+
+   // -1: not yet aggregated, -2: no strong connections (never aggregated)
+   aggregates.SetSize(n);
+   for (int i = 0; i < n; i++)
+   {
+      aggregates[i] = -2;
+      for (int k = I[i]; k < I[i+1]; k++)
+      {
+         if (strong[k]) { aggregates[i] = -1; break; }
+      }
+   }
+
+   // Pass 1: rows whose strong neighbors are all free start new aggregates
+   int num_agg = 0;
+   for (int i = 0; i < n; i++)
+   {
+      if (aggregates[i] != -1) { continue; }
+      bool free_nbrs = true;
+      for (int k = I[i]; k < I[i+1]; k++)
+      {
+         if (strong[k] && aggregates[J[k]] >= 0) { free_nbrs = false; break; }
+      }
+      if (!free_nbrs) { continue; }
+      aggregates[i] = num_agg;
+      for (int k = I[i]; k < I[i+1]; k++)
+      {
+         if (strong[k]) { aggregates[J[k]] = num_agg; }
+      }
+      num_agg++;
+   }
+
+   // Pass 2: join the remaining rows to the aggregate of the strongest
+   // neighbor aggregated in pass 1
+   Array<int> agg1(aggregates);
+   for (int i = 0; i < n; i++)
+   {
+      if (agg1[i] != -1) { continue; }
+      double max_a = 0.0;
+      for (int k = I[i]; k < I[i+1]; k++)
+      {
+         if (strong[k] && agg1[J[k]] >= 0 && fabs(V[k]) > max_a)
+         {
+            max_a = fabs(V[k]);
+            aggregates[i] = agg1[J[k]];
+         }
+      }
+   }
+
+   // Pass 3: the rows that are still free form new aggregates with their free
+   // strong neighbors
+   for (int i = 0; i < n; i++)
+   {
+      if (aggregates[i] != -1) { continue; }
+      aggregates[i] = num_agg;
+      for (int k = I[i]; k < I[i+1]; k++)
+      {
+         if (strong[k] && aggregates[J[k]] == -1)
+         {
+            aggregates[J[k]] = num_agg;
+         }
+      }
+      num_agg++;
+   }
+
+   return num_agg;
+}
+
+SparseMatrix *AMGSolver::Prolongation(const SparseMatrix &Al,
+                                      const Array<int> &aggregates,
+                                      int num_agg) const
+{
+   const int n = Al.Height();
+
+   // Tentative prolongation, interpolating constants on the aggregates
+   int *P0_i = new int[n+1];
+   P0_i[0] = 0;
+   for (int i = 0; i < n; i++)
+   {
+      P0_i[i+1] = P0_i[i] + (aggregates[i] >= 0 ? 1 : 0);
+   }
+   int *P0_j = new int[P0_i[n]];
+   double *P0_data = new double[P0_i[n]];
+   for (int i = 0; i < n; i++)
+   {
+      if (aggregates[i] >= 0)
+      {
+         P0_j[P0_i[i]] = aggregates[i];
+         P0_data[P0_i[i]] = 1.0;
+      }
+   }
+   SparseMatrix P0(P0_i, P0_j, P0_data, n, num_agg);
+
+   // Upper bound for the spectral radius of D^{-1} A (Gershgorin)
+   Vector diag;
+   Al.GetDiag(diag);
+   const int *I = Al.GetI();
+   const double *V = Al.GetData();
+   double rho = 0.0;
+   for (int i = 0; i < n; i++)
+   {
+      MFEM_VERIFY(diag(i) != 0.0, "zero diagonal entry in row " << i);
+      double row_sum = 0.0;
+      for (int k = I[i]; k < I[i+1]; k++) { row_sum += fabs(V[k]); }
+      rho = std::max(rho, row_sum/fabs(diag(i)));
+   }
+   const double omega = 4.0/(3.0*rho);
+
+   // Smoothed prolongation: P = P0 - omega D^{-1} A P0
+   SparseMatrix *Pl = mfem::Mult(Al, P0);
+   for (int i = 0; i < n; i++)
+   {
+      Pl->ScaleRow(i, -omega/diag(i));
+      if (aggregates[i] >= 0) { Pl->Add(i, aggregates[i], 1.0); }
+   }
+   return Pl;
+}
+
+void AMGSolver::Setup()
+{
+   for (int l = 0; l + 1 < max_levels && A[l]->Height() > coarse_size; l++)
+   {
+      const SparseMatrix &Al = *A[l];
+      Array<int> aggregates;
+      const int num_agg = Aggregate(Al, aggregates);
+      // stop if the coarsening stagnates
+      if (num_agg == 0 || num_agg > 0.9*Al.Height()) { break; }
+
+      SparseMatrix *Pl = Prolongation(Al, aggregates, num_agg);
+      P.Append(Pl);
+      A.Append(RAP(*Pl, Al, *Pl));
+   }
+
+   // The dense factorization is O(n^3): after stagnation, the coarsest
+   // operator may be too large for it
+   coarse_direct = (A.Last()->Height() <= 4*coarse_size);
+   SetupSmoothers();
+   const int num_levels = A.Size();
+   for (int l = 0; l < num_levels; l++)
+   {
+      const int n = A[l]->Height();
+      x_lev.Append(l > 0 ? new Vector(n) : NULL);
+      b_lev.Append(l > 0 ? new Vector(n) : NULL);
+      r_lev.Append(new Vector(n));
+   }
+
+   if (coarse_direct)
+   {
+      A.Last()->ToDenseMatrix(coarse_mat);
+      coarse_inv.Factor(coarse_mat);
+   }
+   else
+   {
+      coarse_mat.Clear();
+   }
+
+   if (print_level > 0)
+   {
+      mfem::out << "AMGSolver: " << num_levels << " levels, operator "
+                << "complexity " << GetOperatorComplexity() << ", "
+                << (coarse_direct ? "direct" : "smoothed") << " coarsest "
+                << "level\n";
+      for (int l = 0; l < num_levels; l++)
+      {
+         mfem::out << "   level " << l << ": " << A[l]->Height() << " rows, "
+                   << A[l]->NumNonZeroElems() << " nonzeros\n";
+      }
+   }
+}
+
+void AMGSolver::SetupSmoothers()
+{
+   const int num_smoothed = coarse_direct ? A.Size() - 1 : A.Size();
+   for (int l = 0; l < num_smoothed; l++)
+   {
+      FloatSparseMatrix *Al_sp =
+         single_precision ? new FloatSparseMatrix(*A[l]) : NULL;
+      A_sp.Append(Al_sp);
+
+      Solver *pre, *post;
+      if (smoother_type == GAUSS_SEIDEL && Al_sp)
+      {
+         pre = new FloatGSSmoother(*Al_sp, 1, smooth_sweeps);
+         post = new FloatGSSmoother(*Al_sp, 2, smooth_sweeps);
+      }
+      else if (smoother_type == GAUSS_SEIDEL)
+      {
+         pre = new GSSmoother(*A[l], 1, smooth_sweeps);
+         post = new GSSmoother(*A[l], 2, smooth_sweeps);
+      }
+      else if (smoother_type == CHEBYSHEV)
+      {
+         Vector diag;
+         A[l]->GetDiag(diag);
+         const Operator *Al = Al_sp ? (const Operator *)Al_sp : A[l];
+         pre = new OperatorChebyshevSmoother(
+            *Al, diag, smooth_sweeps, 10,
+            OperatorChebyshevSmoother::LANCZOS);
+         post = NULL;
+      }
+      else
+      {
+         pre = new DSmoother(*A[l], 1, 1.0, smooth_sweeps);
+         post = NULL;
+      }
+      pre->iterative_mode = true;
+      if (post) { post->iterative_mode = true; }
+      smoothers.Append(pre);
+      post_smoothers.Append(post);
+   }
+}
+
+double AMGSolver::GetOperatorComplexity() const
+{
+   if (A.Size() == 0) { return 0.0; }
+   double nnz = 0.0;
+   for (int l = 0; l < A.Size(); l++) { nnz += A[l]->NumNonZeroElems(); }
+   return nnz/A[0]->NumNonZeroElems();
+}
+
+void AMGSolver::Cycle(int level, const Vector &b, Vector &x) const
+{
+   if (level == A.Size() - 1)
+   {
+      if (coarse_direct)
+      {
+         coarse_inv.Mult(b, x);
+         return;
+      }
+      // Symmetric smoothing steps, so that the cycle remains symmetric
+      Solver *post = post_smoothers[level];
+      for (int k = 0; k < 10; k++)
+      {
+         smoothers[level]->Mult(b, x);
+         (post ? post : smoothers[level])->Mult(b, x);
+      }
+      return;
+   }
+
+   Vector &r = *r_lev[level];
+   Vector &bc = *b_lev[level+1], &xc = *x_lev[level+1];
+
+   smoothers[level]->Mult(b, x);
+   for (int c = 0; c < cycle_type; c++)
+   {
+      // coarse grid correction
+      r = b;
+      if (A_sp[level])
+      {
+         A_sp[level]->AddMult(x, r, -1.0);
+      }
+      else
+      {
+         A[level]->AddMult(x, r, -1.0);
+      }
+      P[level]->MultTranspose(r, bc);
+      xc = 0.0;
+      Cycle(level + 1, bc, xc);
+      P[level]->AddMult(xc, x);
+   }
+   Solver *post = post_smoothers[level];
+   (post ? post : smoothers[level])->Mult(b, x);
+}
+
+void AMGSolver::Mult(const Vector &b, Vector &x) const
+{
+   MFEM_VERIFY(A.Size() > 0, "SetOperator() has not been called");
+   MFEM_ASSERT(b.Size() == height && x.Size() == width, "invalid sizes");
+
+   if (!iterative_mode) { x = 0.0; }
+   Cycle(0, b, x);
+}
+
+}
@@ -0,0 +1,177 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#ifndef MFEM_AMG
+#define MFEM_AMG
+
+#include "../config/config.hpp"
+#include "sparsemat.hpp"
+#include "densemat.hpp"
+
+namespace mfem
+{
+
+class FloatSparseMatrix;
+
+/** @brief Serial smoothed aggregation algebraic multigrid (AMG) solver for
+    symmetric positive definite SparseMatrix operators.
+
+    The hierarchy is constructed in SetOperator():
+    - the strong connections of the fine operator A are the off-diagonal
+      entries with |a_ij| >= theta sqrt(|a_ii a_jj|), see
+      SetStrengthThreshold();
+    - the rows are grouped into aggregates of strongly connected rows, and the
+      tentative prolongation P0 interpolates constants on each aggregate; rows
+      without strong connections are not aggregated;
+    - the prolongation is the smoothed P = (I - w D^{-1} A) P0, with
+      w = 4/(3 rho), where rho is an upper bound of the spectral radius of
+      D^{-1} A;
+    - the coarse operator is the Galerkin product P^T A P, computed with the
+      (threaded, when MFEM is built with OpenMP) sparse matrix product Mult().
+
+    The coarsening stops when the operator has at most SetCoarseSize() rows,
+    when the maximal number of levels is reached, or when the coarsening
+    stagnates. The coarsest operator is inverted with dense LU factorization
+    if it has at most 4 times SetCoarseSize() rows; a larger coarsest operator,
+    after stagnation, is only smoothed, with 10 (symmetric) smoother steps.
+
+    Mult() performs one V-cycle (or W-cycle, see SetCycleType()) with
+    Gauss-Seidel (forward for pre-smoothing and backward for post-smoothing),
+    l1-Jacobi, or Chebyshev smoothing, so that the cycle is a symmetric
+    operator suitable as a preconditioner for CG. Unlike Gauss-Seidel, the
+    Chebyshev smoother only uses matrix-vector products and vector updates,
+    which are threaded when MFEM is built with OpenMP.
+
+    Vector problems, e.g. elasticity, are coarsened as scalar problems, which
+    may result in slower convergence. */
+class AMGSolver : public Solver
+{
+public:
+   /// Smoother types.
+   enum SmootherType
+   {
+      GAUSS_SEIDEL, ///< Forward/backward Gauss-Seidel, see GSSmoother.
+      L1_JACOBI,    ///< l1-scaled Jacobi, see DSmoother.
+      /** Chebyshev accelerated Jacobi, see OperatorChebyshevSmoother, with
+          the number of sweeps as the polynomial order. */
+      CHEBYSHEV
+   };
+
+   /// Multigrid cycle types.
+   enum CycleType { V_CYCLE = 1, W_CYCLE = 2 };
+
+protected:
+   double theta;
+   int max_levels, coarse_size, smooth_sweeps, print_level;
+   SmootherType smoother_type;
+   CycleType cycle_type;
+   bool single_precision;
+
+   /// Level operators; A[0] is the fine operator (not owned).
+   Array<const SparseMatrix*> A;
+   /// Prolongations from level l+1 to level l. Owned.
+   Array<SparseMatrix*> P;
+   /** @brief Smoothers for all levels, except the coarsest when it is
+       inverted. Owned. */
+   Array<Solver*> smoothers;
+   /// Post-smoothers for the levels of #smoothers. Owned.
+   Array<Solver*> post_smoothers;
+   /** @brief Single precision copies of the level operators, except the
+       coarsest, when single precision is enabled. Owned. */
+   Array<FloatSparseMatrix*> A_sp;
+   /// Whether the coarsest operator is inverted, or only smoothed.
+   bool coarse_direct;
+   /// Dense coarse operator and its inverse, if #coarse_direct.
+   DenseMatrix coarse_mat;
+   DenseMatrixInverse coarse_inv;
+
+   /// Work vectors on each level; x_lev[0] and b_lev[0] are not used.
+   mutable Array<Vector*> x_lev, b_lev, r_lev;
+
+   void Clear();
+   void Setup();
+
+   /// Construct the smoothers and the single precision operators of A.
+   void SetupSmoothers();
+   void ClearSmoothers();
+
+   /// Compute the aggregates of @a Al; return the number of aggregates.
+   int Aggregate(const SparseMatrix &Al, Array<int> &aggregates) const;
+
+   /// Construct the smoothed prolongation for the given aggregates.
+   SparseMatrix *Prolongation(const SparseMatrix &Al,
+                              const Array<int> &aggregates, int num_agg) const;
+
+   void Cycle(int level, const Vector &b, Vector &x) const;
+
+public:
+   AMGSolver();
+
+   AMGSolver(const SparseMatrix &a);
+
+   /// Set the strength of connection threshold, default: 0.08.
+   void SetStrengthThreshold(double th) { theta = th; }
+
+   /// Set the maximal number of levels, default: 25.
+   void SetMaxLevels(int levels) { max_levels = levels; }
+
+   /** @brief Set the maximal size of the coarsest operator, which is solved
+       directly, default: 100. */
+   /** If the coarsening stagnates first, the coarsest operator is solved
+       directly only up to 4 times this size, see the class description. */
+   void SetCoarseSize(int size) { coarse_size = size; }
+
+   /// Set the smoother type and the number of sweeps, default: 1 GS sweep.
+   void SetSmoother(SmootherType type, int sweeps = 1)
+   { smoother_type = type; smooth_sweeps = sweeps; }
+
+   /** @brief Use single precision copies of the level operators (see
+       FloatSparseMatrix) in the residuals and the smoothers of the cycle,
+       default: false. */
+   /** This halves the memory traffic of the level operators, while the
+       hierarchy is still constructed in double precision, and is typically
+       sufficient for a preconditioner, see also MixedPrecisionSolver. With
+       the L1_JACOBI smoother, only the residuals use single precision. Unlike
+       the other options, this one can also be changed after SetOperator():
+       the smoothers are then rebuilt for the existing hierarchy. */
+   void SetSinglePrecision(bool sp = true);
+
+   /// Set the multigrid cycle type, default: V_CYCLE.
+   void SetCycleType(CycleType type) { cycle_type = type; }
+
+   /** @brief Set the print level: 0 - no output (default), 1 - print the
+       sizes of the hierarchy after the setup. */
+   void SetPrintLevel(int level) { print_level = level; }
+
+   /** @brief Set the operator, which must be a finalized SparseMatrix, and
+       construct the multigrid hierarchy. The options above must be set before
+       calling this method. */
+   virtual void SetOperator(const Operator &op);
+
+   /// Apply one multigrid cycle to the system A x = b.
+   virtual void Mult(const Vector &b, Vector &x) const;
+
+   /// Return the number of levels in the hierarchy.
+   int GetNumLevels() const { return A.Size(); }
+
+   /// Return the operator on the given level (0 is the finest).
+   const SparseMatrix &GetLevelOperator(int level) const { return *A[level]; }
+
+   /** @brief Return the operator complexity: the sum of the numbers of
+       nonzeros of all level operators divided by that of the fine one. */
+   double GetOperatorComplexity() const;
+
+   virtual ~AMGSolver() { Clear(); }
+};
+
+}
+
+#endif
@@ -0,0 +1,442 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+// Implementation of class BlockSparseMatrix and its smoothers
+
+#include "blocksparsemat.hpp"
+#include <algorithm>
+
+namespace mfem
+{
+
+// y += a A x with blocks of compile-time size BS; the block rows are
+// independent, so they can be processed in parallel.
+template <int BS>
+static void BCSRAddMult(int nbr, const int *I, const int *J,
+                        const double *data, const double *x, double *y,
+                        double a)
+{
+#ifdef MFEM_USE_OPENMP
+   #pragma omp parallel for
+#endif
+   for (int i = 0; i < nbr; i++)
+   {
+      double sum[BS];
+      for (int r = 0; r < BS; r++) { sum[r] = 0.0; }
+      for (int k = I[i]; k < I[i+1]; k++)
+      {
+         const double *B = data + k*BS*BS;
+         const double *xj = x + J[k]*BS;
+         for (int c = 0; c < BS; c++)
+         {
+            for (int r = 0; r < BS; r++)
+            {
+               sum[r] += B[r + c*BS]*xj[c];
+            }
+         }
+      }
+      for (int r = 0; r < BS; r++) { y[i*BS + r] += a*sum[r]; }
+   }
+}
+
+// y += a A x with blocks of any size bs.
+static void BCSRAddMult(int bs, int nbr, const int *I, const int *J,
+                        const double *data, const double *x, double *y,
+                        double a)
+{
+#ifdef MFEM_USE_OPENMP
+   #pragma omp parallel for
+#endif
+   for (int i = 0; i < nbr; i++)
+   {
+      double *yi = y + i*bs;
+      for (int k = I[i]; k < I[i+1]; k++)
+      {
+         const double *B = data + k*bs*bs;
+         const double *xj = x + J[k]*bs;
+         for (int c = 0; c < bs; c++)
+         {
+            const double axc = a*xj[c];
+            for (int r = 0; r < bs; r++)
+            {
+               yi[r] += B[r + c*bs]*axc;
+            }
+         }
+      }
+   }
+}
+
+// x_i = Dinv_i (b_i - sum_{j != i} A_ij x_j) for block row i.
+static inline void BlockGSRow(int i, int bs, const int *I, const int *J,
+                              const double *data, const DenseTensor &Dinv,
+                              const double *b, double *x, double *r)
+{
+   for (int q = 0; q < bs; q++) { r[q] = b[i*bs + q]; }
+   for (int k = I[i]; k < I[i+1]; k++)
+   {
+      if (J[k] == i) { continue; }
+      const double *B = data + k*bs*bs;
+      const double *xj = x + J[k]*bs;
+      for (int c = 0; c < bs; c++)
+      {
+         for (int q = 0; q < bs; q++)
+         {
+            r[q] -= B[q + c*bs]*xj[c];
+         }
+      }
+   }
+   const double *Di = Dinv(i).Data();
+   double *xi = x + i*bs;
+   for (int q = 0; q < bs; q++) { xi[q] = 0.0; }
+   for (int c = 0; c < bs; c++)
+   {
+      for (int q = 0; q < bs; q++)
+      {
+         xi[q] += Di[q + c*bs]*r[c];
+      }
+   }
+}
+
+
+BlockSparseMatrix::BlockSparseMatrix(const SparseMatrix &A, int block_size)
+   : Operator(A.Height(), A.Width()), bs(block_size)
+{
+   MFEM_VERIFY(A.Finalized(), "the SparseMatrix must be finalized");
+   MFEM_VERIFY(bs > 0 && height % bs == 0 && width % bs == 0,
+               "the sizes of the matrix must be multiples of the block size");
+   nbr = height/bs;
+   nbc = width/bs;
+
+   const int *Ai = A.GetI(), *Aj = A.GetJ();
+   const double *Av = A.GetData();
+
+   // Collect the block columns of each block row
+   Array<int> last_row(nbc);
+   last_row = -1;
+   I.SetSize(nbr + 1);
+   I[0] = 0;
+   J.SetSize(0);
+   for (int i = 0; i < nbr; i++)
+   {
+      for (int r = 0; r < bs; r++)
+      {
+         const int row = i*bs + r;
+         for (int k = Ai[row]; k < Ai[row+1]; k++)
+         {
+            const int bj = Aj[k]/bs;
+            if (last_row[bj] != i) { last_row[bj] = i; J.Append(bj); }
+         }
+      }
+      I[i+1] = J.Size();
+      std::sort(J.GetData() + I[i], J.GetData() + I[i+1]);
+   }
+
+   data.SetSize(J.Size()*bs*bs);
+   data = 0.0;
+   for (int row = 0; row < height; row++)
+   {
+      const int i = row/bs, r = row % bs;
+      for (int k = Ai[row]; k < Ai[row+1]; k++)
+      {
+         const int blk = FindBlock(i, Aj[k]/bs);
+         GetBlockData(blk)[r + (Aj[k] % bs)*bs] += Av[k];
+      }
+   }
+}
+
+void BlockSparseMatrix::Init(const Table &block_pattern, int num_block_cols,
+                             int block_size)
+{
+   bs = block_size;
+   nbr = block_pattern.Size();
+   nbc = num_block_cols;
+   height = nbr*bs;
+   width = nbc*bs;
+
+   I.SetSize(nbr + 1);
+   I[0] = 0;
+   J.SetSize(0);
+   Array<int> row;
+   for (int i = 0; i < nbr; i++)
+   {
+      block_pattern.GetRow(i, row);
+      row.Sort();
+      row.Unique();
+      J.Append(row);
+      I[i+1] = J.Size();
+   }
+   data.SetSize(J.Size()*bs*bs);
+   data = 0.0;
+}
+
+int BlockSparseMatrix::FindBlock(int bi, int bj) const
+{
+   const int *begin = J.GetData() + I[bi], *end = J.GetData() + I[bi+1];
+   const int *pos = std::lower_bound(begin, end, bj);
+   return (pos != end && *pos == bj) ? int(pos - J.GetData()) : -1;
+}
+
+void BlockSparseMatrix::AddElementMatrix(const Array<int> &dofs,
+                                         const DenseMatrix &elmat)
+{
+   const int nd = dofs.Size();
+   MFEM_ASSERT(elmat.Height() == nd*bs && elmat.Width() == nd*bs,
+               "invalid element matrix size");
+   for (int a = 0; a < nd; a++)
+   {
+      const int ia = (dofs[a] >= 0) ? dofs[a] : -1-dofs[a];
+      for (int b = 0; b < nd; b++)
+      {
+         const int ib = (dofs[b] >= 0) ? dofs[b] : -1-dofs[b];
+         const double s = ((dofs[a] >= 0) == (dofs[b] >= 0)) ? 1.0 : -1.0;
+         const int k = FindBlock(ia, ib);
+         MFEM_ASSERT(k >= 0, "block (" << ia << ',' << ib
+                     << ") is not in the pattern");
+         double *B = GetBlockData(k);
+         for (int c2 = 0; c2 < bs; c2++)
+         {
+            for (int c1 = 0; c1 < bs; c1++)
+            {
+               B[c1 + c2*bs] += s*elmat(c1*nd + a, c2*nd + b);
+            }
+         }
+      }
+   }
+}
+
+void BlockSparseMatrix::Mult(const Vector &x, Vector &y) const
+{
+   y = 0.0;
+   AddMult(x, y);
+}
+
+void BlockSparseMatrix::AddMult(const Vector &x, Vector &y,
+                                const double a) const
+{
+   MFEM_ASSERT(x.Size() == width && y.Size() == height, "invalid sizes");
+
+   const int *Ip = I.GetData(), *Jp = J.GetData();
+   const double *d = data.GetData(), *xp = x.GetData();
+   double *yp = y.GetData();
+   switch (bs)
+   {
+      case 1: BCSRAddMult<1>(nbr, Ip, Jp, d, xp, yp, a); break;
+      case 2: BCSRAddMult<2>(nbr, Ip, Jp, d, xp, yp, a); break;
+      case 3: BCSRAddMult<3>(nbr, Ip, Jp, d, xp, yp, a); break;
+      default: BCSRAddMult(bs, nbr, Ip, Jp, d, xp, yp, a); break;
+   }
+}
+
+void BlockSparseMatrix::MultTranspose(const Vector &x, Vector &y) const
+{
+   y = 0.0;
+   AddMultTranspose(x, y);
+}
+
+void BlockSparseMatrix::AddMultTranspose(const Vector &x, Vector &y,
+                                         const double a) const
+{
+   MFEM_ASSERT(x.Size() == height && y.Size() == width, "invalid sizes");
+
+   for (int i = 0; i < nbr; i++)
+   {
+      const double *xi = x.GetData() + i*bs;
+      for (int k = I[i]; k < I[i+1]; k++)
+      {
+         const double *B = GetBlockData(k);
+         double *yj = y.GetData() + J[k]*bs;
+         for (int c = 0; c < bs; c++)
+         {
+            double sum = 0.0;
+            for (int r = 0; r < bs; r++) { sum += B[r + c*bs]*xi[r]; }
+            yj[c] += a*sum;
+         }
+      }
+   }
+}
+
+void BlockSparseMatrix::GetDiag(Vector &d) const
+{
+   MFEM_VERIFY(nbr == nbc, "the matrix must be square");
+   d.SetSize(height);
+   for (int i = 0; i < nbr; i++)
+   {
+      const int k = FindBlock(i, i);
+      for (int r = 0; r < bs; r++)
+      {
+         d(i*bs + r) = (k >= 0) ? GetBlockData(k)[r + r*bs] : 0.0;
+      }
+   }
+}
+
+void BlockSparseMatrix::GetBlockDiag(DenseTensor &D) const
+{
+   MFEM_VERIFY(nbr == nbc, "the matrix must be square");
+   D.SetSize(bs, bs, nbr);
+   for (int i = 0; i < nbr; i++)
+   {
+      const int k = FindBlock(i, i);
+      double *Di = D.GetData(i);
+      for (int q = 0; q < bs*bs; q++)
+      {
+         Di[q] = (k >= 0) ? GetBlockData(k)[q] : 0.0;
+      }
+   }
+}
+
+void BlockSparseMatrix::EliminateRowsCols(const Array<int> &rc_list,
+                                          Matrix::DiagonalPolicy dpolicy)
+{
+   Vector sol(height), rhs(height);
+   sol = 0.0;
+   rhs = 0.0;
+   EliminateRowsCols(rc_list, sol, rhs, dpolicy);
+}
+
+void BlockSparseMatrix::EliminateRowsCols(const Array<int> &rc_list,
+                                          const Vector &sol, Vector &rhs,
+                                          Matrix::DiagonalPolicy dpolicy)
+{
+   MFEM_VERIFY(height == width, "the matrix must be square");
+
+   Array<bool> ess(height);
+   ess = false;
+   for (int i = 0; i < rc_list.Size(); i++) { ess[rc_list[i]] = true; }
+
+   for (int i = 0; i < nbr; i++)
+   {
+      for (int k = I[i]; k < I[i+1]; k++)
+      {
+         double *B = GetBlockData(k);
+         for (int c = 0; c < bs; c++)
+         {
+            const int col = J[k]*bs + c;
+            for (int r = 0; r < bs; r++)
+            {
+               const int row = i*bs + r;
+               if (!ess[row] && !ess[col]) { continue; }
+               double &a = B[r + c*bs];
+               if (row == col)
+               {
+                  switch (dpolicy)
+                  {
+                     case Matrix::DIAG_ONE: a = 1.0; break;
+                     case Matrix::DIAG_ZERO: a = 0.0; break;
+                     case Matrix::DIAG_KEEP: break;
+                  }
+                  rhs(row) = a*sol(row);
+               }
+               else
+               {
+                  if (!ess[row]) { rhs(row) -= a*sol(col); }
+                  a = 0.0;
+               }
+            }
+         }
+      }
+   }
+}
+
+void BlockSparseMatrix::BlockGaussSeidelForw(const DenseTensor &Dinv,
+                                             const Vector &b,
+                                             Vector &x) const
+{
+   Vector r(bs);
+   for (int i = 0; i < nbr; i++)
+   {
+      BlockGSRow(i, bs, I.GetData(), J.GetData(), data.GetData(), Dinv,
+                 b.GetData(), x.GetData(), r.GetData());
+   }
+}
+
+void BlockSparseMatrix::BlockGaussSeidelBack(const DenseTensor &Dinv,
+                                             const Vector &b,
+                                             Vector &x) const
+{
+   Vector r(bs);
+   for (int i = nbr - 1; i >= 0; i--)
+   {
+      BlockGSRow(i, bs, I.GetData(), J.GetData(), data.GetData(), Dinv,
+                 b.GetData(), x.GetData(), r.GetData());
+   }
+}
+
+SparseMatrix *BlockSparseMatrix::ToSparseMatrix() const
+{
+   SparseMatrix *A = new SparseMatrix(height, width);
+   for (int i = 0; i < nbr; i++)
+   {
+      for (int k = I[i]; k < I[i+1]; k++)
+      {
+         const double *B = GetBlockData(k);
+         for (int c = 0; c < bs; c++)
+         {
+            for (int r = 0; r < bs; r++)
+            {
+               A->Add(i*bs + r, J[k]*bs + c, B[r + c*bs]);
+            }
+         }
+      }
+   }
+   A->Finalize(0);
+   return A;
+}
+
+
+void BlockSparseSmoother::SetOperator(const Operator &a)
+{
+   oper = dynamic_cast<const BlockSparseMatrix*>(&a);
+   MFEM_VERIFY(oper != NULL, "the operator must be a BlockSparseMatrix");
+   height = oper->Height();
+   width = oper->Width();
+
+   const int bs = oper->BlockSize();
+   oper->GetBlockDiag(Dinv);
+   DenseMatrix Di(bs), Di_inv;
+   for (int i = 0; i < oper->NumBlockRows(); i++)
+   {
+      Di = Dinv(i);
+      DenseMatrixInverse inv(Di);
+      inv.GetInverseMatrix(Di_inv);
+      Dinv(i) = Di_inv;
+   }
+}
+
+void BlockJacobiSmoother::Mult(const Vector &x, Vector &y) const
+{
+   const int bs = oper->BlockSize();
+   if (!iterative_mode) { y = 0.0; }
+   r.SetSize(height);
+   z.SetSize(bs);
+   for (int it = 0; it < iterations; it++)
+   {
+      r = x;
+      oper->AddMult(y, r, -1.0);
+      for (int i = 0; i < oper->NumBlockRows(); i++)
+      {
+         Vector ri(r.GetData() + i*bs, bs), yi(y.GetData() + i*bs, bs);
+         Dinv(i).Mult(ri, z);
+         yi.Add(damping, z);
+      }
+   }
+}
+
+void BlockGSSmoother::Mult(const Vector &x, Vector &y) const
+{
+   if (!iterative_mode) { y = 0.0; }
+   for (int i = 0; i < iterations; i++)
+   {
+      if (type != 2) { oper->BlockGaussSeidelForw(Dinv, x, y); }
+      if (type != 1) { oper->BlockGaussSeidelBack(Dinv, x, y); }
+   }
+}
+
+}
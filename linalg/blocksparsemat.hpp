@@ -0,0 +1,198 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#ifndef MFEM_BLOCKSPARSEMAT
+#define MFEM_BLOCKSPARSEMAT
+
+#include "../config/config.hpp"
+#include "../general/table.hpp"
+#include "sparsemat.hpp"
+#include "densemat.hpp"
+
+namespace mfem
+{
+
+/** @brief Sparse matrix with dense square blocks in block compressed sparse
+    row (BCSR) format.
+
+    The matrix has NumBlockRows() x NumBlockCols() blocks of size BlockSize(),
+    and the scalar entry (i,j) belongs to the block (i/bs, j/bs). This is the
+    structure of the matrices of vector finite element spaces with
+    Ordering::byVDIM, where the block (i,j) couples all components of the
+    nodes i and j, see BilinearForm::FormLinearSystem(). Only one column index
+    is stored per block, and the blocks are stored column-major, as
+    DenseMatrix. The block columns of each row are sorted. */
+class BlockSparseMatrix : public Operator
+{
+protected:
+   /// Block size.
+   int bs;
+   /// Numbers of block rows and columns.
+   int nbr, nbc;
+   /// Block row offsets and block column indices.
+   Array<int> I, J;
+   /// The blocks, bs*bs entries each.
+   Vector data;
+
+public:
+   /// Create an empty matrix.
+   BlockSparseMatrix() : bs(1), nbr(0), nbc(0) { }
+
+   /** @brief Create a matrix with zero blocks in the pattern given by the
+       @a block_pattern Table, see Init(). */
+   BlockSparseMatrix(const Table &block_pattern, int num_block_cols,
+                     int block_size)
+   { Init(block_pattern, num_block_cols, block_size); }
+
+   /** @brief Convert the finalized SparseMatrix @a A, whose sizes must be
+       multiples of @a block_size. */
+   BlockSparseMatrix(const SparseMatrix &A, int block_size);
+
+   /** @brief Set the pattern of the matrix: row i of @a block_pattern lists
+       the nonzero blocks of block row i. The blocks are set to zero. */
+   void Init(const Table &block_pattern, int num_block_cols, int block_size);
+
+   /// Set all entries to @a a.
+   BlockSparseMatrix &operator=(double a) { data = a; return *this; }
+
+   int BlockSize() const { return bs; }
+   int NumBlockRows() const { return nbr; }
+   int NumBlockCols() const { return nbc; }
+   int NumNonZeroBlocks() const { return J.Size(); }
+
+   /// Return the number of stored scalar entries.
+   int NumNonZeroElems() const { return data.Size(); }
+
+   const int *GetI() const { return I.GetData(); }
+   const int *GetJ() const { return J.GetData(); }
+
+   /// Return the entries of the k-th stored block, column-major.
+   double *GetBlockData(int k) { return data.GetData() + k*bs*bs; }
+   const double *GetBlockData(int k) const
+   { return data.GetData() + k*bs*bs; }
+
+   /** @brief Return the index of the block (@a bi, @a bj) in the storage, or
+       -1 if it is not in the pattern. */
+   int FindBlock(int bi, int bj) const;
+
+   /** @brief Add the element matrix @a elmat of a vector finite element with
+       the scalar (node) @a dofs. */
+   /** The rows and columns of @a elmat are ordered by component, i.e. the
+       entry (c*nd + a) corresponds to the component c of the node a, where nd
+       is the number of dofs, as in the element matrices of the vector
+       integrators. The blocks of the element must be in the pattern. The
+       rows of different calls with disjoint @a dofs are disjoint, so such
+       calls can be made by different threads. */
+   void AddElementMatrix(const Array<int> &dofs, const DenseMatrix &elmat);
+
+   /// y = A x
+   virtual void Mult(const Vector &x, Vector &y) const;
+
+   /// y += a A x
+   void AddMult(const Vector &x, Vector &y, const double a = 1.0) const;
+
+   /// y = A^T x
+   virtual void MultTranspose(const Vector &x, Vector &y) const;
+
+   /// y += a A^T x
+   void AddMultTranspose(const Vector &x, Vector &y,
+                         const double a = 1.0) const;
+
+   /// Return the scalar diagonal of the matrix in @a d.
+   void GetDiag(Vector &d) const;
+
+   /// Return the diagonal blocks of the matrix in @a D.
+   void GetBlockDiag(DenseTensor &D) const;
+
+   /** @brief Eliminate the scalar rows and columns in @a rc_list, setting the
+       diagonal entries according to @a dpolicy. */
+   void EliminateRowsCols(const Array<int> &rc_list,
+                          Matrix::DiagonalPolicy dpolicy = Matrix::DIAG_ONE);
+
+   /** @brief Eliminate the scalar rows and columns in @a rc_list and modify
+       @a rhs so that the solution has the values of @a sol in @a rc_list. */
+   /** This is the equivalent of SparseMatrix::EliminateRowCol(int, double,
+       Vector &, DiagonalPolicy) for all rows in the list. */
+   void EliminateRowsCols(const Array<int> &rc_list, const Vector &sol,
+                          Vector &rhs,
+                          Matrix::DiagonalPolicy dpolicy = Matrix::DIAG_ONE);
+
+   /** @brief One forward block Gauss-Seidel sweep for A x = b, with the
+       inverses of the diagonal blocks in @a Dinv. */
+   void BlockGaussSeidelForw(const DenseTensor &Dinv, const Vector &b,
+                             Vector &x) const;
+
+   /** @brief One backward block Gauss-Seidel sweep for A x = b, with the
+       inverses of the diagonal blocks in @a Dinv. */
+   void BlockGaussSeidelBack(const DenseTensor &Dinv, const Vector &b,
+                             Vector &x) const;
+
+   /// Return a new SparseMatrix with the same entries.
+   SparseMatrix *ToSparseMatrix() const;
+};
+
+
+/// Base class for the smoothers of BlockSparseMatrix.
+class BlockSparseSmoother : public Solver
+{
+protected:
+   const BlockSparseMatrix *oper;
+   /// Inverses of the diagonal blocks of the matrix.
+   DenseTensor Dinv;
+
+public:
+   BlockSparseSmoother() : oper(NULL) { }
+
+   BlockSparseSmoother(const BlockSparseMatrix &a) { SetOperator(a); }
+
+   /// Set the BlockSparseMatrix and compute the inverses of its diagonal.
+   virtual void SetOperator(const Operator &a);
+};
+
+/** @brief Damped block Jacobi smoother, inverting the diagonal blocks of a
+    BlockSparseMatrix. */
+class BlockJacobiSmoother : public BlockSparseSmoother
+{
+protected:
+   double damping;
+   int iterations;
+   mutable Vector r, z;
+
+public:
+   BlockJacobiSmoother(double damp = 1.0, int it = 1)
+      : damping(damp), iterations(it) { }
+
+   BlockJacobiSmoother(const BlockSparseMatrix &a, double damp = 1.0,
+                       int it = 1)
+      : BlockSparseSmoother(a), damping(damp), iterations(it) { }
+
+   virtual void Mult(const Vector &x, Vector &y) const;
+};
+
+/// Block Gauss-Seidel smoother for a BlockSparseMatrix.
+class BlockGSSmoother : public BlockSparseSmoother
+{
+protected:
+   int type; // 0, 1, 2 - symmetric, forward, backward
+   int iterations;
+
+public:
+   BlockGSSmoother(int t = 0, int it = 1) : type(t), iterations(it) { }
+
+   BlockGSSmoother(const BlockSparseMatrix &a, int t = 0, int it = 1)
+      : BlockSparseSmoother(a), type(t), iterations(it) { }
+
+   virtual void Mult(const Vector &x, Vector &y) const;
+};
+
+}
+
+#endif
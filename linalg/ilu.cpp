@@ -0,0 +1,744 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+// Implementation of the incomplete factorization preconditioners ILUSolver,
+// ILUTSolver, IC0Solver and BlockILU0Solver
+
+#include "ilu.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace mfem
+{
+
+// Levels with fewer rows are merged into serial stages of the triangular
+// solves, and the larger ones are threaded with chunks of this many rows.
+static const int ilu_min_parallel_rows = 128;
+static const int ilu_parallel_chunk = 32;
+
+void TriangularSchedule::Setup(int n, const int *I, const int *J,
+                               const int *diag, bool lower)
+{
+   // The level of a row is one more than the maximal level of the rows it
+   // depends on
+   Array<int> level(n);
+   int num_levels = 0;
+   for (int s = 0; s < n; s++)
+   {
+      const int i = lower ? s : n-1-s;
+      const int beg = lower ? I[i] : diag[i]+1;
+      const int end = lower ? diag[i] : I[i+1];
+      int l = 0;
+      for (int p = beg; p < end; p++)
+      {
+         l = std::max(l, level[J[p]] + 1);
+      }
+      level[i] = l;
+      num_levels = std::max(num_levels, l + 1);
+   }
+
+   ptr.SetSize(num_levels + 1);
+   ptr = 0;
+   for (int i = 0; i < n; i++)
+   {
+      ptr[level[i]+1]++;
+   }
+   for (int l = 0; l < num_levels; l++)
+   {
+      ptr[l+1] += ptr[l];
+   }
+   rows.SetSize(n);
+   for (int i = 0; i < n; i++)
+   {
+      rows[ptr[level[i]]++] = i;
+   }
+   for (int l = num_levels; l > 0; l--)
+   {
+      ptr[l] = ptr[l-1];
+   }
+   ptr[0] = 0;
+
+   stage_ptr.SetSize(1);
+   stage_ptr[0] = 0;
+   stage_chunk.SetSize(0);
+   for (int l = 0; l < num_levels; )
+   {
+      int l_end = l + 1;
+      if (ptr[l+1] - ptr[l] >= ilu_min_parallel_rows)
+      {
+         stage_chunk.Append(ilu_parallel_chunk);
+      }
+      else
+      {
+         while (l_end < num_levels &&
+                ptr[l_end+1] - ptr[l_end] < ilu_min_parallel_rows)
+         {
+            l_end++;
+         }
+         stage_chunk.Append(ptr[l_end] - ptr[l]);
+      }
+      stage_ptr.Append(ptr[l_end]);
+      l = l_end;
+   }
+}
+
+
+// Insert the index j into the sorted linked list 'next', after the entry
+// 'start' < j. The list is terminated by the value n = head.
+static void ListInsert(int j, int start, int *next)
+{
+   int q = start;
+   while (next[q] < j)
+   {
+      q = next[q];
+   }
+   next[j] = next[q];
+   next[q] = j;
+}
+
+void IncompleteFactorization::SetOperator(const Operator &op)
+{
+   const SparseMatrix *A = dynamic_cast<const SparseMatrix*>(&op);
+   MFEM_VERIFY(A != NULL, "the operator must be a SparseMatrix");
+   MFEM_VERIFY(A->Finalized(), "the SparseMatrix must be finalized");
+   MFEM_VERIFY(A->Height() == A->Width(), "the SparseMatrix must be square");
+
+   mat = A;
+   height = width = A->Height();
+   Factor(*A);
+   lower.Setup(height, I.GetData(), J.GetData(), diag.GetData(), true);
+   upper.Setup(height, I.GetData(), J.GetData(), diag.GetData(), false);
+}
+
+void IncompleteFactorization::FactorInPattern(const SparseMatrix &A)
+{
+   const int n = A.Height();
+   const int *ai = A.GetI(), *aj = A.GetJ();
+   const double *av = A.GetData();
+
+   V.SetSize(J.Size());
+   V = 0.0;
+   inv_diag.SetSize(n);
+   Array<int> iw(n); // positions of the columns of row i
+   iw = -1;
+   for (int i = 0; i < n; i++)
+   {
+      for (int p = I[i]; p < I[i+1]; p++)
+      {
+         iw[J[p]] = p;
+      }
+      for (int p = ai[i]; p < ai[i+1]; p++)
+      {
+         MFEM_ASSERT(iw[aj[p]] >= 0, "the pattern does not contain the matrix");
+         V[iw[aj[p]]] += av[p];
+      }
+      // IKJ variant of the Gaussian elimination, restricted to the pattern
+      for (int p = I[i]; p < diag[i]; p++)
+      {
+         const int k = J[p];
+         const double l_ik = (V[p] *= inv_diag[k]);
+         for (int q = diag[k]+1; q < I[k+1]; q++)
+         {
+            const int pos = iw[J[q]];
+            if (pos >= 0)
+            {
+               V[pos] -= l_ik * V[q];
+            }
+         }
+      }
+      MFEM_VERIFY(V[diag[i]] != 0.0, "zero pivot in row " << i);
+      inv_diag[i] = 1.0 / V[diag[i]];
+      for (int p = I[i]; p < I[i+1]; p++)
+      {
+         iw[J[p]] = -1;
+      }
+   }
+}
+
+void IncompleteFactorization::Solve(const Vector &b, Vector &x) const
+{
+   const int *Ip = I.GetData(), *Jp = J.GetData(), *dp = diag.GetData();
+   const double *Vp = V.GetData(), *idp = inv_diag.GetData();
+   const double *bp = b.GetData();
+   x.SetSize(height);
+   double *xp = x.GetData();
+
+#ifdef MFEM_USE_OPENMP
+   #pragma omp parallel
+#endif
+   {
+      // Forward solve with L, which has a unit diagonal
+      for (int k = 0; k < lower.NumStages(); k++)
+      {
+         const int beg = lower.stage_ptr[k], end = lower.stage_ptr[k+1];
+#ifdef MFEM_USE_OPENMP
+         #pragma omp for schedule(static, lower.stage_chunk[k])
+#endif
+         for (int s = beg; s < end; s++)
+         {
+            const int i = lower.rows[s];
+            double sum = bp[i];
+            for (int p = Ip[i]; p < dp[i]; p++)
+            {
+               sum -= Vp[p] * xp[Jp[p]];
+            }
+            xp[i] = sum;
+         }
+      }
+      // Backward solve with U
+      for (int k = 0; k < upper.NumStages(); k++)
+      {
+         const int beg = upper.stage_ptr[k], end = upper.stage_ptr[k+1];
+#ifdef MFEM_USE_OPENMP
+         #pragma omp for schedule(static, upper.stage_chunk[k])
+#endif
+         for (int s = beg; s < end; s++)
+         {
+            const int i = upper.rows[s];
+            double sum = xp[i];
+            for (int p = dp[i]+1; p < Ip[i+1]; p++)
+            {
+               sum -= Vp[p] * xp[Jp[p]];
+            }
+            xp[i] = sum * idp[i];
+         }
+      }
+   }
+}
+
+void IncompleteFactorization::Mult(const Vector &b, Vector &x) const
+{
+   MFEM_VERIFY(mat != NULL, "SetOperator() has not been called");
+
+   if (!iterative_mode)
+   {
+      Solve(b, x);
+      return;
+   }
+   r.SetSize(height);
+   mat->Mult(x, r);
+   subtract(b, r, r);
+   Solve(r, r);
+   x += r;
+}
+
+
+void ILUSolver::Factor(const SparseMatrix &A)
+{
+   MFEM_VERIFY(fill_level >= 0, "invalid level of fill: " << fill_level);
+
+   const int n = A.Height();
+   const int *ai = A.GetI(), *aj = A.GetJ();
+
+   // Symbolic factorization: the columns of row i are kept in a sorted linked
+   // list, with their levels in 'lev' (-1 for the columns not in the list)
+   Array<int> next(n+1), lev(n), Flev;
+   lev = -1;
+   I.SetSize(n+1);
+   J.SetSize(0);
+   diag.SetSize(n);
+   I[0] = 0;
+   for (int i = 0; i < n; i++)
+   {
+      next[n] = n;
+      ListInsert(i, n, next);
+      lev[i] = 0;
+      for (int p = ai[i]; p < ai[i+1]; p++)
+      {
+         const int j = aj[p];
+         if (lev[j] < 0)
+         {
+            ListInsert(j, n, next);
+            lev[j] = 0;
+         }
+      }
+      for (int k = next[n]; k < i; k = next[k])
+      {
+         const int lev_k = lev[k];
+         for (int q = diag[k]+1; q < I[k+1]; q++)
+         {
+            const int j = J[q], l = lev_k + Flev[q] + 1;
+            if (l > fill_level) { continue; }
+            if (lev[j] < 0)
+            {
+               ListInsert(j, k, next);
+               lev[j] = l;
+            }
+            else if (l < lev[j])
+            {
+               lev[j] = l;
+            }
+         }
+      }
+      for (int j = next[n]; j < n; j = next[j])
+      {
+         if (j == i) { diag[i] = J.Size(); }
+         J.Append(j);
+         Flev.Append(lev[j]);
+         lev[j] = -1;
+      }
+      I[i+1] = J.Size();
+   }
+
+   FactorInPattern(A);
+}
+
+
+// Compare the indices of the entries of w by decreasing absolute value
+class ILUTAbsGreater
+{
+   const double *w;
+public:
+   ILUTAbsGreater(const double *w_) : w(w_) { }
+   bool operator()(int a, int b) const
+   { return std::abs(w[a]) > std::abs(w[b]); }
+};
+
+// Keep the p largest entries of w in cols, in increasing order
+static void KeepLargest(Array<int> &cols, int p, const double *w)
+{
+   if (cols.Size() <= p) { return; }
+   int *c = cols.GetData();
+   std::nth_element(c, c + p, c + cols.Size(), ILUTAbsGreater(w));
+   cols.SetSize(p);
+   cols.Sort();
+}
+
+void ILUTSolver::Factor(const SparseMatrix &A)
+{
+   MFEM_VERIFY(tau >= 0.0 && max_fill >= 0, "invalid ILUT parameters");
+
+   const int n = A.Height();
+   const int *ai = A.GetI(), *aj = A.GetJ();
+   const double *av = A.GetData();
+
+   // Row i is computed in the dense work vector w, with its columns in the
+   // sorted linked list 'next'
+   Vector w(n);
+   w = 0.0;
+   Array<int> next(n+1), mark(n), Lcols, Ucols;
+   Array<double> vals;
+   mark = 0;
+   I.SetSize(n+1);
+   J.SetSize(0);
+   diag.SetSize(n);
+   inv_diag.SetSize(n);
+   I[0] = 0;
+   for (int i = 0; i < n; i++)
+   {
+      next[n] = n;
+      ListInsert(i, n, next);
+      mark[i] = 1;
+      double norm = 0.0;
+      for (int p = ai[i]; p < ai[i+1]; p++)
+      {
+         const int j = aj[p];
+         if (!mark[j])
+         {
+            ListInsert(j, n, next);
+            mark[j] = 1;
+         }
+         w(j) += av[p];
+         norm += av[p] * av[p];
+      }
+      norm = std::sqrt(norm);
+      const double tol = tau * norm;
+
+      for (int k = next[n]; k < i; k = next[k])
+      {
+         if (w(k) == 0.0) { continue; }
+         w(k) *= inv_diag[k];
+         if (std::abs(w(k)) < tol)
+         {
+            w(k) = 0.0;
+            continue;
+         }
+         const double w_k = w(k);
+         for (int q = diag[k]+1; q < I[k+1]; q++)
+         {
+            const int j = J[q];
+            if (!mark[j])
+            {
+               ListInsert(j, k, next);
+               mark[j] = 1;
+            }
+            w(j) -= w_k * vals[q];
+         }
+      }
+
+      Lcols.SetSize(0);
+      Ucols.SetSize(0);
+      for (int j = next[n]; j < n; j = next[j])
+      {
+         if (j != i && w(j) != 0.0 && std::abs(w(j)) >= tol)
+         {
+            (j < i ? Lcols : Ucols).Append(j);
+         }
+      }
+      KeepLargest(Lcols, max_fill, w.GetData());
+      KeepLargest(Ucols, max_fill, w.GetData());
+
+      double d = w(i);
+      if (d == 0.0)
+      {
+         d = (norm > 0.0) ? (1e-4 + tau) * norm : 1.0;
+      }
+      for (int p = 0; p < Lcols.Size(); p++)
+      {
+         J.Append(Lcols[p]);
+         vals.Append(w(Lcols[p]));
+      }
+      diag[i] = J.Size();
+      J.Append(i);
+      vals.Append(d);
+      inv_diag[i] = 1.0 / d;
+      for (int p = 0; p < Ucols.Size(); p++)
+      {
+         J.Append(Ucols[p]);
+         vals.Append(w(Ucols[p]));
+      }
+      I[i+1] = J.Size();
+
+      for (int j = next[n]; j < n; j = next[j])
+      {
+         w(j) = 0.0;
+         mark[j] = 0;
+      }
+   }
+
+   V.SetSize(vals.Size());
+   for (int p = 0; p < vals.Size(); p++)
+   {
+      V(p) = vals[p];
+   }
+}
+
+
+void IC0Solver::Factor(const SparseMatrix &A)
+{
+   const int n = A.Height();
+   const int *ai = A.GetI(), *aj = A.GetJ();
+   const double *av = A.GetData();
+
+   // Compute the strictly lower triangular L (Li, Lj, Lv), with sorted column
+   // indices, and D, row by row
+   Array<int> Li(n+1), Lj, iw(n), cols;
+   Array<double> Lv;
+   Vector d(n);
+   iw = -1;
+   Li[0] = 0;
+   for (int i = 0; i < n; i++)
+   {
+      double a_ii = 0.0;
+      cols.SetSize(0);
+      for (int p = ai[i]; p < ai[i+1]; p++)
+      {
+         if (aj[p] < i) { cols.Append(aj[p]); }
+         else if (aj[p] == i) { a_ii = av[p]; }
+      }
+      cols.Sort();
+      const int beg = Lj.Size();
+      for (int p = 0; p < cols.Size(); p++)
+      {
+         iw[cols[p]] = Lj.Size();
+         Lj.Append(cols[p]);
+         Lv.Append(0.0);
+      }
+      for (int p = ai[i]; p < ai[i+1]; p++)
+      {
+         if (aj[p] < i) { Lv[iw[aj[p]]] += av[p]; }
+      }
+
+      double d_i = a_ii;
+      for (int p = beg; p < Lj.Size(); p++)
+      {
+         const int k = Lj[p];
+         double l_ik = Lv[p];
+         for (int q = Li[k]; q < Li[k+1]; q++)
+         {
+            const int pos = iw[Lj[q]];
+            if (pos >= 0)
+            {
+               l_ik -= Lv[pos] * d(Lj[q]) * Lv[q];
+            }
+         }
+         l_ik /= d(k);
+         Lv[p] = l_ik;
+         d_i -= l_ik * l_ik * d(k);
+      }
+      if (d_i <= 0.0)
+      {
+         MFEM_VERIFY(a_ii > 0.0, "non-positive diagonal entry in row " << i);
+         d_i = a_ii;
+      }
+      d(i) = d_i;
+      for (int p = beg; p < Lj.Size(); p++)
+      {
+         iw[Lj[p]] = -1;
+      }
+      Li[i+1] = Lj.Size();
+   }
+
+   // Assemble the factors L and U = D L^t; 'unext' is the next free position
+   // in the upper part of each row
+   Array<int> &unext = iw;
+   unext = 0;
+   for (int p = 0; p < Lj.Size(); p++)
+   {
+      unext[Lj[p]]++;
+   }
+   I.SetSize(n+1);
+   I[0] = 0;
+   for (int i = 0; i < n; i++)
+   {
+      I[i+1] = I[i] + (Li[i+1] - Li[i]) + 1 + unext[i];
+   }
+   J.SetSize(I[n]);
+   V.SetSize(I[n]);
+   diag.SetSize(n);
+   inv_diag.SetSize(n);
+   for (int i = 0; i < n; i++)
+   {
+      int pos = I[i];
+      for (int p = Li[i]; p < Li[i+1]; p++, pos++)
+      {
+         J[pos] = Lj[p];
+         V(pos) = Lv[p];
+      }
+      diag[i] = pos;
+      J[pos] = i;
+      V(pos) = d(i);
+      inv_diag(i) = 1.0 / d(i);
+      unext[i] = pos + 1;
+   }
+   for (int j = 0; j < n; j++)
+   {
+      for (int p = Li[j]; p < Li[j+1]; p++)
+      {
+         const int k = Lj[p], pos = unext[k]++;
+         J[pos] = j;
+         V(pos) = d(k) * Lv[p];
+      }
+   }
+}
+
+
+void BlockILU0Solver::SetOperator(const Operator &op)
+{
+   const SparseMatrix *A = dynamic_cast<const SparseMatrix*>(&op);
+   MFEM_VERIFY(A != NULL, "the operator must be a SparseMatrix");
+   MFEM_VERIFY(A->Finalized(), "the SparseMatrix must be finalized");
+   MFEM_VERIFY(A->Height() == A->Width(), "the SparseMatrix must be square");
+   MFEM_VERIFY(bs > 0 && A->Height() % bs == 0,
+               "the size of the matrix must be a multiple of the block size");
+
+   mat = A;
+   height = width = A->Height();
+   Factor(*A);
+   const int nb = height / bs;
+   lower.Setup(nb, I.GetData(), J.GetData(), diag.GetData(), true);
+   upper.Setup(nb, I.GetData(), J.GetData(), diag.GetData(), false);
+}
+
+void BlockILU0Solver::Factor(const SparseMatrix &A)
+{
+   const int nb = A.Height() / bs, bs2 = bs * bs;
+   const int *ai = A.GetI(), *aj = A.GetJ();
+   const double *av = A.GetData();
+
+   // Block sparsity pattern: the diagonal block and the blocks containing
+   // entries of the matrix
+   Array<int> iw(nb), cols;
+   iw = -1;
+   I.SetSize(nb+1);
+   J.SetSize(0);
+   diag.SetSize(nb);
+   I[0] = 0;
+   for (int ib = 0; ib < nb; ib++)
+   {
+      cols.SetSize(0);
+      cols.Append(ib);
+      iw[ib] = 0;
+      for (int i = ib*bs; i < (ib+1)*bs; i++)
+      {
+         for (int p = ai[i]; p < ai[i+1]; p++)
+         {
+            const int jb = aj[p] / bs;
+            if (iw[jb] < 0)
+            {
+               iw[jb] = 0;
+               cols.Append(jb);
+            }
+         }
+      }
+      cols.Sort();
+      for (int p = 0; p < cols.Size(); p++)
+      {
+         iw[cols[p]] = -1;
+         if (cols[p] == ib) { diag[ib] = J.Size(); }
+         J.Append(cols[p]);
+      }
+      I[ib+1] = J.Size();
+   }
+
+   // Numerical factorization with dense blocks
+   V.SetSize(J.Size() * bs2);
+   V = 0.0;
+   inv_diag.SetSize(nb * bs2);
+   DenseMatrix L_ik, U_kj, B_ij, D_inv, T(bs);
+   for (int ib = 0; ib < nb; ib++)
+   {
+      for (int p = I[ib]; p < I[ib+1]; p++)
+      {
+         iw[J[p]] = p;
+      }
+      for (int i = ib*bs; i < (ib+1)*bs; i++)
+      {
+         for (int p = ai[i]; p < ai[i+1]; p++)
+         {
+            const int j = aj[p];
+            V(iw[j/bs]*bs2 + (i%bs) + (j%bs)*bs) += av[p];
+         }
+      }
+      for (int p = I[ib]; p < diag[ib]; p++)
+      {
+         const int kb = J[p];
+         L_ik.UseExternalData(V.GetData() + p*bs2, bs, bs);
+         D_inv.UseExternalData(inv_diag.GetData() + kb*bs2, bs, bs);
+         mfem::Mult(L_ik, D_inv, T);
+         L_ik = T;
+         for (int q = diag[kb]+1; q < I[kb+1]; q++)
+         {
+            const int pos = iw[J[q]];
+            if (pos < 0) { continue; }
+            U_kj.UseExternalData(V.GetData() + q*bs2, bs, bs);
+            B_ij.UseExternalData(V.GetData() + pos*bs2, bs, bs);
+            mfem::Mult(L_ik, U_kj, T);
+            B_ij -= T;
+         }
+      }
+      B_ij.UseExternalData(V.GetData() + diag[ib]*bs2, bs, bs);
+      D_inv.UseExternalData(inv_diag.GetData() + ib*bs2, bs, bs);
+      D_inv = B_ij;
+      D_inv.Invert();
+      for (int p = I[ib]; p < I[ib+1]; p++)
+      {
+         iw[J[p]] = -1;
+      }
+   }
+}
+
+void BlockILU0Solver::Solve(const Vector &b, Vector &x) const
+{
+   const int bs2 = bs * bs;
+   const int *Ip = I.GetData(), *Jp = J.GetData(), *dp = diag.GetData();
+   const double *Vp = V.GetData(), *Dp = inv_diag.GetData();
+   const double *bp = b.GetData();
+   x.SetSize(height);
+   double *xp = x.GetData();
+
+#ifdef MFEM_USE_OPENMP
+   #pragma omp parallel
+#endif
+   {
+      Vector t(bs);
+      double *tp = t.GetData();
+
+      // Forward solve with the block unit lower triangular L
+      for (int k = 0; k < lower.NumStages(); k++)
+      {
+         const int beg = lower.stage_ptr[k], end = lower.stage_ptr[k+1];
+#ifdef MFEM_USE_OPENMP
+         #pragma omp for schedule(static, lower.stage_chunk[k])
+#endif
+         for (int s = beg; s < end; s++)
+         {
+            const int ib = lower.rows[s];
+            for (int a = 0; a < bs; a++)
+            {
+               tp[a] = bp[ib*bs+a];
+            }
+            for (int p = Ip[ib]; p < dp[ib]; p++)
+            {
+               const double *L = Vp + p*bs2, *xj = xp + Jp[p]*bs;
+               for (int c = 0; c < bs; c++)
+               {
+                  for (int a = 0; a < bs; a++)
+                  {
+                     tp[a] -= L[a+c*bs] * xj[c];
+                  }
+               }
+            }
+            for (int a = 0; a < bs; a++)
+            {
+               xp[ib*bs+a] = tp[a];
+            }
+         }
+      }
+      // Backward solve with the block upper triangular U
+      for (int k = 0; k < upper.NumStages(); k++)
+      {
+         const int beg = upper.stage_ptr[k], end = upper.stage_ptr[k+1];
+#ifdef MFEM_USE_OPENMP
+         #pragma omp for schedule(static, upper.stage_chunk[k])
+#endif
+         for (int s = beg; s < end; s++)
+         {
+            const int ib = upper.rows[s];
+            for (int a = 0; a < bs; a++)
+            {
+               tp[a] = xp[ib*bs+a];
+            }
+            for (int p = dp[ib]+1; p < Ip[ib+1]; p++)
+            {
+               const double *U = Vp + p*bs2, *xj = xp + Jp[p]*bs;
+               for (int c = 0; c < bs; c++)
+               {
+                  for (int a = 0; a < bs; a++)
+                  {
+                     tp[a] -= U[a+c*bs] * xj[c];
+                  }
+               }
+            }
+            const double *D = Dp + ib*bs2;
+            double *xi = xp + ib*bs;
+            for (int a = 0; a < bs; a++)
+            {
+               double sum = 0.0;
+               for (int c = 0; c < bs; c++)
+               {
+                  sum += D[a+c*bs] * tp[c];
+               }
+               xi[a] = sum;
+            }
+         }
+      }
+   }
+}
+
+void BlockILU0Solver::Mult(const Vector &b, Vector &x) const
+{
+   MFEM_VERIFY(mat != NULL, "SetOperator() has not been called");
+
+   if (!iterative_mode)
+   {
+      Solve(b, x);
+      return;
+   }
+   r.SetSize(height);
+   mat->Mult(x, r);
+   subtract(b, r, r);
+   Solve(r, r);
+   x += r;
+}
+
+}
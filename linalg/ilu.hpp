@@ -0,0 +1,229 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#ifndef MFEM_ILU
+#define MFEM_ILU
+
+#include "../config/config.hpp"
+#include "sparsemat.hpp"
+
+namespace mfem
+{
+
+/** @brief Level schedule of the triangular solves with a sparse factor: the
+    rows of each level only depend on the rows of the previous levels. */
+/** The factor is given in CSR format, with sorted column indices and the
+    positions @a diag of the diagonal entries. The rows of level l are
+    rows[ptr[l]] ... rows[ptr[l+1]-1], in increasing order.
+
+    The threaded solves process the levels in stages, separated by a barrier:
+    the rows of stage k are rows[stage_ptr[k]] ... rows[stage_ptr[k+1]-1]. A
+    level with enough rows is one stage, threaded over its rows, while a run
+    of consecutive small levels is merged into one stage solved by a single
+    thread, e.g. for the nearly sequential factors of banded matrices, where
+    a barrier per level would cost more than the work of the level. */
+struct TriangularSchedule
+{
+   Array<int> ptr, rows;
+   /** @brief Stage offsets in #rows and OpenMP chunk size of each stage; the
+       chunk of a merged stage is its size, so one thread solves it in order. */
+   Array<int> stage_ptr, stage_chunk;
+
+   /** @brief Compute the schedule of the strictly lower (@a lower = true) or
+       strictly upper (@a lower = false) triangular part of the factor. */
+   void Setup(int n, const int *I, const int *J, const int *diag, bool lower);
+
+   /// Return the number of levels.
+   int NumLevels() const { return ptr.Size() - 1; }
+
+   /// Return the number of stages of the threaded solves.
+   int NumStages() const { return stage_ptr.Size() - 1; }
+};
+
+
+/** @brief Base class for incomplete factorizations A ~ L U of a SparseMatrix,
+    used as preconditioners.
+
+    Derived classes compute the factors in Factor(). They are stored in one
+    CSR structure: the strictly lower part of the unit lower triangular L and
+    the upper triangular U, including its diagonal. Mult() applies
+    (L U)^{-1} with forward and backward triangular solves, which are
+    level-scheduled (see TriangularSchedule) and threaded over the rows of
+    the large levels when MFEM is built with OpenMP.
+
+    With iterative_mode = true, Mult() performs the correction
+    x += (L U)^{-1} (b - A x). */
+class IncompleteFactorization : public Solver
+{
+protected:
+   const SparseMatrix *mat;
+   /// The factors: row offsets, sorted column indices and values.
+   Array<int> I, J;
+   Vector V;
+   /// Positions of the diagonal entries of U in J and V.
+   Array<int> diag;
+   /// Inverses of the diagonal entries of U.
+   Vector inv_diag;
+   TriangularSchedule lower, upper;
+   mutable Vector r;
+
+   /// Compute the factors of the finalized, square matrix @a A.
+   virtual void Factor(const SparseMatrix &A) = 0;
+
+   /** @brief Numerical ILU factorization of @a A in the sparsity pattern
+       given by #I, #J, #diag, which must contain the pattern of @a A. */
+   void FactorInPattern(const SparseMatrix &A);
+
+   /// Solve L U x = b; @a x can be the same as @a b.
+   void Solve(const Vector &b, Vector &x) const;
+
+public:
+   IncompleteFactorization() : mat(NULL) { }
+
+   /// The operator must be a finalized, square SparseMatrix.
+   virtual void SetOperator(const Operator &op);
+
+   virtual void Mult(const Vector &b, Vector &x) const;
+
+   /// Return the number of stored entries of the factors L and U.
+   int NumNonZeroElems() const { return J.Size(); }
+
+   /** @brief Return the number of levels of the forward and the backward
+       triangular solves. */
+   int GetNumLevels() const
+   {
+      const int nl = lower.NumLevels(), nu = upper.NumLevels();
+      return (nl > nu) ? nl : nu;
+   }
+
+   virtual ~IncompleteFactorization() { }
+};
+
+
+/** @brief Incomplete LU factorization with level of fill @a k, ILU(k); the
+    default k = 0 keeps the sparsity pattern of the matrix, ILU(0). */
+/** The fill-in entries of level up to k are determined by the symbolic
+    factorization, where the entries of the matrix have level 0 and a fill
+    entry created by the entries (i,m) and (m,j) has level
+    lev(i,m) + lev(m,j) + 1. */
+class ILUSolver : public IncompleteFactorization
+{
+protected:
+   int fill_level;
+
+   virtual void Factor(const SparseMatrix &A);
+
+public:
+   ILUSolver(int k = 0) : fill_level(k) { }
+
+   ILUSolver(const SparseMatrix &A, int k = 0) : fill_level(k)
+   { SetOperator(A); }
+
+   /// Set the level of fill; must be called before SetOperator().
+   void SetFillLevel(int k) { fill_level = k; }
+};
+
+
+/** @brief Incomplete LU factorization with threshold dropping, ILUT(tau, p),
+    following Saad. */
+/** In each row i, the entries of the factors smaller than tau times the
+    2-norm of row i of the matrix are dropped, and at most p entries are kept
+    in each of the lower and the upper part (in addition to the diagonal). */
+class ILUTSolver : public IncompleteFactorization
+{
+protected:
+   double tau;
+   int max_fill;
+
+   virtual void Factor(const SparseMatrix &A);
+
+public:
+   ILUTSolver(double tau_ = 1e-4, int p = 20) : tau(tau_), max_fill(p) { }
+
+   ILUTSolver(const SparseMatrix &A, double tau_ = 1e-4, int p = 20)
+      : tau(tau_), max_fill(p) { SetOperator(A); }
+
+   /** @brief Set the drop tolerance and the maximal fill per row; must be
+       called before SetOperator(). */
+   void SetThreshold(double tau_, int p) { tau = tau_; max_fill = p; }
+};
+
+
+/** @brief Incomplete Cholesky factorization A ~ L D L^t, IC(0), of a
+    symmetric positive definite matrix, in its sparsity pattern. */
+/** The factorization only reads the lower triangular part of the matrix. The
+    factors are stored as L and U = D L^t, so that the preconditioner is
+    symmetric and the triangular solves are shared with the ILU solvers. A
+    non-positive pivot, which may occur for matrices that are not M-matrices,
+    is replaced by the diagonal entry of the matrix. */
+class IC0Solver : public IncompleteFactorization
+{
+protected:
+   virtual void Factor(const SparseMatrix &A);
+
+public:
+   IC0Solver() { }
+
+   IC0Solver(const SparseMatrix &A) { SetOperator(A); }
+};
+
+
+/** @brief Block ILU(0) factorization for matrices with a block structure of
+    dense blocks of size @a block_size, e.g. from discontinuous Galerkin
+    discretizations, where the blocks are the degrees of freedom of the
+    elements. */
+/** The sparsity pattern of the factors is the block pattern of the matrix;
+    the diagonal blocks of U are inverted. For scalar DG spaces, the block
+    size is the number of degrees of freedom of the element (all elements
+    must have the same number). As in IncompleteFactorization, the triangular
+    solves are level-scheduled over the block rows and threaded with OpenMP,
+    and iterative_mode is supported. */
+class BlockILU0Solver : public Solver
+{
+protected:
+   const SparseMatrix *mat;
+   int bs;
+   /// Block CSR structure of the factors with sorted block column indices.
+   Array<int> I, J, diag;
+   /// Dense blocks (column-major) and inverted diagonal blocks of U.
+   Vector V, inv_diag;
+   TriangularSchedule lower, upper;
+   mutable Vector r;
+
+   void Factor(const SparseMatrix &A);
+   void Solve(const Vector &b, Vector &x) const;
+
+public:
+   BlockILU0Solver(int block_size) : mat(NULL), bs(block_size) { }
+
+   BlockILU0Solver(const SparseMatrix &A, int block_size)
+      : mat(NULL), bs(block_size) { SetOperator(A); }
+
+   /** @brief The operator must be a finalized, square SparseMatrix with a
+       size that is a multiple of the block size. */
+   virtual void SetOperator(const Operator &op);
+
+   virtual void Mult(const Vector &b, Vector &x) const;
+
+   /// Return the number of nonzero blocks of the factors.
+   int NumNonZeroBlocks() const { return J.Size(); }
+
+   /// Return the number of levels of the triangular solves.
+   int GetNumLevels() const
+   {
+      const int nl = lower.NumLevels(), nu = upper.NumLevels();
+      return (nl > nu) ? nl : nu;
+   }
+};
+
+}
+
+#endif
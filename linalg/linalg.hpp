@@ -18,14 +18,20 @@
 #include "operator.hpp"
 #include "matrix.hpp"
 #include "sparsemat.hpp"
+#include "sellmat.hpp"
+#include "blocksparsemat.hpp"
 #include "complex_operator.hpp"
 #include "blockvector.hpp"
 #include "blockmatrix.hpp"
 #include "blockoperator.hpp"
 #include "sparsesmoothers.hpp"
+#include "ilu.hpp"
 #include "densemat.hpp"
 #include "ode.hpp"
 #include "solvers.hpp"
+#include "amg.hpp"
+#include "mixedprecision.hpp"
+#include "multigrid.hpp"
 #include "handle.hpp"
 #include "invariants.hpp"
 
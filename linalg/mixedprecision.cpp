@@ -0,0 +1,241 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+// Implementation of the mixed precision classes FloatSparseMatrix,
+// FloatGSSmoother and MixedPrecisionSolver
+
+#include "mixedprecision.hpp"
+
+namespace mfem
+{
+
+void FloatSparseMatrix::Set(const SparseMatrix &a)
+{
+   MFEM_VERIFY(a.Finalized(), "the SparseMatrix must be finalized");
+
+   height = a.Height();
+   width = a.Width();
+   const int nnz = a.NumNonZeroElems();
+   const int *ai = a.GetI(), *aj = a.GetJ();
+   const double *av = a.GetData();
+   I.SetSize(height+1);
+   J.SetSize(nnz);
+   A.SetSize(nnz);
+   for (int i = 0; i <= height; i++)
+   {
+      I[i] = ai[i];
+   }
+   for (int j = 0; j < nnz; j++)
+   {
+      J[j] = aj[j];
+      A[j] = static_cast<float>(av[j]);
+   }
+}
+
+void FloatSparseMatrix::Mult(const Vector &x, Vector &y) const
+{
+   y.SetSize(height);
+   y = 0.0;
+   AddMult(x, y);
+}
+
+void FloatSparseMatrix::AddMult(const Vector &x, Vector &y,
+                                const double a) const
+{
+   MFEM_ASSERT(x.Size() == width && y.Size() == height,
+               "incompatible dimensions");
+
+   const int *Ip = I.GetData(), *Jp = J.GetData();
+   const float *Ap = A.GetData();
+   const double *xp = x.GetData();
+   double *yp = y.GetData();
+#ifdef MFEM_USE_OPENMP
+   #pragma omp parallel for
+#endif
+   for (int i = 0; i < height; i++)
+   {
+      double sum = 0.0;
+      for (int j = Ip[i]; j < Ip[i+1]; j++)
+      {
+         sum += Ap[j] * xp[Jp[j]];
+      }
+      yp[i] += a * sum;
+   }
+}
+
+void FloatSparseMatrix::Gauss_Seidel_forw(const Vector &x, Vector &y) const
+{
+   const int *Ip = I.GetData(), *Jp = J.GetData();
+   const float *Ap = A.GetData();
+   const double *xp = x.GetData();
+   double *yp = y.GetData();
+
+   for (int i = 0; i < height; i++)
+   {
+      double sum = 0.0;
+      int d = -1;
+      for (int j = Ip[i]; j < Ip[i+1]; j++)
+      {
+         const int c = Jp[j];
+         if (c == i)
+         {
+            d = j;
+         }
+         else
+         {
+            sum += Ap[j] * yp[c];
+         }
+      }
+
+      if (d >= 0 && Ap[d] != 0.0f)
+      {
+         yp[i] = (xp[i] - sum) / Ap[d];
+      }
+      else if (xp[i] == sum)
+      {
+         yp[i] = sum;
+      }
+      else
+      {
+         mfem_error("FloatSparseMatrix::Gauss_Seidel_forw(...)");
+      }
+   }
+}
+
+void FloatSparseMatrix::Gauss_Seidel_back(const Vector &x, Vector &y) const
+{
+   const int *Ip = I.GetData(), *Jp = J.GetData();
+   const float *Ap = A.GetData();
+   const double *xp = x.GetData();
+   double *yp = y.GetData();
+
+   for (int i = height-1; i >= 0; i--)
+   {
+      double sum = 0.0;
+      int d = -1;
+      for (int j = Ip[i+1]-1; j >= Ip[i]; j--)
+      {
+         const int c = Jp[j];
+         if (c == i)
+         {
+            d = j;
+         }
+         else
+         {
+            sum += Ap[j] * yp[c];
+         }
+      }
+
+      if (d >= 0 && Ap[d] != 0.0f)
+      {
+         yp[i] = (xp[i] - sum) / Ap[d];
+      }
+      else if (xp[i] == sum)
+      {
+         yp[i] = sum;
+      }
+      else
+      {
+         mfem_error("FloatSparseMatrix::Gauss_Seidel_back(...)");
+      }
+   }
+}
+
+
+FloatGSSmoother::FloatGSSmoother(const SparseMatrix &a, int t, int it)
+{
+   oper = NULL;
+   type = t;
+   iterations = it;
+   SetOperator(a);
+}
+
+FloatGSSmoother::FloatGSSmoother(const FloatSparseMatrix &a, int t, int it)
+{
+   oper = NULL;
+   type = t;
+   iterations = it;
+   SetOperator(a);
+}
+
+void FloatGSSmoother::SetOperator(const Operator &op)
+{
+   const FloatSparseMatrix *a_sp = dynamic_cast<const FloatSparseMatrix*>(&op);
+   if (a_sp)
+   {
+      oper = a_sp;
+   }
+   else
+   {
+      const SparseMatrix *a = dynamic_cast<const SparseMatrix*>(&op);
+      MFEM_VERIFY(a != NULL, "the operator must be a SparseMatrix or a "
+                  "FloatSparseMatrix");
+      mat.Set(*a);
+      oper = &mat;
+   }
+   height = oper->Height();
+   width = oper->Width();
+}
+
+void FloatGSSmoother::Mult(const Vector &x, Vector &y) const
+{
+   MFEM_VERIFY(oper != NULL, "SetOperator() has not been called");
+
+   if (!iterative_mode)
+   {
+      y = 0.0;
+   }
+   for (int i = 0; i < iterations; i++)
+   {
+      if (type != 2)
+      {
+         oper->Gauss_Seidel_forw(x, y);
+      }
+      if (type != 1)
+      {
+         oper->Gauss_Seidel_back(x, y);
+      }
+   }
+}
+
+
+void MixedPrecisionSolver::Mult(const Vector &b, Vector &x) const
+{
+   MFEM_VERIFY(oper != NULL, "SetOperator() has not been called");
+   MFEM_VERIFY(prec != NULL, "SetPreconditioner() has not been called");
+
+   SLISolver sli;
+   CGSolver cg;
+   FGMRESSolver fgmres;
+   IterativeSolver *outer;
+   switch (outer_type)
+   {
+      case SLI: outer = &sli; break;
+      case CG: outer = &cg; break;
+      default: outer = &fgmres; fgmres.SetKDim(m); break;
+   }
+   // The operator is set before the preconditioner, so that the inner solver
+   // keeps its single precision operator
+   outer->SetOperator(*oper);
+   outer->SetPreconditioner(*prec);
+   outer->iterative_mode = iterative_mode;
+   outer->SetRelTol(rel_tol);
+   outer->SetAbsTol(abs_tol);
+   outer->SetMaxIter(max_iter);
+   outer->SetPrintLevel(print_level);
+   outer->Mult(b, x);
+
+   final_iter = outer->GetNumIterations();
+   final_norm = outer->GetFinalNorm();
+   converged = outer->GetConverged();
+}
+
+}
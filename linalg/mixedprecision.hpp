@@ -0,0 +1,148 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#ifndef MFEM_MIXEDPRECISION
+#define MFEM_MIXEDPRECISION
+
+#include "../config/config.hpp"
+#include "sparsemat.hpp"
+#include "solvers.hpp"
+
+namespace mfem
+{
+
+/** @brief Copy of a finalized SparseMatrix with the entries stored in single
+    precision.
+
+    The matrix is stored in CSR format with float values, which halves the
+    memory traffic of the values in Mult() and in the Gauss-Seidel sweeps.
+    The vectors remain in double precision and the sums are accumulated in
+    double precision, so only the rounding of the entries (relative accuracy
+    of about 1e-7) is lost. This is sufficient for preconditioners, see
+    FloatGSSmoother, AMGSolver::SetSinglePrecision() and
+    MixedPrecisionSolver.
+
+    The object is an Operator independent of the original matrix, so it can
+    also be used as the operator of an inner Krylov solver, e.g.
+    @code
+       FloatSparseMatrix A_sp(A);
+       CGSolver inner_cg;
+       inner_cg.SetOperator(A_sp);
+    @endcode */
+class FloatSparseMatrix : public Operator
+{
+protected:
+   Array<int> I, J;
+   Array<float> A;
+
+public:
+   FloatSparseMatrix() { }
+
+   /// Copy the finalized matrix @a a, rounding its entries to single precision.
+   explicit FloatSparseMatrix(const SparseMatrix &a) { Set(a); }
+
+   /// Copy the finalized matrix @a a, rounding its entries to single precision.
+   void Set(const SparseMatrix &a);
+
+   /// Return the number of stored entries.
+   int NumNonZeroElems() const { return J.Size(); }
+
+   /// y = A x
+   virtual void Mult(const Vector &x, Vector &y) const;
+
+   /// y += a A x
+   void AddMult(const Vector &x, Vector &y, const double a = 1.0) const;
+
+   /// Gauss-Seidel forward sweep for A y = x, see SparseMatrix.
+   void Gauss_Seidel_forw(const Vector &x, Vector &y) const;
+
+   /// Gauss-Seidel backward sweep for A y = x, see SparseMatrix.
+   void Gauss_Seidel_back(const Vector &x, Vector &y) const;
+};
+
+
+/// Gauss-Seidel smoother, as GSSmoother, with a single precision matrix.
+class FloatGSSmoother : public Solver
+{
+protected:
+   FloatSparseMatrix mat; // used when a SparseMatrix is given
+   const FloatSparseMatrix *oper;
+   int type; // 0, 1, 2 - symmetric, forward, backward
+   int iterations;
+
+public:
+   FloatGSSmoother(int t = 0, int it = 1)
+   { oper = NULL; type = t; iterations = it; }
+
+   /// Use a single precision copy of @a a.
+   FloatGSSmoother(const SparseMatrix &a, int t = 0, int it = 1);
+
+   /// Use the single precision matrix @a a, which is not copied.
+   FloatGSSmoother(const FloatSparseMatrix &a, int t = 0, int it = 1);
+
+   /** @brief The operator can be a finalized SparseMatrix, which is copied in
+       single precision, or a FloatSparseMatrix, which is used directly. */
+   virtual void SetOperator(const Operator &op);
+
+   virtual void Mult(const Vector &x, Vector &y) const;
+};
+
+
+/** @brief Mixed precision iterative refinement: an outer double precision
+    iteration, preconditioned with an inner solver that works in single
+    precision. */
+/** The outer iteration computes the residuals with the (double precision)
+    operator given to SetOperator() and corrects the solution with the inner
+    solver, set with SetPreconditioner(), which should use a single precision
+    operator, e.g. a FloatGSSmoother, an AMGSolver with
+    AMGSolver::SetSinglePrecision(), or a Krylov solver with a
+    FloatSparseMatrix operator. Thus, most of the memory traffic is in single
+    precision, while the solution is accurate to the outer tolerances.
+
+    The outer iteration is one of:
+    - SLI: classical iterative refinement x += B (b - A x);
+    - CG: for symmetric positive definite A and a fixed symmetric positive
+      definite inner solver, e.g. a symmetric smoother or a V-cycle;
+    - FGMRES (default): for general A and inner solvers that may vary between
+      applications, e.g. an inner Krylov solver with a loose tolerance.
+
+    Unlike other iterative solvers, SetOperator() does not call the
+    SetOperator() method of the inner solver, which should be set up with its
+    own single precision operator. */
+class MixedPrecisionSolver : public IterativeSolver
+{
+public:
+   /// Outer iteration types.
+   enum OuterType { SLI, CG, FGMRES };
+
+protected:
+   OuterType outer_type;
+   int m; // see SetKDim()
+
+public:
+   MixedPrecisionSolver(OuterType type = FGMRES) : outer_type(type), m(50) { }
+
+   /// Set the number of FGMRES iterations between restarts, default is 50.
+   void SetKDim(int dim) { m = dim; }
+
+   /// Set the inner solver, which is not modified by SetOperator().
+   virtual void SetPreconditioner(Solver &pr) { prec = &pr; }
+
+   /// Set the double precision operator used for the residuals.
+   virtual void SetOperator(const Operator &op)
+   { oper = &op; height = op.Height(); width = op.Width(); }
+
+   virtual void Mult(const Vector &b, Vector &x) const;
+};
+
+}
+
+#endif
@@ -0,0 +1,116 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+// Implementation of class MultigridSolver
+
+#include "linalg.hpp"
+
+namespace mfem
+{
+
+MultigridSolver::MultigridSolver()
+   : cycle_type(V_CYCLE), pre_smooth(1), post_smooth(1)
+{ }
+
+void MultigridSolver::AddLevel(Operator *op, Solver *smoother,
+                               const Operator *prolongation, bool own_op,
+                               bool own_smoother, bool own_prolongation)
+{
+   const int level = operators.Size();
+   MFEM_VERIFY(op != NULL && smoother != NULL, "invalid arguments");
+   MFEM_VERIFY(op->Height() == op->Width(), "the operator must be square");
+   if (level == 0)
+   {
+      MFEM_VERIFY(prolongation == NULL,
+                  "the coarsest level can not have a prolongation");
+      smoother->iterative_mode = false;
+   }
+   else
+   {
+      MFEM_VERIFY(prolongation != NULL &&
+                  prolongation->Width() == operators.Last()->Height() &&
+                  prolongation->Height() == op->Height(),
+                  "invalid prolongation");
+      smoother->iterative_mode = true;
+   }
+
+   operators.Append(op);
+   smoothers.Append(smoother);
+   prolongations.Append(prolongation);
+   own_operators.Append(own_op);
+   own_smoothers.Append(own_smoother);
+   own_prolongations.Append(own_prolongation);
+
+   // The work vectors of the previous finest level are now needed
+   if (level > 0)
+   {
+      const int n = operators[level-1]->Height();
+      x_lev.Last() = new Vector(n);
+      b_lev.Last() = new Vector(n);
+   }
+   x_lev.Append(NULL);
+   b_lev.Append(NULL);
+   r_lev.Append(new Vector(op->Height()));
+
+   height = width = op->Height();
+}
+
+void MultigridSolver::Cycle(int level, const Vector &b, Vector &x) const
+{
+   if (level == 0)
+   {
+      smoothers[0]->Mult(b, x);
+      return;
+   }
+
+   const Operator &A = *operators[level];
+   const Operator &P = *prolongations[level];
+   Vector &r = *r_lev[level];
+   Vector &bc = *b_lev[level-1], &xc = *x_lev[level-1];
+
+   for (int i = 0; i < pre_smooth; i++) { smoothers[level]->Mult(b, x); }
+   for (int c = 0; c < cycle_type; c++)
+   {
+      // coarse grid correction
+      A.Mult(x, r);
+      subtract(b, r, r);
+      P.MultTranspose(r, bc);
+      xc = 0.0;
+      Cycle(level - 1, bc, xc);
+      P.Mult(xc, r);
+      x += r;
+   }
+   for (int i = 0; i < post_smooth; i++) { smoothers[level]->Mult(b, x); }
+}
+
+void MultigridSolver::Mult(const Vector &b, Vector &x) const
+{
+   MFEM_VERIFY(operators.Size() > 0, "no levels have been added");
+   MFEM_ASSERT(b.Size() == height && x.Size() == width, "invalid sizes");
+
+   if (!iterative_mode) { x = 0.0; }
+   Cycle(operators.Size() - 1, b, x);
+}
+
+MultigridSolver::~MultigridSolver()
+{
+   for (int l = 0; l < operators.Size(); l++)
+   {
+      if (own_operators[l]) { delete operators[l]; }
+      if (own_smoothers[l]) { delete smoothers[l]; }
+      if (own_prolongations[l]) { delete prolongations[l]; }
+      delete x_lev[l];
+      delete b_lev[l];
+      delete r_lev[l];
+   }
+}
+
+}
@@ -0,0 +1,97 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#ifndef MFEM_MULTIGRID
+#define MFEM_MULTIGRID
+
+#include "../config/config.hpp"
+#include "../general/array.hpp"
+#include "operator.hpp"
+
+namespace mfem
+{
+
+/** @brief Multigrid solver defined by a hierarchy of level operators,
+    smoothers, and prolongations between consecutive levels.
+
+    The levels are added with AddLevel(), from the coarsest (level 0) to the
+    finest one. The "smoother" of the coarsest level is used as the coarse
+    solver. The operators and prolongations can be any Operator, e.g. assembled
+    matrices or matrix-free operators.
+
+    Mult() performs one V-cycle or W-cycle on the finest level, see
+    SetCycleType(). The cycle is a symmetric operator, suitable as a
+    preconditioner for CG, if the level operators and the smoothers are
+    symmetric and the coarse solver is a symmetric linear operator. See also
+    GeometricMultigrid. */
+class MultigridSolver : public Solver
+{
+public:
+   /// Multigrid cycle types.
+   enum CycleType { V_CYCLE = 1, W_CYCLE = 2 };
+
+protected:
+   Array<Operator*> operators;
+   Array<Solver*> smoothers;
+   /// Prolongations from level l-1 to level l, prolongations[0] is NULL.
+   Array<const Operator*> prolongations;
+   Array<bool> own_operators, own_smoothers, own_prolongations;
+
+   CycleType cycle_type;
+   int pre_smooth, post_smooth;
+
+   /// Work vectors on each level; x_lev and b_lev on the finest level are not
+   /// used.
+   mutable Array<Vector*> x_lev, b_lev, r_lev;
+
+   void Cycle(int level, const Vector &b, Vector &x) const;
+
+public:
+   MultigridSolver();
+
+   /** @brief Add a new finest level with operator @a op and smoother
+       @a smoother. */
+   /** For the first (coarsest) level, @a prolongation must be NULL and
+       @a smoother is the coarse solver. For the other levels, @a prolongation
+       maps from the previous level to the new one. The ownership flags specify
+       which of the objects are deleted by the MultigridSolver.
+
+       The iterative_mode of the smoothers is set to true and that of the
+       coarse solver to false. */
+   void AddLevel(Operator *op, Solver *smoother, const Operator *prolongation,
+                 bool own_op, bool own_smoother, bool own_prolongation);
+
+   /// Set the cycle type and the number of pre- and post-smoothing steps.
+   void SetCycleType(CycleType type, int pre_steps = 1, int post_steps = 1)
+   { cycle_type = type; pre_smooth = pre_steps; post_smooth = post_steps; }
+
+   /// Return the number of levels.
+   int GetNumLevels() const { return operators.Size(); }
+
+   /// Return the operator on the given level (0 is the coarsest).
+   Operator *GetOperatorAtLevel(int level) const { return operators[level]; }
+
+   /// Return the smoother on the given level (0 is the coarsest).
+   Solver *GetSmootherAtLevel(int level) const { return smoothers[level]; }
+
+   /// The level operators are set with AddLevel().
+   virtual void SetOperator(const Operator &op)
+   { MFEM_ABORT("use AddLevel() to set the operators"); }
+
+   /// Apply one multigrid cycle to the system on the finest level.
+   virtual void Mult(const Vector &b, Vector &x) const;
+
+   virtual ~MultigridSolver();
+};
+
+}
+
+#endif
@@ -11,6 +11,7 @@
 
 #include "vector.hpp"
 #include "operator.hpp"
+#include "densemat.hpp"
 
 #include <iostream>
 #include <iomanip>
@@ -18,6 +19,19 @@
 namespace mfem
 {
 
+void Operator::MultMulti(const DenseMatrix &X, DenseMatrix &Y) const
+{
+   MFEM_ASSERT(X.Height() == width, "invalid input size: " << X.Height());
+   Y.SetSize(height, X.Width());
+   Vector x, y;
+   for (int j = 0; j < X.Width(); j++)
+   {
+      x.SetDataAndSize(const_cast<double *>(X.GetColumn(j)), width);
+      y.SetDataAndSize(Y.GetColumn(j), height);
+      Mult(x, y);
+   }
+}
+
 void Operator::FormLinearSystem(const Array<int> &ess_tdof_list,
                                 Vector &x, Vector &b,
                                 Operator* &Aout, Vector &X, Vector &B,
@@ -202,4 +216,32 @@ void ConstrainedOperator::Mult(const Vector &x, Vector &y) const
    }
 }
 
+void ConstrainedOperator::MultMulti(const DenseMatrix &X, DenseMatrix &Y) const
+{
+   if (constraint_list.Size() == 0)
+   {
+      A->MultMulti(X, Y);
+      return;
+   }
+
+   DenseMatrix Z(X);
+   for (int j = 0; j < X.Width(); j++)
+   {
+      for (int i = 0; i < constraint_list.Size(); i++)
+      {
+         Z(constraint_list[i], j) = 0.0;
+      }
+   }
+
+   A->MultMulti(Z, Y);
+
+   for (int j = 0; j < X.Width(); j++)
+   {
+      for (int i = 0; i < constraint_list.Size(); i++)
+      {
+         Y(constraint_list[i], j) = X(constraint_list[i], j);
+      }
+   }
+}
+
 }
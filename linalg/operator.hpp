@@ -17,6 +17,8 @@
 namespace mfem
 {
 
+class DenseMatrix;
+
 /// Abstract operator
 class Operator
 {
@@ -47,6 +49,13 @@ public:
    /// Operator application: `y=A(x)`.
    virtual void Mult(const Vector &x, Vector &y) const = 0;
 
+   /** @brief Operator application to the columns of @a X: `Y(:,j)=A(X(:,j))`.
+       The matrix @a Y is resized to Height() x X.Width(). */
+   /** The default behavior in class Operator is to call Mult() for every
+       column. Derived classes, e.g. SparseMatrix, can overload it to read their
+       data once for all columns, see BlockCGSolver and BlockGMRESSolver. */
+   virtual void MultMulti(const DenseMatrix &X, DenseMatrix &Y) const;
+
    /** @brief Action of the transpose operator: `y=A^t(x)`. The default behavior
        in class Operator is to generate an error. */
    virtual void MultTranspose(const Vector &x, Vector &y) const
@@ -437,6 +446,9 @@ public:
        the vectors, and "_i" -- the rest of the entries. */
    virtual void Mult(const Vector &x, Vector &y) const;
 
+   /// Constrained operator action on the columns of @a X, see Mult().
+   virtual void MultMulti(const DenseMatrix &X, DenseMatrix &Y) const;
+
    /// Destructor: destroys the unconstrained Operator @a A if @a own_A is true.
    virtual ~ConstrainedOperator() { if (own_A) { delete A; } }
 };
@@ -0,0 +1,209 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+// Implementation of class SellCSigmaMatrix
+
+#include "sellmat.hpp"
+#include "../general/sort_pairs.hpp"
+
+namespace mfem
+{
+
+// y += a A x for chunk size C; the rows of different slices are different, so
+// the slices can be processed in parallel.
+template <int C>
+static void SellAddMult(int num_slices, const int *slice_ptr, const int *col,
+                        const double *val, const int *row_perm,
+                        const double *x, double *y, double a)
+{
+#ifdef MFEM_USE_OPENMP
+   #pragma omp parallel for
+#endif
+   for (int s = 0; s < num_slices; s++)
+   {
+      double sum[C];
+      for (int r = 0; r < C; r++) { sum[r] = 0.0; }
+      for (int k = slice_ptr[s]; k < slice_ptr[s+1]; k += C)
+      {
+         for (int r = 0; r < C; r++)
+         {
+            sum[r] += val[k+r]*x[col[k+r]];
+         }
+      }
+      const int *rows = row_perm + s*C;
+      for (int r = 0; r < C; r++)
+      {
+         if (rows[r] >= 0) { y[rows[r]] += a*sum[r]; }
+      }
+   }
+}
+
+// y += a A^T x for chunk size C; different slices may update the same entries
+// of y, so this loop is sequential.
+template <int C>
+static void SellAddMultTranspose(int num_slices, const int *slice_ptr,
+                                 const int *col, const double *val,
+                                 const int *row_perm, const double *x,
+                                 double *y, double a)
+{
+   for (int s = 0; s < num_slices; s++)
+   {
+      double xs[C];
+      const int *rows = row_perm + s*C;
+      for (int r = 0; r < C; r++)
+      {
+         xs[r] = (rows[r] >= 0) ? a*x[rows[r]] : 0.0;
+      }
+      for (int k = slice_ptr[s]; k < slice_ptr[s+1]; k += C)
+      {
+         for (int r = 0; r < C; r++)
+         {
+            y[col[k+r]] += val[k+r]*xs[r];
+         }
+      }
+   }
+}
+
+SellCSigmaMatrix::SellCSigmaMatrix(const SparseMatrix &A, int C, int sigma_)
+   : Operator(A.Height(), A.Width()), chunk(C), sigma(sigma_)
+{
+   MFEM_VERIFY(A.Finalized(), "the SparseMatrix must be finalized");
+   MFEM_VERIFY(C == 1 || C == 2 || C == 4 || C == 8 || C == 16 || C == 32,
+               "invalid chunk size: " << C);
+   MFEM_VERIFY(sigma >= 1, "invalid sorting scope: " << sigma);
+   Setup(A);
+}
+
+void SellCSigmaMatrix::Setup(const SparseMatrix &A)
+{
+   const int *I = A.GetI(), *J = A.GetJ();
+   const double *V = A.GetData();
+   nnz = I[height];
+   num_slices = (height + chunk - 1)/chunk;
+
+   // Sort the rows by decreasing length within each window of sigma rows
+   row_perm.SetSize(num_slices*chunk);
+   row_perm = -1;
+   Array<Pair<int,int> > rows;
+   for (int w = 0; w < height; w += sigma)
+   {
+      const int w_end = std::min(w + sigma, height);
+      rows.SetSize(0);
+      for (int i = w; i < w_end; i++)
+      {
+         rows.Append(Pair<int,int>(I[i] - I[i+1], i));
+      }
+      SortPairs<int,int>(rows.GetData(), rows.Size());
+      for (int k = 0; k < rows.Size(); k++) { row_perm[w+k] = rows[k].two; }
+   }
+
+   // The width of each slice is the length of its longest row
+   slice_ptr.SetSize(num_slices + 1);
+   slice_ptr[0] = 0;
+   for (int s = 0; s < num_slices; s++)
+   {
+      int width_s = 0;
+      for (int r = 0; r < chunk; r++)
+      {
+         const int i = row_perm[s*chunk + r];
+         if (i >= 0) { width_s = std::max(width_s, I[i+1] - I[i]); }
+      }
+      slice_ptr[s+1] = slice_ptr[s] + width_s*chunk;
+   }
+
+   // Store the slices column-major; the padding repeats the last column of
+   // the row (or uses column 0 for empty rows) with zero value
+   col.SetSize(slice_ptr[num_slices]);
+   val.SetSize(slice_ptr[num_slices]);
+   for (int s = 0; s < num_slices; s++)
+   {
+      const int width_s = (slice_ptr[s+1] - slice_ptr[s])/chunk;
+      for (int r = 0; r < chunk; r++)
+      {
+         const int i = row_perm[s*chunk + r];
+         const int len = (i >= 0) ? I[i+1] - I[i] : 0;
+         for (int j = 0; j < width_s; j++)
+         {
+            const int k = slice_ptr[s] + j*chunk + r;
+            if (j < len)
+            {
+               col[k] = J[I[i] + j];
+               val(k) = V[I[i] + j];
+            }
+            else
+            {
+               col[k] = (len > 0) ? J[I[i] + len - 1] : 0;
+               val(k) = 0.0;
+            }
+         }
+      }
+   }
+}
+
+void SellCSigmaMatrix::Mult(const Vector &x, Vector &y) const
+{
+   y = 0.0;
+   AddMult(x, y);
+}
+
+void SellCSigmaMatrix::AddMult(const Vector &x, Vector &y,
+                               const double a) const
+{
+   MFEM_ASSERT(x.Size() == width && y.Size() == height, "invalid sizes");
+
+   const int *sp = slice_ptr.GetData(), *c = col.GetData();
+   const int *rp = row_perm.GetData();
+   const double *v = val.GetData(), *xp = x.GetData();
+   double *yp = y.GetData();
+   switch (chunk)
+   {
+      case 1: SellAddMult<1>(num_slices, sp, c, v, rp, xp, yp, a); break;
+      case 2: SellAddMult<2>(num_slices, sp, c, v, rp, xp, yp, a); break;
+      case 4: SellAddMult<4>(num_slices, sp, c, v, rp, xp, yp, a); break;
+      case 8: SellAddMult<8>(num_slices, sp, c, v, rp, xp, yp, a); break;
+      case 16: SellAddMult<16>(num_slices, sp, c, v, rp, xp, yp, a); break;
+      case 32: SellAddMult<32>(num_slices, sp, c, v, rp, xp, yp, a); break;
+   }
+}
+
+void SellCSigmaMatrix::MultTranspose(const Vector &x, Vector &y) const
+{
+   y = 0.0;
+   AddMultTranspose(x, y);
+}
+
+void SellCSigmaMatrix::AddMultTranspose(const Vector &x, Vector &y,
+                                        const double a) const
+{
+   MFEM_ASSERT(x.Size() == height && y.Size() == width, "invalid sizes");
+
+   const int *sp = slice_ptr.GetData(), *c = col.GetData();
+   const int *rp = row_perm.GetData();
+   const double *v = val.GetData(), *xp = x.GetData();
+   double *yp = y.GetData();
+   switch (chunk)
+   {
+      case 1:
+         SellAddMultTranspose<1>(num_slices, sp, c, v, rp, xp, yp, a); break;
+      case 2:
+         SellAddMultTranspose<2>(num_slices, sp, c, v, rp, xp, yp, a); break;
+      case 4:
+         SellAddMultTranspose<4>(num_slices, sp, c, v, rp, xp, yp, a); break;
+      case 8:
+         SellAddMultTranspose<8>(num_slices, sp, c, v, rp, xp, yp, a); break;
+      case 16:
+         SellAddMultTranspose<16>(num_slices, sp, c, v, rp, xp, yp, a); break;
+      case 32:
+         SellAddMultTranspose<32>(num_slices, sp, c, v, rp, xp, yp, a); break;
+   }
+}
+
+}
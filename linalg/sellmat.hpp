@@ -0,0 +1,94 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#ifndef MFEM_SELLMAT
+#define MFEM_SELLMAT
+
+#include "../config/config.hpp"
+#include "sparsemat.hpp"
+
+namespace mfem
+{
+
+/** @brief Sparse matrix in the sliced ELLPACK (SELL-C-sigma) format, built
+    from a finalized SparseMatrix.
+
+    The rows are sorted by decreasing length within windows of sigma rows and
+    grouped into slices of C consecutive sorted rows (the chunk size). Each
+    slice is stored column-major and padded to its longest row, so that the
+    inner loop of Mult() runs over the C rows of a slice with unit stride and a
+    compile-time trip count. The compiler can then vectorize it with gathers of
+    the input vector (AVX2, AVX-512) or unroll it (NEON). Sorting within the
+    windows keeps the padding small for matrices with irregular row lengths,
+    e.g. from mixed-order or nonconforming spaces, while preserving the
+    locality of the rows. With OpenMP, Mult() is threaded over the slices.
+
+    The object is an Operator independent of the original matrix, so it can
+    replace the SparseMatrix in the iterative solvers, e.g.
+    @code
+       SellCSigmaMatrix A_sell(A);
+       PCG(A_sell, prec, B, X);
+    @endcode */
+class SellCSigmaMatrix : public Operator
+{
+protected:
+   int chunk, sigma, num_slices, nnz;
+   /// Offsets of the slices in #col and #val.
+   Array<int> slice_ptr;
+   /// Column indices and values of the slices, padded with zero values.
+   Array<int> col;
+   Vector val;
+   /// The original row of each sorted row; -1 for the padding rows.
+   Array<int> row_perm;
+
+   void Setup(const SparseMatrix &A);
+
+public:
+   /** @brief Convert the finalized matrix @a A with chunk size @a C, which
+       must be 1, 2, 4, 8, 16, or 32, and sorting scope @a sigma rows. */
+   /** The default C = 8 matches the double precision SIMD width of AVX-512
+       and two AVX2 registers; @a sigma = 1 disables the sorting. */
+   SellCSigmaMatrix(const SparseMatrix &A, int C = 8, int sigma = 256);
+
+   /// y = A x
+   virtual void Mult(const Vector &x, Vector &y) const;
+
+   /// y += a A x
+   void AddMult(const Vector &x, Vector &y, const double a = 1.0) const;
+
+   /// y = A^T x
+   virtual void MultTranspose(const Vector &x, Vector &y) const;
+
+   /// y += a A^T x
+   void AddMultTranspose(const Vector &x, Vector &y,
+                         const double a = 1.0) const;
+
+   /// Return the chunk size C.
+   int GetChunkSize() const { return chunk; }
+
+   /// Return the sorting scope sigma.
+   int GetSortingScope() const { return sigma; }
+
+   /// Return the number of nonzeros of the original matrix.
+   int NumNonZeroElems() const { return nnz; }
+
+   /// Return the number of stored entries, including the padding.
+   int NumStoredElems() const { return col.Size(); }
+
+   /** @brief Return the ratio of the number of stored entries to the number
+       of nonzeros, i.e. the padding overhead (1 means no padding). */
+   double GetPaddingRatio() const
+   { return nnz ? double(col.Size())/nnz : 1.0; }
+};
+
+}
+
+#endif
@@ -0,0 +1,619 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#ifndef MFEM_TEMPLATE_SIMD
+#define MFEM_TEMPLATE_SIMD
+
+#include "../config/tconfig.hpp"
+#include <cstddef>
+
+#if defined(__SSE2__) || defined(__AVX__) || defined(__AVX512F__)
+#include <immintrin.h>
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+namespace mfem
+{
+
+// Portable SIMD value type used by the templated classes, e.g. TBilinearForm,
+// to process a batch of elements at once, one element per SIMD lane.
+
+// Generic implementation: S values of type scalar_t, aligned to align_S bytes.
+// The operations are written as loops over the lanes that the compiler is
+// expected to vectorize. The specializations below use the intrinsics of the
+// SSE2, AVX, AVX-512 and NEON instruction sets.
+template <typename scalar_t, int S, int align_S>
+struct MFEM_ALIGN_AS(align_S) AutoSIMD
+{
+   typedef scalar_t scalar_type;
+   static const int size = S;
+   static const int align_size = align_S;
+
+   scalar_t vec[size];
+
+   inline MFEM_ALWAYS_INLINE scalar_t &operator[](int i) { return vec[i]; }
+
+   inline MFEM_ALWAYS_INLINE const scalar_t &operator[](int i) const
+   { return vec[i]; }
+
+   inline MFEM_ALWAYS_INLINE AutoSIMD &operator=(const scalar_t &e)
+   {
+      for (int i = 0; i < size; i++) { vec[i] = e; }
+      return *this;
+   }
+
+   inline MFEM_ALWAYS_INLINE AutoSIMD &operator+=(const AutoSIMD &v)
+   {
+      for (int i = 0; i < size; i++) { vec[i] += v[i]; }
+      return *this;
+   }
+
+   inline MFEM_ALWAYS_INLINE AutoSIMD &operator+=(const scalar_t &e)
+   {
+      for (int i = 0; i < size; i++) { vec[i] += e; }
+      return *this;
+   }
+
+   inline MFEM_ALWAYS_INLINE AutoSIMD &operator-=(const AutoSIMD &v)
+   {
+      for (int i = 0; i < size; i++) { vec[i] -= v[i]; }
+      return *this;
+   }
+
+   inline MFEM_ALWAYS_INLINE AutoSIMD &operator-=(const scalar_t &e)
+   {
+      for (int i = 0; i < size; i++) { vec[i] -= e; }
+      return *this;
+   }
+
+   inline MFEM_ALWAYS_INLINE AutoSIMD &operator*=(const AutoSIMD &v)
+   {
+      for (int i = 0; i < size; i++) { vec[i] *= v[i]; }
+      return *this;
+   }
+
+   inline MFEM_ALWAYS_INLINE AutoSIMD &operator*=(const scalar_t &e)
+   {
+      for (int i = 0; i < size; i++) { vec[i] *= e; }
+      return *this;
+   }
+
+   inline MFEM_ALWAYS_INLINE AutoSIMD &operator/=(const AutoSIMD &v)
+   {
+      for (int i = 0; i < size; i++) { vec[i] /= v[i]; }
+      return *this;
+   }
+
+   inline MFEM_ALWAYS_INLINE AutoSIMD &operator/=(const scalar_t &e)
+   {
+      for (int i = 0; i < size; i++) { vec[i] /= e; }
+      return *this;
+   }
+
+   inline MFEM_ALWAYS_INLINE AutoSIMD operator-() const
+   {
+      AutoSIMD r;
+      for (int i = 0; i < size; i++) { r[i] = -vec[i]; }
+      return r;
+   }
+
+   inline MFEM_ALWAYS_INLINE AutoSIMD operator+(const AutoSIMD &v) const
+   {
+      AutoSIMD r;
+      for (int i = 0; i < size; i++) { r[i] = vec[i] + v[i]; }
+      return r;
+   }
+
+   inline MFEM_ALWAYS_INLINE AutoSIMD operator+(const scalar_t &e) const
+   {
+      AutoSIMD r;
+      for (int i = 0; i < size; i++) { r[i] = vec[i] + e; }
+      return r;
+   }
+
+   inline MFEM_ALWAYS_INLINE AutoSIMD operator-(const AutoSIMD &v) const
+   {
+      AutoSIMD r;
+      for (int i = 0; i < size; i++) { r[i] = vec[i] - v[i]; }
+      return r;
+   }
+
+   inline MFEM_ALWAYS_INLINE AutoSIMD operator-(const scalar_t &e) const
+   {
+      AutoSIMD r;
+      for (int i = 0; i < size; i++) { r[i] = vec[i] - e; }
+      return r;
+   }
+
+   inline MFEM_ALWAYS_INLINE AutoSIMD operator*(const AutoSIMD &v) const
+   {
+      AutoSIMD r;
+      for (int i = 0; i < size; i++) { r[i] = vec[i] * v[i]; }
+      return r;
+   }
+
+   inline MFEM_ALWAYS_INLINE AutoSIMD operator*(const scalar_t &e) const
+   {
+      AutoSIMD r;
+      for (int i = 0; i < size; i++) { r[i] = vec[i] * e; }
+      return r;
+   }
+
+   inline MFEM_ALWAYS_INLINE AutoSIMD operator/(const AutoSIMD &v) const
+   {
+      AutoSIMD r;
+      for (int i = 0; i < size; i++) { r[i] = vec[i] / v[i]; }
+      return r;
+   }
+
+   inline MFEM_ALWAYS_INLINE AutoSIMD operator/(const scalar_t &e) const
+   {
+      AutoSIMD r;
+      for (int i = 0; i < size; i++) { r[i] = vec[i] / e; }
+      return r;
+   }
+
+   /// this += v * w
+   inline MFEM_ALWAYS_INLINE AutoSIMD &fma(const AutoSIMD &v, const AutoSIMD &w)
+   {
+      for (int i = 0; i < size; i++) { vec[i] += v[i] * w[i]; }
+      return *this;
+   }
+};
+
+template <typename scalar_t, int S, int A>
+inline MFEM_ALWAYS_INLINE AutoSIMD<scalar_t,S,A>
+operator+(const scalar_t &e, const AutoSIMD<scalar_t,S,A> &v)
+{
+   return v + e;
+}
+
+template <typename scalar_t, int S, int A>
+inline MFEM_ALWAYS_INLINE AutoSIMD<scalar_t,S,A>
+operator-(const scalar_t &e, const AutoSIMD<scalar_t,S,A> &v)
+{
+   AutoSIMD<scalar_t,S,A> r;
+   r = e;
+   return r -= v;
+}
+
+template <typename scalar_t, int S, int A>
+inline MFEM_ALWAYS_INLINE AutoSIMD<scalar_t,S,A>
+operator*(const scalar_t &e, const AutoSIMD<scalar_t,S,A> &v)
+{
+   return v * e;
+}
+
+template <typename scalar_t, int S, int A>
+inline MFEM_ALWAYS_INLINE AutoSIMD<scalar_t,S,A>
+operator/(const scalar_t &e, const AutoSIMD<scalar_t,S,A> &v)
+{
+   AutoSIMD<scalar_t,S,A> r;
+   r = e;
+   return r /= v;
+}
+
+#if defined(__SSE2__)
+// 2 doubles, SSE2
+template <>
+struct AutoSIMD<double,2,16>
+{
+   typedef double scalar_type;
+   static const int size = 2;
+   static const int align_size = 16;
+
+   union
+   {
+      __m128d m128d;
+      double vec[size];
+   };
+
+   inline MFEM_ALWAYS_INLINE double &operator[](int i) { return vec[i]; }
+
+   inline MFEM_ALWAYS_INLINE const double &operator[](int i) const
+   { return vec[i]; }
+
+   inline MFEM_ALWAYS_INLINE AutoSIMD &operator=(const double &e)
+   { m128d = _mm_set1_pd(e); return *this; }
+
+   inline MFEM_ALWAYS_INLINE AutoSIMD &operator+=(const AutoSIMD &v)
+   { m128d = _mm_add_pd(m128d, v.m128d); return *this; }
+
+   inline MFEM_ALWAYS_INLINE AutoSIMD &operator+=(const double &e)
+   { m128d = _mm_add_pd(m128d, _mm_set1_pd(e)); return *this; }
+
+   inline MFEM_ALWAYS_INLINE AutoSIMD &operator-=(const AutoSIMD &v)
+   { m128d = _mm_sub_pd(m128d, v.m128d); return *this; }
+
+   inline MFEM_ALWAYS_INLINE AutoSIMD &operator-=(const double &e)
+   { m128d = _mm_sub_pd(m128d, _mm_set1_pd(e)); return *this; }
+
+   inline MFEM_ALWAYS_INLINE AutoSIMD &operator*=(const AutoSIMD &v)
+   { m128d = _mm_mul_pd(m128d, v.m128d); return *this; }
+
+   inline MFEM_ALWAYS_INLINE AutoSIMD &operator*=(const double &e)
+   { m128d = _mm_mul_pd(m128d, _mm_set1_pd(e)); return *this; }
+
+   inline MFEM_ALWAYS_INLINE AutoSIMD &operator/=(const AutoSIMD &v)
+   { m128d = _mm_div_pd(m128d, v.m128d); return *this; }
+
+   inline MFEM_ALWAYS_INLINE AutoSIMD &operator/=(const double &e)
+   { m128d = _mm_div_pd(m128d, _mm_set1_pd(e)); return *this; }
+
+   inline MFEM_ALWAYS_INLINE AutoSIMD operator-() const
+   { AutoSIMD r; r.m128d = _mm_xor_pd(_mm_set1_pd(-0.0), m128d); return r; }
+
+   inline MFEM_ALWAYS_INLINE AutoSIMD operator+(const AutoSIMD &v) const
+   { AutoSIMD r; r.m128d = _mm_add_pd(m128d, v.m128d); return r; }
+
+   inline MFEM_ALWAYS_INLINE AutoSIMD operator+(const double &e) const
+   { AutoSIMD r; r.m128d = _mm_add_pd(m128d, _mm_set1_pd(e)); return r; }
+
+   inline MFEM_ALWAYS_INLINE AutoSIMD operator-(const AutoSIMD &v) const
+   { AutoSIMD r; r.m128d = _mm_sub_pd(m128d, v.m128d); return r; }
+
+   inline MFEM_ALWAYS_INLINE AutoSIMD operator-(const double &e) const
+   { AutoSIMD r; r.m128d = _mm_sub_pd(m128d, _mm_set1_pd(e)); return r; }
+
+   inline MFEM_ALWAYS_INLINE AutoSIMD operator*(const AutoSIMD &v) const
+   { AutoSIMD r; r.m128d = _mm_mul_pd(m128d, v.m128d); return r; }
+
+   inline MFEM_ALWAYS_INLINE AutoSIMD operator*(const double &e) const
+   { AutoSIMD r; r.m128d = _mm_mul_pd(m128d, _mm_set1_pd(e)); return r; }
+
+   inline MFEM_ALWAYS_INLINE AutoSIMD operator/(const AutoSIMD &v) const
+   { AutoSIMD r; r.m128d = _mm_div_pd(m128d, v.m128d); return r; }
+
+   inline MFEM_ALWAYS_INLINE AutoSIMD operator/(const double &e) const
+   { AutoSIMD r; r.m128d = _mm_div_pd(m128d, _mm_set1_pd(e)); return r; }
+
+   inline MFEM_ALWAYS_INLINE AutoSIMD &fma(const AutoSIMD &v, const AutoSIMD &w)
+   {
+#ifdef __FMA__
+      m128d = _mm_fmadd_pd(v.m128d, w.m128d, m128d);
+#else
+      m128d = _mm_add_pd(_mm_mul_pd(v.m128d, w.m128d), m128d);
+#endif
+      return *this;
+   }
+};
+#endif // __SSE2__
+
+#if defined(__AVX__)
+// 4 doubles, AVX
+template <>
+struct AutoSIMD<double,4,32>
+{
+   typedef double scalar_type;
+   static const int size = 4;
+   static const int align_size = 32;
+
+   union
+   {
+      __m256d m256d;
+      double vec[size];
+   };
+
+   inline MFEM_ALWAYS_INLINE double &operator[](int i) { return vec[i]; }
+
+   inline MFEM_ALWAYS_INLINE const double &operator[](int i) const
+   { return vec[i]; }
+
+   inline MFEM_ALWAYS_INLINE AutoSIMD &operator=(const double &e)
+   { m256d = _mm256_set1_pd(e); return *this; }
+
+   inline MFEM_ALWAYS_INLINE AutoSIMD &operator+=(const AutoSIMD &v)
+   { m256d = _mm256_add_pd(m256d, v.m256d); return *this; }
+
+   inline MFEM_ALWAYS_INLINE AutoSIMD &operator+=(const double &e)
+   { m256d = _mm256_add_pd(m256d, _mm256_set1_pd(e)); return *this; }
+
+   inline MFEM_ALWAYS_INLINE AutoSIMD &operator-=(const AutoSIMD &v)
+   { m256d = _mm256_sub_pd(m256d, v.m256d); return *this; }
+
+   inline MFEM_ALWAYS_INLINE AutoSIMD &operator-=(const double &e)
+   { m256d = _mm256_sub_pd(m256d, _mm256_set1_pd(e)); return *this; }
+
+   inline MFEM_ALWAYS_INLINE AutoSIMD &operator*=(const AutoSIMD &v)
+   { m256d = _mm256_mul_pd(m256d, v.m256d); return *this; }
+
+   inline MFEM_ALWAYS_INLINE AutoSIMD &operator*=(const double &e)
+   { m256d = _mm256_mul_pd(m256d, _mm256_set1_pd(e)); return *this; }
+
+   inline MFEM_ALWAYS_INLINE AutoSIMD &operator/=(const AutoSIMD &v)
+   { m256d = _mm256_div_pd(m256d, v.m256d); return *this; }
+
+   inline MFEM_ALWAYS_INLINE AutoSIMD &operator/=(const double &e)
+   { m256d = _mm256_div_pd(m256d, _mm256_set1_pd(e)); return *this; }
+
+   inline MFEM_ALWAYS_INLINE AutoSIMD operator-() const
+   {
+      AutoSIMD r;
+      r.m256d = _mm256_xor_pd(_mm256_set1_pd(-0.0), m256d);
+      return r;
+   }
+
+   inline MFEM_ALWAYS_INLINE AutoSIMD operator+(const AutoSIMD &v) const
+   { AutoSIMD r; r.m256d = _mm256_add_pd(m256d, v.m256d); return r; }
+
+   inline MFEM_ALWAYS_INLINE AutoSIMD operator+(const double &e) const
+   { AutoSIMD r; r.m256d = _mm256_add_pd(m256d, _mm256_set1_pd(e)); return r; }
+
+   inline MFEM_ALWAYS_INLINE AutoSIMD operator-(const AutoSIMD &v) const
+   { AutoSIMD r; r.m256d = _mm256_sub_pd(m256d, v.m256d); return r; }
+
+   inline MFEM_ALWAYS_INLINE AutoSIMD operator-(const double &e) const
+   { AutoSIMD r; r.m256d = _mm256_sub_pd(m256d, _mm256_set1_pd(e)); return r; }
+
+   inline MFEM_ALWAYS_INLINE AutoSIMD operator*(const AutoSIMD &v) const
+   { AutoSIMD r; r.m256d = _mm256_mul_pd(m256d, v.m256d); return r; }
+
+   inline MFEM_ALWAYS_INLINE AutoSIMD operator*(const double &e) const
+   { AutoSIMD r; r.m256d = _mm256_mul_pd(m256d, _mm256_set1_pd(e)); return r; }
+
+   inline MFEM_ALWAYS_INLINE AutoSIMD operator/(const AutoSIMD &v) const
+   { AutoSIMD r; r.m256d = _mm256_div_pd(m256d, v.m256d); return r; }
+
+   inline MFEM_ALWAYS_INLINE AutoSIMD operator/(const double &e) const
+   { AutoSIMD r; r.m256d = _mm256_div_pd(m256d, _mm256_set1_pd(e)); return r; }
+
+   inline MFEM_ALWAYS_INLINE AutoSIMD &fma(const AutoSIMD &v, const AutoSIMD &w)
+   {
+#ifdef __FMA__
+      m256d = _mm256_fmadd_pd(v.m256d, w.m256d, m256d);
+#else
+      m256d = _mm256_add_pd(_mm256_mul_pd(v.m256d, w.m256d), m256d);
+#endif
+      return *this;
+   }
+};
+#endif // __AVX__
+
+#if defined(__AVX512F__)
+// 8 doubles, AVX-512
+template <>
+struct AutoSIMD<double,8,64>
+{
+   typedef double scalar_type;
+   static const int size = 8;
+   static const int align_size = 64;
+
+   union
+   {
+      __m512d m512d;
+      double vec[size];
+   };
+
+   inline MFEM_ALWAYS_INLINE double &operator[](int i) { return vec[i]; }
+
+   inline MFEM_ALWAYS_INLINE const double &operator[](int i) const
+   { return vec[i]; }
+
+   inline MFEM_ALWAYS_INLINE AutoSIMD &operator=(const double &e)
+   { m512d = _mm512_set1_pd(e); return *this; }
+
+   inline MFEM_ALWAYS_INLINE AutoSIMD &operator+=(const AutoSIMD &v)
+   { m512d = _mm512_add_pd(m512d, v.m512d); return *this; }
+
+   inline MFEM_ALWAYS_INLINE AutoSIMD &operator+=(const double &e)
+   { m512d = _mm512_add_pd(m512d, _mm512_set1_pd(e)); return *this; }
+
+   inline MFEM_ALWAYS_INLINE AutoSIMD &operator-=(const AutoSIMD &v)
+   { m512d = _mm512_sub_pd(m512d, v.m512d); return *this; }
+
+   inline MFEM_ALWAYS_INLINE AutoSIMD &operator-=(const double &e)
+   { m512d = _mm512_sub_pd(m512d, _mm512_set1_pd(e)); return *this; }
+
+   inline MFEM_ALWAYS_INLINE AutoSIMD &operator*=(const AutoSIMD &v)
+   { m512d = _mm512_mul_pd(m512d, v.m512d); return *this; }
+
+   inline MFEM_ALWAYS_INLINE AutoSIMD &operator*=(const double &e)
+   { m512d = _mm512_mul_pd(m512d, _mm512_set1_pd(e)); return *this; }
+
+   inline MFEM_ALWAYS_INLINE AutoSIMD &operator/=(const AutoSIMD &v)
+   { m512d = _mm512_div_pd(m512d, v.m512d); return *this; }
+
+   inline MFEM_ALWAYS_INLINE AutoSIMD &operator/=(const double &e)
+   { m512d = _mm512_div_pd(m512d, _mm512_set1_pd(e)); return *this; }
+
+   inline MFEM_ALWAYS_INLINE AutoSIMD operator-() const
+   {
+      // _mm512_xor_pd requires AVX512DQ, so flip the sign bits as integers
+      AutoSIMD r;
+      r.m512d = _mm512_castsi512_pd(
+                   _mm512_xor_si512(_mm512_castpd_si512(m512d),
+                                    _mm512_castpd_si512(_mm512_set1_pd(-0.0))));
+      return r;
+   }
+
+   inline MFEM_ALWAYS_INLINE AutoSIMD operator+(const AutoSIMD &v) const
+   { AutoSIMD r; r.m512d = _mm512_add_pd(m512d, v.m512d); return r; }
+
+   inline MFEM_ALWAYS_INLINE AutoSIMD operator+(const double &e) const
+   { AutoSIMD r; r.m512d = _mm512_add_pd(m512d, _mm512_set1_pd(e)); return r; }
+
+   inline MFEM_ALWAYS_INLINE AutoSIMD operator-(const AutoSIMD &v) const
+   { AutoSIMD r; r.m512d = _mm512_sub_pd(m512d, v.m512d); return r; }
+
+   inline MFEM_ALWAYS_INLINE AutoSIMD operator-(const double &e) const
+   { AutoSIMD r; r.m512d = _mm512_sub_pd(m512d, _mm512_set1_pd(e)); return r; }
+
+   inline MFEM_ALWAYS_INLINE AutoSIMD operator*(const AutoSIMD &v) const
+   { AutoSIMD r; r.m512d = _mm512_mul_pd(m512d, v.m512d); return r; }
+
+   inline MFEM_ALWAYS_INLINE AutoSIMD operator*(const double &e) const
+   { AutoSIMD r; r.m512d = _mm512_mul_pd(m512d, _mm512_set1_pd(e)); return r; }
+
+   inline MFEM_ALWAYS_INLINE AutoSIMD operator/(const AutoSIMD &v) const
+   { AutoSIMD r; r.m512d = _mm512_div_pd(m512d, v.m512d); return r; }
+
+   inline MFEM_ALWAYS_INLINE AutoSIMD operator/(const double &e) const
+   { AutoSIMD r; r.m512d = _mm512_div_pd(m512d, _mm512_set1_pd(e)); return r; }
+
+   inline MFEM_ALWAYS_INLINE AutoSIMD &fma(const AutoSIMD &v, const AutoSIMD &w)
+   { m512d = _mm512_fmadd_pd(v.m512d, w.m512d, m512d); return *this; }
+};
+#endif // __AVX512F__
+
+#if defined(__aarch64__) && defined(__ARM_NEON)
+// 2 doubles, NEON
+template <>
+struct AutoSIMD<double,2,16>
+{
+   typedef double scalar_type;
+   static const int size = 2;
+   static const int align_size = 16;
+
+   union
+   {
+      float64x2_t vd;
+      double vec[size];
+   };
+
+   inline MFEM_ALWAYS_INLINE double &operator[](int i) { return vec[i]; }
+
+   inline MFEM_ALWAYS_INLINE const double &operator[](int i) const
+   { return vec[i]; }
+
+   inline MFEM_ALWAYS_INLINE AutoSIMD &operator=(const double &e)
+   { vd = vdupq_n_f64(e); return *this; }
+
+   inline MFEM_ALWAYS_INLINE AutoSIMD &operator+=(const AutoSIMD &v)
+   { vd = vaddq_f64(vd, v.vd); return *this; }
+
+   inline MFEM_ALWAYS_INLINE AutoSIMD &operator+=(const double &e)
+   { vd = vaddq_f64(vd, vdupq_n_f64(e)); return *this; }
+
+   inline MFEM_ALWAYS_INLINE AutoSIMD &operator-=(const AutoSIMD &v)
+   { vd = vsubq_f64(vd, v.vd); return *this; }
+
+   inline MFEM_ALWAYS_INLINE AutoSIMD &operator-=(const double &e)
+   { vd = vsubq_f64(vd, vdupq_n_f64(e)); return *this; }
+
+   inline MFEM_ALWAYS_INLINE AutoSIMD &operator*=(const AutoSIMD &v)
+   { vd = vmulq_f64(vd, v.vd); return *this; }
+
+   inline MFEM_ALWAYS_INLINE AutoSIMD &operator*=(const double &e)
+   { vd = vmulq_n_f64(vd, e); return *this; }
+
+   inline MFEM_ALWAYS_INLINE AutoSIMD &operator/=(const AutoSIMD &v)
+   { vd = vdivq_f64(vd, v.vd); return *this; }
+
+   inline MFEM_ALWAYS_INLINE AutoSIMD &operator/=(const double &e)
+   { vd = vdivq_f64(vd, vdupq_n_f64(e)); return *this; }
+
+   inline MFEM_ALWAYS_INLINE AutoSIMD operator-() const
+   { AutoSIMD r; r.vd = vnegq_f64(vd); return r; }
+
+   inline MFEM_ALWAYS_INLINE AutoSIMD operator+(const AutoSIMD &v) const
+   { AutoSIMD r; r.vd = vaddq_f64(vd, v.vd); return r; }
+
+   inline MFEM_ALWAYS_INLINE AutoSIMD operator+(const double &e) const
+   { AutoSIMD r; r.vd = vaddq_f64(vd, vdupq_n_f64(e)); return r; }
+
+   inline MFEM_ALWAYS_INLINE AutoSIMD operator-(const AutoSIMD &v) const
+   { AutoSIMD r; r.vd = vsubq_f64(vd, v.vd); return r; }
+
+   inline MFEM_ALWAYS_INLINE AutoSIMD operator-(const double &e) const
+   { AutoSIMD r; r.vd = vsubq_f64(vd, vdupq_n_f64(e)); return r; }
+
+   inline MFEM_ALWAYS_INLINE AutoSIMD operator*(const AutoSIMD &v) const
+   { AutoSIMD r; r.vd = vmulq_f64(vd, v.vd); return r; }
+
+   inline MFEM_ALWAYS_INLINE AutoSIMD operator*(const double &e) const
+   { AutoSIMD r; r.vd = vmulq_n_f64(vd, e); return r; }
+
+   inline MFEM_ALWAYS_INLINE AutoSIMD operator/(const AutoSIMD &v) const
+   { AutoSIMD r; r.vd = vdivq_f64(vd, v.vd); return r; }
+
+   inline MFEM_ALWAYS_INLINE AutoSIMD operator/(const double &e) const
+   { AutoSIMD r; r.vd = vdivq_f64(vd, vdupq_n_f64(e)); return r; }
+
+   inline MFEM_ALWAYS_INLINE AutoSIMD &fma(const AutoSIMD &v, const AutoSIMD &w)
+   { vd = vfmaq_f64(vd, v.vd, w.vd); return *this; }
+};
+#endif // __aarch64__ && __ARM_NEON
+
+
+// Access to the lanes of SIMD values; scalars are treated as SIMD values with a
+// single lane.
+
+template <typename T>
+inline MFEM_ALWAYS_INLINE T &SIMDLane(T &x, int) { return x; }
+
+template <typename T>
+inline MFEM_ALWAYS_INLINE const T &SIMDLane(const T &x, int) { return x; }
+
+template <typename scalar_t, int S, int A>
+inline MFEM_ALWAYS_INLINE
+scalar_t &SIMDLane(AutoSIMD<scalar_t,S,A> &x, int l) { return x[l]; }
+
+template <typename scalar_t, int S, int A>
+inline MFEM_ALWAYS_INLINE
+const scalar_t &SIMDLane(const AutoSIMD<scalar_t,S,A> &x, int l)
+{ return x[l]; }
+
+
+// SIMD traits used by the templated classes, e.g. TBilinearForm. They define
+// the type vcomplex_t used for the element data, which holds the data of
+// simd_size elements, one element per lane, and is aligned to align_size
+// bytes.
+
+// Use the SIMD registers selected when MFEM was configured, see MFEM_SIMD_SIZE.
+// Application code that needs another width can define similar traits with a
+// different simd_size instead of redefining MFEM_SIMD_SIZE.
+template <typename complex_t, typename real_t>
+struct AutoSIMDTraits
+{
+   static const int align_size = MFEM_SIMD_SIZE;
+   static const int simd_size = (MFEM_SIMD_SIZE > (int)sizeof(complex_t)) ?
+                                (MFEM_SIMD_SIZE/(int)sizeof(complex_t)) : 1;
+
+   typedef AutoSIMD<complex_t,simd_size,align_size> vcomplex_t;
+};
+
+// Process one element at a time.
+template <typename complex_t, typename real_t>
+struct NoSIMDTraits
+{
+   static const int align_size = (int)sizeof(complex_t);
+   static const int simd_size = 1;
+
+   typedef complex_t vcomplex_t;
+};
+
+
+// Allocate an array of n objects of the POD type T, e.g. a tensor of AutoSIMD
+// values, aligned to 'align' bytes (at most 128). The alignment of objects
+// allocated with 'new' is not guaranteed to be sufficient before C++17.
+template <typename T>
+inline T *AlignedAlloc(int n, int align)
+{
+   char *ptr = new char[n*sizeof(T) + align];
+   const int offset = align - (int)(reinterpret_cast<size_t>(ptr) % align);
+   char *aligned_ptr = ptr + offset;
+   aligned_ptr[-1] = (char)offset; // offset is in [1,align]
+   return reinterpret_cast<T*>(aligned_ptr);
+}
+
+// Free an array allocated with AlignedAlloc().
+template <typename T>
+inline void AlignedFree(T *aligned_ptr)
+{
+   if (aligned_ptr == NULL) { return; }
+   char *ptr = reinterpret_cast<char*>(aligned_ptr);
+   delete [] (ptr - (unsigned char)ptr[-1]);
+}
+
+} // namespace mfem
+
+#endif // MFEM_TEMPLATE_SIMD
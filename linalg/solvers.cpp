@@ -69,6 +69,135 @@ double IterativeSolver::Dot(const Vector &x, const Vector &y) const
 #endif
 }
 
+void IterativeSolver::StartDots(double *dots, int n) const
+{
+#ifdef MFEM_USE_MPI
+   if (dot_prod_type == 1)
+   {
+#if MPI_VERSION >= 3
+      MPI_Iallreduce(MPI_IN_PLACE, dots, n, MPI_DOUBLE, MPI_SUM, comm,
+                     &dot_request);
+#else
+      MPI_Allreduce(MPI_IN_PLACE, dots, n, MPI_DOUBLE, MPI_SUM, comm);
+#endif
+   }
+#endif
+}
+
+void IterativeSolver::FinishDots() const
+{
+#if defined(MFEM_USE_MPI) && MPI_VERSION >= 3
+   if (dot_prod_type == 1)
+   {
+      MPI_Wait(&dot_request, MPI_STATUS_IGNORE);
+   }
+#endif
+}
+
+void IterativeSolver::Dot(const DenseMatrix &X, const DenseMatrix &Y,
+                          DenseMatrix &G) const
+{
+   G.SetSize(X.Width(), Y.Width());
+   MultAtB(X, Y, G);
+   StartDots(G.Data(), G.Height()*G.Width());
+   FinishDots();
+}
+
+// One pass of Cholesky QR with diagonal pivoting, given the Gram matrix
+// G = W^t W. With D = diag(G)^{1/2}, the factorization W D^{-1} = Q R1 is
+// computed, Q replaces W and R = R1 D is returned. A column is not used as a
+// pivot when its remaining squared norm, relative to its initial one, is
+// below 'tol'.
+static int CholQR(DenseMatrix &W, const DenseMatrix &G, DenseMatrix &R)
+{
+   const double tol = 1e-12;
+   const int n = W.Height(), k = W.Width();
+   Vector d(k), diag(k);
+   Array<int> piv;
+   DenseMatrix L(k);
+
+   L = 0.0;
+   for (int j = 0; j < k; j++)
+   {
+      d(j) = sqrt(std::max(G(j,j), 0.0));
+      diag(j) = (d(j) > 0.0) ? 1.0 : -1.0; // -1 marks the excluded columns
+   }
+   for (int s = 0; s < k; s++)
+   {
+      int p = -1;
+      double dmax = tol;
+      for (int j = 0; j < k; j++)
+      {
+         if (diag(j) > dmax) { dmax = diag(j); p = j; }
+      }
+      if (p < 0) { break; }
+      const double rpp = sqrt(dmax);
+      piv.Append(p);
+      L(s,p) = rpp;
+      diag(p) = -1.0;
+      for (int j = 0; j < k; j++)
+      {
+         if (j == p || d(j) == 0.0) { continue; }
+         bool pivot = false;
+         for (int t = 0; t < s; t++)
+         {
+            if (piv[t] == j) { pivot = true; break; }
+         }
+         if (pivot) { continue; }
+         double r = G(p,j)/(d(p)*d(j));
+         for (int t = 0; t < s; t++)
+         {
+            r -= L(t,p)*L(t,j);
+         }
+         L(s,j) = r/rpp;
+         if (diag(j) > 0.0) { diag(j) -= L(s,j)*L(s,j); }
+      }
+   }
+
+   const int rank = piv.Size();
+   if (rank == 0) { return 0; }
+   DenseMatrix Q(n, rank);
+   for (int s = 0; s < rank; s++)
+   {
+      const int p = piv[s];
+      Vector q(Q.GetColumn(s), n);
+      Vector w(W.GetColumn(p), n);
+      q.Set(1.0/d(p), w);
+      for (int t = 0; t < s; t++)
+      {
+         Vector qt(Q.GetColumn(t), n);
+         q.Add(-L(t,p), qt);
+      }
+      q /= L(s,p);
+   }
+   W = Q;
+   R.SetSize(rank, k);
+   for (int j = 0; j < k; j++)
+   {
+      for (int s = 0; s < rank; s++)
+      {
+         R(s,j) = L(s,j)*d(j);
+      }
+   }
+   return rank;
+}
+
+int IterativeSolver::Orthonormalize(DenseMatrix &W, DenseMatrix &R) const
+{
+   DenseMatrix G, R1, R2, W1(W);
+
+   Dot(W1, W1, G);
+   const int r1 = CholQR(W1, G, R1);
+   if (r1 == 0) { return 0; }
+   Dot(W1, W1, G);
+   const int r2 = CholQR(W1, G, R2);
+   if (r2 == 0) { return 0; }
+   W = W1;
+   R.SetSize(r2, R1.Width());
+   mfem::Mult(R2, R1, R);
+   return r2;
+}
+
 void IterativeSolver::SetPrintLevel(int print_lvl)
 {
 #ifndef MFEM_USE_MPI
@@ -358,17 +487,21 @@ void CGSolver::Mult(const Vector &b, Vector &x) const
    for (i = 1; true; )
    {
       alpha = nom/den;
-      add(x,  alpha, d, x);     //  x = x + alpha d
-      add(r, -alpha, z, r);     //  r = r - alpha A d
 
       if (prec)
       {
+         //  x = x + alpha d and r = r - alpha A d in one pass
+         AddPair(x, alpha, d, r, -alpha, z);
          prec->Mult(r, z);      //  z = B r
          betanom = Dot(r, z);
       }
       else
       {
-         betanom = Dot(r, r);
+         x.Add(alpha, d);       //  x = x + alpha d
+         //  r = r - alpha A d and (r, r) in one pass
+         betanom = AddAndDot(r, -alpha, z, r, r);
+         StartDots(&betanom, 1);
+         FinishDots();
       }
       MFEM_ASSERT(IsFinite(betanom), "betanom = " << betanom);
 
@@ -469,6 +602,156 @@ void PCG(const Operator &A, Solver &B, const Vector &b, Vector &x,
 }
 
 
+void PipelinedCGSolver::UpdateVectors()
+{
+   r.SetSize(width);
+   u.SetSize(width);
+   w.SetSize(width);
+   m.SetSize(width);
+   n.SetSize(width);
+   p.SetSize(width);
+   s.SetSize(width);
+   q.SetSize(width);
+   z.SetSize(width);
+}
+
+void PipelinedCGSolver::Mult(const Vector &b, Vector &x) const
+{
+   // Preconditioned pipelined CG following Algorithm 4 in Ghysels and
+   // Vanroose. With B the preconditioner, the vectors satisfy u = B r,
+   // w = A u, m = B w, n = A m, and for the search direction p: s = A p,
+   // q = B s, z = A q.
+   int i;
+   double dots[2], gamma = 0.0, gamma_old = 0.0, alpha = 0.0, r0 = 0.0;
+   double nom0 = 0.0;
+
+   if (iterative_mode)
+   {
+      oper->Mult(x, r);
+      subtract(b, r, r); // r = b - A x
+   }
+   else
+   {
+      r = b;
+      x = 0.0;
+   }
+   if (prec)
+   {
+      prec->Mult(r, u);
+   }
+   else
+   {
+      u = r;
+   }
+   oper->Mult(u, w);
+   p = 0.0;
+   s = 0.0;
+   q = 0.0;
+   z = 0.0;
+
+   double *X = x.GetData(), *R = r.GetData(), *U = u.GetData();
+   double *W = w.GetData(), *P = p.GetData(), *S = s.GetData();
+   double *Q = q.GetData(), *Z = z.GetData();
+   const double *M = m.GetData(), *N = n.GetData();
+
+   converged = 0;
+   final_iter = max_iter;
+   for (i = 0; true; i++)
+   {
+      // The reduction for (r, u) and (w, u) is overlapped with m = B w and
+      // n = A m
+      dots[0] = r*u;
+      dots[1] = w*u;
+      StartDots(dots, 2);
+      if (prec)
+      {
+         prec->Mult(w, m);
+      }
+      else
+      {
+         m = w;
+      }
+      oper->Mult(m, n);
+      FinishDots();
+      gamma = dots[0];
+      const double delta = dots[1];
+      MFEM_ASSERT(IsFinite(gamma), "gamma = " << gamma);
+      MFEM_ASSERT(IsFinite(delta), "delta = " << delta);
+
+      if (i == 0)
+      {
+         nom0 = gamma;
+         r0 = std::max(gamma*rel_tol*rel_tol, abs_tol*abs_tol);
+      }
+      if (print_level == 1 || (print_level == 3 && i == 0))
+      {
+         mfem::out << "   Iteration : " << setw(3) << i << "  (B r, r) = "
+                   << gamma << (print_level == 3 ? " ...\n" : "\n");
+      }
+      if (gamma <= r0)
+      {
+         converged = 1;
+         final_iter = i;
+         break;
+      }
+      if (i == max_iter)
+      {
+         break;
+      }
+
+      const double beta = (i == 0) ? 0.0 : gamma/gamma_old;
+      const double den = (i == 0) ? delta : delta - beta*gamma/alpha;
+      if (den <= 0.0)
+      {
+         if (print_level >= 0)
+         {
+            mfem::out << "Pipelined PCG: The operator is not positive "
+                      << "definite. den = " << den << '\n';
+         }
+         final_iter = i;
+         break;
+      }
+      alpha = gamma/den;
+#ifdef MFEM_USE_OPENMP
+      #pragma omp parallel for
+#endif
+      for (int j = 0; j < width; j++)
+      {
+         Z[j] = N[j] + beta*Z[j];
+         Q[j] = M[j] + beta*Q[j];
+         S[j] = W[j] + beta*S[j];
+         P[j] = U[j] + beta*P[j];
+         X[j] += alpha*P[j];
+         R[j] -= alpha*S[j];
+         U[j] -= alpha*Q[j];
+         W[j] -= alpha*Z[j];
+      }
+      gamma_old = gamma;
+   }
+
+   if (print_level == 2)
+   {
+      mfem::out << "Number of pipelined PCG iterations: " << final_iter
+                << '\n';
+   }
+   else if (print_level == 3)
+   {
+      mfem::out << "   Iteration : " << setw(3) << final_iter
+                << "  (B r, r) = " << gamma << '\n';
+   }
+   if (print_level >= 0 && !converged)
+   {
+      mfem::out << "Pipelined PCG: No convergence!" << '\n';
+   }
+   if (print_level >= 1 || (print_level >= 0 && !converged))
+   {
+      mfem::out << "Average reduction factor = "
+                << pow(gamma/nom0, 0.5/std::max(final_iter, 1)) << '\n';
+   }
+   final_norm = sqrt(gamma);
+}
+
+
 inline void GeneratePlaneRotation(double &dx, double &dy,
                                   double &cs, double &sn)
 {
@@ -699,6 +982,194 @@ finish:
    }
 }
 
+// r = B (b - A x), where B = I without preconditioner, using w as temporary
+static void PreconditionedResidual(const Operator &A, const Solver *B,
+                                   const Vector &b, const Vector &x,
+                                   Vector &r, Vector &w)
+{
+   A.Mult(x, w);
+   subtract(b, w, w);
+   if (B)
+   {
+      B->Mult(w, r);
+   }
+   else
+   {
+      r = w;
+   }
+}
+
+void PipelinedGMRESSolver::Mult(const Vector &b, Vector &x) const
+{
+   // Restarted GMRES, as in GMRESSolver, where the Arnoldi process uses CGS2
+   // and keeps z_k = B A v_k for the basis vectors v_k. Since
+   //    v_{i+1} = (z_i - sum_k H(k,i) v_k) / H(i+1,i),
+   // the next product is z_{i+1} = (B A z_i - sum_k H(k,i) z_k) / H(i+1,i),
+   // and B A z_i is computed while the Gram-Schmidt reductions are in flight.
+   const int n = width;
+
+   DenseMatrix H(m+1, m);
+   Vector s(m+1), cs(m+1), sn(m+1), h(m+1), h2(m+2);
+   Vector r(n), w(n), t(n);
+   Array<Vector *> v(m+1), z(m+1);
+   for (int k = 0; k <= m; k++)
+   {
+      v[k] = new Vector(n);
+      z[k] = new Vector(n);
+   }
+
+   if (!iterative_mode)
+   {
+      x = 0.0;
+   }
+   PreconditionedResidual(*oper, prec, b, x, r, w);
+   double beta = Norm(r);  // beta = ||r||
+   MFEM_ASSERT(IsFinite(beta), "beta = " << beta);
+
+   const double tol_goal = std::max(rel_tol*beta, abs_tol);
+   if (print_level == 1 || print_level == 3)
+   {
+      mfem::out << "   Pass : " << setw(2) << 1
+                << "   Iteration : " << setw(3) << 0
+                << "  ||B r|| = " << beta << (print_level == 3 ? " ...\n" : "\n");
+   }
+
+   int i, j = 0;
+   converged = (beta <= tol_goal);
+   while (!converged && j < max_iter)
+   {
+      v[0]->Set(1.0/beta, r);
+      oper->Mult(*v[0], w);
+      if (prec)
+      {
+         prec->Mult(w, *z[0]);
+      }
+      else
+      {
+         *z[0] = w;
+      }
+      s = 0.0; s(0) = beta;
+
+      for (i = 0; i < m && j < max_iter; )
+      {
+         const bool lookahead = (i+1 < m && j+1 < max_iter);
+
+         // First Gram-Schmidt pass, overlapped with t = B A z_i
+         for (int k = 0; k <= i; k++)
+         {
+            h(k) = (*z[i]) * (*v[k]);
+         }
+         StartDots(h.GetData(), i+1);
+         if (lookahead)
+         {
+            oper->Mult(*z[i], w);
+            if (prec)
+            {
+               prec->Mult(w, t);
+            }
+            else
+            {
+               t = w;
+            }
+         }
+         FinishDots();
+         w = *z[i];
+         for (int k = 0; k <= i; k++)
+         {
+            w.Add(-h(k), *v[k]);
+         }
+
+         // Second pass and ||w||, overlapped with the update of t
+         for (int k = 0; k <= i; k++)
+         {
+            h2(k) = w * (*v[k]);
+         }
+         h2(i+1) = w * w;
+         StartDots(h2.GetData(), i+2);
+         if (lookahead)
+         {
+            for (int k = 0; k <= i; k++)
+            {
+               t.Add(-h(k), *z[k]);
+            }
+         }
+         FinishDots();
+         double norm2 = h2(i+1);
+         for (int k = 0; k <= i; k++)
+         {
+            w.Add(-h2(k), *v[k]);
+            if (lookahead) { t.Add(-h2(k), *z[k]); }
+            H(k,i) = h(k) + h2(k);
+            norm2 -= h2(k)*h2(k);
+         }
+         H(i+1,i) = sqrt(std::max(norm2, 0.0)); // ||w|| after the second pass
+         MFEM_ASSERT(IsFinite(H(i+1,i)), "Norm(w) = " << H(i+1,i));
+         const double norm = H(i+1,i);
+
+         for (int k = 0; k < i; k++)
+         {
+            ApplyPlaneRotation(H(k,i), H(k+1,i), cs(k), sn(k));
+         }
+         GeneratePlaneRotation(H(i,i), H(i+1,i), cs(i), sn(i));
+         ApplyPlaneRotation(H(i,i), H(i+1,i), cs(i), sn(i));
+         ApplyPlaneRotation(s(i), s(i+1), cs(i), sn(i));
+
+         const double resid = fabs(s(i+1));
+         MFEM_ASSERT(IsFinite(resid), "resid = " << resid);
+         i++, j++;
+         if (print_level == 1)
+         {
+            mfem::out << "   Pass : " << setw(2) << (j-1)/m+1
+                      << "   Iteration : " << setw(3) << j
+                      << "  ||B r|| = " << resid << '\n';
+         }
+         if (resid <= tol_goal || norm == 0.0)
+         {
+            break;
+         }
+         v[i]->Set(1.0/norm, w);
+         if (lookahead)
+         {
+            z[i]->Set(1.0/norm, t);
+         }
+      }
+
+      // Update x and confirm the convergence with the true residual
+      Update(x, i-1, H, s, v);
+      PreconditionedResidual(*oper, prec, b, x, r, w);
+      beta = Norm(r);
+      MFEM_ASSERT(IsFinite(beta), "beta = " << beta);
+      converged = (beta <= tol_goal);
+      if (print_level == 1 && !converged && j < max_iter)
+      {
+         mfem::out << "Restarting..." << '\n';
+      }
+   }
+   final_norm = beta;
+   final_iter = j;
+
+   if (print_level == 1 || print_level == 3)
+   {
+      mfem::out << "   Pass : " << setw(2) << (final_iter-1)/m+1
+                << "   Iteration : " << setw(3) << final_iter
+                << "  ||B r|| = " << final_norm << '\n';
+   }
+   else if (print_level == 2)
+   {
+      mfem::out << "Pipelined GMRES: Number of iterations: " << final_iter
+                << '\n';
+   }
+   if (print_level >= 0 && !converged)
+   {
+      mfem::out << "Pipelined GMRES: No convergence!\n";
+   }
+   for (int k = 0; k <= m; k++)
+   {
+      delete v[k];
+      delete z[k];
+   }
+}
+
 void FGMRESSolver::Mult(const Vector &b, Vector &x) const
 {
    DenseMatrix H(m+1,m);
@@ -889,7 +1360,7 @@ void BiCGSTABSolver::Mult(const Vector &b, Vector &x) const
 
    int i;
    double resid, tol_goal;
-   double rho_1, rho_2=1.0, alpha=1.0, beta, omega=1.0;
+   double rho_1, rho_2=1.0, alpha=1.0, beta, omega=1.0, dots[2];
 
    if (iterative_mode)
    {
@@ -939,8 +1410,7 @@ void BiCGSTABSolver::Mult(const Vector &b, Vector &x) const
       else
       {
          beta = (rho_1/rho_2) * (alpha/omega);
-         add(p, -omega, v, p);  //  p = p - omega * v
-         add(r, beta, p, p);    //  p = r + beta * p
+         add(1.0, r, -beta*omega, v, beta, p); //  p = r + beta (p - omega v)
       }
       if (prec)
       {
@@ -952,8 +1422,10 @@ void BiCGSTABSolver::Mult(const Vector &b, Vector &x) const
       }
       oper->Mult(phat, v);     //  v = A * phat
       alpha = rho_1 / Dot(rtilde, v);
-      add(r, -alpha, v, s); //  s = r - alpha * v
-      resid = Norm(s);
+      resid = AddAndDot(r, -alpha, v, s, s); //  s = r - alpha v, (s, s)
+      StartDots(&resid, 1);
+      FinishDots();
+      resid = sqrt(resid);
       MFEM_ASSERT(IsFinite(resid), "resid = " << resid);
       if (resid < tol_goal)
       {
@@ -978,13 +1450,17 @@ void BiCGSTABSolver::Mult(const Vector &b, Vector &x) const
          shat = s;
       }
       oper->Mult(shat, t);     //  t = A * shat
-      omega = Dot(t, s) / Dot(t, t);
-      x.Add(alpha, phat);   //  x += alpha * phat
-      x.Add(omega, shat);   //  x += omega * shat
-      add(s, -omega, t, r); //  r = s - omega * t
+      t.Dots(s, t, dots[0], dots[1]);
+      StartDots(dots, 2);
+      FinishDots();
+      omega = dots[0] / dots[1];
+      add(alpha, phat, omega, shat, 1.0, x); //  x += alpha phat + omega shat
+      resid = AddAndDot(s, -omega, t, r, r); //  r = s - omega t, (r, r)
+      StartDots(&resid, 1);
+      FinishDots();
+      resid = sqrt(resid);
 
       rho_2 = rho_1;
-      resid = Norm(r);
       MFEM_ASSERT(IsFinite(resid), "resid = " << resid);
       if (print_level >= 0)
       {
@@ -1034,35 +1510,577 @@ void BiCGSTAB(const Operator &A, Solver &B, const Vector &b, Vector &x,
 }
 
 
-void MINRESSolver::SetOperator(const Operator &op)
+void PipelinedBiCGSTABSolver::UpdateVectors()
 {
-   IterativeSolver::SetOperator(op);
-   v0.SetSize(width);
-   v1.SetSize(width);
-   w0.SetSize(width);
-   w1.SetSize(width);
-   q.SetSize(width);
-   if (prec)
+   Vector *vecs[] = { &r, &rhat, &rtilde, &w, &what, &t, &p, &s, &shat, &z,
+                      &zhat, &v, &q, &qhat, &y
+                    };
+   for (int k = 0; k < 15; k++)
    {
-      u1.SetSize(width);
+      vecs[k]->SetSize(width);
    }
 }
 
-void MINRESSolver::Mult(const Vector &b, Vector &x) const
+void PipelinedBiCGSTABSolver::Mult(const Vector &b, Vector &x) const
 {
-   // Based on the MINRES algorithm on p. 86, Fig. 6.9 in
-   // "Iterative Krylov Methods for Large Linear Systems",
-   // by Henk A. van der Vorst, 2003.
-   // Extended to support an SPD preconditioner.
-
-   int it;
-   double beta, eta, gamma0, gamma1, sigma0, sigma1;
-   double alpha, delta, rho1, rho2, rho3, norm_goal;
-   Vector *z = (prec) ? &u1 : &v1;
-
-   converged = 1;
+   // Preconditioned pipelined BiCGSTAB following Cools and Vanroose. With M
+   // the preconditioner, the vectors satisfy rhat = M r, w = A rhat,
+   // what = M w, t = A what, and for the search direction p: s = A p,
+   // shat = M s, z = A shat, zhat = M z, v = A zhat. The solution is updated
+   // with p and qhat = M q.
+   int i;
+   double dots[5], resid, tol_goal, rho, alpha, beta = 0.0, omega = 0.0;
 
-   if (!iterative_mode)
+   if (iterative_mode)
+   {
+      oper->Mult(x, r);
+      subtract(b, r, r); // r = b - A x
+   }
+   else
+   {
+      x = 0.0;
+      r = b;
+   }
+   rtilde = r;
+   if (prec)
+   {
+      prec->Mult(r, rhat);
+   }
+   else
+   {
+      rhat = r;
+   }
+   oper->Mult(rhat, w);
+   if (prec)
+   {
+      prec->Mult(w, what);
+   }
+   else
+   {
+      what = w;
+   }
+   dots[0] = r*r;
+   dots[1] = rtilde*w;
+   StartDots(dots, 2);
+   oper->Mult(what, t);
+   FinishDots();
+   resid = sqrt(dots[0]);
+   rho = dots[0];
+   alpha = rho/dots[1];
+   MFEM_ASSERT(IsFinite(resid), "resid = " << resid);
+   if (print_level >= 0)
+   {
+      mfem::out << "   Iteration : " << setw(3) << 0
+                << "   ||r|| = " << resid << '\n';
+   }
+
+   tol_goal = std::max(resid*rel_tol, abs_tol);
+   if (resid <= tol_goal)
+   {
+      final_norm = resid;
+      final_iter = 0;
+      converged = 1;
+      return;
+   }
+   p = 0.0;
+   s = 0.0;
+   shat = 0.0;
+   z = 0.0;
+   zhat = 0.0;
+   v = 0.0;
+
+   double *X = x.GetData(), *R = r.GetData(), *RH = rhat.GetData();
+   double *P = p.GetData(), *S = s.GetData(), *SH = shat.GetData();
+   double *Z = z.GetData(), *Q = q.GetData(), *QH = qhat.GetData();
+   double *Y = y.GetData(), *W = w.GetData();
+   const double *WH = what.GetData(), *T = t.GetData(), *ZH = zhat.GetData();
+   const double *V = v.GetData();
+
+   converged = 0;
+   for (i = 1; i <= max_iter; i++)
+   {
+#ifdef MFEM_USE_OPENMP
+      #pragma omp parallel for
+#endif
+      for (int j = 0; j < width; j++)
+      {
+         P[j] = RH[j] + beta*(P[j] - omega*SH[j]);
+         S[j] = W[j] + beta*(S[j] - omega*Z[j]);
+         SH[j] = WH[j] + beta*(SH[j] - omega*ZH[j]);
+         Z[j] = T[j] + beta*(Z[j] - omega*V[j]);
+         Q[j] = R[j] - alpha*S[j];
+         QH[j] = RH[j] - alpha*SH[j];
+         Y[j] = W[j] - alpha*Z[j];
+      }
+
+      // The reduction for omega is overlapped with zhat = M z and v = A zhat
+      dots[0] = q*y;
+      dots[1] = y*y;
+      StartDots(dots, 2);
+      if (prec)
+      {
+         prec->Mult(z, zhat);
+      }
+      else
+      {
+         zhat = z;
+      }
+      oper->Mult(zhat, v);
+      FinishDots();
+      omega = (dots[1] > 0.0) ? dots[0]/dots[1] : 0.0;
+
+#ifdef MFEM_USE_OPENMP
+      #pragma omp parallel for
+#endif
+      for (int j = 0; j < width; j++)
+      {
+         X[j] += alpha*P[j] + omega*QH[j];
+         R[j] = Q[j] - omega*Y[j];
+         RH[j] = QH[j] - omega*(WH[j] - alpha*ZH[j]);
+         W[j] = Y[j] - omega*(T[j] - alpha*V[j]);
+      }
+
+      // The reduction for ||r||, beta and alpha is overlapped with what = M w
+      // and t = A what
+      dots[0] = r*r;
+      dots[1] = rtilde*r;
+      dots[2] = rtilde*w;
+      dots[3] = rtilde*s;
+      dots[4] = rtilde*z;
+      StartDots(dots, 5);
+      if (prec)
+      {
+         prec->Mult(w, what);
+      }
+      else
+      {
+         what = w;
+      }
+      oper->Mult(what, t);
+      FinishDots();
+
+      resid = sqrt(dots[0]);
+      MFEM_ASSERT(IsFinite(resid), "resid = " << resid);
+      if (print_level >= 0)
+      {
+         mfem::out << "   Iteration : " << setw(3) << i
+                   << "   ||r|| = " << resid << '\n';
+      }
+      if (resid < tol_goal)
+      {
+         converged = 1;
+         break;
+      }
+      if (omega == 0.0 || dots[1] == 0.0)
+      {
+         break;
+      }
+      beta = (alpha/omega)*(dots[1]/rho);
+      rho = dots[1];
+      alpha = rho/(dots[2] + beta*dots[3] - beta*omega*dots[4]);
+   }
+
+   final_norm = resid;
+   final_iter = std::min(i, max_iter);
+}
+
+
+// Local inner products d(j) = X(:,j)^t Y(:,j) of the columns of X and Y
+static void ColumnDots(const DenseMatrix &X, const DenseMatrix &Y, Vector &d)
+{
+   const int n = X.Height(), k = X.Width();
+   d.SetSize(k);
+   for (int j = 0; j < k; j++)
+   {
+      const double *x = X.GetColumn(j), *y = Y.GetColumn(j);
+      double dot = 0.0;
+      for (int i = 0; i < n; i++)
+      {
+         dot += x[i]*y[i];
+      }
+      d(j) = dot;
+   }
+}
+
+// R = M (B - A X) for the columns of X and B, using W as temporary
+static void PreconditionedResidual(const Operator &A, const Solver *M,
+                                   const DenseMatrix &B, const DenseMatrix &X,
+                                   DenseMatrix &R, DenseMatrix &W)
+{
+   A.MultMulti(X, W);
+   W.Neg();
+   W += B;
+   if (M)
+   {
+      M->MultMulti(W, R);
+   }
+   else
+   {
+      R = W;
+   }
+}
+
+void BlockCGSolver::Mult(const Vector &b, Vector &x) const
+{
+   const DenseMatrix B(const_cast<double*>(b.GetData()), b.Size(), 1);
+   DenseMatrix X(x.GetData(), x.Size(), 1);
+   MultMulti(B, X);
+}
+
+void BlockCGSolver::MultMulti(const DenseMatrix &B, DenseMatrix &X) const
+{
+   // Breakdown-free block CG following Ji and Li, with the block of search
+   // directions P, Q = A P, orthonormalized with Orthonormalize():
+   //    alpha = (P^t Q)^{-1} P^t R,   X += P alpha,   R -= Q alpha,
+   //    Z = M R,   P = orth(Z - P (P^t Q)^{-1} Q^t Z).
+   const int n = width, k = B.Width();
+   DenseMatrix R(n, k), Z, P, Q, PQ, PR, QZ, alpha, Rp;
+   Vector nom, r0(k);
+
+   if (iterative_mode)
+   {
+      MFEM_VERIFY(X.Height() == n && X.Width() == k,
+                  "incompatible dimensions of X and B");
+      oper->MultMulti(X, R);
+      R.Neg();
+      R += B;
+   }
+   else
+   {
+      X.SetSize(n, k);
+      X = 0.0;
+      R = B;
+   }
+   if (prec)
+   {
+      prec->MultMulti(R, Z);
+   }
+   else
+   {
+      Z = R;
+   }
+   ColumnDots(Z, R, nom);
+   StartDots(nom.GetData(), k);
+   FinishDots();
+   for (int j = 0; j < k; j++)
+   {
+      MFEM_ASSERT(IsFinite(nom(j)), "nom = " << nom(j));
+      r0(j) = std::max(nom(j)*rel_tol*rel_tol, abs_tol*abs_tol);
+   }
+   if (print_level == 1 || print_level == 3)
+   {
+      mfem::out << "   Iteration : " << setw(3) << 0 << "  max (B r, r) = "
+                << nom.Max() << (print_level == 3 ? " ...\n" : "\n");
+   }
+
+   int i, rank = 0;
+   converged = 1;
+   for (int j = 0; j < k; j++)
+   {
+      if (nom(j) > r0(j)) { converged = 0; }
+   }
+   if (!converged)
+   {
+      P = Z;
+      rank = Orthonormalize(P, Rp);
+   }
+   for (i = 1; !converged && rank > 0 && i <= max_iter; i++)
+   {
+      oper->MultMulti(P, Q);
+      Dot(P, Q, PQ);
+      Dot(P, R, PR);
+      DenseMatrixInverse PQinv(PQ);
+      PQinv.Mult(PR, alpha);
+      AddMult(P, alpha, X);
+      alpha.Neg();
+      AddMult(Q, alpha, R);
+      if (prec)
+      {
+         prec->MultMulti(R, Z);
+      }
+      else
+      {
+         Z = R;
+      }
+
+      ColumnDots(Z, R, nom);
+      StartDots(nom.GetData(), k);
+      FinishDots();
+      if (print_level == 1)
+      {
+         mfem::out << "   Iteration : " << setw(3) << i << "  max (B r, r) = "
+                   << nom.Max() << '\n';
+      }
+      converged = 1;
+      for (int j = 0; j < k; j++)
+      {
+         MFEM_ASSERT(IsFinite(nom(j)), "nom = " << nom(j));
+         if (nom(j) > r0(j)) { converged = 0; }
+      }
+      if (converged) { break; }
+
+      Dot(Q, Z, QZ);
+      PQinv.Mult(QZ, alpha);
+      alpha.Neg();
+      AddMult(P, alpha, Z);
+      P = Z;
+      rank = Orthonormalize(P, Rp);
+   }
+   final_iter = std::min(i, max_iter);
+   final_norm = sqrt(nom.Max());
+
+   if (print_level == 1 || print_level == 3)
+   {
+      mfem::out << "   Iteration : " << setw(3) << final_iter
+                << "  max (B r, r) = " << nom.Max() << '\n';
+   }
+   else if (print_level == 2)
+   {
+      mfem::out << "Block CG: Number of iterations: " << final_iter << '\n';
+   }
+   if (print_level >= 0 && !converged)
+   {
+      mfem::out << "Block CG: No convergence!\n";
+   }
+}
+
+void BlockGMRESSolver::Mult(const Vector &b, Vector &x) const
+{
+   const DenseMatrix B(const_cast<double*>(b.GetData()), b.Size(), 1);
+   DenseMatrix X(x.GetData(), x.Size(), 1);
+   MultMulti(B, X);
+}
+
+void BlockGMRESSolver::MultMulti(const DenseMatrix &B, DenseMatrix &X) const
+{
+   // Left preconditioned block GMRES. The basis vectors are stored in the
+   // columns of V, where the block i occupies the columns off[i] to
+   // off[i+1]-1. The band Hessenberg matrix H is reduced to upper triangular
+   // form with Givens rotations, which are also applied to the right-hand
+   // sides G of the least squares problems.
+   const int n = width, k = B.Width();
+   DenseMatrix V(n, (m+1)*k), H((m+1)*k, m*k), G((m+1)*k, k);
+   DenseMatrix R(n, k), T, W, S, C, Y, Vi;
+   Array<int> off(m+2), rot;
+   Array<double> rot_cs, rot_sn;
+   Vector resid, tol(k);
+
+   if (iterative_mode)
+   {
+      MFEM_VERIFY(X.Height() == n && X.Width() == k,
+                  "incompatible dimensions of X and B");
+   }
+   else
+   {
+      X.SetSize(n, k);
+      X = 0.0;
+   }
+   PreconditionedResidual(*oper, prec, B, X, R, T);
+   ColumnDots(R, R, resid);
+   StartDots(resid.GetData(), k);
+   FinishDots();
+   for (int l = 0; l < k; l++)
+   {
+      resid(l) = sqrt(resid(l));
+      MFEM_ASSERT(IsFinite(resid(l)), "resid = " << resid(l));
+      tol(l) = std::max(rel_tol*resid(l), abs_tol);
+   }
+   if (print_level == 1 || print_level == 3)
+   {
+      mfem::out << "   Pass : " << setw(2) << 1
+                << "   Iteration : " << setw(3) << 0
+                << "  max ||B r|| = " << resid.Max()
+                << (print_level == 3 ? " ...\n" : "\n");
+   }
+
+   int i, j = 0;
+   converged = 1;
+   for (int l = 0; l < k; l++)
+   {
+      if (resid(l) > tol(l)) { converged = 0; }
+   }
+   while (!converged && j < max_iter)
+   {
+      W = R;
+      const int r = Orthonormalize(W, S);
+      if (r == 0) { break; }
+      H = 0.0;
+      G = 0.0;
+      G.CopyMN(S, 0, 0);
+      V.CopyMN(W, 0, 0);
+      rot.SetSize(0);
+      rot_cs.SetSize(0);
+      rot_sn.SetSize(0);
+      off[0] = 0;
+      off[1] = r;
+
+      for (i = 0; i < m && j < max_iter; )
+      {
+         const int b0 = off[i], b1 = off[i+1];
+
+         Vi.UseExternalData(V.GetColumn(b0), n, b1-b0);
+         oper->MultMulti(Vi, T);
+         if (prec)
+         {
+            prec->MultMulti(T, W);
+         }
+         else
+         {
+            W = T;
+         }
+
+         // Block classical Gram-Schmidt with reorthogonalization
+         Vi.UseExternalData(V.Data(), n, b1);
+         for (int pass = 0; pass < 2; pass++)
+         {
+            Dot(Vi, W, C);
+            H.AddMatrix(C, 0, b0);
+            C.Neg();
+            AddMult(Vi, C, W);
+         }
+         const int s = Orthonormalize(W, S);
+         if (s > 0)
+         {
+            V.CopyMN(W, 0, b1);
+            H.CopyMN(S, b1, b0);
+         }
+         off[i+2] = b1 + s;
+
+         // Zero the entries below the diagonal in the new columns of H
+         for (int c = b0; c < b1; c++)
+         {
+            for (int l = 0; l < rot.Size(); l++)
+            {
+               const int q = rot[l];
+               ApplyPlaneRotation(H(q,c), H(q+1,c), rot_cs[l], rot_sn[l]);
+            }
+            for (int q = b1 + s - 1; q > c; q--)
+            {
+               if (H(q,c) == 0.0) { continue; }
+               double cs, sn;
+               GeneratePlaneRotation(H(q-1,c), H(q,c), cs, sn);
+               ApplyPlaneRotation(H(q-1,c), H(q,c), cs, sn);
+               for (int l = 0; l < k; l++)
+               {
+                  ApplyPlaneRotation(G(q-1,l), G(q,l), cs, sn);
+               }
+               rot.Append(q-1);
+               rot_cs.Append(cs);
+               rot_sn.Append(sn);
+            }
+         }
+
+         // The residual norms of the least squares problems
+         int done = 1;
+         for (int l = 0; l < k; l++)
+         {
+            double nrm2 = 0.0;
+            for (int q = b1; q < b1 + s; q++)
+            {
+               nrm2 += G(q,l)*G(q,l);
+            }
+            resid(l) = sqrt(nrm2);
+            MFEM_ASSERT(IsFinite(resid(l)), "resid = " << resid(l));
+            if (resid(l) > tol(l)) { done = 0; }
+         }
+         i++, j++;
+         if (print_level == 1)
+         {
+            mfem::out << "   Pass : " << setw(2) << (j-1)/m+1
+                      << "   Iteration : " << setw(3) << j
+                      << "  max ||B r|| = " << resid.Max() << '\n';
+         }
+         if (done || s == 0)
+         {
+            break;
+         }
+      }
+
+      // Update X += V Y, where H Y = G (H upper triangular), and confirm the
+      // convergence with the true residual
+      const int dim = off[i];
+      Y.SetSize(dim, k);
+      for (int l = 0; l < k; l++)
+      {
+         for (int q = dim-1; q >= 0; q--)
+         {
+            double y = G(q,l);
+            for (int p = q+1; p < dim; p++)
+            {
+               y -= H(q,p)*Y(p,l);
+            }
+            Y(q,l) = y/H(q,q);
+         }
+      }
+      Vi.UseExternalData(V.Data(), n, dim);
+      AddMult(Vi, Y, X);
+
+      PreconditionedResidual(*oper, prec, B, X, R, T);
+      ColumnDots(R, R, resid);
+      StartDots(resid.GetData(), k);
+      FinishDots();
+      converged = 1;
+      for (int l = 0; l < k; l++)
+      {
+         resid(l) = sqrt(resid(l));
+         MFEM_ASSERT(IsFinite(resid(l)), "resid = " << resid(l));
+         if (resid(l) > tol(l)) { converged = 0; }
+      }
+      if (print_level == 1 && !converged && j < max_iter)
+      {
+         mfem::out << "Restarting..." << '\n';
+      }
+   }
+   final_norm = resid.Max();
+   final_iter = j;
+
+   if (print_level == 1 || print_level == 3)
+   {
+      mfem::out << "   Pass : " << setw(2) << (final_iter-1)/m+1
+                << "   Iteration : " << setw(3) << final_iter
+                << "  max ||B r|| = " << final_norm << '\n';
+   }
+   else if (print_level == 2)
+   {
+      mfem::out << "Block GMRES: Number of iterations: " << final_iter
+                << '\n';
+   }
+   if (print_level >= 0 && !converged)
+   {
+      mfem::out << "Block GMRES: No convergence!\n";
+   }
+}
+
+
+void MINRESSolver::SetOperator(const Operator &op)
+{
+   IterativeSolver::SetOperator(op);
+   v0.SetSize(width);
+   v1.SetSize(width);
+   w0.SetSize(width);
+   w1.SetSize(width);
+   q.SetSize(width);
+   if (prec)
+   {
+      u1.SetSize(width);
+   }
+}
+
+void MINRESSolver::Mult(const Vector &b, Vector &x) const
+{
+   // Based on the MINRES algorithm on p. 86, Fig. 6.9 in
+   // "Iterative Krylov Methods for Large Linear Systems",
+   // by Henk A. van der Vorst, 2003.
+   // Extended to support an SPD preconditioner.
+
+   int it;
+   double beta, eta, gamma0, gamma1, sigma0, sigma1;
+   double alpha, delta, rho1, rho2, rho3, norm_goal;
+   Vector *z = (prec) ? &u1 : &v1;
+
+   converged = 1;
+
+   if (!iterative_mode)
    {
       v1 = b;
       x = 0.;
@@ -1106,11 +2124,8 @@ void MINRESSolver::Mult(const Vector &b, Vector &x) const
       oper->Mult(*z, q);
       alpha = Dot(*z, q);
       MFEM_ASSERT(IsFinite(alpha), "alpha = " << alpha);
-      if (it > 1) // (v0 == 0) for (it == 1)
-      {
-         q.Add(-beta, v0);
-      }
-      add(q, -alpha, v1, v0);
+      // v0 = q - alpha v1 - beta v0, where (v0 == 0) for (it == 1)
+      add(1.0, q, -alpha, v1, (it > 1) ? -beta : 0.0, v0);
 
       delta = gamma1*alpha - gamma0*sigma1*beta;
       rho3 = sigma0*beta;
@@ -1137,8 +2152,7 @@ void MINRESSolver::Mult(const Vector &b, Vector &x) const
       }
       else
       {
-         add(-rho3/rho1, w0, -rho2/rho1, w1, w0);
-         w0.Add(1./rho1, *z);
+         add(1./rho1, *z, -rho2/rho1, w1, -rho3/rho1, w0);
       }
 
       gamma0 = gamma1;
@@ -1673,6 +2687,217 @@ slbqp_done:
    }
 }
 
+OperatorChebyshevSmoother::OperatorChebyshevSmoother(const Operator &op,
+                                                     const Vector &diag,
+                                                     int order_,
+                                                     int power_iterations,
+                                                     EigenEstimator estimator)
+   : Solver(op.Height(), op.Width()), oper(&op), dinv(diag.Size()),
+     order(order_)
+{
+#ifdef MFEM_USE_MPI
+   use_comm = false;
+#endif
+   Setup(diag, power_iterations, estimator);
+}
+
+#ifdef MFEM_USE_MPI
+OperatorChebyshevSmoother::OperatorChebyshevSmoother(MPI_Comm comm_,
+                                                     const Operator &op,
+                                                     const Vector &diag,
+                                                     int order_,
+                                                     int power_iterations,
+                                                     EigenEstimator estimator)
+   : Solver(op.Height(), op.Width()), oper(&op), dinv(diag.Size()),
+     order(order_)
+{
+   use_comm = true;
+   comm = comm_;
+   Setup(diag, power_iterations, estimator);
+}
+#endif
+
+double OperatorChebyshevSmoother::Dot(const Vector &x, const Vector &y) const
+{
+   double dot = x * y;
+#ifdef MFEM_USE_MPI
+   if (use_comm)
+   {
+      double local_dot = dot;
+      MPI_Allreduce(&local_dot, &dot, 1, MPI_DOUBLE, MPI_SUM, comm);
+   }
+#endif
+   return dot;
+}
+
+void OperatorChebyshevSmoother::Setup(const Vector &diag, int iterations,
+                                      EigenEstimator estimator)
+{
+   MFEM_VERIFY(oper->Height() == oper->Width() && diag.Size() == height,
+               "invalid operator or diagonal sizes");
+   MFEM_VERIFY(order >= 1, "invalid order: " << order);
+
+   for (int i = 0; i < height; i++)
+   {
+      MFEM_VERIFY(diag(i) != 0.0, "zero diagonal entry: " << i);
+      dinv(i) = 1.0/diag(i);
+   }
+
+   r.SetSize(height);
+   d.SetSize(height);
+   z.SetSize(height);
+
+   max_eig_estimate = (estimator == LANCZOS) ?
+                      LanczosEstimate(diag, iterations) :
+                      PowerEstimate(iterations);
+   MFEM_VERIFY(max_eig_estimate > 0.0, "invalid eigenvalue estimate: "
+               << max_eig_estimate);
+}
+
+double OperatorChebyshevSmoother::PowerEstimate(int iterations)
+{
+   // Power iterations with D^{-1} A
+   Vector &v = r, &w = z;
+   v.Randomize(1);
+   double norm = sqrt(Dot(v, v));
+   double estimate = 0.0;
+   for (int it = 0; it < iterations && norm > 0.0; it++)
+   {
+      v /= norm;
+      oper->Mult(v, w);
+      for (int i = 0; i < height; i++) { w(i) *= dinv(i); }
+      estimate = Dot(v, w);
+      norm = sqrt(Dot(w, w));
+      v = w;
+   }
+   return estimate;
+}
+
+// Return the largest eigenvalue of the symmetric tridiagonal matrix with
+// diagonal @a alpha and off-diagonal @a beta, computed by bisection with
+// Sturm sequence counts.
+static double TridiagonalMaxEigenvalue(const Array<double> &alpha,
+                                       const Array<double> &beta)
+{
+   const int n = alpha.Size();
+   // Gershgorin bounds of the spectrum
+   double lower = alpha[0], upper = alpha[0];
+   for (int i = 0; i < n; i++)
+   {
+      const double radius = ((i > 0) ? fabs(beta[i-1]) : 0.0) +
+                            ((i < n-1) ? fabs(beta[i]) : 0.0);
+      lower = std::min(lower, alpha[i] - radius);
+      upper = std::max(upper, alpha[i] + radius);
+   }
+   const double tol = 1e-12*std::max(fabs(lower), fabs(upper));
+   while (upper - lower > tol)
+   {
+      // Count the eigenvalues smaller than x
+      const double x = 0.5*(lower + upper);
+      int count = 0;
+      double q = 1.0;
+      for (int i = 0; i < n; i++)
+      {
+         const double b2 = (i > 0) ? beta[i-1]*beta[i-1] : 0.0;
+         q = alpha[i] - x - ((i > 0) ? b2/q : 0.0);
+         if (q == 0.0) { q = -tol; }
+         if (q < 0.0) { count++; }
+      }
+      if (count == n) { upper = x; }
+      else { lower = x; }
+   }
+   return upper;
+}
+
+double OperatorChebyshevSmoother::LanczosEstimate(const Vector &diag,
+                                                  int iterations)
+{
+   // Lanczos iterations with D^{-1} A, which is self-adjoint in the inner
+   // product (x, y)_D = x^t D y. The vectors Dv = D v are kept to compute the
+   // D inner products with global dot products only.
+   Vector &v = r, &w = z, &v_old = d, Dv(height);
+   Array<double> alpha, beta;
+   v.Randomize(1);
+   for (int i = 0; i < height; i++)
+   {
+      MFEM_VERIFY(diag(i) > 0.0, "the Lanczos estimate requires a positive "
+                  "diagonal, entry " << i << ": " << diag(i));
+      Dv(i) = diag(i)*v(i);
+   }
+   double norm = sqrt(Dot(v, Dv));
+   v_old = 0.0;
+   double beta_old = 0.0;
+   for (int it = 0; it < iterations && norm > 0.0; it++)
+   {
+      v /= norm;
+      Dv /= norm;
+      // w = D^{-1} A v - beta v_old, alpha = (w, v)_D = v^t A v
+      oper->Mult(v, w);
+      const double a = Dot(w, v);
+      for (int i = 0; i < height; i++)
+      {
+         w(i) = dinv(i)*w(i) - beta_old*v_old(i) - a*v(i);
+      }
+      alpha.Append(a);
+      v_old = v;
+      v = w;
+      for (int i = 0; i < height; i++) { Dv(i) = diag(i)*v(i); }
+      norm = sqrt(Dot(v, Dv));
+      beta_old = norm;
+      beta.Append(norm);
+   }
+   if (alpha.Size() == 0) { return 0.0; }
+   return TridiagonalMaxEigenvalue(alpha, beta);
+}
+
+void OperatorChebyshevSmoother::Mult(const Vector &b, Vector &x) const
+{
+   // Chebyshev iteration, see Y. Saad, "Iterative Methods for Sparse Linear
+   // Systems", Algorithm 12.1
+   const double upper = 1.2*max_eig_estimate, lower = 0.3*upper;
+   const double theta = 0.5*(upper + lower), delta = 0.5*(upper - lower);
+   const double sigma = theta/delta;
+   double rho = 1.0/sigma;
+
+   if (iterative_mode)
+   {
+      oper->Mult(x, r);
+      subtract(b, r, r);
+   }
+   else
+   {
+      r = b;
+      x = 0.0;
+   }
+   const double *Dinv = dinv.GetData();
+   double *R = r.GetData(), *Dk = d.GetData(), *X = x.GetData();
+#ifdef MFEM_USE_OPENMP
+   #pragma omp parallel for
+#endif
+   for (int i = 0; i < height; i++)
+   {
+      Dk[i] = Dinv[i]*R[i]/theta;
+      X[i] += Dk[i];
+   }
+   for (int k = 1; k < order; k++)
+   {
+      oper->Mult(d, z);
+      const double rho_new = 1.0/(2.0*sigma - rho);
+      const double c = 2.0*rho_new/delta, s = rho_new*rho;
+      const double *Z = z.GetData();
+#ifdef MFEM_USE_OPENMP
+      #pragma omp parallel for
+#endif
+      for (int i = 0; i < height; i++)
+      {
+         R[i] -= Z[i];
+         Dk[i] = s*Dk[i] + c*Dinv[i]*R[i];
+         X[i] += Dk[i];
+      }
+      rho = rho_new;
+   }
+}
+
 #ifdef MFEM_USE_SUITESPARSE
 
 void UMFPackSolver::Init()
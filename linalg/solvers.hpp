@@ -35,6 +35,7 @@ class IterativeSolver : public Solver
 private:
    int dot_prod_type; // 0 - local, 1 - global over 'comm'
    MPI_Comm comm;
+   mutable MPI_Request dot_request; // see StartDots()
 #endif
 
 protected:
@@ -51,6 +52,27 @@ protected:
    double Dot(const Vector &x, const Vector &y) const;
    double Norm(const Vector &x) const { return sqrt(Dot(x, x)); }
 
+   /** @brief Start the global sum of the @a n local dot products in @a dots,
+       computed e.g. with Vector::operator*(). */
+   /** In parallel, with MPI 3, the reduction is non-blocking (MPI_Iallreduce)
+       and local work, e.g. the action of the operator or the preconditioner,
+       can be overlapped with it. The array @a dots must not be accessed until
+       FinishDots() is called, and only one reduction can be in flight. */
+   void StartDots(double *dots, int n) const;
+   /// Wait for the reduction started by StartDots() to complete.
+   void FinishDots() const;
+
+   /// Compute the matrix of inner products G = X^t Y of the columns of X, Y.
+   void Dot(const DenseMatrix &X, const DenseMatrix &Y, DenseMatrix &G) const;
+   /** @brief Orthonormalize the columns of @a W, W_in = W_out R, and return
+       the numerical rank r. */
+   /** Two passes of Cholesky QR (CholQR2) with diagonal pivoting are used,
+       each with a single global reduction. Columns that are (numerically)
+       linearly dependent on the previous ones are dropped, so that @a W
+       becomes n x r and @a R is r x k, with the columns of @a R in the
+       original order. If r = 0, @a W and @a R are not modified. */
+   int Orthonormalize(DenseMatrix &W, DenseMatrix &R) const;
+
 public:
    IterativeSolver();
 
@@ -139,6 +161,36 @@ void PCG(const Operator &A, Solver &B, const Vector &b, Vector &x,
          double RTOLERANCE = 1e-12, double ATOLERANCE = 1e-24);
 
 
+/** @brief Pipelined conjugate gradient method, see P. Ghysels and
+    W. Vanroose, "Hiding global synchronization latency in the preconditioned
+    Conjugate Gradient algorithm", Parallel Computing 40, 2014. */
+/** The two dot products of an iteration are combined into one global
+    reduction, which is overlapped with the application of the preconditioner
+    and the operator. This hides the latency of the reduction in parallel at
+    the cost of extra vector updates and memory, and of a somewhat lower
+    attainable accuracy than CGSolver. The stopping criterion, (B r, r), is the
+    same as in CGSolver. */
+class PipelinedCGSolver : public IterativeSolver
+{
+protected:
+   mutable Vector r, u, w, m, n, p, s, q, z;
+
+   void UpdateVectors();
+
+public:
+   PipelinedCGSolver() { }
+
+#ifdef MFEM_USE_MPI
+   PipelinedCGSolver(MPI_Comm _comm) : IterativeSolver(_comm) { }
+#endif
+
+   virtual void SetOperator(const Operator &op)
+   { IterativeSolver::SetOperator(op); UpdateVectors(); }
+
+   virtual void Mult(const Vector &b, Vector &x) const;
+};
+
+
 /// GMRES method
 class GMRESSolver : public IterativeSolver
 {
@@ -158,6 +210,35 @@ public:
    virtual void Mult(const Vector &b, Vector &x) const;
 };
 
+/** @brief Pipelined GMRES method with classical Gram-Schmidt
+    orthogonalization and reorthogonalization (CGS2). */
+/** As GMRESSolver, the method is left preconditioned and restarted every
+    SetKDim() iterations. The products z_k = B A v_k of the Krylov basis
+    vectors are computed with a one step lookahead, see P. Ghysels et al.,
+    "Hiding global communication latency in the GMRES algorithm on massively
+    parallel machines", SIAM J. Sci. Comput. 35, 2013, so that the reduction of
+    the first Gram-Schmidt pass is overlapped with the application of the
+    operator and the preconditioner, and the reduction of the second pass,
+    which also gives the norm of the new basis vector, with the update of the
+    lookahead vector. Convergence is confirmed with the true residual. */
+class PipelinedGMRESSolver : public IterativeSolver
+{
+protected:
+   int m; // see SetKDim()
+
+public:
+   PipelinedGMRESSolver() { m = 50; }
+
+#ifdef MFEM_USE_MPI
+   PipelinedGMRESSolver(MPI_Comm _comm) : IterativeSolver(_comm) { m = 50; }
+#endif
+
+   /// Set the number of iteration to perform between restarts, default is 50.
+   void SetKDim(int dim) { m = dim; }
+
+   virtual void Mult(const Vector &b, Vector &x) const;
+};
+
 /// FGMRES method
 class FGMRESSolver : public IterativeSolver
 {
@@ -217,6 +298,92 @@ void BiCGSTAB(const Operator &A, Solver &B, const Vector &b, Vector &x,
               double rtol = 1e-12, double atol = 1e-24);
 
 
+/** @brief Pipelined BiCGSTAB method, see S. Cools and W. Vanroose, "The
+    communication-hiding pipelined BiCGStab method for the parallel solution
+    of large unsymmetric linear systems", Parallel Computing 65, 2017. */
+/** The method is right preconditioned, as BiCGSTABSolver. The dot products of
+    an iteration are combined into two global reductions, each overlapped with
+    one application of the preconditioner and the operator. The stopping
+    criterion is the norm of the residual, ||r||. */
+class PipelinedBiCGSTABSolver : public IterativeSolver
+{
+protected:
+   mutable Vector r, rhat, rtilde, w, what, t, p, s, shat, z, zhat, v, q, qhat,
+           y;
+
+   void UpdateVectors();
+
+public:
+   PipelinedBiCGSTABSolver() { }
+
+#ifdef MFEM_USE_MPI
+   PipelinedBiCGSTABSolver(MPI_Comm _comm) : IterativeSolver(_comm) { }
+#endif
+
+   virtual void SetOperator(const Operator &op)
+   { IterativeSolver::SetOperator(op); UpdateVectors(); }
+
+   virtual void Mult(const Vector &b, Vector &x) const;
+};
+
+
+/** @brief Block conjugate gradient method for multiple right-hand sides,
+    see MultMulti(). */
+/** The breakdown-free variant of Ji and Li is used: the block of search
+    directions is orthonormalized in every iteration, dropping the directions
+    that have become linearly dependent, e.g. when some of the right-hand
+    sides are (nearly) linearly dependent or have already converged. Each
+    column is considered converged when it satisfies the stopping criterion
+    of CGSolver. */
+class BlockCGSolver : public IterativeSolver
+{
+public:
+   BlockCGSolver() { }
+
+#ifdef MFEM_USE_MPI
+   BlockCGSolver(MPI_Comm _comm) : IterativeSolver(_comm) { }
+#endif
+
+   virtual void Mult(const Vector &b, Vector &x) const;
+
+   /** @brief Solve for all columns of @a B at once, using the block products
+       Operator::MultMulti() and Solver::MultMulti() of the operator and the
+       preconditioner. */
+   virtual void MultMulti(const DenseMatrix &B, DenseMatrix &X) const;
+};
+
+
+/** @brief Block GMRES method for multiple right-hand sides, see
+    MultMulti(). */
+/** Restarted, left preconditioned block GMRES. The Arnoldi process uses block
+    classical Gram-Schmidt with reorthogonalization and CholQR2 for the new
+    block of basis vectors (see IterativeSolver::Orthonormalize()), so that
+    linearly dependent directions are deflated and the block size can only
+    decrease within a cycle. Each column is considered converged when it
+    satisfies the stopping criterion of GMRESSolver. */
+class BlockGMRESSolver : public IterativeSolver
+{
+protected:
+   int m; // see SetKDim()
+
+public:
+   BlockGMRESSolver() { m = 10; }
+
+#ifdef MFEM_USE_MPI
+   BlockGMRESSolver(MPI_Comm _comm) : IterativeSolver(_comm) { m = 10; }
+#endif
+
+   /** @brief Set the number of block iterations to perform between restarts,
+       default is 10. */
+   void SetKDim(int dim) { m = dim; }
+
+   virtual void Mult(const Vector &b, Vector &x) const;
+
+   /// Solve for all columns of @a B at once, see BlockCGSolver::MultMulti().
+   virtual void MultMulti(const DenseMatrix &B, DenseMatrix &X) const;
+};
+
+
 /// MINRES method
 class MINRESSolver : public IterativeSolver
 {
@@ -338,6 +505,87 @@ public:
 };
 
 
+/** @brief Chebyshev accelerated Jacobi smoother, which only requires the
+    action of the operator and its diagonal.
+
+    The smoother applies the Chebyshev polynomial of the given @a order for
+    D^{-1} A, with D = diag(A), on the interval [0.3 lmax, 1.2 lmax], where
+    lmax is an estimate of the largest eigenvalue of D^{-1} A computed in the
+    constructor, either with the power method or with the Lanczos method in
+    the D inner product, see EigenEstimator. Rows with essential boundary
+    conditions, e.g. of a ConstrainedOperator, should have unit diagonal.
+
+    Mult() only uses the action of the operator and entry-wise vector updates,
+    so it is as parallel as the operator, unlike the sequential sweeps of
+    GSSmoother, and it can smooth matrix-free operators, e.g. partially
+    assembled forms, see BilinearForm::FormSystemDiagonal().
+
+    The smoother is a symmetric operator when A is symmetric, so it can be
+    used in a symmetric multigrid cycle. With iterative_mode set to true, the
+    input @a x of Mult() is used as the initial guess. */
+class OperatorChebyshevSmoother : public Solver
+{
+public:
+   /// Methods for the estimate of the largest eigenvalue of D^{-1} A.
+   enum EigenEstimator
+   {
+      POWER,  ///< Power iterations.
+      /** Lanczos iterations in the D inner product, which converge faster
+          than the power iterations but require a symmetric operator and a
+          positive diagonal. */
+      LANCZOS
+   };
+
+#ifdef MFEM_USE_MPI
+private:
+   bool use_comm;
+   MPI_Comm comm;
+#endif
+
+protected:
+   const Operator *oper;
+   Vector dinv;
+   int order;
+   double max_eig_estimate;
+   mutable Vector r, d, z;
+
+   double Dot(const Vector &x, const Vector &y) const;
+
+   /// Store the inverse diagonal and estimate the largest eigenvalue.
+   void Setup(const Vector &diag, int iterations, EigenEstimator estimator);
+
+   /// Estimate the largest eigenvalue with the power method.
+   double PowerEstimate(int iterations);
+
+   /// Estimate the largest eigenvalue with the Lanczos method.
+   double LanczosEstimate(const Vector &diag, int iterations);
+
+public:
+   /** @brief Construct the smoother for the operator @a op with diagonal
+       @a diag; @a power_iterations is the number of iterations of the
+       @a estimator of the largest eigenvalue of D^{-1} A. */
+   OperatorChebyshevSmoother(const Operator &op, const Vector &diag,
+                             int order = 2, int power_iterations = 10,
+                             EigenEstimator estimator = POWER);
+
+#ifdef MFEM_USE_MPI
+   /// Parallel version, the eigenvalue estimate uses global dot products.
+   OperatorChebyshevSmoother(MPI_Comm comm, const Operator &op,
+                             const Vector &diag, int order = 2,
+                             int power_iterations = 10,
+                             EigenEstimator estimator = POWER);
+#endif
+
+   /// Return the estimate of the largest eigenvalue of D^{-1} A.
+   double GetMaxEigenvalueEstimate() const { return max_eig_estimate; }
+
+   virtual void Mult(const Vector &b, Vector &x) const;
+
+   /// The operator is set in the constructor.
+   virtual void SetOperator(const Operator &op)
+   { MFEM_ABORT("the operator is set in the constructor"); }
+};
+
 #ifdef MFEM_USE_SUITESPARSE
 
 /// Direct sparse solver using UMFPACK
@@ -548,6 +548,44 @@ void SparseMatrix::Mult(const Vector &x, Vector &y) const
    AddMult(x, y);
 }
 
+void SparseMatrix::MultMulti(const DenseMatrix &X, DenseMatrix &Y) const
+{
+   if (A == NULL)
+   {
+      //  The matrix is not finalized, multiply one column at a time
+      Operator::MultMulti(X, Y);
+      return;
+   }
+   MFEM_ASSERT(width == X.Height(),
+               "Input matrix height (" << X.Height() << ") must match matrix "
+               "width (" << width << ")");
+
+   const int k = X.Width();
+   Y.SetSize(height, k);
+   const double *Xp = X.Data();
+   double *Yp = Y.Data();
+#ifdef MFEM_USE_OPENMP
+   #pragma omp parallel for
+#endif
+   for (int i = 0; i < height; i++)
+   {
+      double *yi = Yp + i;
+      for (int c = 0; c < k; c++)
+      {
+         yi[height*c] = 0.0;
+      }
+      for (int j = I[i]; j < I[i+1]; j++)
+      {
+         const double a = A[j];
+         const double *xj = Xp + J[j];
+         for (int c = 0; c < k; c++)
+         {
+            yi[height*c] += a * xj[width*c];
+         }
+      }
+   }
+}
+
 void SparseMatrix::AddMult(const Vector &x, Vector &y, const double a) const
 {
    MFEM_ASSERT(width == x.Size(),
@@ -1954,7 +1992,8 @@ void SparseMatrix::Jacobi(const Vector &b, const Vector &x0, Vector &x1,
    }
 }
 
-void SparseMatrix::DiagScale(const Vector &b, Vector &x, double sc) const
+void SparseMatrix::DiagScale(const double *b, double *x, int nvec,
+                             double sc) const
 {
    MFEM_VERIFY(Finalized(), "Matrix must be finalized.");
 
@@ -1970,13 +2009,17 @@ void SparseMatrix::DiagScale(const Vector &b, Vector &x, double sc) const
          if (J[j] == i)
          {
             MFEM_VERIFY(std::abs(A[j]) > 0.0, "Diagonal " << j << " must be nonzero");
-            if (scale)
-            {
-               x(i) = sc * b(i) / A[j];
-            }
-            else
+            for (int c = 0; c < nvec; c++)
             {
-               x(i) = b(i) / A[j];
+               const int ic = i + c*height;
+               if (scale)
+               {
+                  x[ic] = sc * b[ic] / A[j];
+               }
+               else
+               {
+                  x[ic] = b[ic] / A[j];
+               }
             }
             break;
          }
@@ -2072,6 +2115,62 @@ void SparseMatrix::AddSubMatrix(const Array<int> &rows, const Array<int> &cols,
    }
 }
 
+void SparseMatrix::AddSubMatrixThreadSafe(const Array<int> &rows,
+                                          const Array<int> &cols,
+                                          const DenseMatrix &subm,
+                                          int skip_zeros)
+{
+   MFEM_VERIFY(Finalized(), "the matrix must be finalized");
+
+   // Visit the columns in increasing order, so that the search in a row with
+   // sorted column indices restarts from the last position found.
+   Array<Pair<int,int> > sorted_cols(cols.Size());
+   for (int j = 0; j < cols.Size(); j++)
+   {
+      const int gj = cols[j];
+      sorted_cols[j].one = (gj < 0) ? -1-gj : gj;
+      sorted_cols[j].two = j;
+   }
+   SortPairs<int,int>(sorted_cols, sorted_cols.Size());
+
+   for (int i = 0; i < rows.Size(); i++)
+   {
+      int gi = rows[i], s = 1;
+      if (gi < 0) { gi = -1-gi, s = -1; }
+      MFEM_ASSERT(gi < height,
+                  "Trying to insert a row " << gi << " outside the matrix height "
+                  << height);
+      const int row_beg = I[gi], row_end = I[gi+1];
+      int pos = row_beg;
+      for (int k = 0; k < sorted_cols.Size(); k++)
+      {
+         const int gj = sorted_cols[k].one, j = sorted_cols[k].two;
+         double a = subm(i, j);
+         if (skip_zeros && a == 0.0)
+         {
+            // if the element is zero do not assemble it unless this breaks
+            // the symmetric structure
+            if (&rows != &cols || subm(j, i) == 0.0)
+            {
+               continue;
+            }
+         }
+         if (cols[j] < 0) { a = -a; }
+         if (s < 0) { a = -a; }
+         // search the row, starting from the last position found
+         int l = row_end - row_beg;
+         while (l > 0 && J[pos] != gj)
+         {
+            if (++pos == row_end) { pos = row_beg; }
+            l--;
+         }
+         MFEM_VERIFY(l > 0, "entry (" << gi << "," << gj << ") is not in the"
+                     " sparsity pattern of the matrix");
+         A[pos] += a;
+      }
+   }
+}
+
 void SparseMatrix::Set(const int i, const int j, const double A)
 {
    double a = A;
@@ -2920,6 +3019,85 @@ SparseMatrix *TransposeAbstractSparseMatrix (const AbstractSparseMatrix &A,
 }
 
 
+#ifdef MFEM_USE_OPENMP
+// Threaded version of Mult(A, B) without a pre-allocated output matrix. The
+// rows of the product are distributed among the threads, each using its own
+// marker array; the rows are computed exactly as in the serial version.
+static SparseMatrix *MultThreaded(const SparseMatrix &A, const SparseMatrix &B)
+{
+   const int nrowsA = A.Height(), ncolsB = B.Width();
+   const int *A_i = A.GetI(), *A_j = A.GetJ(), *B_i = B.GetI(), *B_j = B.GetJ();
+   const double *A_data = A.GetData(), *B_data = B.GetData();
+
+   int *C_i = new int[nrowsA+1];
+   C_i[0] = 0;
+   #pragma omp parallel
+   {
+      int *B_marker = new int[ncolsB];
+      for (int ib = 0; ib < ncolsB; ib++) { B_marker[ib] = -1; }
+      #pragma omp for
+      for (int ic = 0; ic < nrowsA; ic++)
+      {
+         int row_nnz = 0;
+         for (int ia = A_i[ic]; ia < A_i[ic+1]; ia++)
+         {
+            const int ja = A_j[ia];
+            for (int ib = B_i[ja]; ib < B_i[ja+1]; ib++)
+            {
+               const int jb = B_j[ib];
+               if (B_marker[jb] != ic)
+               {
+                  B_marker[jb] = ic;
+                  row_nnz++;
+               }
+            }
+         }
+         C_i[ic+1] = row_nnz;
+      }
+      delete [] B_marker;
+   }
+   for (int ic = 0; ic < nrowsA; ic++) { C_i[ic+1] += C_i[ic]; }
+
+   const int num_nonzeros = C_i[nrowsA];
+   int *C_j = new int[num_nonzeros];
+   double *C_data = new double[num_nonzeros];
+   #pragma omp parallel
+   {
+      int *B_marker = new int[ncolsB];
+      for (int ib = 0; ib < ncolsB; ib++) { B_marker[ib] = -1; }
+      #pragma omp for
+      for (int ic = 0; ic < nrowsA; ic++)
+      {
+         const int row_start = C_i[ic];
+         int counter = row_start;
+         for (int ia = A_i[ic]; ia < A_i[ic+1]; ia++)
+         {
+            const int ja = A_j[ia];
+            const double a_entry = A_data[ia];
+            for (int ib = B_i[ja]; ib < B_i[ja+1]; ib++)
+            {
+               const int jb = B_j[ib];
+               if (B_marker[jb] < row_start)
+               {
+                  B_marker[jb] = counter;
+                  C_j[counter] = jb;
+                  C_data[counter] = a_entry*B_data[ib];
+                  counter++;
+               }
+               else
+               {
+                  C_data[B_marker[jb]] += a_entry*B_data[ib];
+               }
+            }
+         }
+      }
+      delete [] B_marker;
+   }
+
+   return new SparseMatrix(C_i, C_j, C_data, nrowsA, ncolsB);
+}
+#endif
+
 SparseMatrix *Mult (const SparseMatrix &A, const SparseMatrix &B,
                     SparseMatrix *OAB)
 {
@@ -2940,6 +3118,10 @@ SparseMatrix *Mult (const SparseMatrix &A, const SparseMatrix &B,
                "number of columns of A (" << ncolsA
                << ") must equal number of rows of B (" << nrowsB << ")");
 
+#ifdef MFEM_USE_OPENMP
+   if (OAB == NULL) { return MultThreaded(A, B); }
+#endif
+
    A_i    = A.GetI();
    A_j    = A.GetJ();
    A_data = A.GetData();
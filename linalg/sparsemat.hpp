@@ -80,6 +80,10 @@ protected:
    void Destroy();   // Delete all owned data
    void SetEmpty();  // Init all entries with empty values
 
+   // Scale the nvec columns of b by sc D^{-1}, where D is the diagonal of the
+   // matrix; b and x are stored by columns with leading dimension height.
+   void DiagScale(const double *b, double *x, int nvec, double sc) const;
+
 public:
    /// Create an empty SparseMatrix.
    SparseMatrix() { SetEmpty(); }
@@ -199,6 +203,10 @@ public:
    /// y += A * x (default)  or  y += a * A * x
    void AddMult(const Vector &x, Vector &y, const double a = 1.0) const;
 
+   /** @brief Multiplication of the columns of @a X: Y = A * X, reading the
+       matrix once for all columns. */
+   virtual void MultMulti(const DenseMatrix &X, DenseMatrix &Y) const;
+
    /// Multiply a vector with the transposed matrix. y = At * x
    void MultTranspose(const Vector &x, Vector &y) const;
 
@@ -297,7 +305,12 @@ public:
        x1 = x0 + sc D^{-1} (b - A x0)  where D is the diag of A. */
    void Jacobi(const Vector &b, const Vector &x0, Vector &x1, double sc) const;
 
-   void DiagScale(const Vector &b, Vector &x, double sc = 1.0) const;
+   void DiagScale(const Vector &b, Vector &x, double sc = 1.0) const
+   { DiagScale(b.GetData(), x.GetData(), 1, sc); }
+
+   /// Apply DiagScale() to the columns of @a B; @a X must have the same size.
+   void DiagScale(const DenseMatrix &B, DenseMatrix &X, double sc = 1.0) const
+   { DiagScale(B.Data(), X.Data(), B.Width(), sc); }
 
    /** x1 = x0 + sc D^{-1} (b - A x0) where \f$ D_{ii} = \sum_j |A_{ij}| \f$. */
    void Jacobi2(const Vector &b, const Vector &x0, Vector &x1,
@@ -355,6 +368,15 @@ public:
    void AddSubMatrix(const Array<int> &rows, const Array<int> &cols,
                      const DenseMatrix &subm, int skip_zeros = 1);
 
+   /** @brief Same as AddSubMatrix(), for a finalized matrix whose sparsity
+       pattern already contains all entries of @a subm.
+
+       Unlike AddSubMatrix(), this method does not use any internal work
+       arrays, so it can be called concurrently from several threads as long as
+       the calls update disjoint sets of rows. */
+   void AddSubMatrixThreadSafe(const Array<int> &rows, const Array<int> &cols,
+                               const DenseMatrix &subm, int skip_zeros = 1);
+
    bool RowIsEmpty(const int row) const;
 
    /// Extract all column indices and values from a given row.
@@ -456,7 +478,8 @@ SparseMatrix *TransposeAbstractSparseMatrix (const AbstractSparseMatrix &A,
     If OAB is not NULL, we assume it has the structure
     of A.B and store the result in OAB.
     If OAB is NULL, we create a new SparseMatrix to store
-    the result and return a pointer to it.
+    the result and return a pointer to it; with OpenMP, the rows of the
+    product are computed in parallel in this case.
     All matrices must be finalized. */
 SparseMatrix *Mult(const SparseMatrix &A, const SparseMatrix &B,
                    SparseMatrix *OAB = NULL);
@@ -108,4 +108,16 @@ void DSmoother::Mult(const Vector &x, Vector &y) const
    }
 }
 
+void DSmoother::MultMulti(const DenseMatrix &X, DenseMatrix &Y) const
+{
+   if (iterative_mode || type != 0 || iterations != 1)
+   {
+      Operator::MultMulti(X, Y);
+      return;
+   }
+
+   Y.SetSize(height, X.Width());
+   oper->DiagScale(X, Y, scale);
+}
+
 }
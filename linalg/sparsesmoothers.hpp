@@ -71,6 +71,10 @@ public:
 
    /// Matrix vector multiplication with Jacobi smoother.
    virtual void Mult(const Vector &x, Vector &y) const;
+
+   /** @brief Application to the columns of @a X. One scaled Jacobi step with
+       zero initial guess reads the matrix diagonal once for all columns. */
+   virtual void MultMulti(const DenseMatrix &X, DenseMatrix &Y) const;
 };
 
 }
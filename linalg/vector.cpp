@@ -113,6 +113,25 @@ double Vector::operator*(const Vector &v) const
    return operator*(v.data);
 }
 
+void Vector::Dots(const Vector &v, const Vector &w,
+                  double &dv, double &dw) const
+{
+   MFEM_ASSERT(v.size == size && w.size == size, "incompatible Vectors!");
+
+   const double *d = data, *vp = v.data, *wp = w.data;
+   double sv = 0.0, sw = 0.0;
+#ifdef MFEM_USE_OPENMP
+   #pragma omp parallel for reduction(+:sv,sw)
+#endif
+   for (int i = 0; i < size; i++)
+   {
+      sv += d[i] * vp[i];
+      sw += d[i] * wp[i];
+   }
+   dv = sv;
+   dw = sw;
+}
+
 Vector &Vector::operator=(const double *v)
 {
    if (data != v)
@@ -383,6 +402,73 @@ void add(const double a, const Vector &x,
    }
 }
 
+void add(const double a, const Vector &x, const double b,
+         const Vector &y, const double c, Vector &z)
+{
+   MFEM_ASSERT(x.size == z.size && y.size == z.size, "incompatible Vectors!");
+
+   if (c == 0.0)
+   {
+      add(a, x, b, y, z);
+   }
+   else
+   {
+      const double *xp = x.data;
+      const double *yp = y.data;
+      double       *zp = z.data;
+      int            s = z.size;
+
+#ifdef MFEM_USE_OPENMP
+      #pragma omp parallel for
+#endif
+      for (int i = 0; i < s; i++)
+      {
+         zp[i] = a * xp[i] + b * yp[i] + c * zp[i];
+      }
+   }
+}
+
+double AddAndDot(const Vector &v1, double alpha, const Vector &v2,
+                 Vector &v, const Vector &w)
+{
+   MFEM_ASSERT(v1.size == v.size && v2.size == v.size && w.size == v.size,
+               "incompatible Vectors!");
+
+   const double *v1p = v1.data, *v2p = v2.data, *wp = w.data;
+   double *vp = v.data;
+   int s = v.size;
+   double prod = 0.0;
+#ifdef MFEM_USE_OPENMP
+   #pragma omp parallel for reduction(+:prod)
+#endif
+   for (int i = 0; i < s; i++)
+   {
+      // if w is v, wp[i] is read after vp[i] is updated
+      vp[i] = v1p[i] + alpha * v2p[i];
+      prod += vp[i] * wp[i];
+   }
+   return prod;
+}
+
+void AddPair(Vector &v1, double a1, const Vector &w1,
+             Vector &v2, double a2, const Vector &w2)
+{
+   MFEM_ASSERT(w1.size == v1.size && v2.size == v1.size && w2.size == v1.size,
+               "incompatible Vectors!");
+
+   const double *w1p = w1.data, *w2p = w2.data;
+   double *v1p = v1.data, *v2p = v2.data;
+   int s = v1.size;
+#ifdef MFEM_USE_OPENMP
+   #pragma omp parallel for
+#endif
+   for (int i = 0; i < s; i++)
+   {
+      v1p[i] += a1 * w1p[i];
+      v2p[i] += a2 * w2p[i];
+   }
+}
+
 void subtract(const Vector &x, const Vector &y, Vector &z)
 {
 #ifdef MFEM_DEBUG
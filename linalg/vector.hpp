@@ -167,6 +167,10 @@ public:
    /// Return the inner-product.
    double operator*(const Vector &v) const;
 
+   /// Compute the inner products @a dv = (*this) * v and @a dw = (*this) * w.
+   /** Both products are computed in a single pass over the vectors. */
+   void Dots(const Vector &v, const Vector &w, double &dv, double &dw) const;
+
    /// Copy Size() entries from @a v.
    Vector & operator=(const double *v);
 
@@ -215,6 +219,23 @@ public:
    friend void add (const double a, const Vector &x,
                     const double b, const Vector &y, Vector &z);
 
+   /// z = a * x + b * y + c * z
+   /** When @a c is zero, the input values of @a z are not used. */
+   friend void add(const double a, const Vector &x, const double b,
+                   const Vector &y, const double c, Vector &z);
+
+   /// Set v = v1 + alpha * v2 and return the inner product v * w.
+   /** The update and the inner product are computed in a single pass over the
+       vectors. The vector @a v may be the same as @a v1 and @a w may be the
+       same as @a v, e.g. `AddAndDot(r, -alpha, z, r, r)` returns the squared
+       norm of the updated r. */
+   friend double AddAndDot(const Vector &v1, double alpha, const Vector &v2,
+                           Vector &v, const Vector &w);
+
+   /// Set v1 += a1 * w1 and v2 += a2 * w2 in a single pass over the vectors.
+   friend void AddPair(Vector &v1, double a1, const Vector &w1,
+                       Vector &v2, double a2, const Vector &w2);
+
    /// Set v = v1 - v2.
    friend void subtract(const Vector &v1, const Vector &v2, Vector &v);
 
@@ -0,0 +1,269 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+// Implementation of class BoundingBoxTree
+
+#include "mesh_headers.hpp"
+#include "../fem/fem.hpp"
+
+#include <algorithm>
+
+namespace mfem
+{
+
+// Compare two elements by the coordinate of their box centers along 'dir'.
+class BoxCenterLess
+{
+   const double *box;
+   int sdim, dir;
+public:
+   BoxCenterLess(const Vector &b, int s, int d) : box(b.GetData()), sdim(s),
+      dir(d) { }
+   bool operator()(int i, int j) const
+   {
+      const double *bi = box + 2*sdim*i, *bj = box + 2*sdim*j;
+      return (bi[dir] + bi[sdim+dir] < bj[dir] + bj[sdim+dir]);
+   }
+};
+
+BoundingBoxTree::BoundingBoxTree(Mesh &m, double rel_margin, int leaf_sz)
+   : mesh(&m), margin(rel_margin), leaf_size(leaf_sz)
+{
+   MFEM_VERIFY(leaf_size > 0, "invalid leaf size: " << leaf_size);
+   Rebuild();
+}
+
+void BoundingBoxTree::Update()
+{
+   if (sequence != mesh->GetSequence() || ne != mesh->GetNE() ||
+       sdim != mesh->SpaceDimension())
+   {
+      Rebuild();
+   }
+   else if (coords_sequence != mesh->GetCoordinatesSequence())
+   {
+      Refit();
+   }
+}
+
+bool BoundingBoxTree::IsUpToDate() const
+{
+   return (sequence == mesh->GetSequence() && ne == mesh->GetNE() &&
+           sdim == mesh->SpaceDimension() &&
+           coords_sequence == mesh->GetCoordinatesSequence());
+}
+
+void BoundingBoxTree::Rebuild()
+{
+   sdim = mesh->SpaceDimension();
+   ne = mesh->GetNE();
+   sequence = mesh->GetSequence();
+   coords_sequence = mesh->GetCoordinatesSequence();
+
+   ComputeElementBoxes();
+
+   el_perm.SetSize(ne);
+   for (int i = 0; i < ne; i++) { el_perm[i] = i; }
+
+   node_child.SetSize(0);
+   node_first.SetSize(0);
+   node_num.SetSize(0);
+   if (ne > 0)
+   {
+      node_child.Append(-1);
+      node_first.Append(0);
+      node_num.Append(ne);
+      BuildNode(0, 0, ne);
+   }
+   ComputeNodeBoxes();
+}
+
+void BoundingBoxTree::Refit()
+{
+   coords_sequence = mesh->GetCoordinatesSequence();
+   ComputeElementBoxes();
+   ComputeNodeBoxes();
+}
+
+void BoundingBoxTree::ComputeElementBoxes()
+{
+   const GridFunction *nodes = mesh->GetNodes();
+   Array<int> vdofs, verts;
+
+   el_box.SetSize(2*sdim*ne);
+   for (int i = 0; i < ne; i++)
+   {
+      double *bmin = el_box.GetData() + 2*sdim*i, *bmax = bmin + sdim;
+      for (int d = 0; d < sdim; d++)
+      {
+         bmin[d] = infinity();
+         bmax[d] = -infinity();
+      }
+      if (nodes)
+      {
+         nodes->FESpace()->GetElementVDofs(i, vdofs);
+         const int n = vdofs.Size()/sdim;
+         for (int d = 0; d < sdim; d++)
+         {
+            for (int j = 0; j < n; j++)
+            {
+               const double x = (*nodes)(vdofs[n*d+j]);
+               bmin[d] = std::min(bmin[d], x);
+               bmax[d] = std::max(bmax[d], x);
+            }
+         }
+      }
+      else
+      {
+         mesh->GetElementVertices(i, verts);
+         for (int j = 0; j < verts.Size(); j++)
+         {
+            const double *x = mesh->GetVertex(verts[j]);
+            for (int d = 0; d < sdim; d++)
+            {
+               bmin[d] = std::min(bmin[d], x[d]);
+               bmax[d] = std::max(bmax[d], x[d]);
+            }
+         }
+      }
+      double h = 0.0;
+      for (int d = 0; d < sdim; d++)
+      {
+         h = std::max(h, bmax[d] - bmin[d]);
+      }
+      for (int d = 0; d < sdim; d++)
+      {
+         bmin[d] -= margin*h;
+         bmax[d] += margin*h;
+      }
+   }
+}
+
+void BoundingBoxTree::BuildNode(int node, int first, int num)
+{
+   if (num <= leaf_size) { return; }
+
+   // Split along the direction with the largest extent of the element centers
+   int dir = 0;
+   double max_ext = -1.0;
+   for (int d = 0; d < sdim; d++)
+   {
+      double cmin = infinity(), cmax = -infinity();
+      for (int k = first; k < first + num; k++)
+      {
+         const double *b = el_box.GetData() + 2*sdim*el_perm[k];
+         const double c = b[d] + b[sdim+d];
+         cmin = std::min(cmin, c);
+         cmax = std::max(cmax, c);
+      }
+      if (cmax - cmin > max_ext)
+      {
+         max_ext = cmax - cmin;
+         dir = d;
+      }
+   }
+
+   const int half = num/2;
+   int *perm = el_perm.GetData();
+   std::nth_element(perm + first, perm + first + half, perm + first + num,
+                    BoxCenterLess(el_box, sdim, dir));
+
+   const int left = node_child.Size();
+   node_child[node] = left;
+   for (int c = 0; c < 2; c++)
+   {
+      node_child.Append(-1);
+      node_first.Append(c == 0 ? first : first + half);
+      node_num.Append(c == 0 ? half : num - half);
+   }
+   BuildNode(left, first, half);
+   BuildNode(left + 1, first + half, num - half);
+}
+
+void BoundingBoxTree::ComputeNodeBoxes()
+{
+   const int nn = node_child.Size();
+   node_box.SetSize(2*sdim*nn);
+   // Children are stored after their parents, so visit the nodes backwards
+   for (int k = nn - 1; k >= 0; k--)
+   {
+      double *bmin = node_box.GetData() + 2*sdim*k, *bmax = bmin + sdim;
+      for (int d = 0; d < sdim; d++)
+      {
+         bmin[d] = infinity();
+         bmax[d] = -infinity();
+      }
+      const int child = node_child[k];
+      const int num = (child < 0) ? node_num[k] : 2;
+      for (int j = 0; j < num; j++)
+      {
+         const double *b = (child < 0) ?
+                           el_box.GetData() + 2*sdim*el_perm[node_first[k]+j] :
+                           node_box.GetData() + 2*sdim*(child+j);
+         for (int d = 0; d < sdim; d++)
+         {
+            bmin[d] = std::min(bmin[d], b[d]);
+            bmax[d] = std::max(bmax[d], b[sdim+d]);
+         }
+      }
+   }
+}
+
+bool BoundingBoxTree::BoxContains(const Vector &box, int i,
+                                  const double *x) const
+{
+   const double *b = box.GetData() + 2*sdim*i;
+   for (int d = 0; d < sdim; d++)
+   {
+      if (x[d] < b[d] || x[d] > b[sdim+d]) { return false; }
+   }
+   return true;
+}
+
+void BoundingBoxTree::FindCandidates(const double *x, Array<int> &elems) const
+{
+   elems.SetSize(0);
+   if (node_child.Size() == 0) { return; }
+
+   Array<int> stack;
+   stack.Append(0);
+   while (stack.Size() > 0)
+   {
+      const int k = stack.Last();
+      stack.DeleteLast();
+      if (!BoxContains(node_box, k, x)) { continue; }
+      const int child = node_child[k];
+      if (child >= 0)
+      {
+         stack.Append(child + 1);
+         stack.Append(child);
+         continue;
+      }
+      for (int j = 0; j < node_num[k]; j++)
+      {
+         const int e = el_perm[node_first[k]+j];
+         if (BoxContains(el_box, e, x)) { elems.Append(e); }
+      }
+   }
+}
+
+void BoundingBoxTree::GetElementBox(int i, Vector &min, Vector &max) const
+{
+   min.SetSize(sdim);
+   max.SetSize(sdim);
+   for (int d = 0; d < sdim; d++)
+   {
+      min(d) = el_box(2*sdim*i+d);
+      max(d) = el_box(2*sdim*i+sdim+d);
+   }
+}
+
+}
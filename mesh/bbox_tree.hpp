@@ -0,0 +1,118 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#ifndef MFEM_BBOX_TREE
+#define MFEM_BBOX_TREE
+
+#include "../config/config.hpp"
+#include "../general/array.hpp"
+#include "../linalg/vector.hpp"
+
+namespace mfem
+{
+
+class Mesh;
+
+/** @brief Bounding volume hierarchy of axis-aligned boxes enclosing the
+    elements of a Mesh.
+
+    The box of each element is computed from its vertices or, for curved meshes
+    (when the Mesh has Nodes), from its nodal coordinates. Since the nodes of a
+    high-order element do not necessarily bound it, every box is enlarged by a
+    relative margin. The boxes are organized in a binary tree, built by
+    splitting the element centers at the median along the longest direction,
+    which allows the elements that may contain a given point to be found in
+    O(log NE) operations.
+
+    After the mesh nodes are moved, the tree can be updated cheaply by
+    recomputing the boxes without changing the tree structure (Refit()). After
+    the mesh is refined, derefined, etc., the tree is rebuilt. Update() selects
+    between the two options based on the Mesh sequence number, and does nothing
+    if the vertex or node coordinates did not change, as tracked by
+    Mesh::GetCoordinatesSequence(). */
+class BoundingBoxTree
+{
+protected:
+   Mesh *mesh;
+   double margin;
+   int leaf_size;
+   int sdim, ne;
+   long sequence, coords_sequence;
+
+   /** Element boxes: the minimum and the maximum corners of element i are
+       stored at offsets 2*sdim*i and 2*sdim*i + sdim, respectively. */
+   Vector el_box;
+   /// Element indices ordered so that the elements of every node are adjacent.
+   Array<int> el_perm;
+
+   /** Tree nodes: children of node k are node_child[k] and node_child[k]+1,
+       with node_child[k] == -1 for leaves. Children are always stored after
+       their parent. The elements of node k are el_perm[node_first[k]], ...,
+       el_perm[node_first[k]+node_num[k]-1]. */
+   Array<int> node_child, node_first, node_num;
+   /// Node boxes, with the same layout as #el_box.
+   Vector node_box;
+
+   void ComputeElementBoxes();
+   void BuildNode(int node, int first, int num);
+   void ComputeNodeBoxes();
+
+   bool BoxContains(const Vector &box, int i, const double *x) const;
+
+public:
+   /** @brief Construct the tree for the elements of @a m.
+
+       @param[in] m          The mesh; it is not owned by the tree.
+       @param[in] rel_margin Every box is enlarged by this fraction of its
+                             largest side in all directions.
+       @param[in] leaf_sz    Maximal number of elements in a leaf. */
+   BoundingBoxTree(Mesh &m, double rel_margin = 0.1, int leaf_sz = 4);
+
+   /** @brief Update the tree after the mesh was modified: if the Mesh sequence
+       changed, e.g. after refinement, the tree is rebuilt, otherwise only the
+       boxes are recomputed, if the mesh coordinates changed. */
+   void Update();
+
+   /// Rebuild the tree from scratch.
+   void Rebuild();
+
+   /** @brief Recompute the element and node boxes from the current mesh
+       coordinates, keeping the tree structure. */
+   void Refit();
+
+   /** @brief Find all elements whose boxes contain the point @a x, an array of
+       size equal to the space dimension of the mesh. */
+   void FindCandidates(const double *x, Array<int> &elems) const;
+
+   /// Return the box of element @a i.
+   void GetElementBox(int i, Vector &min, Vector &max) const;
+
+   /// Return true if the box of element @a i contains the point @a x.
+   bool ElementBoxContains(int i, const double *x) const
+   { return BoxContains(el_box, i, x); }
+
+   /// Return the mesh of the tree.
+   const Mesh *GetMesh() const { return mesh; }
+
+   /** @brief Return true if the tree corresponds to the current elements and
+       coordinates of the mesh, i.e. if Update() would do nothing. */
+   bool IsUpToDate() const;
+
+   /// Return the number of nodes in the tree.
+   int GetNumNodes() const { return node_child.Size(); }
+
+   /// Return the Mesh sequence number the tree structure corresponds to.
+   long GetSequence() const { return sequence; }
+};
+
+}
+
+#endif
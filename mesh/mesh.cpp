@@ -335,6 +335,7 @@ void Mesh::GetElementTransformation(int i, IsoparametricTransformation *ElTr)
 {
    ElTr->Attribute = GetAttribute(i);
    ElTr->ElementNo = i;
+   ElTr->mesh = this;
    if (Nodes == NULL)
    {
       GetPointMatrix(i, ElTr->GetPointMat());
@@ -365,6 +366,7 @@ void Mesh::GetElementTransformation(int i, const Vector &nodes,
 {
    ElTr->Attribute = GetAttribute(i);
    ElTr->ElementNo = i;
+   ElTr->mesh = this;
    DenseMatrix &pm = ElTr->GetPointMat();
    if (Nodes == NULL)
    {
@@ -418,6 +420,7 @@ void Mesh::GetBdrElementTransformation(int i, IsoparametricTransformation* ElTr)
 {
    ElTr->Attribute = GetBdrAttribute(i);
    ElTr->ElementNo = i; // boundary element number
+   ElTr->mesh = this;
    if (Nodes == NULL)
    {
       GetBdrPointMatrix(i, ElTr->GetPointMat());
@@ -447,6 +450,7 @@ void Mesh::GetFaceTransformation(int FaceNo, IsoparametricTransformation *FTr)
 {
    FTr->Attribute = (Dim == 1) ? 1 : faces[FaceNo]->GetAttribute();
    FTr->ElementNo = FaceNo;
+   FTr->mesh = this;
    DenseMatrix &pm = FTr->GetPointMat();
    if (Nodes == NULL)
    {
@@ -526,6 +530,7 @@ void Mesh::GetEdgeTransformation(int EdgeNo, IsoparametricTransformation *EdTr)
 
    EdTr->Attribute = 1;
    EdTr->ElementNo = EdgeNo;
+   EdTr->mesh = this;
    DenseMatrix &pm = EdTr->GetPointMat();
    if (Nodes == NULL)
    {
@@ -919,6 +924,8 @@ void Mesh::Init()
    NURBSext = NULL;
    ncmesh = NULL;
    last_operation = Mesh::NONE;
+   bbox_tree = NULL;
+   coords_sequence = 0;
 }
 
 void Mesh::InitTables()
@@ -956,6 +963,10 @@ void Mesh::DestroyPointers()
 
    delete NURBSext;
 
+   delete bbox_tree;
+
+   DeleteGeometricFactors();
+
    for (int i = 0; i < NumOfElements; i++)
    {
       FreeElement(elements[i]);
@@ -1331,6 +1342,7 @@ void Mesh::GetGeckoElementReordering(Array<int> &ordering)
 
 void Mesh::ReorderElements(const Array<int> &ordering, bool reorder_vertices)
 {
+   DeleteGeometricFactors();
    if (NURBSext)
    {
       MFEM_WARNING("element reordering of NURBS meshes is not supported.");
@@ -1628,6 +1640,7 @@ void Mesh::PrepareNodeReorder(DSTable **old_v_to_v, Table **old_elem_vert)
 
 void Mesh::DoNodeReorder(DSTable *old_v_to_v, Table *old_elem_vert)
 {
+   DeleteGeometricFactors();
    FiniteElementSpace *fes = Nodes->FESpace();
    const FiniteElementCollection *fec = fes->FEColl();
    Array<int> old_dofs, new_dofs;
@@ -2529,6 +2542,8 @@ Mesh::Mesh(const Mesh &mesh, bool copy_nodes)
    // Create the new Mesh instance without a record of its refinement history
    sequence = 0;
    last_operation = Mesh::NONE;
+   bbox_tree = NULL;
+   coords_sequence = 0;
 
    // Duplicate the elements
    elements.SetSize(NumOfElements);
@@ -4777,6 +4792,8 @@ void Mesh::ReorientTetMesh()
 {
    int *v;
 
+   DeleteGeometricFactors();
+
    if (Dim != 3 || !(meshgen & 1))
    {
       return;
@@ -5585,6 +5602,7 @@ void Mesh::CheckDisplacements(const Vector &displacements, double &tmax)
 
 void Mesh::MoveVertices(const Vector &displacements)
 {
+   DeleteGeometricFactors();
    for (int i = 0, nv = vertices.Size(); i < nv; i++)
       for (int j = 0; j < spaceDim; j++)
       {
@@ -5605,6 +5623,7 @@ void Mesh::GetVertices(Vector &vert_coord) const
 
 void Mesh::SetVertices(const Vector &vert_coord)
 {
+   DeleteGeometricFactors();
    for (int i = 0, nv = vertices.Size(); i < nv; i++)
       for (int j = 0; j < spaceDim; j++)
       {
@@ -5633,6 +5652,7 @@ void Mesh::GetNode(int i, double *coord)
 
 void Mesh::SetNode(int i, const double *coord)
 {
+   DeleteGeometricFactors();
    if (Nodes)
    {
       FiniteElementSpace *fes = Nodes->FESpace();
@@ -5653,6 +5673,7 @@ void Mesh::SetNode(int i, const double *coord)
 
 void Mesh::MoveNodes(const Vector &displacements)
 {
+   DeleteGeometricFactors();
    if (Nodes)
    {
       (*Nodes) += displacements;
@@ -5677,6 +5698,7 @@ void Mesh::GetNodes(Vector &node_coord) const
 
 void Mesh::SetNodes(const Vector &node_coord)
 {
+   DeleteGeometricFactors();
    if (Nodes)
    {
       (*Nodes) = node_coord;
@@ -5689,6 +5711,7 @@ void Mesh::SetNodes(const Vector &node_coord)
 
 void Mesh::NewNodes(GridFunction &nodes, bool make_owner)
 {
+   DeleteGeometricFactors();
    if (own_nodes) { delete Nodes; }
    Nodes = &nodes;
    spaceDim = Nodes->FESpace()->GetVDim();
@@ -5703,6 +5726,7 @@ void Mesh::NewNodes(GridFunction &nodes, bool make_owner)
 
 void Mesh::SwapNodes(GridFunction *&nodes, int &own_nodes_)
 {
+   DeleteGeometricFactors();
    mfem::Swap<GridFunction*>(Nodes, nodes);
    mfem::Swap<int>(own_nodes, own_nodes_);
    // TODO:
@@ -6931,6 +6955,15 @@ void Mesh::Swap(Mesh& other, bool non_geometry)
    mfem::Swap(attributes, other.attributes);
    mfem::Swap(bdr_attributes, other.bdr_attributes);
 
+   // The bounding box trees and the geometric factors refer to their meshes,
+   // so they are not swapped
+   delete bbox_tree;
+   bbox_tree = NULL;
+   delete other.bbox_tree;
+   other.bbox_tree = NULL;
+   DeleteGeometricFactors();
+   other.DeleteGeometricFactors();
+
    if (non_geometry)
    {
       mfem::Swap(NURBSext, other.NURBSext);
@@ -9006,6 +9039,7 @@ void Mesh::ScaleElements(double sf)
 
 void Mesh::Transform(void (*f)(const Vector&, Vector&))
 {
+   DeleteGeometricFactors();
    // TODO: support for different new spaceDim.
    if (Nodes == NULL)
    {
@@ -9031,6 +9065,7 @@ void Mesh::Transform(void (*f)(const Vector&, Vector&))
 
 void Mesh::Transform(VectorCoefficient &deformation)
 {
+   DeleteGeometricFactors();
    MFEM_VERIFY(spaceDim == deformation.GetVDim(),
                "incompatible vector dimensions");
    if (Nodes == NULL)
@@ -9273,6 +9308,248 @@ std::ostream &operator<<(std::ostream &out, const Mesh &mesh)
    return out;
 }
 
+
+GeometricFactors::GeometricFactors(Mesh *mesh, const IntegrationRule &ir,
+                                   int flags)
+   : int_rule(ir), mesh(mesh), IntRule(&int_rule)
+{
+   Compute(flags);
+}
+
+// Store the determinant and inverse of the Jacobian Jq at the point q.
+static inline void StoreJacobianFactors(const DenseMatrix &Jq, int q, int NQ,
+                                        int flags, DenseMatrix &Jinv,
+                                        double *detJe, double *InvJe)
+{
+   if (flags & GeometricFactors::DETERMINANTS)
+   {
+      detJe[q] = Jq.Weight();
+   }
+   if (flags & GeometricFactors::INV_JACOBIANS)
+   {
+      CalcInverse(Jq, Jinv);
+      for (int c = 0; c < Jinv.Width(); c++)
+      {
+         for (int k = 0; k < Jinv.Height(); k++)
+         {
+            InvJe[q+NQ*(k+Jinv.Height()*c)] = Jinv(k,c);
+         }
+      }
+   }
+}
+
+void GeometricFactors::Compute(int flags)
+{
+   const int NE = mesh->GetNE();
+   const int NQ = IntRule->GetNPoints();
+   const int dim = mesh->Dimension();
+   const int sdim = mesh->SpaceDimension();
+   // The determinants and the inverses are computed from the Jacobians
+   if (flags & (DETERMINANTS | INV_JACOBIANS)) { flags |= JACOBIANS; }
+   computed_factors = flags;
+   sequence = mesh->GetSequence();
+
+   X.SetSize((flags & COORDINATES) ? NQ*sdim*NE : 0);
+   J.SetSize((flags & JACOBIANS) ? NQ*sdim*dim*NE : 0);
+   InvJ.SetSize((flags & INV_JACOBIANS) ? NQ*dim*sdim*NE : 0);
+   detJ.SetSize((flags & DETERMINANTS) ? NQ*NE : 0);
+   if (NE == 0) { return; }
+
+   const Geometry::Type geom = mesh->GetElementBaseGeometry(0);
+   for (int e = 1; e < NE; e++)
+   {
+      MFEM_VERIFY(mesh->GetElementBaseGeometry(e) == geom,
+                  "meshes with mixed element geometries are not supported");
+   }
+
+   const GridFunction *nodes = mesh->GetNodes();
+   const FiniteElementSpace *nfes = nodes ? nodes->FESpace() : NULL;
+   if (nfes && !nfes->GetFE(0)->HasElementIndependentBasis())
+   {
+      // The basis of the nodes, e.g. NURBS, changes from element to element:
+      // evaluate the transformations point by point.
+      IsoparametricTransformation T;
+      DenseMatrix Jinv(dim, sdim);
+      Vector x;
+      for (int e = 0; e < NE; e++)
+      {
+         mesh->GetElementTransformation(e, &T);
+         for (int q = 0; q < NQ; q++)
+         {
+            const IntegrationPoint &ip = IntRule->IntPoint(q);
+            T.SetIntPoint(&ip);
+            if (flags & COORDINATES)
+            {
+               T.Transform(ip, x);
+               for (int c = 0; c < sdim; c++) { X(q+NQ*(c+sdim*e)) = x(c); }
+            }
+            if (flags & JACOBIANS)
+            {
+               const DenseMatrix &Jq = T.Jacobian();
+               for (int k = 0; k < dim; k++)
+               {
+                  for (int c = 0; c < sdim; c++)
+                  {
+                     J(q+NQ*(c+sdim*(k+dim*e))) = Jq(c,k);
+                  }
+               }
+               StoreJacobianFactors(Jq, q, NQ, flags, Jinv,
+                                    detJ.GetData() + NQ*e,
+                                    InvJ.GetData() + NQ*dim*sdim*e);
+            }
+         }
+      }
+      return;
+   }
+
+#ifdef MFEM_USE_OPENMP
+   #pragma omp parallel
+#endif
+   {
+      const FiniteElement *fe = NULL;
+      // The transformation elements may outlive the rule copy: do not store
+      // the maps in them
+      DofToQuad maps;
+      Array<int> vdofs, v;
+      Vector el_nodes;
+      DenseMatrix Jq(sdim, dim), Jinv(dim, sdim);
+#ifdef MFEM_USE_OPENMP
+      #pragma omp for schedule(static)
+#endif
+      for (int e = 0; e < NE; e++)
+      {
+         const FiniteElement *el_fe = nfes ? nfes->GetFE(e) :
+                                      Mesh::GetTransformationFEforElementType(
+                                         mesh->GetElementType(e));
+         if (el_fe != fe)
+         {
+            fe = el_fe;
+            fe->ComputeDofToQuad(*IntRule, maps);
+         }
+         const int ND = fe->GetDof();
+
+         // The node coordinates of the element, layout ND x SDIM
+         el_nodes.SetSize(ND*sdim);
+         if (nfes)
+         {
+            nfes->GetElementVDofs(e, vdofs);
+            for (int i = 0; i < ND*sdim; i++) { el_nodes(i) = (*nodes)(vdofs[i]); }
+         }
+         else
+         {
+            mesh->GetElementVertices(e, v);
+            for (int d = 0; d < ND; d++)
+            {
+               const double *vx = mesh->GetVertex(v[d]);
+               for (int c = 0; c < sdim; c++) { el_nodes(d+ND*c) = vx[c]; }
+            }
+         }
+         const double *Ne = el_nodes.GetData();
+
+         if (flags & COORDINATES)
+         {
+            const double *B = maps.B.GetData();
+            double *Xe = X.GetData() + NQ*sdim*e;
+            for (int i = 0; i < NQ*sdim; i++) { Xe[i] = 0.0; }
+            for (int d = 0; d < ND; d++)
+            {
+               const double *Bd = B + NQ*d;
+               for (int c = 0; c < sdim; c++)
+               {
+                  const double s = Ne[d+ND*c];
+                  double *Xc = Xe + NQ*c;
+                  for (int q = 0; q < NQ; q++) { Xc[q] += Bd[q]*s; }
+               }
+            }
+         }
+
+         if (flags & JACOBIANS)
+         {
+            const double *G = maps.G.GetData();
+            double *Je = J.GetData() + NQ*sdim*dim*e;
+            for (int i = 0; i < NQ*sdim*dim; i++) { Je[i] = 0.0; }
+            for (int d = 0; d < ND; d++)
+            {
+               for (int k = 0; k < dim; k++)
+               {
+                  const double *Gdk = G + NQ*(k+dim*d);
+                  for (int c = 0; c < sdim; c++)
+                  {
+                     const double s = Ne[d+ND*c];
+                     double *Jck = Je + NQ*(c+sdim*k);
+                     for (int q = 0; q < NQ; q++) { Jck[q] += Gdk[q]*s; }
+                  }
+               }
+            }
+            if (flags & (DETERMINANTS | INV_JACOBIANS))
+            {
+               for (int q = 0; q < NQ; q++)
+               {
+                  for (int k = 0; k < dim; k++)
+                  {
+                     for (int c = 0; c < sdim; c++)
+                     {
+                        Jq(c,k) = Je[q+NQ*(c+sdim*k)];
+                     }
+                  }
+                  StoreJacobianFactors(Jq, q, NQ, flags, Jinv,
+                                       detJ.GetData() + NQ*e,
+                                       InvJ.GetData() + NQ*dim*sdim*e);
+               }
+            }
+         }
+      }
+   }
+}
+
+const BoundingBoxTree &Mesh::GetBoundingBoxTree()
+{
+   if (bbox_tree == NULL)
+   {
+      bbox_tree = new BoundingBoxTree(*this);
+   }
+   else
+   {
+      bbox_tree->Update();
+   }
+   return *bbox_tree;
+}
+
+const GeometricFactors *Mesh::GetGeometricFactors(const IntegrationRule &ir,
+                                                  const int flags)
+{
+   for (int i = 0; i < geom_factors.Size(); i++)
+   {
+      GeometricFactors *gf = geom_factors[i];
+      // The rules are compared by value: a rule at the address of a deleted
+      // one may be different.
+      if (!gf->IntRule->SameAs(ir, Dim)) { continue; }
+      if (gf->sequence != sequence)
+      {
+         // Keep the factors that earlier callers may use
+         gf->Compute(gf->computed_factors | flags);
+      }
+      else if ((gf->computed_factors & flags) != flags)
+      {
+         gf->Compute(gf->computed_factors | flags);
+      }
+      return gf;
+   }
+   GeometricFactors *gf = new GeometricFactors(this, ir, flags);
+   geom_factors.Append(gf);
+   return gf;
+}
+
+void Mesh::DeleteGeometricFactors()
+{
+   for (int i = 0; i < geom_factors.Size(); i++)
+   {
+      delete geom_factors[i];
+   }
+   geom_factors.SetSize(0);
+   coords_sequence++;
+}
+
 int Mesh::FindPoints(DenseMatrix &point_mat, Array<int>& elem_ids,
                      Array<IntegrationPoint>& ips, bool warn,
                      InverseElementTransformation *inv_trans)
@@ -9289,73 +9566,27 @@ int Mesh::FindPoints(DenseMatrix &point_mat, Array<int>& elem_ids,
    InverseElementTransformation *inv_tr = inv_trans;
    inv_tr = inv_tr ? inv_tr : new InverseElementTransformation;
 
-   // For each point in 'point_mat', find the element whose center is closest.
-   Vector min_dist(npts);
-   Array<int> e_idx(npts);
-   min_dist = std::numeric_limits<double>::max();
-   e_idx = -1;
-
-   Vector pt(spaceDim);
-   for (int i = 0; i < GetNE(); i++)
-   {
-      GetElementTransformation(i)->Transform(
-         Geometries.GetCenter(GetElementBaseGeometry(i)), pt);
-      for (int k = 0; k < npts; k++)
-      {
-         double dist = pt.DistanceTo(data+k*spaceDim);
-         if (dist < min_dist(k))
-         {
-            min_dist(k) = dist;
-            e_idx[k] = i;
-         }
-      }
-   }
-
-   // Checks if the points lie in the closest element
+   // For each point in 'point_mat', try the elements whose bounding boxes
+   // contain the point.
+   const BoundingBoxTree &tree = GetBoundingBoxTree();
+   Array<int> candidates;
+   Vector pt(NULL, spaceDim);
    int pts_found = 0;
-   pt.NewDataAndSize(NULL, spaceDim);
    for (int k = 0; k < npts; k++)
    {
       pt.SetData(data+k*spaceDim);
-      inv_tr->SetTransformation(*GetElementTransformation(e_idx[k]));
-      int res = inv_tr->Transform(pt, ips[k]);
-      if (res == InverseElementTransformation::Inside)
+      tree.FindCandidates(pt.GetData(), candidates);
+      for (int j = 0; j < candidates.Size(); j++)
       {
-         elem_ids[k] = e_idx[k];
-         pts_found++;
-      }
-   }
-   if (pts_found != npts)
-   {
-      Array<int> vertices;
-      Table *vtoel = GetVertexToElementTable();
-      for (int k = 0; k < npts; k++)
-      {
-         if (elem_ids[k] != -1) { continue; }
-         // Try all vertex-neighbors of element e_idx[k]
-         pt.SetData(data+k*spaceDim);
-         GetElementVertices(e_idx[k], vertices);
-         for (int v = 0; v < vertices.Size(); v++)
+         inv_tr->SetTransformation(*GetElementTransformation(candidates[j]));
+         int res = inv_tr->Transform(pt, ips[k]);
+         if (res == InverseElementTransformation::Inside)
          {
-            int vv = vertices[v];
-            int ne = vtoel->RowSize(vv);
-            const int* els = vtoel->GetRow(vv);
-            for (int e = 0; e < ne; e++)
-            {
-               if (els[e] == e_idx[k]) { continue; }
-               inv_tr->SetTransformation(*GetElementTransformation(els[e]));
-               int res = inv_tr->Transform(pt, ips[k]);
-               if (res == InverseElementTransformation::Inside)
-               {
-                  elem_ids[k] = els[e];
-                  pts_found++;
-                  goto next_point;
-               }
-            }
+            elem_ids[k] = candidates[j];
+            pts_found++;
+            break;
          }
-      next_point: ;
       }
-      delete vtoel;
    }
    if (inv_trans == NULL) { delete inv_tr; }
 
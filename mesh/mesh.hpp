@@ -33,6 +33,8 @@ class KnotVector;
 class NURBSExtension;
 class FiniteElementSpace;
 class GridFunction;
+class BoundingBoxTree;
+class GeometricFactors;
 struct Refinement;
 
 #ifdef MFEM_USE_MPI
@@ -185,6 +187,14 @@ public:
 protected:
    Operation last_operation;
 
+   /// Bounding box tree of the elements, built on demand. Owned.
+   BoundingBoxTree *bbox_tree;
+   /// Counter of the changes of the coordinates, see DeleteGeometricFactors().
+   long coords_sequence;
+
+   /// Geometric factors computed by GetGeometricFactors(). Owned.
+   Array<GeometricFactors*> geom_factors;
+
    void Init();
    void InitTables();
    void SetEmpty();  // Init all data members with empty values
@@ -1114,6 +1124,10 @@ public:
        Update() calls. */
    long GetSequence() const { return sequence; }
 
+   /** Return the coordinates counter. The counter is incremented each time the
+       vertex or node coordinates change, see DeleteGeometricFactors(). */
+   long GetCoordinatesSequence() const { return coords_sequence; }
+
    /// Print the mesh to the given stream using Netgen/Truegrid format.
    virtual void PrintXG(std::ostream &out = mfem::out) const;
 
@@ -1205,6 +1219,32 @@ public:
 
    void MesquiteSmooth(const int mesquite_option = 0);
 
+   /** @brief Return a bounding box tree of the mesh elements, see class
+       BoundingBoxTree.
+
+       The tree is constructed on the first call. On subsequent calls it is
+       updated with BoundingBoxTree::Update(), i.e. the element boxes are
+       recomputed if the vertex or node coordinates changed (see
+       GetCoordinatesSequence()), and the whole tree is rebuilt if the mesh was
+       refined, derefined, etc. */
+   const BoundingBoxTree &GetBoundingBoxTree();
+
+   /** @brief Return the geometric factors of all elements at the points of
+       the IntegrationRule @a ir, see class GeometricFactors. */
+   /** The @a flags are a bitwise or of GeometricFactors::FactorFlags. The
+       returned object is owned by the Mesh and is reused in subsequent calls
+       with a rule that has the same points and weights as @a ir. It is
+       deleted when the mesh is refined or when the
+       vertices/nodes are changed through the Mesh methods, e.g. MoveNodes(),
+       SetNodes(), or NewNodes(). After modifying the GridFunction returned by
+       GetNodes() directly, call DeleteGeometricFactors(). */
+   const GeometricFactors *GetGeometricFactors(const IntegrationRule &ir,
+                                               const int flags);
+
+   /** @brief Delete the objects created by GetGeometricFactors() and
+       increment the coordinates counter, see GetCoordinatesSequence(). */
+   void DeleteGeometricFactors();
+
    /** @brief Find the ids of the elements that contain the given points, and
        their corresponding reference coordinates.
 
@@ -1226,6 +1266,9 @@ public:
        non-negative number; the other ranks will set their elem_ids[i] to -2 to
        indicate that the point was found but assigned to another rank.
 
+       The candidate elements for each point are the ones whose bounding boxes
+       contain the point, see GetBoundingBoxTree().
+
        @returns The total number of points that were found.
 
        @note This method is not 100 percent reliable, i.e. it is not guaranteed
@@ -1243,6 +1286,63 @@ public:
 std::ostream &operator<<(std::ostream &out, const Mesh &mesh);
 
 
+/** @brief Structure for storing the coordinates, Jacobians, inverse Jacobians
+    and Jacobian determinants of the element transformations of a Mesh at the
+    points of an IntegrationRule, for all elements. */
+/** The factors are computed in one pass over the elements by contracting the
+    element vertex or node coordinates with the DofToQuad matrices of the
+    nodal FiniteElement, instead of evaluating the ElementTransformation point
+    by point. All elements must have the geometry of the IntegrationRule.
+    Objects of this type are created and owned by the Mesh, see
+    Mesh::GetGeometricFactors(). */
+class GeometricFactors
+{
+protected:
+   friend class Mesh;
+
+   /** Copy of the IntegrationRule given to the constructor, so that the
+       factors do not depend on the lifetime of the user's rule. */
+   IntegrationRule int_rule;
+
+   /// (Re)compute the factors given by @a flags.
+   void Compute(int flags);
+
+public:
+   Mesh *mesh;
+   /// The IntegrationRule of the factors, a copy owned by this object.
+   const IntegrationRule *IntRule;
+   /// The factors that have been computed, see FactorFlags.
+   int computed_factors;
+   /// The Mesh::GetSequence() for which the factors were computed.
+   long sequence;
+
+   enum FactorFlags
+   {
+      COORDINATES   = 1 << 0,
+      JACOBIANS     = 1 << 1,
+      DETERMINANTS  = 1 << 2,
+      INV_JACOBIANS = 1 << 3
+   };
+
+   /// Compute the factors given by @a flags, see FactorFlags.
+   GeometricFactors(Mesh *mesh, const IntegrationRule &ir, int flags);
+
+   /// Physical coordinates of the points, layout NQ x SDIM x NE.
+   Vector X;
+
+   /// Jacobians of the element transformations, layout NQ x SDIM x DIM x NE.
+   Vector J;
+
+   /** @brief Inverse Jacobians, layout NQ x DIM x SDIM x NE. For SDIM > DIM,
+       this is the left inverse (J^t J)^{-1} J^t. */
+   Vector InvJ;
+
+   /** @brief Jacobian determinants, layout NQ x NE. For SDIM > DIM, this is
+       sqrt(det(J^t J)), as ElementTransformation::Weight(). */
+   Vector detJ;
+};
+
+
 /// Class used to extrude the nodes of a mesh
 class NodeExtrudeCoefficient : public VectorCoefficient
 {
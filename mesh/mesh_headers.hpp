@@ -25,6 +25,7 @@
 #include "ncmesh.hpp"
 #include "mesh.hpp"
 #include "mesh_operators.hpp"
+#include "bbox_tree.hpp"
 #include "nurbs.hpp"
 #include "wedge.hpp"
 
@@ -1587,6 +1587,7 @@ void ParMesh::GetFaceNbrElementTransformation(
 
    ElTr->Attribute = elem->GetAttribute();
    ElTr->ElementNo = NumOfElements + i;
+   ElTr->mesh = this;
 
    if (Nodes == NULL)
    {
@@ -17,6 +17,7 @@
 #include "linalg/tlayout.hpp"
 #include "linalg/tmatrix.hpp"
 #include "linalg/ttensor.hpp"
+#include "linalg/simd.hpp"
 #include "mesh/tmesh.hpp"
 #include "fem/tintrules.hpp"
 #include "fem/tfe.hpp"
@@ -0,0 +1,414 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#include "mfem.hpp"
+#include "catch.hpp"
+
+using namespace mfem;
+
+namespace assembly
+{
+
+double coeff(const Vector &x)
+{
+   return 1.0 + x(0)*x(1);
+}
+
+TEST_CASE("Element coloring of FiniteElementSpace", "[Assembly]")
+{
+   for (int dim = 2; dim <= 3; dim++)
+   {
+      Mesh *mesh = (dim == 2) ?
+                   new Mesh(4, 4, Element::TRIANGLE, 1) :
+                   new Mesh(3, 3, 3, Element::HEXAHEDRON, 1);
+      H1_FECollection fec(2, dim);
+      FiniteElementSpace fes(mesh, &fec);
+
+      Array<int> colors;
+      fes.GetElementColoring(colors);
+      REQUIRE(colors.Size() == mesh->GetNE());
+      REQUIRE(colors.Min() == 0);
+
+      // No dof is shared by two elements of the same color
+      Array<int> dofs, dof_color(fes.GetNDofs());
+      bool conflict = false;
+      for (int c = 0; c <= colors.Max(); c++)
+      {
+         dof_color = 0;
+         for (int i = 0; i < mesh->GetNE(); i++)
+         {
+            if (colors[i] != c) { continue; }
+            fes.GetElementDofs(i, dofs);
+            for (int j = 0; j < dofs.Size(); j++)
+            {
+               if (dof_color[dofs[j]]++) { conflict = true; }
+            }
+         }
+      }
+      REQUIRE(!conflict);
+      delete mesh;
+   }
+}
+
+TEST_CASE("Assembly with precomputed sparsity", "[Assembly]")
+{
+   FunctionCoefficient q(coeff);
+   ConstantCoefficient one(1.0);
+   Mesh mesh(3, 3, Element::QUADRILATERAL, 1);
+   H1_FECollection fec(2, 2);
+
+   for (int ordering = Ordering::byNODES; ordering <= Ordering::byVDIM;
+        ordering++)
+   {
+      FiniteElementSpace fes(&mesh, &fec, 2, ordering);
+
+      // a1 assembles into linked-list rows, a2 into the precomputed pattern
+      // (the default)
+      BilinearForm a1(&fes), a2(&fes);
+      a1.UsePrecomputedSparsity(0);
+      a1.AddDomainIntegrator(new ElasticityIntegrator(one, q));
+      a1.AddDomainIntegrator(new VectorMassIntegrator(q));
+      a1.AddBoundaryIntegrator(new VectorMassIntegrator);
+      a1.Assemble();
+      REQUIRE(!a1.SpMat().Finalized());
+      a1.Finalize();
+
+      a2.AddDomainIntegrator(new ElasticityIntegrator(one, q));
+      a2.AddDomainIntegrator(new VectorMassIntegrator(q));
+      a2.AddBoundaryIntegrator(new VectorMassIntegrator);
+      a2.Assemble();
+      REQUIRE(a2.SpMat().Finalized());
+      a2.Finalize();
+
+      Vector x(fes.GetVSize()), y1(fes.GetVSize()), y2(fes.GetVSize());
+      x.Randomize(1);
+      a1.Mult(x, y1);
+      a2.Mult(x, y2);
+      y2 -= y1;
+      REQUIRE(y2.Normlinf() < 1e-12*y1.Normlinf());
+   }
+}
+
+TEST_CASE("Colored assembly of BilinearForm", "[Assembly]")
+{
+   FunctionCoefficient q(coeff);
+   ConstantCoefficient one(1.0);
+   for (int dim = 2; dim <= 3; dim++)
+   {
+      Mesh *mesh = (dim == 2) ?
+                   new Mesh(4, 3, Element::TRIANGLE, 1) :
+                   new Mesh(2, 2, 2, Element::TETRAHEDRON, 1);
+      H1_FECollection fec(2, dim);
+      FiniteElementSpace fes(mesh, &fec, dim);
+
+      // a1 assembles element by element, a2 by colors (also without OpenMP)
+      BilinearForm a1(&fes), a2(&fes);
+      a1.UseColoredAssembly(0);
+      a2.UseColoredAssembly(1);
+      BilinearForm *forms[] = { &a1, &a2 };
+      for (int k = 0; k < 2; k++)
+      {
+         forms[k]->AddDomainIntegrator(new ElasticityIntegrator(one, q));
+         forms[k]->AddDomainIntegrator(new VectorMassIntegrator(q));
+         forms[k]->AddBoundaryIntegrator(new VectorMassIntegrator);
+         forms[k]->Assemble();
+         forms[k]->Finalize();
+      }
+
+      Vector x(fes.GetVSize()), y1(fes.GetVSize()), y2(fes.GetVSize());
+      x.Randomize(1);
+      a1.Mult(x, y1);
+      a2.Mult(x, y2);
+      y2 -= y1;
+      REQUIRE(y2.Normlinf() < 1e-12*y1.Normlinf());
+      delete mesh;
+   }
+}
+
+TEST_CASE("Assembly of face integrators with precomputed sparsity",
+          "[Assembly]")
+{
+   FunctionCoefficient q(coeff);
+   ConstantCoefficient one(1.0);
+   Mesh mesh(4, 3, Element::TRIANGLE, 1);
+   DG_FECollection fec(2, 2);
+   FiniteElementSpace fes(&mesh, &fec);
+
+   BilinearForm a1(&fes), a2(&fes);
+   a1.UsePrecomputedSparsity(0);
+   BilinearForm *forms[] = { &a1, &a2 };
+   for (int k = 0; k < 2; k++)
+   {
+      forms[k]->AddDomainIntegrator(new DiffusionIntegrator(q));
+      forms[k]->AddInteriorFaceIntegrator(
+         new DGDiffusionIntegrator(one, -1.0, 2.0));
+      forms[k]->AddBdrFaceIntegrator(new DGDiffusionIntegrator(one, -1.0, 2.0));
+      forms[k]->Assemble();
+      forms[k]->Finalize();
+   }
+
+   // The precomputed pattern couples the elements sharing a face
+   REQUIRE(a2.SpMat().NumNonZeroElems() >= a1.SpMat().NumNonZeroElems());
+   Vector x(fes.GetVSize()), y1(fes.GetVSize()), y2(fes.GetVSize());
+   x.Randomize(1);
+   a1.Mult(x, y1);
+   a2.Mult(x, y2);
+   y2 -= y1;
+   REQUIRE(y2.Normlinf() < 1e-12*y1.Normlinf());
+}
+
+TEST_CASE("SparseMatrix AddSubMatrixThreadSafe", "[Assembly]")
+{
+   const int n = 6;
+   SparseMatrix A(n), B(n);
+   for (int i = 0; i < n; i++)
+   {
+      for (int j = 0; j < n; j++)
+      {
+         if ((i+j) % 2 == 0) { A.Set(i, j, 1.0); }
+      }
+   }
+   A.Finalize();
+   B = A;
+
+   Array<int> rows(3), cols(3);
+   rows[0] = 4; rows[1] = -1-0; rows[2] = 2;
+   cols[0] = 2; cols[1] = 0; cols[2] = -1-4;
+   DenseMatrix subm(3);
+   for (int i = 0; i < 3; i++)
+   {
+      for (int j = 0; j < 3; j++)
+      {
+         subm(i,j) = 1.0 + i + 3*j;
+      }
+   }
+   A.AddSubMatrix(rows, cols, subm);
+   B.AddSubMatrixThreadSafe(rows, cols, subm);
+
+   DenseMatrix *Ad = A.ToDenseMatrix(), *Bd = B.ToDenseMatrix();
+   *Bd -= *Ad;
+   REQUIRE(Bd->MaxMaxNorm() == 0.0);
+   delete Ad;
+   delete Bd;
+}
+
+
+void perturb(const Vector &x, Vector &y)
+{
+   y = x;
+   y(0) += 0.1*x(0)*x(1);
+   y(1) += 0.05*x(0)*x(0);
+}
+
+TEST_CASE("Assembly with the registered templated kernels", "[Assembly]")
+{
+   ConstantCoefficient two(2.0);
+   for (int dim = 2; dim <= 3; dim++)
+   {
+      for (int mesh_order = 1; mesh_order <= 2; mesh_order++)
+      {
+         // More elements than one batch of BilinearForm::Assemble() in 2D
+         Mesh *mesh = (dim == 2) ?
+                      new Mesh(9, 9, Element::QUADRILATERAL, 1) :
+                      new Mesh(2, 2, 2, Element::HEXAHEDRON, 1);
+         if (mesh_order > 1)
+         {
+            // The templated kernels require byNODES ordering of the nodes
+            mesh->SetCurvature(mesh_order, false, -1, Ordering::byNODES);
+            mesh->Transform(perturb);
+         }
+         H1_FECollection fec(2, dim);
+         FiniteElementSpace fes(mesh, &fec);
+
+         Array<BilinearFormIntegrator*> integs;
+         integs.Append(new MassIntegrator(two));
+         integs.Append(new DiffusionIntegrator);
+         DenseTensor *elmats =
+            TBilinearFormKernels::ComputeElementMatrices(fes, integs);
+         REQUIRE(elmats != NULL);
+         delete elmats;
+
+         BilinearForm a1(&fes), a2(&fes);
+         for (int k = 0; k < integs.Size(); k++)
+         {
+            a1.AddDomainIntegrator(integs[k]);
+         }
+         a1.Assemble();
+         a1.Finalize();
+
+         a2.UseTemplatedKernels(0);
+         a2.AddDomainIntegrator(new MassIntegrator(two));
+         a2.AddDomainIntegrator(new DiffusionIntegrator);
+         a2.Assemble();
+         a2.Finalize();
+
+         Vector x(fes.GetVSize()), y1(fes.GetVSize()), y2(fes.GetVSize());
+         x.Randomize(1);
+         a1.Mult(x, y1);
+         a2.Mult(x, y2);
+         y2 -= y1;
+         REQUIRE(y2.Normlinf() < 1e-12*y1.Normlinf());
+         delete mesh;
+      }
+   }
+
+   // No registered kernel for non-constant coefficients
+   Mesh mesh(3, 3, Element::QUADRILATERAL, 1);
+   H1_FECollection fec(2, 2);
+   FiniteElementSpace fes(&mesh, &fec);
+   FunctionCoefficient q(coeff);
+   Array<BilinearFormIntegrator*> integs;
+   integs.Append(new MassIntegrator(q));
+   REQUIRE(TBilinearFormKernels::ComputeElementMatrices(fes, integs) == NULL);
+   delete integs[0];
+}
+
+void velocity(const Vector &x, Vector &v)
+{
+   v(0) = 1.0 + x(1);
+   v(1) = 0.5 - x(0);
+   if (x.Size() == 3) { v(2) = 0.3 + x(0)*x(1); }
+}
+
+// Cartesian mesh with perturbed vertices, where every other element is
+// rotated, so that the neighbors of a face have various orientations.
+Mesh *MakeTwistedMesh(int dim, int n)
+{
+   Mesh *cart = (dim == 2) ?
+                new Mesh(n, n, Element::QUADRILATERAL, 1) :
+                new Mesh(n, n, n, Element::HEXAHEDRON, 1);
+   const int nv = cart->GetNV();
+   Mesh *mesh = new Mesh(dim, nv, cart->GetNE(), cart->GetNBE());
+   for (int i = 0; i < nv; i++)
+   {
+      const double *v = cart->GetVertex(i);
+      double x[3];
+      for (int d = 0; d < dim; d++)
+      {
+         x[d] = v[d] + 0.1*std::sin(3.0*v[(d+1)%dim] + d)*v[d]*(1.0-v[d]);
+      }
+      mesh->AddVertex(x);
+   }
+   // Reference coordinates of the vertices of the quad/hex
+   const int nve = (dim == 2) ? 4 : 8;
+   const int pos[8][3] = {{0,0,0},{1,0,0},{1,1,0},{0,1,0},
+      {0,0,1},{1,0,1},{1,1,1},{0,1,1}
+   };
+   for (int e = 0; e < cart->GetNE(); e++)
+   {
+      const int *ev = cart->GetElement(e)->GetVertices();
+      int rv[8];
+      for (int i = 0; i < nve; i++)
+      {
+         // Rotations of the reference element: about z for even elements
+         // and about x for the others (identity in 2D)
+         int q[3] = { pos[i][0], pos[i][1], pos[i][2] };
+         if (e % 2 == 0) { q[0] = 1-pos[i][1]; q[1] = pos[i][0]; }
+         else if (dim == 3) { q[1] = 1-pos[i][2]; q[2] = pos[i][1]; }
+         for (int j = 0; j < nve; j++)
+         {
+            if (pos[j][0] == q[0] && pos[j][1] == q[1] && pos[j][2] == q[2])
+            {
+               rv[i] = ev[j];
+            }
+         }
+      }
+      if (dim == 2) { mesh->AddQuad(rv, 1); }
+      else { mesh->AddHex(rv, 1); }
+   }
+   for (int be = 0; be < cart->GetNBE(); be++)
+   {
+      const int *bv = cart->GetBdrElement(be)->GetVertices();
+      const int attr = cart->GetBdrAttribute(be);
+      if (dim == 2) { mesh->AddBdrSegment(bv, attr); }
+      else { mesh->AddBdrQuad(bv, attr); }
+   }
+   if (dim == 2) { mesh->FinalizeQuadMesh(1, 1, true); }
+   else { mesh->FinalizeHexMesh(1, 1, true); }
+   delete cart;
+   return mesh;
+}
+
+TEST_CASE("Batched assembly of DG face integrators", "[Assembly]")
+{
+   FunctionCoefficient q(coeff);
+   ConstantCoefficient rho(0.7);
+   VectorFunctionCoefficient u2(2, velocity), u3(3, velocity);
+   for (int dim = 2; dim <= 3; dim++)
+   {
+      VectorCoefficient &u = (dim == 2) ? (VectorCoefficient&)u2 : u3;
+      for (int btype = 0; btype < 2; btype++)
+      {
+         Mesh *mesh = MakeTwistedMesh(dim, 3);
+         mesh->SetCurvature(2);
+         Array<int> bdr_marker(mesh->bdr_attributes.Max());
+         bdr_marker = 0;
+         bdr_marker[0] = 1;
+         const int basis = (btype == 0) ? BasisType::GaussLobatto :
+                           BasisType::GaussLegendre;
+         L2_FECollection fec(2, dim, basis);
+         FiniteElementSpace fes(mesh, &fec);
+
+         BilinearForm *a[3];
+         for (int k = 0; k < 3; k++)
+         {
+            a[k] = new BilinearForm(&fes);
+            a[k]->AddDomainIntegrator(new DiffusionIntegrator(q));
+            a[k]->AddInteriorFaceIntegrator(
+               new DGTraceIntegrator(u, 1.0, -0.5));
+            a[k]->AddBdrFaceIntegrator(
+               new DGTraceIntegrator(rho, u, 1.0, -0.5));
+            a[k]->AddInteriorFaceIntegrator(
+               new DGDiffusionIntegrator(q, -1.0, 4.0));
+            a[k]->AddBdrFaceIntegrator(
+               new DGDiffusionIntegrator(q, 1.0, 2.0), bdr_marker);
+         }
+         a[0]->UseBatchedFaceAssembly(0);
+         a[2]->SetAssemblyLevel(AssemblyLevel::PARTIAL);
+
+         // The second pass curves the mesh: the forms must not reuse the
+         // geometry of the first one
+         for (int pass = 0; pass < 2; pass++)
+         {
+            if (pass == 1)
+            {
+               mesh->Transform(perturb);
+               *a[0] = 0.0;
+               *a[1] = 0.0;
+            }
+            for (int k = 0; k < 3; k++)
+            {
+               a[k]->Assemble();
+               if (k < 2) { a[k]->Finalize(); }
+            }
+
+            Vector x(fes.GetVSize()), y0(fes.GetVSize()), y(fes.GetVSize());
+            x.Randomize(1);
+            for (int transp = 0; transp < 2; transp++)
+            {
+               if (transp) { a[0]->MultTranspose(x, y0); }
+               else { a[0]->Mult(x, y0); }
+               for (int k = 1; k < 3; k++)
+               {
+                  if (transp) { a[k]->MultTranspose(x, y); }
+                  else { a[k]->Mult(x, y); }
+                  y -= y0;
+                  REQUIRE(y.Normlinf() < 1e-12*y0.Normlinf());
+               }
+            }
+         }
+         for (int k = 0; k < 3; k++) { delete a[k]; }
+         delete mesh;
+      }
+   }
+}
+
+}
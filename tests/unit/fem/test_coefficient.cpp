@@ -0,0 +1,221 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#include "mfem.hpp"
+#include "catch.hpp"
+
+using namespace mfem;
+
+namespace coefficient
+{
+
+double kappa(const Vector &x)
+{
+   return 1.0 + x(0)*x(0) + 0.5*sin(x(1));
+}
+
+void kappa_mat(const Vector &x, DenseMatrix &K)
+{
+   K(0,0) = 2.0 + x(0);
+   K(0,1) = K(1,0) = 0.5*x(1);
+   K(1,1) = 1.0 + x(0)*x(1);
+}
+
+// Coefficient that counts its pointwise evaluations
+class CountingCoefficient : public FunctionCoefficient
+{
+public:
+   int count;
+   CountingCoefficient() : FunctionCoefficient(kappa), count(0) { }
+   virtual double Eval(ElementTransformation &T, const IntegrationPoint &ip)
+   {
+      count++;
+      return FunctionCoefficient::Eval(T, ip);
+   }
+};
+
+class CountingMatrixCoefficient : public MatrixFunctionCoefficient
+{
+public:
+   int count;
+   CountingMatrixCoefficient()
+      : MatrixFunctionCoefficient(2, kappa_mat), count(0) { }
+   virtual void Eval(DenseMatrix &K, ElementTransformation &T,
+                     const IntegrationPoint &ip)
+   {
+      count++;
+      MatrixFunctionCoefficient::Eval(K, T, ip);
+   }
+};
+
+double MatrixDifference(BilinearForm &a, BilinearForm &b)
+{
+   SparseMatrix diff(a.SpMat());
+   diff.Add(-1.0, b.SpMat());
+   return diff.MaxNorm();
+}
+
+TEST_CASE("CachedCoefficient", "[Coefficient]")
+{
+   Mesh mesh(4, 4, Element::QUADRILATERAL, 1, 1.0, 1.0);
+   H1_FECollection fec(2, 2);
+   FiniteElementSpace fes(&mesh, &fec);
+   CountingCoefficient q;
+   CountingMatrixCoefficient mq;
+   CachedCoefficient cq(q, mesh);
+   CachedMatrixCoefficient cmq(mq, mesh);
+
+   BilinearForm ref(&fes);
+   ref.AddDomainIntegrator(new MassIntegrator(q));
+   ref.AddDomainIntegrator(new DiffusionIntegrator(mq));
+   ref.Assemble();
+   ref.Finalize();
+   const int count = q.count, mcount = mq.count;
+   REQUIRE(count > 0);
+   REQUIRE(mcount > 0);
+
+   BilinearForm a(&fes);
+   a.AddDomainIntegrator(new MassIntegrator(cq));
+   a.AddDomainIntegrator(new DiffusionIntegrator(cmq));
+   for (int k = 0; k < 3; k++)
+   {
+      a.Update();
+      a.Assemble();
+      a.Finalize();
+      REQUIRE(MatrixDifference(a, ref) == 0.0);
+      // The coefficients are only evaluated in the first assembly
+      REQUIRE(q.count == 2*count);
+      REQUIRE(mq.count == 2*mcount);
+   }
+
+   SECTION("Partial assembly")
+   {
+      BilinearForm pa(&fes);
+      pa.SetAssemblyLevel(AssemblyLevel::PARTIAL);
+      pa.AddDomainIntegrator(new MassIntegrator(cq));
+      pa.Assemble();
+      pa.Assemble();
+      REQUIRE(q.count == 2*count);
+
+      Vector x(fes.GetVSize()), y(fes.GetVSize()), z(fes.GetVSize());
+      x.Randomize(1);
+      pa.Mult(x, y);
+      BilinearForm mass(&fes);
+      mass.AddDomainIntegrator(new MassIntegrator(q));
+      mass.Assemble();
+      mass.Finalize();
+      mass.Mult(x, z);
+      z -= y;
+      REQUIRE(z.Normlinf() < 1e-12);
+   }
+
+   SECTION("Rules are identified by their points and weights")
+   {
+      const IntegrationRule &ir = IntRules.Get(Geometry::SQUARE, 7);
+      const IntegrationRule ir_copy(ir);
+      ElementTransformation &T = *mesh.GetElementTransformation(0);
+      Vector V1, V2;
+      cq.Eval(V1, T, ir);
+      REQUIRE(q.count == 2*count + ir.GetNPoints());
+      cq.Eval(V2, T, ir_copy);
+      REQUIRE(q.count == 2*count + ir.GetNPoints());
+      V2 -= V1;
+      REQUIRE(V2.Normlinf() == 0.0);
+
+      // Different user rules with the same number of points
+      IntegrationRule a(1), b(1);
+      a.IntPoint(0).Set2w(0.25, 0.25, 1.0);
+      b.IntPoint(0).Set2w(0.75, 0.25, 1.0);
+      cq.Eval(V1, T, a);
+      cq.Eval(V2, T, b);
+      T.SetIntPoint(&b.IntPoint(0));
+      REQUIRE(V2(0) == q.FunctionCoefficient::Eval(T, b.IntPoint(0)));
+      REQUIRE(V1(0) != V2(0));
+      const int ab_count = q.count;
+
+      // Transformations of other meshes are not cached
+      Mesh mesh2(4, 4, Element::QUADRILATERAL, 1, 2.0, 2.0);
+      ElementTransformation &T2 = *mesh2.GetElementTransformation(0);
+      cq.Eval(V2, T2, ir);
+      cq.Eval(V2, T2, ir);
+      REQUIRE(q.count == ab_count + 2*ir.GetNPoints());
+   }
+
+   SECTION("Mesh refinement resets the cache")
+   {
+      mesh.UniformRefinement();
+      fes.Update();
+      a.Update();
+      a.Assemble();
+      REQUIRE(q.count == 2*count + 4*count);
+   }
+}
+
+TEST_CASE("QuadratureFunctionCoefficient", "[Coefficient]")
+{
+   Mesh mesh(3, 3, 3, Element::HEXAHEDRON, 1, 1.0, 1.0, 1.0);
+   H1_FECollection fec(2, 3);
+   FiniteElementSpace fes(&mesh, &fec);
+   FunctionCoefficient f(kappa);
+   Coefficient &coeff = f;
+
+   QuadratureSpace qspace(&mesh, 5);
+   QuadratureFunction qf(&qspace);
+   Vector values, f_values;
+   for (int e = 0; e < mesh.GetNE(); e++)
+   {
+      ElementTransformation &T = *mesh.GetElementTransformation(e);
+      coeff.Eval(f_values, T, qspace.GetElementIntRule(e));
+      qf.GetElementValues(e, values);
+      values = f_values;
+   }
+   QuadratureFunctionCoefficient qfc(qf);
+   const IntegrationRule &ir = qfc.GetIntRule();
+
+   // Pointwise evaluation
+   ElementTransformation &T = *mesh.GetElementTransformation(1);
+   for (int i = 0; i < ir.GetNPoints(); i++)
+   {
+      const IntegrationPoint &ip = ir.IntPoint(i);
+      T.SetIntPoint(&ip);
+      REQUIRE(qfc.Eval(T, ip) == f.Eval(T, ip));
+      // Copies of the points are found from their coordinates
+      const IntegrationPoint ip_copy = ip;
+      REQUIRE(qfc.Eval(T, ip_copy) == f.Eval(T, ip));
+   }
+
+   BilinearForm a(&fes), b(&fes);
+   MassIntegrator *mi = new MassIntegrator(qfc);
+   mi->SetIntRule(&ir);
+   a.AddDomainIntegrator(mi);
+   a.Assemble();
+   a.Finalize();
+   mi = new MassIntegrator(f);
+   mi->SetIntRule(&ir);
+   b.AddDomainIntegrator(mi);
+   b.Assemble();
+   b.Finalize();
+   REQUIRE(MatrixDifference(a, b) < 1e-14);
+
+   LinearForm la(&fes), lb(&fes);
+   DomainLFIntegrator *lfi = new DomainLFIntegrator(qfc);
+   lfi->SetIntRule(&ir);
+   la.AddDomainIntegrator(lfi);
+   la.Assemble();
+   lfi = new DomainLFIntegrator(f);
+   lfi->SetIntRule(&ir);
+   lb.AddDomainIntegrator(lfi);
+   lb.Assemble();
+   la -= lb;
+   REQUIRE(la.Normlinf() < 1e-14);
+}
+
+}
@@ -111,3 +111,127 @@ TEST_CASE("L2 Hexahedron Finite Element",
       REQUIRE( fe.GetDerivMapType()   == (int) FiniteElement::H_CURL );
    }
 }
+
+TEST_CASE("DofToQuad values at quadrature points",
+          "[DofToQuad]"
+          "[FiniteElement]")
+{
+   H1_HexahedronElement h1(3);
+   L2_TriangleElement l2(2);
+   ND_HexahedronElement nd(2);
+   RT_TetrahedronElement rt(1);
+   const FiniteElement *fes[] = { &h1, &l2, &nd, &rt };
+
+   for (int f = 0; f < 4; f++)
+   {
+      const FiniteElement &fe = *fes[f];
+      const int dof = fe.GetDof(), dim = fe.GetDim();
+      const IntegrationRule &ir =
+         IntRules.Get(fe.GetGeomType(), 2*fe.GetOrder());
+      const DofToQuad &maps = fe.GetDofToQuad(ir, DofToQuad::FULL);
+      REQUIRE(&fe.GetDofToQuad(ir, DofToQuad::FULL) == &maps);
+      REQUIRE(maps.nqpt == ir.GetNPoints());
+
+      Vector shape(dof), c_shape;
+      DenseMatrix dshape(dof, dim), c_dshape;
+      for (int i = 0; i < ir.GetNPoints(); i++)
+      {
+         const IntegrationPoint &ip = ir.IntPoint(i);
+         if (fe.GetRangeType() == FiniteElement::SCALAR)
+         {
+            fe.CalcShape(ip, shape);
+            maps.GetShape(i, c_shape);
+            c_shape -= shape;
+            REQUIRE(c_shape.Normlinf() == 0.0);
+
+            fe.CalcDShape(ip, dshape);
+            maps.GetDShape(i, c_dshape);
+            c_dshape -= dshape;
+            REQUIRE(c_dshape.MaxMaxNorm() == 0.0);
+         }
+         else
+         {
+            fe.CalcVShape(ip, dshape);
+            maps.GetVShape(i, c_dshape);
+            c_dshape -= dshape;
+            REQUIRE(c_dshape.MaxMaxNorm() == 0.0);
+         }
+      }
+   }
+}
+
+TEST_CASE("DofToQuad of user rules",
+          "[DofToQuad]"
+          "[FiniteElement]")
+{
+   H1_QuadrilateralElement fe(2);
+
+   SECTION("Rules are identified by their points and weights")
+   {
+      IntegrationRule a(1), b(1);
+      a.IntPoint(0).Set2w(0.25, 0.25, 1.0);
+      b.IntPoint(0).Set2w(0.75, 0.25, 1.0);
+      const DofToQuad &maps_a = fe.GetDofToQuad(a, DofToQuad::FULL);
+      const DofToQuad &maps_b = fe.GetDofToQuad(b, DofToQuad::FULL);
+      REQUIRE(&maps_a != &maps_b);
+
+      IntegrationRule a_copy(a);
+      REQUIRE(&fe.GetDofToQuad(a_copy, DofToQuad::FULL) == &maps_a);
+
+      Vector shape(fe.GetDof()), c_shape;
+      fe.CalcShape(b.IntPoint(0), shape);
+      maps_b.GetShape(0, c_shape);
+      c_shape -= shape;
+      REQUIRE(c_shape.Normlinf() == 0.0);
+   }
+
+   SECTION("Deleted rules")
+   {
+      // A new rule may be allocated at the address of a deleted one
+      Mesh mesh(2, 2, Element::QUADRILATERAL, 1);
+      H1_FECollection fec(2, 2);
+      FiniteElementSpace fes(&mesh, &fec);
+      const int orders[] = { 0, 9 };
+      for (int k = 0; k < 2; k++)
+      {
+         IntegrationRule *ir =
+            new IntegrationRule(IntRules.Get(Geometry::SQUARE, orders[k]));
+         BilinearForm m(&fes);
+         MassIntegrator *integ = new MassIntegrator;
+         integ->SetIntRule(ir);
+         m.AddDomainIntegrator(integ);
+         m.Assemble();
+         m.Finalize();
+         const SparseMatrix &M = m.SpMat();
+         double area = 0.0;
+         for (int i = 0; i < M.NumNonZeroElems(); i++)
+         {
+            area += M.GetData()[i];
+         }
+         REQUIRE(fabs(area - 1.0) < 1e-12);
+         delete ir;
+      }
+   }
+}
+
+TEST_CASE("Poly_1D precomputed bases",
+          "[Poly_1D]"
+          "[FiniteElement]")
+{
+   const int p_max = 12;
+   poly1d.Precompute(p_max, BasisType::GaussLobatto);
+   poly1d.Precompute(p_max, BasisType::Positive);
+   for (int p = 1; p <= p_max; p++)
+   {
+      const double *pts = poly1d.ClosedPoints(p, BasisType::GaussLobatto);
+      REQUIRE(pts[0] == 0.0);
+      REQUIRE(pts[p] == 1.0);
+      REQUIRE(&poly1d.GetBasis(p, BasisType::GaussLobatto) ==
+              &poly1d.GetBasis(p, BasisType::GaussLobatto));
+
+      // The nodal basis interpolates at the points
+      Vector u(p + 1);
+      poly1d.GetBasis(p, BasisType::GaussLobatto).Eval(pts[1], u);
+      REQUIRE(fabs(u(1) - 1.0) < 1e-12);
+   }
+}
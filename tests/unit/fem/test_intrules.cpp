@@ -191,3 +191,36 @@ TEST_CASE("Simplex integration rules", "[SimplexRules]")
       }
    }
 }
+
+TEST_CASE("Integration rule container used by many threads",
+          "[IntegrationRules]")
+{
+   IntegrationRules my_intrules(0, Quadrature1D::GaussLegendre);
+   const int geoms[] = { Geometry::SEGMENT, Geometry::TRIANGLE,
+                         Geometry::SQUARE, Geometry::CUBE
+                       };
+   const int max_order = 16;
+   Array<const IntegrationRule *> irs(4*(max_order + 1));
+
+   // The rules are generated by the first thread that needs them
+#ifdef MFEM_USE_OPENMP
+   #pragma omp parallel for schedule(dynamic, 1)
+#endif
+   for (int k = 0; k < irs.Size(); k++)
+   {
+      irs[k] = &my_intrules.Get(geoms[k%4], k/4);
+   }
+
+   for (int k = 0; k < irs.Size(); k++)
+   {
+      REQUIRE(irs[k] == &my_intrules.Get(geoms[k%4], k/4));
+      REQUIRE(irs[k]->GetOrder() >= k/4);
+   }
+
+   my_intrules.Precompute(Geometry::TETRAHEDRON, max_order);
+   const IntegrationRule &ir = my_intrules.Get(Geometry::TETRAHEDRON, 5);
+   REQUIRE(ir.GetOrder() >= 5);
+   double sum = 0.0;
+   for (int i = 0; i < ir.GetNPoints(); i++) { sum += ir.IntPoint(i).weight; }
+   REQUIRE(fabs(sum - 1.0/6.0) < 1e-14);
+}
@@ -0,0 +1,127 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#include "mfem.hpp"
+#include "catch.hpp"
+
+using namespace mfem;
+
+namespace lor
+{
+
+void func(const Vector &x, Vector &y)
+{
+   y.SetSize(2);
+   y(0) = sin(3.0*x(0))*exp(x(1));
+   y(1) = cos(x(0)*x(1)) + x(0);
+}
+
+void twist(const Vector &x, Vector &y)
+{
+   y = x;
+   y(0) += 0.05*sin(3.0*x(1));
+   y(1) += 0.05*cos(2.0*x(0));
+}
+
+// Solve a Poisson problem with the partially assembled operator of the given
+// order and PCG + LORSolver; return the number of iterations.
+int Solve(Mesh &mesh, int order)
+{
+   const int dim = mesh.Dimension();
+   H1_FECollection fec(order, dim);
+   FiniteElementSpace fes(&mesh, &fec);
+
+   Array<int> ess_bdr(mesh.bdr_attributes.Max()), ess_tdof_list;
+   ess_bdr = 1;
+   fes.GetEssentialTrueDofs(ess_bdr, ess_tdof_list);
+
+   ConstantCoefficient one(1.0);
+   BilinearForm a(&fes);
+   a.SetAssemblyLevel(AssemblyLevel::PARTIAL);
+   a.AddDomainIntegrator(new DiffusionIntegrator(one));
+   a.Assemble();
+   LinearForm b(&fes);
+   b.AddDomainIntegrator(new DomainLFIntegrator(one));
+   b.Assemble();
+   GridFunction x(&fes);
+   x = 0.0;
+
+   Operator *A;
+   Vector B, X;
+   a.FormLinearSystem(ess_tdof_list, x, b, A, X, B);
+
+   LORSolver lor(a, ess_tdof_list);
+   REQUIRE(lor.GetFESpace().GetTrueVSize() == fes.GetTrueVSize());
+
+   CGSolver cg;
+   cg.SetRelTol(1e-8);
+   cg.SetMaxIter(200);
+   cg.SetOperator(*A);
+   cg.SetPreconditioner(lor);
+   cg.Mult(B, X);
+   REQUIRE(cg.GetConverged());
+   delete A;
+   return cg.GetNumIterations();
+}
+
+TEST_CASE("LOR dof permutation", "[LORSolver]")
+{
+   for (int dim = 2; dim <= 3; dim++)
+   {
+      Mesh *mesh = (dim == 2) ?
+                   new Mesh(3, 2, Element::QUADRILATERAL, 1, 1.0, 1.0) :
+                   new Mesh(2, 2, 1, Element::HEXAHEDRON, 1, 1.0, 1.0, 1.0);
+      const int order = (dim == 2) ? 4 : 3;
+      H1_FECollection fec(order, dim);
+      FiniteElementSpace fes(mesh, &fec, 2, Ordering::byVDIM);
+      BilinearForm a(&fes);
+      ConstantCoefficient one(1.0);
+      a.AddDomainIntegrator(new VectorMassIntegrator(one));
+      a.Assemble();
+      Array<int> ess_tdof_list;
+      LORSolver lor(a, ess_tdof_list);
+
+      // The nodal values of the high-order and LOR interpolants coincide
+      VectorFunctionCoefficient coeff(2, func);
+      GridFunction x_ho(&fes), x_lor(&lor.GetFESpace());
+      x_ho.ProjectCoefficient(coeff);
+      x_lor.ProjectCoefficient(coeff);
+
+      const Array<int> &perm = lor.GetDofPermutation();
+      REQUIRE(perm.Size() == x_ho.Size());
+      double err = 0.0;
+      for (int i = 0; i < perm.Size(); i++)
+      {
+         err = std::max(err, fabs(x_ho(i) - x_lor(perm[i])));
+      }
+      REQUIRE(err < 1e-12);
+      delete mesh;
+   }
+}
+
+TEST_CASE("LOR preconditioner", "[LORSolver]")
+{
+   // The number of iterations is bounded independently of the order
+   Mesh mesh_2d(4, 4, Element::QUADRILATERAL, 1, 1.0, 1.0);
+   mesh_2d.Transform(twist);
+   for (int order = 2; order <= 6; order += 2)
+   {
+      REQUIRE(Solve(mesh_2d, order) < 35);
+   }
+
+   Mesh mesh_3d(2, 2, 2, Element::HEXAHEDRON, 1, 1.0, 1.0, 1.0);
+   for (int order = 2; order <= 4; order += 2)
+   {
+      REQUIRE(Solve(mesh_3d, order) < 30);
+   }
+}
+
+}
@@ -0,0 +1,296 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#include "mfem.hpp"
+#include "catch.hpp"
+
+using namespace mfem;
+
+namespace multigrid
+{
+
+BilinearForm *MakeForm(FiniteElementSpace &fes, bool elasticity)
+{
+   static ConstantCoefficient one(1.0);
+   BilinearForm *a = new BilinearForm(&fes);
+   if (elasticity)
+   {
+      a->AddDomainIntegrator(new ElasticityIntegrator(one, one));
+   }
+   else
+   {
+      a->AddDomainIntegrator(new DiffusionIntegrator(one));
+   }
+   a->Assemble();
+   return a;
+}
+
+// Solve a Poisson or elasticity problem with PCG + GeometricMultigrid on a
+// hierarchy with the given number of refinements; return the number of
+// iterations.
+int Solve(Mesh &mesh, int order, bool elasticity, int num_refs,
+          bool galerkin, GeometricMultigrid::SmootherType smoother,
+          MultigridSolver::CycleType cycle)
+{
+   const int dim = mesh.Dimension();
+   H1_FECollection fec(order, dim);
+   FiniteElementSpace *coarse_fes =
+      new FiniteElementSpace(&mesh, &fec, elasticity ? dim : 1);
+   FiniteElementSpaceHierarchy hierarchy(&mesh, coarse_fes, false, true);
+   for (int l = 0; l < num_refs; l++)
+   {
+      hierarchy.AddUniformlyRefinedLevel();
+   }
+   REQUIRE(hierarchy.GetNumLevels() == num_refs + 1);
+
+   Array<int> ess_bdr(mesh.bdr_attributes.Max());
+   ess_bdr = 0;
+   ess_bdr[0] = 1;
+
+   Array<BilinearForm*> forms(hierarchy.GetNumLevels());
+   for (int l = 0; l < forms.Size(); l++)
+   {
+      const bool form_needed = !galerkin || l == forms.Size() - 1;
+      forms[l] = form_needed ?
+                 MakeForm(hierarchy.GetFESpaceAtLevel(l), elasticity) : NULL;
+   }
+
+   GeometricMultigrid mg(hierarchy, ess_bdr);
+   mg.SetSmoother(smoother);
+   mg.SetCycleType(cycle);
+   if (galerkin) { mg.FormOperators(*forms.Last()); }
+   else { mg.FormOperators(forms); }
+   REQUIRE(mg.GetNumLevels() == num_refs + 1);
+
+   FiniteElementSpace &fes = hierarchy.GetFinestFESpace();
+   Vector ones(fes.GetVDim());
+   ones = 1.0;
+   VectorConstantCoefficient f(ones);
+   LinearForm b(&fes);
+   b.AddDomainIntegrator(new VectorDomainLFIntegrator(f));
+   b.Assemble();
+   GridFunction x(&fes);
+   x = 0.0;
+
+   SparseMatrix A;
+   Vector B, X;
+   forms.Last()->FormLinearSystem(mg.GetEssentialTrueDofs(), x, b, A, X, B);
+
+   CGSolver cg;
+   cg.SetRelTol(1e-10);
+   cg.SetMaxIter(200);
+   cg.SetOperator(A);
+   cg.SetPreconditioner(mg);
+   cg.Mult(B, X);
+   REQUIRE(cg.GetConverged());
+
+   Vector r(B);
+   A.AddMult(X, r, -1.0);
+   REQUIRE(r.Normlinf() < 1e-8*B.Normlinf());
+
+   for (int l = 0; l < forms.Size(); l++) { delete forms[l]; }
+   return cg.GetNumIterations();
+}
+
+TEST_CASE("GeometricMultigrid", "[Multigrid]")
+{
+   for (int t = 0; t < 2; t++)
+   {
+      const bool galerkin = (t == 0);
+      Mesh mesh(2, 2, Element::QUADRILATERAL, 1);
+
+      SECTION("Poisson")
+      {
+         int it[3];
+         for (int r = 1; r <= 3; r++)
+         {
+            it[r-1] = Solve(mesh, 2, false, r, galerkin,
+                            GeometricMultigrid::GAUSS_SEIDEL,
+                            MultigridSolver::V_CYCLE);
+         }
+         // Mesh-independent iteration counts
+         REQUIRE(it[2] < 20);
+         REQUIRE(it[2] <= it[0] + 2);
+      }
+
+      SECTION("Elasticity")
+      {
+         int it[3];
+         for (int r = 1; r <= 3; r++)
+         {
+            it[r-1] = Solve(mesh, 1, true, r, galerkin,
+                            GeometricMultigrid::JACOBI,
+                            MultigridSolver::W_CYCLE);
+         }
+         REQUIRE(it[2] < 40);
+         REQUIRE(it[2] <= it[0] + 4);
+      }
+   }
+}
+
+TEST_CASE("GeometricMultigrid Galerkin operators", "[Multigrid]")
+{
+   // For nested spaces, the Galerkin and the rediscretized coarse operators
+   // agree on the interior dofs
+   Mesh mesh(3, 3, 3, Element::HEXAHEDRON, 1);
+   H1_FECollection fec(2, 3);
+   FiniteElementSpace coarse_fes(&mesh, &fec);
+   FiniteElementSpaceHierarchy hierarchy(&mesh, &coarse_fes, false, false);
+   hierarchy.AddUniformlyRefinedLevel();
+
+   Array<int> ess_bdr(mesh.bdr_attributes.Max());
+   ess_bdr = 1;
+   BilinearForm *a_coarse = MakeForm(hierarchy.GetFESpaceAtLevel(0), false);
+   BilinearForm *a_fine = MakeForm(hierarchy.GetFESpaceAtLevel(1), false);
+   Array<BilinearForm*> forms(2);
+   forms[0] = a_coarse;
+   forms[1] = a_fine;
+
+   GeometricMultigrid mg_galerkin(hierarchy, ess_bdr);
+   GeometricMultigrid mg_rediscr(hierarchy, ess_bdr);
+   mg_galerkin.FormOperators(*a_fine);
+   mg_rediscr.FormOperators(forms);
+
+   DenseMatrix Ag, Ar;
+   static_cast<SparseMatrix*>(mg_galerkin.GetOperatorAtLevel(0))
+   ->ToDenseMatrix(Ag);
+   static_cast<SparseMatrix*>(mg_rediscr.GetOperatorAtLevel(0))
+   ->ToDenseMatrix(Ar);
+   Ag -= Ar;
+   const Array<int> &ess = mg_galerkin.GetEssentialTrueDofs(0);
+   for (int i = 0; i < ess.Size(); i++) { Ag(ess[i], ess[i]) = 0.0; }
+   REQUIRE(Ag.MaxMaxNorm() < 1e-12*Ar.MaxMaxNorm());
+
+   delete a_coarse;
+   delete a_fine;
+}
+
+double poly(const Vector &x)
+{
+   return 1.0 + 2.0*x(0) - x(1) + x(0)*x(1)*x(1);
+}
+
+TEST_CASE("p-refinement transfer", "[Multigrid]")
+{
+   Mesh mesh(3, 3, Element::QUADRILATERAL, 1);
+   for (int t = 0; t < 2; t++)
+   {
+      FiniteElementCollection *coarse_fec, *fine_fec;
+      if (t == 0)
+      {
+         coarse_fec = new H1_FECollection(3, 2);
+         fine_fec = new H1_FECollection(5, 2);
+      }
+      else
+      {
+         coarse_fec = new L2_FECollection(3, 2);
+         fine_fec = new L2_FECollection(4, 2);
+      }
+      FiniteElementSpace coarse_fes(&mesh, coarse_fec, 2);
+      FiniteElementSpace fine_fes(&mesh, fine_fec, 2);
+
+      OperatorHandle T_op(Operator::ANY_TYPE), T_mat(Operator::MFEM_SPARSEMAT);
+      fine_fes.GetTransferOperator(coarse_fes, T_op);
+      fine_fes.GetTransferOperator(coarse_fes, T_mat);
+      REQUIRE(T_op.Ptr()->Height() == fine_fes.GetVSize());
+      REQUIRE(T_op.Ptr()->Width() == coarse_fes.GetVSize());
+
+      // The transfer is exact for functions in the coarse space
+      FunctionCoefficient c(poly);
+      Array<Coefficient*> coeffs(2);
+      coeffs = &c;
+      GridFunction x_coarse(&coarse_fes), x_fine(&fine_fes), y(&fine_fes);
+      x_coarse.ProjectCoefficient(coeffs);
+      x_fine.ProjectCoefficient(coeffs);
+      T_op.Ptr()->Mult(x_coarse, y);
+      y -= x_fine;
+      REQUIRE(y.Normlinf() < 1e-12);
+
+      // The matrix-free and the assembled transfers agree
+      Vector u(coarse_fes.GetVSize()), v(fine_fes.GetVSize());
+      Vector Tu(v.Size()), Tu_mat(v.Size()), Ttv(u.Size()), Ttv_mat(u.Size());
+      u.Randomize(1);
+      v.Randomize(2);
+      T_op.Ptr()->Mult(u, Tu);
+      T_mat.Ptr()->Mult(u, Tu_mat);
+      T_op.Ptr()->MultTranspose(v, Ttv);
+      T_mat.Ptr()->MultTranspose(v, Ttv_mat);
+      Tu -= Tu_mat;
+      Ttv -= Ttv_mat;
+      REQUIRE(Tu.Normlinf() < 1e-12);
+      REQUIRE(Ttv.Normlinf() < 1e-12);
+
+      delete fine_fec;
+      delete coarse_fec;
+   }
+}
+
+TEST_CASE("p-multigrid", "[Multigrid]")
+{
+   ConstantCoefficient one(1.0);
+   for (int dim = 2; dim <= 3; dim++)
+   {
+      Mesh *mesh = (dim == 2) ? new Mesh(4, 4, Element::QUADRILATERAL, 1) :
+                   new Mesh(2, 2, 2, Element::HEXAHEDRON, 1);
+      H1_FECollection fec(1, dim);
+      FiniteElementSpace *fes = new FiniteElementSpace(mesh, &fec);
+      FiniteElementSpaceHierarchy hierarchy(mesh, fes, true, true);
+      const int max_order = (dim == 2) ? 8 : 4;
+      for (int p = 2; p <= max_order; p *= 2)
+      {
+         hierarchy.AddOrderRefinedLevel(new H1_FECollection(p, dim));
+      }
+
+      // Matrix-free high-order levels, assembled p = 1 level
+      const int num_levels = hierarchy.GetNumLevels();
+      Array<BilinearForm*> forms(num_levels);
+      for (int l = 0; l < num_levels; l++)
+      {
+         forms[l] = new BilinearForm(&hierarchy.GetFESpaceAtLevel(l));
+         if (l > 0) { forms[l]->SetAssemblyLevel(AssemblyLevel::PARTIAL); }
+         forms[l]->AddDomainIntegrator(new DiffusionIntegrator(one));
+         forms[l]->Assemble();
+      }
+
+      Array<int> ess_bdr(mesh->bdr_attributes.Max());
+      ess_bdr = 1;
+      GeometricMultigrid mg(hierarchy, ess_bdr);
+      mg.SetSmoother(GeometricMultigrid::CHEBYSHEV, 3);
+      mg.FormOperators(forms);
+      REQUIRE(dynamic_cast<ConstrainedOperator*>(
+                 mg.GetOperatorAtLevel(num_levels-1)) != NULL);
+
+      FiniteElementSpace &fine_fes = hierarchy.GetFinestFESpace();
+      LinearForm b(&fine_fes);
+      b.AddDomainIntegrator(new DomainLFIntegrator(one));
+      b.Assemble();
+      GridFunction x(&fine_fes);
+      x = 0.0;
+
+      Operator *A;
+      Vector B, X;
+      forms.Last()->FormLinearSystem(mg.GetEssentialTrueDofs(), x, b, A, X, B);
+
+      CGSolver cg;
+      cg.SetRelTol(1e-10);
+      cg.SetMaxIter(100);
+      cg.SetOperator(*A);
+      cg.SetPreconditioner(mg);
+      cg.Mult(B, X);
+      REQUIRE(cg.GetConverged());
+      REQUIRE(cg.GetNumIterations() < 15);
+
+      delete A;
+      for (int l = 0; l < num_levels; l++) { delete forms[l]; }
+   }
+}
+
+}
@@ -0,0 +1,339 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#include "mfem.hpp"
+#include "catch.hpp"
+
+using namespace mfem;
+
+namespace pa_kernels
+{
+
+double coeff(const Vector &x)
+{
+   return 1.0 + x(0)*x(0) + (x.Size() > 1 ? x(1) : 0.0);
+}
+
+void perturb(const Vector &x, Vector &y)
+{
+   y = x;
+   y(0) += 0.05*sin(3.0*x(x.Size()-1));
+   y(x.Size()-1) += 0.03*cos(2.0*x(0));
+}
+
+Mesh *MakeMesh(int dim, Element::Type type)
+{
+   Mesh *mesh = NULL;
+   if (dim == 2) { mesh = new Mesh(3, 3, type, 1); }
+   else { mesh = new Mesh(2, 2, 2, type, 1); }
+   mesh->SetCurvature(2);
+   mesh->Transform(perturb);
+   return mesh;
+}
+
+// Return the max norm of the difference between the action of the fully
+// assembled and the partially assembled forms.
+double CompareFullAndPA(FiniteElementSpace &fes,
+                        BilinearFormIntegrator *integ_full,
+                        BilinearFormIntegrator *integ_pa)
+{
+   BilinearForm a_full(&fes), a_pa(&fes);
+   a_full.AddDomainIntegrator(integ_full);
+   a_full.Assemble();
+   a_full.Finalize();
+
+   a_pa.SetAssemblyLevel(AssemblyLevel::PARTIAL);
+   a_pa.AddDomainIntegrator(integ_pa);
+   a_pa.Assemble();
+
+   Vector x(fes.GetVSize()), y_full(fes.GetVSize()), y_pa(fes.GetVSize());
+   x.Randomize(1);
+   a_full.Mult(x, y_full);
+   a_pa.Mult(x, y_pa);
+   y_pa -= y_full;
+   return y_pa.Normlinf() / y_full.Normlinf();
+}
+
+// Return the max norm of the difference between the diagonals computed by
+// BilinearForm::AssembleDiagonal() for the fully and the partially assembled
+// forms.
+double CompareFullAndPAFormDiagonal(FiniteElementSpace &fes,
+                                    BilinearFormIntegrator *integ_full,
+                                    BilinearFormIntegrator *integ_pa)
+{
+   BilinearForm a_full(&fes), a_pa(&fes);
+   a_full.AddDomainIntegrator(integ_full);
+   a_full.Assemble();
+   a_full.Finalize();
+
+   a_pa.SetAssemblyLevel(AssemblyLevel::PARTIAL);
+   a_pa.AddDomainIntegrator(integ_pa);
+   a_pa.Assemble();
+
+   Vector diag_full, diag_pa;
+   a_full.AssembleDiagonal(diag_full);
+   a_pa.AssembleDiagonal(diag_pa);
+   diag_pa -= diag_full;
+   return diag_pa.Normlinf() / diag_full.Normlinf();
+}
+
+TEST_CASE("Partial assembly of domain integrators", "[PartialAssembly]")
+{
+   FunctionCoefficient q(coeff);
+   for (int dim = 2; dim <= 3; dim++)
+   {
+      for (int t = 0; t < 2; t++)
+      {
+         Element::Type type = (t == 0) ?
+                              (dim == 2 ? Element::QUADRILATERAL :
+                               Element::HEXAHEDRON) :
+                              (dim == 2 ? Element::TRIANGLE :
+                               Element::TETRAHEDRON);
+         Mesh *mesh = MakeMesh(dim, type);
+         for (int order = 1; order <= 3; order++)
+         {
+            H1_FECollection fec(order, dim);
+            FiniteElementSpace fes(mesh, &fec);
+            FiniteElementSpace vfes(mesh, &fec, dim, Ordering::byVDIM);
+
+            REQUIRE(CompareFullAndPA(fes, new MassIntegrator(q),
+                                     new MassIntegrator(q)) < 1e-12);
+            REQUIRE(CompareFullAndPA(fes, new DiffusionIntegrator(q),
+                                     new DiffusionIntegrator(q)) < 1e-12);
+            REQUIRE(CompareFullAndPA(vfes, new VectorDiffusionIntegrator(q),
+                                     new VectorDiffusionIntegrator(q))
+                    < 1e-12);
+            REQUIRE(CompareFullAndPA(vfes, new VectorMassIntegrator(q),
+                                     new VectorMassIntegrator(q)) < 1e-12);
+
+            REQUIRE(CompareFullAndPAFormDiagonal(
+                       fes, new MassIntegrator(q), new MassIntegrator(q))
+                    < 1e-12);
+            REQUIRE(CompareFullAndPAFormDiagonal(
+                       fes, new DiffusionIntegrator(q),
+                       new DiffusionIntegrator(q)) < 1e-12);
+            REQUIRE(CompareFullAndPAFormDiagonal(
+                       vfes, new VectorDiffusionIntegrator(q),
+                       new VectorDiffusionIntegrator(q)) < 1e-12);
+            REQUIRE(CompareFullAndPAFormDiagonal(
+                       vfes, new VectorMassIntegrator(q),
+                       new VectorMassIntegrator(q)) < 1e-12);
+         }
+         delete mesh;
+      }
+   }
+}
+
+// Return the max norm of the difference between the diagonal of the fully
+// assembled form and the diagonal computed by AssembleDiagonalPA().
+double CompareFullAndPADiagonal(FiniteElementSpace &fes,
+                                BilinearFormIntegrator *integ_full,
+                                BilinearFormIntegrator &integ_pa)
+{
+   BilinearForm a_full(&fes);
+   a_full.AddDomainIntegrator(integ_full);
+   a_full.Assemble();
+   a_full.Finalize();
+   Vector diag_full;
+   a_full.SpMat().GetDiag(diag_full);
+
+   integ_pa.AssemblePA(fes);
+   const int nd = fes.GetFE(0)->GetDof();
+   Vector elem_diag(nd*fes.GetNE()), diag_pa(fes.GetVSize());
+   elem_diag = 0.0;
+   integ_pa.AssembleDiagonalPA(elem_diag);
+   diag_pa = 0.0;
+   Array<int> dofs;
+   for (int e = 0; e < fes.GetNE(); e++)
+   {
+      fes.GetElementDofs(e, dofs);
+      for (int i = 0; i < nd; i++)
+      {
+         const int d = (dofs[i] >= 0) ? dofs[i] : -1-dofs[i];
+         diag_pa(d) += elem_diag(i+nd*e);
+      }
+   }
+   diag_pa -= diag_full;
+   return diag_pa.Normlinf() / diag_full.Normlinf();
+}
+
+TEST_CASE("Partial assembly of H(curl) and H(div) integrators",
+          "[PartialAssembly]")
+{
+   FunctionCoefficient q(coeff);
+   for (int dim = 2; dim <= 3; dim++)
+   {
+      Mesh *mesh = MakeMesh(dim, dim == 2 ? Element::QUADRILATERAL :
+                            Element::HEXAHEDRON);
+      for (int order = 1; order <= 3; order++)
+      {
+         ND_FECollection nd_fec(order, dim);
+         RT_FECollection rt_fec(order-1, dim);
+         FiniteElementSpace nd_fes(mesh, &nd_fec), rt_fes(mesh, &rt_fec);
+
+         REQUIRE(CompareFullAndPA(nd_fes, new VectorFEMassIntegrator(q),
+                                  new VectorFEMassIntegrator(q)) < 1e-12);
+         REQUIRE(CompareFullAndPA(nd_fes, new CurlCurlIntegrator(q),
+                                  new CurlCurlIntegrator(q)) < 1e-12);
+         REQUIRE(CompareFullAndPA(rt_fes, new VectorFEMassIntegrator(q),
+                                  new VectorFEMassIntegrator(q)) < 1e-12);
+         REQUIRE(CompareFullAndPA(rt_fes, new DivDivIntegrator(q),
+                                  new DivDivIntegrator(q)) < 1e-12);
+
+         VectorFEMassIntegrator nd_mass(q), rt_mass(q);
+         CurlCurlIntegrator curlcurl(q);
+         DivDivIntegrator divdiv(q);
+         REQUIRE(CompareFullAndPADiagonal(
+                    nd_fes, new VectorFEMassIntegrator(q), nd_mass) < 1e-12);
+         REQUIRE(CompareFullAndPADiagonal(
+                    nd_fes, new CurlCurlIntegrator(q), curlcurl) < 1e-12);
+         REQUIRE(CompareFullAndPADiagonal(
+                    rt_fes, new VectorFEMassIntegrator(q), rt_mass) < 1e-12);
+         REQUIRE(CompareFullAndPADiagonal(
+                    rt_fes, new DivDivIntegrator(q), divdiv) < 1e-12);
+      }
+      delete mesh;
+   }
+}
+
+TEST_CASE("Partial assembly linear system", "[PartialAssembly]")
+{
+   Mesh mesh(4, 4, Element::QUADRILATERAL, 1);
+   H1_FECollection fec(3, 2);
+   FiniteElementSpace fes(&mesh, &fec);
+
+   Array<int> ess_tdof_list, ess_bdr(mesh.bdr_attributes.Max());
+   ess_bdr = 1;
+   fes.GetEssentialTrueDofs(ess_bdr, ess_tdof_list);
+
+   ConstantCoefficient one(1.0);
+   LinearForm b(&fes);
+   b.AddDomainIntegrator(new DomainLFIntegrator(one));
+   b.Assemble();
+
+   GridFunction x_full(&fes), x_pa(&fes);
+   for (int pa = 0; pa < 2; pa++)
+   {
+      GridFunction &x = pa ? x_pa : x_full;
+      x = 0.0;
+      BilinearForm a(&fes);
+      if (pa) { a.SetAssemblyLevel(AssemblyLevel::PARTIAL); }
+      a.AddDomainIntegrator(new DiffusionIntegrator(one));
+      a.Assemble();
+
+      Operator *A;
+      Vector B, X;
+      LinearForm rhs(&fes);
+      rhs = b;
+      a.FormLinearSystem(ess_tdof_list, x, rhs, A, X, B);
+
+      CGSolver cg;
+      cg.SetRelTol(1e-12);
+      cg.SetMaxIter(500);
+      cg.SetOperator(*A);
+      cg.Mult(B, X);
+      a.RecoverFEMSolution(X, rhs, x);
+      delete A;
+   }
+   x_pa -= x_full;
+   REQUIRE(x_pa.Normlinf() < 1e-8);
+}
+
+TEST_CASE("Diagonal of the system operator", "[PartialAssembly]")
+{
+   FunctionCoefficient q(coeff);
+   for (int dim = 2; dim <= 3; dim++)
+   {
+      Mesh *mesh = MakeMesh(dim, dim == 2 ? Element::QUADRILATERAL :
+                            Element::HEXAHEDRON);
+      mesh->EnsureNCMesh();
+      Array<int> refs;
+      refs.Append(0);
+      mesh->GeneralRefinement(refs);
+      Array<int> ess_bdr(mesh->bdr_attributes.Max());
+      ess_bdr = 1;
+
+      // Continuous space on a non-conforming mesh: the system diagonals agree
+      // once the full matrix is formed on the true dofs.
+      H1_FECollection fec(2, dim);
+      FiniteElementSpace fes(mesh, &fec);
+      Array<int> ess_tdof_list;
+      fes.GetEssentialTrueDofs(ess_bdr, ess_tdof_list);
+      BilinearForm a_full(&fes), a_pa(&fes);
+      a_pa.SetAssemblyLevel(AssemblyLevel::PARTIAL);
+      for (int k = 0; k < 2; k++)
+      {
+         BilinearForm &a = k ? a_pa : a_full;
+         a.AddDomainIntegrator(new DiffusionIntegrator(q));
+         a.AddDomainIntegrator(new MassIntegrator(q));
+         a.Assemble();
+      }
+      a_full.SetDiagonalPolicy(Matrix::DIAG_ONE);
+      SparseMatrix A;
+      a_full.FormSystemMatrix(ess_tdof_list, A);
+      Vector diag_full, diag_pa, diag_A;
+      A.GetDiag(diag_A);
+      a_full.FormSystemDiagonal(ess_tdof_list, diag_full);
+      a_pa.FormSystemDiagonal(ess_tdof_list, diag_pa);
+      REQUIRE(diag_full.Size() == fes.GetTrueVSize());
+      diag_full -= diag_A;
+      REQUIRE(diag_full.Normlinf() == 0.0);
+      // The P^t reduction of the partially assembled diagonal is exact on
+      // the true dofs that are copied to a single local dof.
+      const SparseMatrix *P = fes.GetConformingProlongation();
+      REQUIRE(P != NULL);
+      SparseMatrix *Pt = Transpose(*P);
+      int num_exact = 0;
+      for (int i = 0; i < Pt->Height(); i++)
+      {
+         if (Pt->RowSize(i) == 1 && Pt->GetRowEntries(i)[0] == 1.0)
+         {
+            REQUIRE(std::abs(diag_pa(i) - diag_A(i)) <
+                    1e-12*diag_A.Normlinf());
+            num_exact++;
+         }
+      }
+      REQUIRE(num_exact > 0);
+      delete Pt;
+      delete mesh;
+   }
+}
+
+TEST_CASE("Diagonal of DG forms", "[PartialAssembly]")
+{
+   FunctionCoefficient q(coeff);
+   for (int dim = 2; dim <= 3; dim++)
+   {
+      Mesh *mesh = MakeMesh(dim, dim == 2 ? Element::QUADRILATERAL :
+                            Element::HEXAHEDRON);
+      L2_FECollection fec(2, dim, BasisType::GaussLobatto);
+      FiniteElementSpace fes(mesh, &fec);
+      BilinearForm a_full(&fes), a_pa(&fes);
+      a_pa.SetAssemblyLevel(AssemblyLevel::PARTIAL);
+      for (int k = 0; k < 2; k++)
+      {
+         BilinearForm &a = k ? a_pa : a_full;
+         a.AddDomainIntegrator(new DiffusionIntegrator(q));
+         a.AddInteriorFaceIntegrator(new DGDiffusionIntegrator(q, -1.0, 4.0));
+         a.AddBdrFaceIntegrator(new DGDiffusionIntegrator(q, -1.0, 4.0));
+         a.Assemble();
+      }
+      a_full.Finalize();
+      Vector diag_full, diag_pa;
+      a_full.AssembleDiagonal(diag_full);
+      a_pa.AssembleDiagonal(diag_pa);
+      diag_pa -= diag_full;
+      REQUIRE(diag_pa.Normlinf() < 1e-12*diag_full.Normlinf());
+      delete mesh;
+   }
+}
+
+}
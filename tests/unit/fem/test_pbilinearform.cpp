@@ -0,0 +1,87 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#include "mfem.hpp"
+#include "catch.hpp"
+
+using namespace mfem;
+
+#ifdef MFEM_USE_MPI
+
+namespace pbilinearform
+{
+
+double coeff(const Vector &x)
+{
+   return 1.0 + x(0)*x(0) + x(1);
+}
+
+TEST_CASE("Diagonal of ParBilinearForm", "[Parallel]")
+{
+   FunctionCoefficient q(coeff);
+   for (int dim = 2; dim <= 3; dim++)
+   {
+      Mesh *mesh = (dim == 2) ?
+                   new Mesh(4, 4, Element::QUADRILATERAL, 1) :
+                   new Mesh(2, 2, 2, Element::HEXAHEDRON, 1);
+      ParMesh pmesh(MPI_COMM_WORLD, *mesh);
+      delete mesh;
+
+      H1_FECollection fec(2, dim);
+      ParFiniteElementSpace fes(&pmesh, &fec);
+      Array<int> ess_bdr(pmesh.bdr_attributes.Max());
+      ess_bdr = 1;
+      Array<int> ess_tdof_list;
+      fes.GetEssentialTrueDofs(ess_bdr, ess_tdof_list);
+
+      ParBilinearForm a(&fes);
+      a.AddDomainIntegrator(new DiffusionIntegrator(q));
+      a.AddDomainIntegrator(new MassIntegrator(q));
+      a.Assemble();
+      a.Finalize();
+
+      // Before FormSystemMatrix(): the local diagonals are summed over the
+      // processors sharing a dof
+      Vector diag, sys_diag, diag_A;
+      HypreParMatrix *A0 = a.ParallelAssemble();
+      A0->GetDiag(diag_A);
+      delete A0;
+      a.AssembleDiagonal(diag);
+      REQUIRE(diag.Size() == fes.GetTrueVSize());
+      diag -= diag_A;
+      REQUIRE(diag.Normlinf() < 1e-12*diag_A.Normlinf());
+      a.FormSystemDiagonal(ess_tdof_list, sys_diag);
+
+      // The eliminated parallel matrix has a unit diagonal at the essential
+      // dofs
+      HypreParMatrix A;
+      a.FormSystemMatrix(ess_tdof_list, A);
+      A.GetDiag(diag_A);
+      for (int i = 0; i < ess_tdof_list.Size(); i++)
+      {
+         REQUIRE(diag_A(ess_tdof_list[i]) == 1.0);
+      }
+      sys_diag -= diag_A;
+      REQUIRE(sys_diag.Normlinf() < 1e-12*diag_A.Normlinf());
+
+      // After FormSystemMatrix(): the diagonal of the parallel matrix
+      a.AssembleDiagonal(diag);
+      diag -= diag_A;
+      REQUIRE(diag.Normlinf() == 0.0);
+      a.FormSystemDiagonal(ess_tdof_list, sys_diag);
+      sys_diag -= diag_A;
+      REQUIRE(sys_diag.Normlinf() == 0.0);
+   }
+}
+
+} // namespace pbilinearform
+
+#endif // MFEM_USE_MPI
@@ -0,0 +1,48 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#include "mfem.hpp"
+using namespace mfem;
+
+#include "catch.hpp"
+
+TEST_CASE("PublishedArray", "[General]")
+{
+   const int n = 100;
+   int values[n];
+   Array<int*> a;
+   PublishedArray<int> pub;
+   REQUIRE(pub.Get(0) == NULL);
+
+   // Grow one entry at a time, as the caches of the library do
+   for (int i = 0; i < n; i++)
+   {
+      values[i] = i;
+      a.Append(&values[i]);
+      pub.Publish(a);
+      REQUIRE(pub.Get(i) == &values[i]);
+      REQUIRE(pub.Get(i+1) == NULL);
+   }
+   for (int i = 0; i < n; i++)
+   {
+      REQUIRE(*pub.Get(i) == i);
+   }
+
+   // NULL entries may be set later
+   a.SetSize(n + 10, NULL);
+   pub.Publish(a);
+   REQUIRE(pub.Get(n + 5) == NULL);
+   a[n + 5] = &values[5];
+   pub.Publish(a);
+   REQUIRE(pub.Get(n + 5) == &values[5]);
+   REQUIRE(pub.Get(n + 4) == NULL);
+   REQUIRE(pub.Get(n + 10) == NULL);
+}
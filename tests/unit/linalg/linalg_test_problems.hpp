@@ -0,0 +1,89 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#ifndef MFEM_LINALG_TEST_PROBLEMS
+#define MFEM_LINALG_TEST_PROBLEMS
+
+// Model problems shared by the solver and preconditioner tests.
+
+#include "mfem.hpp"
+
+namespace linalg_test
+{
+
+using namespace mfem;
+
+// The 1D Laplacian tridiag(-1, 2, -1) of size n.
+inline SparseMatrix *Laplacian1D(int n)
+{
+   SparseMatrix *A = new SparseMatrix(n);
+   for (int i = 0; i < n; i++)
+   {
+      A->Add(i, i, 2.0);
+      if (i > 0) { A->Add(i, i-1, -1.0); }
+      if (i < n-1) { A->Add(i, i+1, -1.0); }
+   }
+   A->Finalize();
+   return A;
+}
+
+// Assemble the system of -eps Delta u + v.grad u = 1 in the unit square with
+// u = 0 on the boundary, where v = (vx, vy), with H1 elements of the given
+// order on an n x n quadrilateral mesh. Without velocity, this is the Poisson
+// problem. Return the matrix and set the right-hand side @a b.
+inline SparseMatrix *ConvectionDiffusion(int n, int order, double eps,
+                                         double vx, double vy, Vector &b)
+{
+   Mesh mesh(n, n, Element::QUADRILATERAL, 1);
+   H1_FECollection fec(order, 2);
+   FiniteElementSpace fes(&mesh, &fec);
+   Array<int> ess_tdof_list, ess_bdr(mesh.bdr_attributes.Max());
+   ess_bdr = 1;
+   fes.GetEssentialTrueDofs(ess_bdr, ess_tdof_list);
+
+   ConstantCoefficient one(1.0), diff(eps);
+   Vector v(2);
+   v(0) = vx;
+   v(1) = vy;
+   VectorConstantCoefficient velocity(v);
+   LinearForm lf(&fes);
+   lf.AddDomainIntegrator(new DomainLFIntegrator(one));
+   lf.Assemble();
+   BilinearForm a(&fes);
+   a.AddDomainIntegrator(new DiffusionIntegrator(diff));
+   if (vx != 0.0 || vy != 0.0)
+   {
+      a.AddDomainIntegrator(new ConvectionIntegrator(velocity));
+   }
+   a.Assemble();
+
+   GridFunction x(&fes);
+   x = 0.0;
+   SparseMatrix A;
+   Vector X, B;
+   a.FormLinearSystem(ess_tdof_list, x, lf, A, X, B);
+   b = B; // B may use the data of lf
+   return new SparseMatrix(A);
+}
+
+// Return the relative residual |b - A x| / |b|.
+inline double RelativeResidual(const SparseMatrix &A, const Vector &b,
+                               const Vector &x)
+{
+   Vector r(b.Size());
+   A.Mult(x, r);
+   r -= b;
+   return r.Norml2()/b.Norml2();
+}
+
+} // namespace linalg_test
+
+#endif
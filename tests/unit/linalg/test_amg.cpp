@@ -0,0 +1,140 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#include "mfem.hpp"
+#include "catch.hpp"
+
+using namespace mfem;
+
+namespace amg
+{
+
+// Solve the Poisson problem on a n x n mesh with PCG + AMGSolver; return the
+// number of iterations and check the residual.
+int SolvePoisson(int n, int order, AMGSolver::SmootherType smoother,
+                 AMGSolver::CycleType cycle)
+{
+   Mesh mesh(n, n, Element::QUADRILATERAL, 1);
+   H1_FECollection fec(order, 2);
+   FiniteElementSpace fes(&mesh, &fec);
+
+   Array<int> ess_bdr(mesh.bdr_attributes.Max()), ess_tdof_list;
+   ess_bdr = 1;
+   fes.GetEssentialTrueDofs(ess_bdr, ess_tdof_list);
+
+   ConstantCoefficient one(1.0);
+   LinearForm b(&fes);
+   b.AddDomainIntegrator(new DomainLFIntegrator(one));
+   b.Assemble();
+
+   BilinearForm a(&fes);
+   a.AddDomainIntegrator(new DiffusionIntegrator(one));
+   a.Assemble();
+
+   GridFunction x(&fes);
+   x = 0.0;
+   SparseMatrix A;
+   Vector B, X;
+   a.FormLinearSystem(ess_tdof_list, x, b, A, X, B);
+
+   AMGSolver amg;
+   amg.SetSmoother(smoother);
+   amg.SetCycleType(cycle);
+   amg.SetOperator(A);
+   REQUIRE(amg.GetNumLevels() > 1);
+   REQUIRE(amg.GetOperatorComplexity() < 2.0);
+
+   CGSolver cg;
+   cg.SetRelTol(1e-10);
+   cg.SetMaxIter(200);
+   cg.SetOperator(A);
+   cg.SetPreconditioner(amg);
+   cg.Mult(B, X);
+   REQUIRE(cg.GetConverged());
+
+   Vector r(B);
+   A.AddMult(X, r, -1.0);
+   REQUIRE(r.Normlinf() < 1e-8*B.Normlinf());
+   return cg.GetNumIterations();
+}
+
+TEST_CASE("AMGSolver", "[AMGSolver]")
+{
+   SECTION("Gauss-Seidel V-cycle")
+   {
+      const int it_coarse = SolvePoisson(16, 1, AMGSolver::GAUSS_SEIDEL,
+                                         AMGSolver::V_CYCLE);
+      const int it_fine = SolvePoisson(64, 1, AMGSolver::GAUSS_SEIDEL,
+                                       AMGSolver::V_CYCLE);
+      // The iteration counts grow slowly with the problem size
+      REQUIRE(it_fine < 30);
+      REQUIRE(it_fine <= 2*it_coarse);
+   }
+
+   SECTION("l1-Jacobi W-cycle")
+   {
+      REQUIRE(SolvePoisson(32, 2, AMGSolver::L1_JACOBI,
+                           AMGSolver::W_CYCLE) < 60);
+   }
+
+   SECTION("Chebyshev V-cycle")
+   {
+      REQUIRE(SolvePoisson(64, 1, AMGSolver::CHEBYSHEV,
+                           AMGSolver::V_CYCLE) < 40);
+   }
+}
+
+TEST_CASE("AMGSolver small operator", "[AMGSolver]")
+{
+   // Operators with at most SetCoarseSize() rows are solved directly
+   SparseMatrix A(3);
+   for (int i = 0; i < 3; i++)
+   {
+      A.Add(i, i, 2.0);
+      if (i > 0) { A.Add(i, i-1, -1.0); A.Add(i-1, i, -1.0); }
+   }
+   A.Finalize();
+   AMGSolver amg(A);
+   REQUIRE(amg.GetNumLevels() == 1);
+
+   Vector b(3), x(3), r(3);
+   b.Randomize(1);
+   amg.Mult(b, x);
+   A.Mult(x, r);
+   r -= b;
+   REQUIRE(r.Normlinf() < 1e-12);
+}
+
+TEST_CASE("AMGSolver stagnating coarsening", "[AMGSolver]")
+{
+   // Without strong connections the coarsening stagnates on the fine level,
+   // which is larger than 4*SetCoarseSize(): it is smoothed instead of being
+   // factored
+   const int n = 500;
+   SparseMatrix A(n);
+   for (int i = 0; i < n; i++)
+   {
+      A.Add(i, i, 2.0);
+      if (i > 0) { A.Add(i, i-1, -0.01); A.Add(i-1, i, -0.01); }
+   }
+   A.Finalize();
+   AMGSolver amg(A);
+   REQUIRE(amg.GetNumLevels() == 1);
+
+   Vector b(n), x(n), r(n);
+   b.Randomize(1);
+   amg.Mult(b, x);
+   A.Mult(x, r);
+   r -= b;
+   REQUIRE(r.Normlinf() < 1e-8*b.Normlinf());
+}
+
+}
@@ -0,0 +1,149 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#include "mfem.hpp"
+#include "catch.hpp"
+
+using namespace mfem;
+
+namespace blocksparsemat
+{
+
+double MaxDiff(const Vector &x, const Vector &y)
+{
+   Vector d(x);
+   d -= y;
+   return d.Normlinf();
+}
+
+// Check that A and As have the same action and transpose action.
+void CheckAction(const BlockSparseMatrix &A, const SparseMatrix &As)
+{
+   Vector x(A.Width()), xt(A.Height());
+   Vector y(A.Height()), ys(A.Height()), yt(A.Width()), yst(A.Width());
+   x.Randomize(1);
+   xt.Randomize(2);
+   A.Mult(x, y);
+   As.Mult(x, ys);
+   REQUIRE(MaxDiff(y, ys) < 1e-12*ys.Normlinf());
+   A.MultTranspose(xt, yt);
+   As.MultTranspose(xt, yst);
+   REQUIRE(MaxDiff(yt, yst) < 1e-12*yst.Normlinf());
+}
+
+TEST_CASE("BlockSparseMatrix conversion", "[BlockSparseMatrix]")
+{
+   // A random matrix with partially filled blocks
+   const int m = 60, n = 48;
+   SparseMatrix As(m, n);
+   for (int i = 0; i < m; i++)
+   {
+      for (int k = 0; k < 5; k++)
+      {
+         As.Add(i, (7*i + 13*k*k) % n, 1.0 + i - 0.5*k);
+      }
+   }
+   As.Finalize();
+
+   const int block_sizes[] = { 1, 2, 3, 4, 6 };
+   for (int s = 0; s < 5; s++)
+   {
+      const int bs = block_sizes[s];
+      BlockSparseMatrix A(As, bs);
+      REQUIRE(A.NumBlockRows() == m/bs);
+      REQUIRE(A.NumBlockCols() == n/bs);
+      CheckAction(A, As);
+
+      SparseMatrix *As2 = A.ToSparseMatrix();
+      CheckAction(A, *As2);
+      delete As2;
+   }
+}
+
+TEST_CASE("BlockSparseMatrix assembly", "[BlockSparseMatrix]")
+{
+   for (int dim = 2; dim <= 3; dim++)
+   {
+      Mesh *mesh = (dim == 2) ?
+                   new Mesh(6, 5, Element::QUADRILATERAL, 1, 1.0, 1.0) :
+                   new Mesh(3, 3, 2, Element::HEXAHEDRON, 1, 1.0, 1.0, 1.0);
+      H1_FECollection fec(2, dim);
+      FiniteElementSpace fes(mesh, &fec, dim, Ordering::byVDIM);
+
+      Array<int> ess_bdr(mesh->bdr_attributes.Max()), ess_tdof_list;
+      ess_bdr = 0;
+      ess_bdr[0] = 1;
+      fes.GetEssentialTrueDofs(ess_bdr, ess_tdof_list);
+      Array<int> load_bdr(mesh->bdr_attributes.Max());
+      load_bdr = 0;
+      load_bdr[1] = 1;
+
+      ConstantCoefficient one(1.0), two(2.0);
+      BilinearForm a(&fes);
+      a.AddDomainIntegrator(new ElasticityIntegrator(one, two));
+      a.AddDomainIntegrator(new VectorMassIntegrator(one));
+      a.AddBoundaryIntegrator(new VectorMassIntegrator(two), load_bdr);
+
+      Vector g(dim);
+      g = 1.0;
+      VectorConstantCoefficient g_coeff(g);
+      LinearForm b(&fes);
+      b.AddDomainIntegrator(new VectorDomainLFIntegrator(g_coeff));
+      b.Assemble();
+      GridFunction x(&fes);
+      x.ProjectCoefficient(g_coeff);
+
+      // Reference: SparseMatrix assembly
+      a.Assemble();
+      Vector x_s(x), b_s(b), X_s, B_s;
+      SparseMatrix As;
+      a.FormLinearSystem(ess_tdof_list, x_s, b_s, As, X_s, B_s);
+
+      // Direct block assembly
+      Vector x_b(x), b_b(b), X_b, B_b;
+      BlockSparseMatrix A;
+      a.FormLinearSystem(ess_tdof_list, x_b, b_b, A, X_b, B_b);
+
+      REQUIRE(A.BlockSize() == dim);
+      REQUIRE(A.NumNonZeroBlocks()*dim*dim == A.NumNonZeroElems());
+      CheckAction(A, As);
+      REQUIRE(MaxDiff(B_b, B_s) < 1e-12*B_s.Normlinf());
+      REQUIRE(MaxDiff(X_b, X_s) == 0.0);
+
+      Vector d, ds;
+      A.GetDiag(d);
+      As.GetDiag(ds);
+      REQUIRE(MaxDiff(d, ds) < 1e-12*ds.Normlinf());
+
+      // PCG with block smoothers
+      BlockGSSmoother gs(A);
+      BlockJacobiSmoother jacobi(A, 0.5, 2);
+      Solver *precs[] = { &gs, &jacobi };
+      for (int p = 0; p < 2; p++)
+      {
+         Vector X(X_b);
+         CGSolver cg;
+         cg.SetRelTol(1e-10);
+         cg.SetMaxIter(1000);
+         cg.SetOperator(A);
+         cg.SetPreconditioner(*precs[p]);
+         cg.Mult(B_b, X);
+         REQUIRE(cg.GetConverged());
+
+         Vector r(B_b);
+         As.AddMult(X, r, -1.0);
+         REQUIRE(r.Normlinf() < 1e-8*B_b.Normlinf());
+      }
+      delete mesh;
+   }
+}
+
+}
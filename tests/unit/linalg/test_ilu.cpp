@@ -0,0 +1,240 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#include "mfem.hpp"
+#include "catch.hpp"
+#include "linalg_test_problems.hpp"
+
+using namespace mfem;
+using namespace linalg_test;
+
+namespace ilu
+{
+
+// The upwind DG discretization of u + b.grad u = 1 with Q1 elements on an
+// n x n mesh, with the inflow boundary condition u = 0.
+SparseMatrix *DGAdvection(int n, int &block_size, Vector &b)
+{
+   Mesh mesh(n, n, Element::QUADRILATERAL, 1);
+   L2_FECollection fec(1, 2);
+   FiniteElementSpace fes(&mesh, &fec);
+   block_size = fes.GetFE(0)->GetDof();
+
+   ConstantCoefficient one(1.0);
+   Vector v(2);
+   v(0) = 1.0;
+   v(1) = 0.5;
+   VectorConstantCoefficient velocity(v);
+   LinearForm lf(&fes);
+   lf.AddDomainIntegrator(new DomainLFIntegrator(one));
+   lf.Assemble();
+   BilinearForm a(&fes);
+   a.AddDomainIntegrator(new MassIntegrator);
+   a.AddDomainIntegrator(new ConvectionIntegrator(velocity, 1.0));
+   a.AddInteriorFaceIntegrator(
+      new TransposeIntegrator(new DGTraceIntegrator(velocity, -1.0, 0.5)));
+   a.AddBdrFaceIntegrator(
+      new TransposeIntegrator(new DGTraceIntegrator(velocity, -1.0, 0.5)));
+   a.Assemble();
+   a.Finalize();
+
+   b = lf;
+   return new SparseMatrix(a.SpMat());
+}
+
+TEST_CASE("ILU without fill-in", "[ILU]")
+{
+   const int n = 50;
+   // The 1D Laplacian has no fill-in in its LU factorization
+   SparseMatrix *A = Laplacian1D(n);
+   Vector b(n), x(n);
+   b.Randomize(1);
+
+   ILUSolver ilu0(*A);
+   REQUIRE(ilu0.NumNonZeroElems() == A->NumNonZeroElems());
+   // The factors of a tridiagonal matrix are bidiagonal: one row per level
+   REQUIRE(ilu0.GetNumLevels() == n);
+   // ... which are solved in one serial stage
+   A->SortColumnIndices();
+   const int *I = A->GetI(), *J = A->GetJ();
+   Array<int> diag(n);
+   for (int i = 0; i < n; i++)
+   {
+      diag[i] = I[i];
+      while (J[diag[i]] != i) { diag[i]++; }
+   }
+   TriangularSchedule lower;
+   lower.Setup(n, I, J, diag.GetData(), true);
+   REQUIRE(lower.NumLevels() == n);
+   REQUIRE(lower.NumStages() == 1);
+   ilu0.Mult(b, x);
+   REQUIRE(RelativeResidual(*A, b, x) < 1e-12);
+
+   IC0Solver ic0(*A);
+   ic0.Mult(b, x);
+   REQUIRE(RelativeResidual(*A, b, x) < 1e-12);
+
+   ILUTSolver ilut(*A, 0.0, 1);
+   ilut.Mult(b, x);
+   REQUIRE(RelativeResidual(*A, b, x) < 1e-12);
+
+   delete A;
+}
+
+TEST_CASE("Complete factorizations", "[ILU]")
+{
+   Vector b;
+   SparseMatrix *A = ConvectionDiffusion(6, 1, 0.1, 1.0, 0.5, b);
+   const int n = A->Height();
+   Vector x(n);
+
+   ILUSolver ilu0(*A);
+   REQUIRE(ilu0.NumNonZeroElems() == A->NumNonZeroElems());
+
+   // Without dropping, ILU(k) and ILUT are the exact LU factorization
+   ILUSolver iluk(*A, n);
+   REQUIRE(iluk.NumNonZeroElems() > A->NumNonZeroElems());
+   iluk.Mult(b, x);
+   REQUIRE(RelativeResidual(*A, b, x) < 1e-12);
+
+   ILUTSolver ilut(*A, 0.0, n);
+   REQUIRE(ilut.NumNonZeroElems() <= iluk.NumNonZeroElems());
+   ilut.Mult(b, x);
+   REQUIRE(RelativeResidual(*A, b, x) < 1e-12);
+
+   // In iterative mode, the preconditioner corrects the given x
+   x = 1.0;
+   iluk.iterative_mode = true;
+   iluk.Mult(b, x);
+   REQUIRE(RelativeResidual(*A, b, x) < 1e-12);
+
+   delete A;
+}
+
+TEST_CASE("IC0Solver", "[ILU]")
+{
+   Vector b;
+   SparseMatrix *A = ConvectionDiffusion(16, 1, 1.0, 0.0, 0.0, b);
+   const int n = A->Height();
+   Vector x(n);
+
+   CGSolver cg;
+   cg.SetOperator(*A);
+   cg.SetRelTol(1e-10);
+   cg.SetMaxIter(500);
+
+   DSmoother jacobi(*A);
+   cg.SetPreconditioner(jacobi);
+   x = 0.0;
+   cg.Mult(b, x);
+   REQUIRE(cg.GetConverged());
+   const int jacobi_iter = cg.GetNumIterations();
+
+   IC0Solver ic0(*A);
+   REQUIRE(ic0.NumNonZeroElems() == A->NumNonZeroElems());
+   cg.SetPreconditioner(ic0);
+   x = 0.0;
+   cg.Mult(b, x);
+   REQUIRE(cg.GetConverged());
+   REQUIRE(cg.GetNumIterations() < jacobi_iter);
+   REQUIRE(RelativeResidual(*A, b, x) < 1e-8);
+
+   delete A;
+}
+
+TEST_CASE("ILU preconditioned GMRES", "[ILU]")
+{
+   Vector b;
+   SparseMatrix *A = ConvectionDiffusion(16, 1, 0.01, 1.0, 0.5, b);
+   const int n = A->Height();
+   Vector x(n);
+
+   GMRESSolver gmres;
+   gmres.SetOperator(*A);
+   gmres.SetRelTol(1e-10);
+   gmres.SetMaxIter(500);
+   gmres.SetKDim(100);
+
+   ILUSolver ilu0(*A);
+   gmres.SetPreconditioner(ilu0);
+   x = 0.0;
+   gmres.Mult(b, x);
+   REQUIRE(gmres.GetConverged());
+   REQUIRE(RelativeResidual(*A, b, x) < 1e-8);
+   const int ilu0_iter = gmres.GetNumIterations();
+
+   ILUSolver ilu1(*A, 1);
+   REQUIRE(ilu1.NumNonZeroElems() > ilu0.NumNonZeroElems());
+   gmres.SetPreconditioner(ilu1);
+   x = 0.0;
+   gmres.Mult(b, x);
+   REQUIRE(gmres.GetConverged());
+   REQUIRE(gmres.GetNumIterations() <= ilu0_iter);
+
+   ILUTSolver ilut(*A, 1e-3, 10);
+   gmres.SetPreconditioner(ilut);
+   x = 0.0;
+   gmres.Mult(b, x);
+   REQUIRE(gmres.GetConverged());
+   REQUIRE(RelativeResidual(*A, b, x) < 1e-8);
+
+   delete A;
+}
+
+TEST_CASE("BlockILU0Solver", "[ILU]")
+{
+   SECTION("Block size 1")
+   {
+      Vector b;
+      SparseMatrix *A = ConvectionDiffusion(8, 1, 0.1, 1.0, 0.5, b);
+      const int n = A->Height();
+      Vector x(n), y(n);
+
+      ILUSolver ilu0(*A);
+      BlockILU0Solver bilu0(*A, 1);
+      REQUIRE(bilu0.NumNonZeroBlocks() == ilu0.NumNonZeroElems());
+      REQUIRE(bilu0.GetNumLevels() == ilu0.GetNumLevels());
+      ilu0.Mult(b, x);
+      bilu0.Mult(b, y);
+      y -= x;
+      REQUIRE(y.Normlinf() < 1e-12 * x.Normlinf());
+
+      delete A;
+   }
+
+   SECTION("DG advection")
+   {
+      Vector b;
+      int block_size;
+      SparseMatrix *A = DGAdvection(8, block_size, b);
+      const int n = A->Height();
+      Vector x(n);
+
+      BlockILU0Solver bilu0(*A, block_size);
+      REQUIRE(bilu0.NumNonZeroBlocks() * block_size * block_size >=
+              A->NumNonZeroElems());
+
+      GMRESSolver gmres;
+      gmres.SetOperator(*A);
+      gmres.SetPreconditioner(bilu0);
+      gmres.SetRelTol(1e-10);
+      gmres.SetMaxIter(200);
+      gmres.SetKDim(50);
+      x = 0.0;
+      gmres.Mult(b, x);
+      REQUIRE(gmres.GetConverged());
+      REQUIRE(RelativeResidual(*A, b, x) < 1e-8);
+
+      delete A;
+   }
+}
+
+} // namespace ilu
@@ -0,0 +1,147 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#include "mfem.hpp"
+#include "catch.hpp"
+#include "linalg_test_problems.hpp"
+
+using namespace mfem;
+using namespace linalg_test;
+
+namespace mixedprecision
+{
+
+// The Poisson problem with a Q2 discretization on a 24 x 24 mesh.
+SparseMatrix *Poisson(Vector &b)
+{
+   return ConvectionDiffusion(24, 2, 1.0, 0.0, 0.0, b);
+}
+
+TEST_CASE("FloatSparseMatrix", "[MixedPrecision]")
+{
+   Vector b;
+   SparseMatrix *A = Poisson(b);
+   FloatSparseMatrix A_sp(*A);
+   const int n = A->Height();
+   REQUIRE(A_sp.Height() == n);
+   REQUIRE(A_sp.NumNonZeroElems() == A->NumNonZeroElems());
+
+   Vector x(n), y(n), y_sp(n);
+   x.Randomize(1);
+   A->Mult(x, y);
+   A_sp.Mult(x, y_sp);
+   y_sp -= y;
+   REQUIRE(y_sp.Normlinf() <= 1e-6*y.Normlinf());
+
+   A_sp.AddMult(x, y, -2.0);
+   y += y_sp;
+   A->AddMult(x, y, 1.0);
+   REQUIRE(y.Normlinf() <= 1e-6*x.Normlinf()*A->MaxNorm());
+
+   for (int type = 1; type <= 2; type++)
+   {
+      GSSmoother gs(*A, type);
+      FloatGSSmoother gs_sp(*A, type);
+      gs.Mult(b, y);
+      gs_sp.Mult(b, y_sp);
+      y_sp -= y;
+      REQUIRE(y_sp.Normlinf() <= 1e-5*y.Normlinf());
+   }
+   delete A;
+}
+
+TEST_CASE("MixedPrecisionSolver", "[MixedPrecision]")
+{
+   Vector b;
+   SparseMatrix *A = Poisson(b);
+   const int n = A->Height();
+   Vector x(n);
+
+   SECTION("FGMRES with a single precision Gauss-Seidel smoother")
+   {
+      FloatGSSmoother gs(*A);
+      MixedPrecisionSolver solver;
+      solver.SetRelTol(1e-10);
+      solver.SetMaxIter(2000);
+      solver.SetPreconditioner(gs);
+      solver.SetOperator(*A);
+      x = 0.0;
+      solver.Mult(b, x);
+      REQUIRE(solver.GetConverged());
+      REQUIRE(RelativeResidual(*A, b, x) < 1e-9);
+   }
+
+   SECTION("FGMRES with an inner single precision CG solver")
+   {
+      FloatSparseMatrix A_sp(*A);
+      CGSolver inner;
+      inner.SetRelTol(1e-3);
+      inner.SetMaxIter(100);
+      inner.SetOperator(A_sp);
+      MixedPrecisionSolver solver(MixedPrecisionSolver::FGMRES);
+      solver.SetRelTol(1e-12);
+      solver.SetMaxIter(50);
+      solver.SetPreconditioner(inner);
+      solver.SetOperator(*A);
+      x = 0.0;
+      solver.Mult(b, x);
+      REQUIRE(solver.GetConverged());
+      REQUIRE(RelativeResidual(*A, b, x) < 1e-11);
+   }
+
+   SECTION("CG and SLI with single precision AMG")
+   {
+      AMGSolver amg, amg_sp;
+      amg.SetOperator(*A);
+      amg_sp.SetSinglePrecision();
+      amg_sp.SetOperator(*A);
+
+      // The option can also be changed after SetOperator
+      AMGSolver amg_sp_after(*A);
+      amg_sp_after.SetSinglePrecision();
+      Vector y(n), y_after(n);
+      amg_sp.Mult(b, y);
+      amg_sp_after.Mult(b, y_after);
+      y_after -= y;
+      REQUIRE(y_after.Normlinf() == 0.0);
+
+      CGSolver cg;
+      cg.SetRelTol(1e-10);
+      cg.SetMaxIter(200);
+      cg.SetPreconditioner(amg);
+      cg.SetOperator(*A);
+      x = 0.0;
+      cg.Mult(b, x);
+      REQUIRE(cg.GetConverged());
+
+      MixedPrecisionSolver::OuterType types[] =
+      { MixedPrecisionSolver::CG, MixedPrecisionSolver::SLI };
+      for (int t = 0; t < 2; t++)
+      {
+         MixedPrecisionSolver solver(types[t]);
+         solver.SetRelTol(1e-10);
+         solver.SetMaxIter(200);
+         solver.SetPreconditioner(amg_sp);
+         solver.SetOperator(*A);
+         x = 0.0;
+         solver.Mult(b, x);
+         REQUIRE(solver.GetConverged());
+         REQUIRE(RelativeResidual(*A, b, x) < 1e-8);
+         if (types[t] == MixedPrecisionSolver::CG)
+         {
+            REQUIRE(solver.GetNumIterations() <= cg.GetNumIterations() + 2);
+         }
+      }
+   }
+   delete A;
+}
+
+}
@@ -0,0 +1,130 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#include "mfem.hpp"
+#include "catch.hpp"
+
+using namespace mfem;
+
+namespace sellmat
+{
+
+// A rectangular matrix with irregular row lengths, including empty rows.
+SparseMatrix *MakeMatrix(int m, int n)
+{
+   SparseMatrix *A = new SparseMatrix(m, n);
+   for (int i = 0; i < m; i++)
+   {
+      const int len = (i % 7 == 3) ? 0 : (i*i) % 13 + ((i % 11 == 0) ? 25 : 1);
+      for (int k = 0; k < len; k++)
+      {
+         A->Add(i, (i*31 + k*k*17) % n, 1.0 + 0.01*i - 0.1*k);
+      }
+   }
+   A->Finalize();
+   return A;
+}
+
+double MaxDiff(const Vector &x, const Vector &y)
+{
+   Vector d(x);
+   d -= y;
+   return d.Normlinf();
+}
+
+TEST_CASE("SellCSigmaMatrix", "[SellCSigmaMatrix]")
+{
+   const int m = 203, n = 157;
+   SparseMatrix *A = MakeMatrix(m, n);
+
+   Vector x(n), xt(m), y(m), yt(n), y_sell(m), yt_sell(n);
+   x.Randomize(1);
+   xt.Randomize(2);
+   A->Mult(x, y);
+   A->MultTranspose(xt, yt);
+
+   const int chunks[] = { 1, 2, 4, 8, 16, 32 };
+   const int sigmas[] = { 1, 32, 1000 };
+   for (int c = 0; c < 6; c++)
+   {
+      for (int s = 0; s < 3; s++)
+      {
+         SellCSigmaMatrix A_sell(*A, chunks[c], sigmas[s]);
+         REQUIRE(A_sell.NumNonZeroElems() == A->NumNonZeroElems());
+         REQUIRE(A_sell.GetPaddingRatio() >= 1.0);
+
+         A_sell.Mult(x, y_sell);
+         REQUIRE(MaxDiff(y, y_sell) < 1e-12);
+         A_sell.MultTranspose(xt, yt_sell);
+         REQUIRE(MaxDiff(yt, yt_sell) < 1e-12);
+
+         A_sell.AddMult(x, y_sell, -1.0);
+         REQUIRE(y_sell.Normlinf() < 1e-12);
+         A_sell.AddMultTranspose(xt, yt_sell, -1.0);
+         REQUIRE(yt_sell.Normlinf() < 1e-12);
+      }
+   }
+
+   // Sorting the rows reduces the padding
+   SellCSigmaMatrix A_unsorted(*A, 8, 1), A_sorted(*A, 8, m);
+   REQUIRE(A_sorted.NumStoredElems() < A_unsorted.NumStoredElems());
+
+   delete A;
+}
+
+// Solve A X = B with PCG; return the number of iterations.
+int SolveCG(const Operator &A, Solver &prec, const Vector &B, Vector &X)
+{
+   CGSolver cg;
+   cg.SetRelTol(1e-10);
+   cg.SetMaxIter(500);
+   cg.SetOperator(A);
+   cg.SetPreconditioner(prec);
+   cg.Mult(B, X);
+   REQUIRE(cg.GetConverged());
+   return cg.GetNumIterations();
+}
+
+TEST_CASE("SellCSigmaMatrix in PCG", "[SellCSigmaMatrix]")
+{
+   Mesh mesh(8, 8, Element::QUADRILATERAL, 1);
+   H1_FECollection fec(3, 2);
+   FiniteElementSpace fes(&mesh, &fec);
+
+   Array<int> ess_bdr(mesh.bdr_attributes.Max()), ess_tdof_list;
+   ess_bdr = 1;
+   fes.GetEssentialTrueDofs(ess_bdr, ess_tdof_list);
+
+   ConstantCoefficient one(1.0);
+   LinearForm b(&fes);
+   b.AddDomainIntegrator(new DomainLFIntegrator(one));
+   b.Assemble();
+   BilinearForm a(&fes);
+   a.AddDomainIntegrator(new DiffusionIntegrator(one));
+   a.Assemble();
+
+   GridFunction x(&fes);
+   x = 0.0;
+   SparseMatrix A;
+   Vector B, X;
+   a.FormLinearSystem(ess_tdof_list, x, b, A, X, B);
+
+   SellCSigmaMatrix A_sell(A);
+   DSmoother prec(A);
+
+   Vector X_sell(X);
+   const int it = SolveCG(A, prec, B, X);
+   const int it_sell = SolveCG(A_sell, prec, B, X_sell);
+   REQUIRE(abs(it_sell - it) <= 1);
+   REQUIRE(MaxDiff(X, X_sell) < 1e-8*X.Normlinf());
+}
+
+}
@@ -0,0 +1,145 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#include "mfem-performance.hpp"
+#include "catch.hpp"
+
+using namespace mfem;
+
+namespace simd
+{
+
+// Check the operations of AutoSIMD<double,S,A> against the scalar ones.
+template <int S, int A>
+void TestAutoSIMD()
+{
+   typedef AutoSIMD<double,S,A> simd_t;
+   simd_t u, v, w;
+   for (int i = 0; i < S; i++)
+   {
+      u[i] = 1.0 + i;
+      v[i] = 0.5 - 2.0*i;
+   }
+   REQUIRE(size_t(&u) % A == 0);
+
+   const double e = 3.0;
+   w = u + v;
+   for (int i = 0; i < S; i++) { REQUIRE(w[i] == u[i] + v[i]); }
+   w = u - v;
+   for (int i = 0; i < S; i++) { REQUIRE(w[i] == u[i] - v[i]); }
+   w = u * v;
+   for (int i = 0; i < S; i++) { REQUIRE(w[i] == u[i] * v[i]); }
+   w = u / v;
+   for (int i = 0; i < S; i++) { REQUIRE(w[i] == u[i] / v[i]); }
+   w = -u;
+   for (int i = 0; i < S; i++) { REQUIRE(w[i] == -u[i]); }
+   w = e * u + v / e - e;
+   for (int i = 0; i < S; i++)
+   {
+      REQUIRE(w[i] == e * u[i] + v[i] / e - e);
+   }
+   w = e - u;
+   w *= v;
+   w += e;
+   for (int i = 0; i < S; i++) { REQUIRE(w[i] == (e - u[i]) * v[i] + e); }
+   w = e;
+   w.fma(u, v);
+   for (int i = 0; i < S; i++)
+   {
+      REQUIRE(std::abs(w[i] - (e + u[i] * v[i])) < 1e-14);
+   }
+   w = 1.0;
+   w /= u;
+   w -= v;
+   for (int i = 0; i < S; i++) { REQUIRE(w[i] == 1.0 / u[i] - v[i]); }
+   for (int i = 0; i < S; i++) { REQUIRE(SIMDLane(w, i) == w[i]); }
+}
+
+TEST_CASE("AutoSIMD operations", "[AutoSIMD]")
+{
+   TestAutoSIMD<1,8>();
+   TestAutoSIMD<2,16>();
+   TestAutoSIMD<4,32>();
+   TestAutoSIMD<8,64>();
+   TestAutoSIMD<3,8>();
+
+   typedef AutoSIMDTraits<double,double> traits_t;
+   REQUIRE(traits_t::simd_size*sizeof(double) == MFEM_SIMD_SIZE);
+   TestAutoSIMD<traits_t::simd_size,traits_t::align_size>();
+
+   double *a = AlignedAlloc<double>(5, 64);
+   REQUIRE(size_t(a) % 64 == 0);
+   AlignedFree(a);
+}
+
+// Compare the SIMD and the scalar implementations of TBilinearForm.
+template <Geometry::Type geom, template<int,int,typename> class kernel_t>
+void TestTBilinearFormSIMD(Mesh &mesh)
+{
+   const int dim = Geometry::Constants<geom>::Dimension;
+   const int p = 2;
+
+   typedef H1_FiniteElement<geom,1>                mesh_fe_t;
+   typedef H1_FiniteElementSpace<mesh_fe_t>        mesh_fes_t;
+   typedef TMesh<mesh_fes_t>                       mesh_t;
+   typedef H1_FiniteElement<geom,p>                sol_fe_t;
+   typedef H1_FiniteElementSpace<sol_fe_t>         sol_fes_t;
+   typedef TIntegrationRule<geom,2*p>              int_rule_t;
+   typedef TConstantCoefficient<>                  coeff_t;
+   typedef TIntegrator<coeff_t,kernel_t>           integ_t;
+   typedef TBilinearForm<mesh_t,sol_fes_t,int_rule_t,integ_t> simd_form_t;
+   typedef TBilinearForm<mesh_t,sol_fes_t,int_rule_t,integ_t,ScalarLayout,
+           double,double,NoSIMDTraits<double,double> > form_t;
+
+   H1_FECollection nodes_fec(1, dim);
+   FiniteElementSpace nodes_fes(&mesh, &nodes_fec, dim, Ordering::byNODES);
+   GridFunction nodes(&nodes_fes);
+   mesh.GetNodes(nodes);
+
+   H1_FECollection fec(p, dim, BasisType::GaussLobatto);
+   FiniteElementSpace fes(&mesh, &fec);
+   const int NE = mesh.GetNE();
+
+   integ_t integ(coeff_t(2.0));
+   simd_form_t simd_form(integ, fes, nodes);
+   form_t form(integ, fes, nodes);
+   simd_form.Assemble();
+   form.Assemble();
+
+   Vector x(fes.GetVSize()), y1(fes.GetVSize()), y2(fes.GetVSize());
+   x.Randomize(1);
+   simd_form.Mult(x, y1);
+   form.Mult(x, y2);
+   y2 -= y1;
+   REQUIRE(y2.Normlinf() < 1e-12*y1.Normlinf());
+
+   const int dofs = sol_fe_t::dofs;
+   DenseTensor M1(dofs, dofs, NE), M2(dofs, dofs, NE);
+   simd_form.AssembleMatrix(M1);
+   form.AssembleMatrix(M2);
+   for (int i = 0; i < dofs*dofs*NE; i++)
+   {
+      REQUIRE(std::abs(M1.Data()[i] - M2.Data()[i]) < 1e-12);
+   }
+}
+
+TEST_CASE("TBilinearForm with AutoSIMD", "[AutoSIMD]")
+{
+   // The number of elements is not a multiple of the SIMD width
+   Mesh mesh2d(3, 5, Element::QUADRILATERAL, 1);
+   TestTBilinearFormSIMD<Geometry::SQUARE,TMassKernel>(mesh2d);
+   TestTBilinearFormSIMD<Geometry::SQUARE,TDiffusionKernel>(mesh2d);
+   Mesh mesh3d(3, 1, 1, Element::HEXAHEDRON, 1);
+   TestTBilinearFormSIMD<Geometry::CUBE,TMassKernel>(mesh3d);
+   TestTBilinearFormSIMD<Geometry::CUBE,TDiffusionKernel>(mesh3d);
+}
+
+}
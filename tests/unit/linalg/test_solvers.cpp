@@ -0,0 +1,320 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#include "mfem.hpp"
+#include "catch.hpp"
+#include "linalg_test_problems.hpp"
+
+using namespace mfem;
+using namespace linalg_test;
+
+namespace solvers
+{
+
+TEST_CASE("OperatorChebyshevSmoother eigenvalue estimates", "[Chebyshev]")
+{
+   const int n = 200;
+   SparseMatrix *A = Laplacian1D(n);
+   Vector diag;
+   A->GetDiag(diag);
+   // The largest eigenvalue of D^{-1} A
+   const double lmax = 1.0 - cos(M_PI*n/(n+1.0));
+
+   OperatorChebyshevSmoother power(*A, diag, 2, 10,
+                                   OperatorChebyshevSmoother::POWER);
+   OperatorChebyshevSmoother lanczos(*A, diag, 2, 10,
+                                     OperatorChebyshevSmoother::LANCZOS);
+   const double power_est = power.GetMaxEigenvalueEstimate();
+   const double lanczos_est = lanczos.GetMaxEigenvalueEstimate();
+   REQUIRE(power_est <= lmax*(1.0 + 1e-12));
+   REQUIRE(lanczos_est <= lmax*(1.0 + 1e-12));
+   REQUIRE(lanczos_est > 0.95*lmax);
+   REQUIRE(lmax - lanczos_est < lmax - power_est);
+   delete A;
+}
+
+TEST_CASE("OperatorChebyshevSmoother with matrix-free operators",
+          "[Chebyshev]")
+{
+   Mesh mesh(8, 8, Element::QUADRILATERAL, 1);
+   H1_FECollection fec(4, 2);
+   FiniteElementSpace fes(&mesh, &fec);
+   Array<int> ess_tdof_list, ess_bdr(mesh.bdr_attributes.Max());
+   ess_bdr = 1;
+   fes.GetEssentialTrueDofs(ess_bdr, ess_tdof_list);
+
+   ConstantCoefficient one(1.0);
+   LinearForm b(&fes);
+   b.AddDomainIntegrator(new DomainLFIntegrator(one));
+   b.Assemble();
+
+   BilinearForm a(&fes);
+   a.SetAssemblyLevel(AssemblyLevel::PARTIAL);
+   a.AddDomainIntegrator(new DiffusionIntegrator(one));
+   a.Assemble();
+
+   GridFunction x(&fes);
+   x = 0.0;
+   Operator *A;
+   Vector B, X;
+   a.FormLinearSystem(ess_tdof_list, x, b, A, X, B);
+   Vector diag;
+   a.FormSystemDiagonal(ess_tdof_list, diag);
+
+   int iterations[2];
+   for (int k = 0; k < 2; k++)
+   {
+      OperatorChebyshevSmoother cheby(*A, diag, 3, 10,
+                                      OperatorChebyshevSmoother::LANCZOS);
+      CGSolver cg;
+      cg.SetRelTol(1e-10);
+      cg.SetMaxIter(1000);
+      cg.SetOperator(*A);
+      if (k == 1) { cg.SetPreconditioner(cheby); }
+      X = 0.0;
+      cg.Mult(B, X);
+      REQUIRE(cg.GetConverged());
+      iterations[k] = cg.GetNumIterations();
+
+      Vector r(B);
+      A->Mult(X, r);
+      r -= B;
+      REQUIRE(r.Normlinf() < 1e-8*B.Normlinf());
+   }
+   // Chebyshev preconditioning reduces the iterations at least by half
+   REQUIRE(2*iterations[1] < iterations[0]);
+   delete A;
+}
+
+// The SPD (diffusion) or nonsymmetric (convection-diffusion) system of a Q2
+// discretization on a 16 x 16 mesh
+SparseMatrix *FEMatrix(bool symmetric, Vector &b)
+{
+   return symmetric ? ConvectionDiffusion(16, 2, 1.0, 0.0, 0.0, b) :
+          ConvectionDiffusion(16, 2, 1.0, 20.0, 10.0, b);
+}
+
+// Solve with the given solver and return the relative true residual
+double SolveAndCheck(IterativeSolver &solver, const SparseMatrix &A,
+                     Solver *prec, const Vector &b, int &iterations)
+{
+   solver.SetRelTol(1e-10);
+   solver.SetMaxIter(2000);
+   if (prec) { solver.SetPreconditioner(*prec); }
+   solver.SetOperator(A);
+   Vector x(b.Size());
+   x = 0.0;
+   solver.Mult(b, x);
+   REQUIRE(solver.GetConverged());
+   iterations = solver.GetNumIterations();
+   return RelativeResidual(A, b, x);
+}
+
+TEST_CASE("Pipelined Krylov solvers", "[PipelinedSolvers]")
+{
+   for (int use_prec = 0; use_prec < 2; use_prec++)
+   {
+      Vector b;
+      int it, it_pipe;
+
+      SparseMatrix *A = FEMatrix(true, b);
+      DSmoother jacobi(*A);
+      Solver *prec = use_prec ? &jacobi : NULL;
+      {
+         CGSolver cg;
+         PipelinedCGSolver pcg;
+         REQUIRE(SolveAndCheck(cg, *A, prec, b, it) < 1e-8);
+         REQUIRE(SolveAndCheck(pcg, *A, prec, b, it_pipe) < 1e-8);
+         REQUIRE(abs(it - it_pipe) <= 2 + it/10);
+      }
+      delete A;
+
+      A = FEMatrix(false, b);
+      DSmoother jacobi_ns(*A);
+      prec = use_prec ? &jacobi_ns : NULL;
+      {
+         GMRESSolver gmres;
+         PipelinedGMRESSolver pgmres;
+         gmres.SetKDim(30);
+         pgmres.SetKDim(30);
+         REQUIRE(SolveAndCheck(gmres, *A, prec, b, it) < 1e-8);
+         REQUIRE(SolveAndCheck(pgmres, *A, prec, b, it_pipe) < 1e-8);
+         REQUIRE(abs(it - it_pipe) <= 2 + it/10);
+      }
+      {
+         BiCGSTABSolver bicgstab;
+         PipelinedBiCGSTABSolver pbicgstab;
+         REQUIRE(SolveAndCheck(bicgstab, *A, prec, b, it) < 1e-8);
+         REQUIRE(SolveAndCheck(pbicgstab, *A, prec, b, it_pipe) < 1e-8);
+         REQUIRE(abs(it - it_pipe) <= 2 + it/5);
+      }
+      delete A;
+   }
+}
+
+TEST_CASE("Krylov solvers with fused vector updates", "[FusedKernels]")
+{
+   for (int use_prec = 0; use_prec < 2; use_prec++)
+   {
+      Vector b;
+      int it;
+
+      SparseMatrix *A = FEMatrix(true, b);
+      DSmoother jacobi(*A);
+      Solver *prec = use_prec ? &jacobi : NULL;
+      {
+         CGSolver cg;
+         MINRESSolver minres;
+         BiCGSTABSolver bicgstab;
+         REQUIRE(SolveAndCheck(cg, *A, prec, b, it) < 1e-8);
+         REQUIRE(SolveAndCheck(minres, *A, prec, b, it) < 1e-8);
+         REQUIRE(SolveAndCheck(bicgstab, *A, prec, b, it) < 1e-8);
+      }
+      delete A;
+   }
+}
+
+// Block of k right-hand sides: b, random vectors, a repeated column, a zero
+// column and a linear combination of the other columns.
+void RHSBlock(const Vector &b, int k, DenseMatrix &B)
+{
+   const int n = b.Size();
+   B.SetSize(n, k);
+   B = 0.0;
+   for (int j = 0; j < k; j++)
+   {
+      Vector bj(B.GetColumn(j), n);
+      if (j == 0) { bj = b; }
+      else if (j < k-3) { bj.Randomize(j); }
+      else if (j == k-3) { bj = Vector(B.GetColumn(1), n); }
+      else if (j == k-1)
+      {
+         add(b, 2.0, Vector(B.GetColumn(1), n), bj);
+      }
+   }
+}
+
+// Maximal relative residual over the columns of B, where zero columns of B
+// require zero columns of X.
+double MaxResidual(const SparseMatrix &A, const DenseMatrix &B,
+                   const DenseMatrix &X)
+{
+   const int n = B.Height();
+   Vector r(n);
+   double max_res = 0.0;
+   for (int j = 0; j < B.Width(); j++)
+   {
+      Vector bj(const_cast<double*>(B.GetColumn(j)), n);
+      Vector xj(const_cast<double*>(X.GetColumn(j)), n);
+      A.Mult(xj, r);
+      r -= bj;
+      const double nb = bj.Norml2();
+      max_res = std::max(max_res, r.Norml2()/(nb > 0.0 ? nb : 1.0));
+   }
+   return max_res;
+}
+
+TEST_CASE("Block products of operators", "[BlockSolvers]")
+{
+   Vector b;
+   SparseMatrix *A = FEMatrix(false, b);
+   const int n = A->Height(), k = 4;
+   DenseMatrix X(n, k), Y, Y2;
+   for (int j = 0; j < k; j++)
+   {
+      Vector(X.GetColumn(j), n).Randomize(j+1);
+   }
+
+   Array<int> list;
+   for (int i = 0; i < n; i += 7) { list.Append(i); }
+   ConstrainedOperator C(A, list);
+   DSmoother jacobi(*A, 0, 0.7);
+
+   Operator *ops[] = { A, &C, &jacobi };
+   for (int op = 0; op < 3; op++)
+   {
+      ops[op]->MultMulti(X, Y);
+      REQUIRE(Y.Height() == n);
+      REQUIRE(Y.Width() == k);
+      Y2.SetSize(n, k);
+      for (int j = 0; j < k; j++)
+      {
+         Vector xj(X.GetColumn(j), n), yj(Y2.GetColumn(j), n);
+         ops[op]->Mult(xj, yj);
+      }
+      Y -= Y2;
+      REQUIRE(Y.MaxMaxNorm() <= 1e-12*Y2.MaxMaxNorm());
+   }
+   delete A;
+}
+
+TEST_CASE("Block Krylov solvers", "[BlockSolvers]")
+{
+   const int k = 6;
+   for (int use_prec = 0; use_prec < 2; use_prec++)
+   {
+      Vector b;
+      DenseMatrix B, X;
+      int it, max_it = 0;
+
+      SparseMatrix *A = FEMatrix(true, b);
+      RHSBlock(b, k, B);
+      DSmoother jacobi(*A);
+      Solver *prec = use_prec ? &jacobi : NULL;
+      {
+         CGSolver cg;
+         for (int j = 0; j < k-3; j++)
+         {
+            Vector bj(B.GetColumn(j), B.Height());
+            REQUIRE(SolveAndCheck(cg, *A, prec, bj, it) < 1e-8);
+            max_it = std::max(max_it, it);
+         }
+
+         BlockCGSolver bcg;
+         bcg.SetRelTol(1e-10);
+         bcg.SetMaxIter(2000);
+         if (prec) { bcg.SetPreconditioner(*prec); }
+         bcg.SetOperator(*A);
+         X.SetSize(B.Height(), k);
+         X = 0.0;
+         bcg.MultMulti(B, X);
+         REQUIRE(bcg.GetConverged());
+         REQUIRE(bcg.GetNumIterations() <= max_it);
+         REQUIRE(MaxResidual(*A, B, X) < 1e-8);
+
+         REQUIRE(SolveAndCheck(bcg, *A, prec, b, it) < 1e-8);
+      }
+      delete A;
+
+      A = FEMatrix(false, b);
+      RHSBlock(b, k, B);
+      DSmoother jacobi_ns(*A);
+      prec = use_prec ? &jacobi_ns : NULL;
+      {
+         BlockGMRESSolver bgmres;
+         bgmres.SetKDim(20);
+         bgmres.SetRelTol(1e-10);
+         bgmres.SetMaxIter(2000);
+         if (prec) { bgmres.SetPreconditioner(*prec); }
+         bgmres.SetOperator(*A);
+         X.SetSize(B.Height(), k);
+         X = 0.0;
+         bgmres.MultMulti(B, X);
+         REQUIRE(bgmres.GetConverged());
+         REQUIRE(MaxResidual(*A, B, X) < 1e-8);
+
+         REQUIRE(SolveAndCheck(bgmres, *A, prec, b, it) < 1e-8);
+      }
+      delete A;
+   }
+}
+
+}
@@ -0,0 +1,79 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#include "mfem.hpp"
+#include "catch.hpp"
+
+#include <limits>
+
+using namespace mfem;
+
+TEST_CASE("Vector fused kernels", "[Vector]")
+{
+   const int n = 1001;
+   const double tol = 1e-12;
+   const double a = 0.3, b = -1.7, c = 2.5;
+
+   Vector x(n), y(n), z(n), w(n), ref(n);
+   x.Randomize(1);
+   y.Randomize(2);
+   z.Randomize(3);
+
+   SECTION("Dots")
+   {
+      double dx, dy;
+      z.Dots(x, y, dx, dy);
+      REQUIRE(fabs(dx - z*x) <= tol*fabs(z*x));
+      REQUIRE(fabs(dy - z*y) <= tol*fabs(z*y));
+   }
+
+   SECTION("add with three terms")
+   {
+      add(a, x, b, y, ref);
+      ref.Add(c, z);
+      add(a, x, b, y, c, z);
+      z -= ref;
+      REQUIRE(z.Normlinf() <= tol);
+
+      // c = 0 does not use the values of z
+      z = std::numeric_limits<double>::quiet_NaN();
+      add(a, x, b, y, 0.0, z);
+      add(a, x, b, y, ref);
+      z -= ref;
+      REQUIRE(z.Normlinf() <= tol);
+   }
+
+   SECTION("AddAndDot")
+   {
+      add(x, a, y, ref);
+      double d = AddAndDot(x, a, y, w, z);
+      REQUIRE(fabs(d - ref*z) <= tol*fabs(ref*z));
+      w -= ref;
+      REQUIRE(w.Normlinf() <= tol);
+
+      // In place update and squared norm of the result
+      d = AddAndDot(x, a, y, x, x);
+      REQUIRE(fabs(d - ref*ref) <= tol*(ref*ref));
+      x -= ref;
+      REQUIRE(x.Normlinf() <= tol);
+   }
+
+   SECTION("AddPair")
+   {
+      add(x, a, y, ref);
+      add(y, b, z, w);
+      AddPair(x, a, y, y, b, z);
+      x -= ref;
+      REQUIRE(x.Normlinf() <= tol);
+      y -= w;
+      REQUIRE(y.Normlinf() <= tol);
+   }
+}
@@ -0,0 +1,181 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#include "mfem.hpp"
+#include "catch.hpp"
+
+using namespace mfem;
+
+namespace bbox_tree
+{
+
+void twist(const Vector &x, Vector &y)
+{
+   y = x;
+   y(0) += 0.1*sin(3.0*x(1));
+   y(1) += 0.1*cos(2.0*x(0));
+}
+
+// Check that the element containing each of the given points is among the
+// candidates returned by the tree, and that FindPoints finds all points.
+void CheckPoints(Mesh &mesh, const DenseMatrix &pts, const Array<int> &elems,
+                 const Array<IntegrationPoint> &ips)
+{
+   const BoundingBoxTree &tree = mesh.GetBoundingBoxTree();
+   Array<int> candidates;
+   for (int k = 0; k < pts.Width(); k++)
+   {
+      tree.FindCandidates(pts.GetColumn(k), candidates);
+      REQUIRE(candidates.Find(elems[k]) >= 0);
+   }
+
+   // Use a robust initial guess for the inversion in the curved elements and
+   // tolerances above round-off, so that the Newton iteration can terminate
+   InverseElementTransformation inv_tr;
+   inv_tr.SetInitialGuessType(InverseElementTransformation::ClosestPhysNode);
+   inv_tr.SetReferenceTol(1e-12);
+   inv_tr.SetPhysicalRelTol(1e-12);
+   DenseMatrix point_mat(pts);
+   Array<int> found_elems;
+   Array<IntegrationPoint> found_ips;
+   REQUIRE(mesh.FindPoints(point_mat, found_elems, found_ips, true, &inv_tr)
+           == pts.Width());
+
+   // Points may lie on element boundaries, so compare the physical points
+   Vector x;
+   double err = 0.0;
+   for (int k = 0; k < pts.Width(); k++)
+   {
+      mesh.GetElementTransformation(found_elems[k])->Transform(found_ips[k], x);
+      for (int d = 0; d < x.Size(); d++)
+      {
+         err = std::max(err, fabs(x(d) - pts(d,k)));
+      }
+   }
+   REQUIRE(err < 1e-8);
+}
+
+// Generate random reference points in random elements, with their physical
+// coordinates.
+void MakePoints(Mesh &mesh, int npts, DenseMatrix &pts, Array<int> &elems,
+                Array<IntegrationPoint> &ips)
+{
+   const int dim = mesh.Dimension();
+   pts.SetSize(mesh.SpaceDimension(), npts);
+   elems.SetSize(npts);
+   ips.SetSize(npts);
+   Vector x;
+   for (int k = 0; k < npts; k++)
+   {
+      elems[k] = rand() % mesh.GetNE();
+      ips[k].x = rand()/double(RAND_MAX);
+      ips[k].y = rand()/double(RAND_MAX);
+      ips[k].z = (dim == 3) ? rand()/double(RAND_MAX) : 0.0;
+      if (mesh.GetElementBaseGeometry(elems[k]) == Geometry::TRIANGLE &&
+          ips[k].x + ips[k].y > 1.0)
+      {
+         ips[k].x = 1.0 - ips[k].x;
+         ips[k].y = 1.0 - ips[k].y;
+      }
+      mesh.GetElementTransformation(elems[k])->Transform(ips[k], x);
+      pts.SetCol(k, x);
+   }
+}
+
+TEST_CASE("BoundingBoxTree and FindPoints", "[BoundingBoxTree]")
+{
+   for (int t = 0; t < 3; t++)
+   {
+      Mesh *mesh = (t == 0) ? new Mesh(8, 8, Element::QUADRILATERAL, 1) :
+                   (t == 1) ? new Mesh(8, 8, Element::TRIANGLE, 1) :
+                   new Mesh(4, 4, 4, Element::HEXAHEDRON, 1);
+      if (t < 2)
+      {
+         mesh->SetCurvature(3);
+         mesh->Transform(twist);
+      }
+
+      DenseMatrix pts;
+      Array<int> elems;
+      Array<IntegrationPoint> ips;
+
+      MakePoints(*mesh, 100, pts, elems, ips);
+      CheckPoints(*mesh, pts, elems, ips);
+
+      // Move the nodes: the tree is refitted
+      const long coords_sequence = mesh->GetCoordinatesSequence();
+      Vector disp;
+      mesh->GetNodes(disp);
+      disp = 0.0;
+      const GridFunction *nodes = mesh->GetNodes();
+      for (int i = 0; i < disp.Size()/mesh->SpaceDimension(); i++)
+      {
+         disp(nodes ? nodes->FESpace()->DofToVDof(i, 0) : i) = 0.5;
+      }
+      mesh->MoveNodes(disp);
+      REQUIRE(mesh->GetCoordinatesSequence() > coords_sequence);
+      MakePoints(*mesh, 100, pts, elems, ips);
+      CheckPoints(*mesh, pts, elems, ips);
+
+      // Refine the mesh: the tree is rebuilt
+      const int num_nodes = mesh->GetBoundingBoxTree().GetNumNodes();
+      mesh->UniformRefinement();
+      MakePoints(*mesh, 100, pts, elems, ips);
+      CheckPoints(*mesh, pts, elems, ips);
+      REQUIRE(mesh->GetBoundingBoxTree().GetNumNodes() > num_nodes);
+
+      delete mesh;
+   }
+}
+
+TEST_CASE("FindPoints outside of the mesh", "[BoundingBoxTree]")
+{
+   Mesh mesh(4, 4, Element::QUADRILATERAL, 1);
+   DenseMatrix pts(2, 2);
+   pts(0,0) = 1.5; pts(1,0) = 0.5;
+   pts(0,1) = 0.3; pts(1,1) = 0.7;
+   Array<int> elems;
+   Array<IntegrationPoint> ips;
+   REQUIRE(mesh.FindPoints(pts, elems, ips, false) == 1);
+   REQUIRE(elems[0] == -1);
+   REQUIRE(elems[1] >= 0);
+}
+
+TEST_CASE("InverseElementTransformation with a BoundingBoxTree",
+          "[BoundingBoxTree]")
+{
+   Mesh mesh(4, 4, Element::QUADRILATERAL, 1);
+   const BoundingBoxTree &tree = mesh.GetBoundingBoxTree();
+   InverseElementTransformation inv_tr;
+   inv_tr.SetBoundingBoxTree(&tree);
+
+   // The point is in element 0, at the corner (0,0) of the mesh, and outside
+   // of the box of element 15, at the opposite corner
+   Vector pt(2);
+   pt(0) = 0.1; pt(1) = 0.1;
+   IntegrationPoint ip;
+   inv_tr.SetTransformation(*mesh.GetElementTransformation(0));
+   REQUIRE(inv_tr.Transform(pt, ip) == InverseElementTransformation::Inside);
+   inv_tr.SetTransformation(*mesh.GetElementTransformation(15));
+   REQUIRE(inv_tr.Transform(pt, ip) == InverseElementTransformation::Outside);
+
+   // After the vertices move, the tree is out of date until it is updated
+   Vector disp(2*mesh.GetNV());
+   disp = 0.01;
+   mesh.MoveVertices(disp);
+   REQUIRE(!tree.IsUpToDate());
+   REQUIRE(&mesh.GetBoundingBoxTree() == &tree);
+   REQUIRE(tree.IsUpToDate());
+   inv_tr.SetTransformation(*mesh.GetElementTransformation(0));
+   REQUIRE(inv_tr.Transform(pt, ip) == InverseElementTransformation::Inside);
+}
+
+}
@@ -0,0 +1,149 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#include "mfem.hpp"
+#include "catch.hpp"
+
+using namespace mfem;
+
+namespace geometric_factors
+{
+
+void bump(const Vector &x, Vector &y)
+{
+   y = x;
+   y(0) += 0.1*sin(3.0*x(1));
+   y(1) += 0.1*cos(2.0*x(0));
+   if (y.Size() == 3) { y(2) = 0.2*x(0)*x(1); }
+}
+
+// Compare the geometric factors with the ElementTransformation values.
+void CheckFactors(Mesh &mesh, int order)
+{
+   const int dim = mesh.Dimension(), sdim = mesh.SpaceDimension();
+   const int flags = GeometricFactors::COORDINATES |
+                     GeometricFactors::JACOBIANS |
+                     GeometricFactors::DETERMINANTS |
+                     GeometricFactors::INV_JACOBIANS;
+   const IntegrationRule &ir =
+      IntRules.Get(mesh.GetElementBaseGeometry(0), order);
+   const GeometricFactors *geom = mesh.GetGeometricFactors(ir, flags);
+   REQUIRE(mesh.GetGeometricFactors(ir, GeometricFactors::JACOBIANS) == geom);
+
+   const int NQ = ir.GetNPoints(), NE = mesh.GetNE();
+   REQUIRE(geom->X.Size() == NQ*sdim*NE);
+   REQUIRE(geom->detJ.Size() == NQ*NE);
+   double err = 0.0;
+   Vector x;
+   for (int e = 0; e < NE; e++)
+   {
+      ElementTransformation &T = *mesh.GetElementTransformation(e);
+      for (int q = 0; q < NQ; q++)
+      {
+         const IntegrationPoint &ip = ir.IntPoint(q);
+         T.SetIntPoint(&ip);
+         T.Transform(ip, x);
+         const DenseMatrix &J = T.Jacobian();
+         const DenseMatrix &Jinv = T.InverseJacobian();
+         for (int c = 0; c < sdim; c++)
+         {
+            err = std::max(err, fabs(geom->X(q+NQ*(c+sdim*e)) - x(c)));
+            for (int k = 0; k < dim; k++)
+            {
+               err = std::max(err, fabs(geom->J(q+NQ*(c+sdim*(k+dim*e))) -
+                                        J(c,k)));
+               err = std::max(err, fabs(geom->InvJ(q+NQ*(k+dim*(c+sdim*e))) -
+                                        Jinv(k,c)));
+            }
+         }
+         err = std::max(err, fabs(geom->detJ(q+NQ*e) - T.Weight()));
+      }
+   }
+   REQUIRE(err < 1e-12);
+}
+
+TEST_CASE("GeometricFactors", "[GeometricFactors]")
+{
+   SECTION("Straight tetrahedra")
+   {
+      Mesh mesh(2, 3, 2, Element::TETRAHEDRON, 1, 1.0, 2.0, 0.5);
+      CheckFactors(mesh, 3);
+   }
+
+   SECTION("Curved quadrilaterals")
+   {
+      Mesh mesh(4, 3, Element::QUADRILATERAL, 1);
+      mesh.SetCurvature(3);
+      mesh.Transform(bump);
+      CheckFactors(mesh, 5);
+   }
+
+   SECTION("Curved surface")
+   {
+      Mesh mesh(3, 3, Element::TRIANGLE, 1);
+      mesh.SetCurvature(2, false, 3, Ordering::byVDIM);
+      mesh.Transform(bump);
+      CheckFactors(mesh, 4);
+   }
+}
+
+TEST_CASE("GeometricFactors update", "[GeometricFactors]")
+{
+   Mesh mesh(3, 3, Element::QUADRILATERAL, 1);
+   const IntegrationRule &ir = IntRules.Get(Geometry::SQUARE, 2);
+   const GeometricFactors *geom =
+      mesh.GetGeometricFactors(ir, GeometricFactors::DETERMINANTS);
+   REQUIRE(fabs(geom->detJ.Sum() - ir.GetNPoints()*mesh.GetNE()/9.0) < 1e-12);
+
+   // Doubling the coordinates quadruples the determinants
+   Vector nodes;
+   mesh.GetNodes(nodes);
+   mesh.MoveNodes(nodes);
+   geom = mesh.GetGeometricFactors(ir, GeometricFactors::DETERMINANTS);
+   REQUIRE(fabs(geom->detJ.Sum() - 4.0*ir.GetNPoints()*mesh.GetNE()/9.0) <
+           1e-12);
+
+   // The factors of the refined mesh are recomputed
+   mesh.UniformRefinement();
+   geom = mesh.GetGeometricFactors(ir, GeometricFactors::DETERMINANTS);
+   REQUIRE(geom->detJ.Size() == ir.GetNPoints()*mesh.GetNE());
+   CheckFactors(mesh, 2);
+}
+
+TEST_CASE("GeometricFactors of user rules", "[GeometricFactors]")
+{
+   Mesh mesh(3, 3, Element::QUADRILATERAL, 1);
+   const IntegrationRule &ir = IntRules.Get(Geometry::SQUARE, 2);
+   const int NQ = ir.GetNPoints(), NE = mesh.GetNE();
+
+   // The factors are found by the points of the rule, not by its address, so
+   // the rule of the user can be deleted
+   IntegrationRule *user_ir = new IntegrationRule(ir);
+   const GeometricFactors *geom =
+      mesh.GetGeometricFactors(*user_ir, GeometricFactors::JACOBIANS);
+   delete user_ir;
+   REQUIRE(geom->IntRule->GetNPoints() == NQ);
+   REQUIRE(mesh.GetGeometricFactors(ir, GeometricFactors::JACOBIANS) == geom);
+
+   const IntegrationRule &ir4 = IntRules.Get(Geometry::SQUARE, 4);
+   const GeometricFactors *geom4 =
+      mesh.GetGeometricFactors(ir4, GeometricFactors::JACOBIANS);
+   REQUIRE(geom4 != geom);
+   REQUIRE(geom4->J.Size() == ir4.GetNPoints()*2*2*NE);
+
+   // After refinement, the factors computed before are recomputed as well
+   mesh.UniformRefinement();
+   geom = mesh.GetGeometricFactors(ir, GeometricFactors::COORDINATES);
+   REQUIRE(geom->X.Size() == NQ*2*mesh.GetNE());
+   REQUIRE(geom->J.Size() == NQ*2*2*mesh.GetNE());
+}
+
+}
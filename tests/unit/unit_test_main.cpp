@@ -9,5 +9,19 @@
 // terms of the GNU Lesser General Public License (as published by the Free
 // Software Foundation) version 2.1 dated February 1999.
 
-#define CATCH_CONFIG_MAIN     // This tells Catch to provide a main() - only do this in one cpp file
+#define CATCH_CONFIG_RUNNER   // Provide main() below - only do this in one cpp file
+#include "mfem.hpp"
 #include "catch.hpp"
+
+int main(int argc, char *argv[])
+{
+#ifdef MFEM_USE_MPI
+   // The tests tagged [Parallel] use MPI_COMM_WORLD
+   MPI_Init(&argc, &argv);
+#endif
+   int result = Catch::Session().run(argc, argv);
+#ifdef MFEM_USE_MPI
+   MPI_Finalize();
+#endif
+   return result;
+}